@@ -0,0 +1,72 @@
+#ifndef ACLIENT_H
+#define ACLIENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// =====================================================================
+// [비동기 클라이언트] 논블로킹 소켓 + poll 이벤트 루프
+// - 요청마다 요청 ID 를 붙이고(REQ_ID_FLAG) 응답 헤더로 돌아온 ID 로 요청과 짝을 맞춤
+// - 한 연결에 응답을 기다리지 않고 요청을 이어 보냄(파이프라이닝). 서버는 연결마다 순서대로 처리하므로
+//   여러 요청을 동시에 처리받으려면 연결 풀(AcPool)로 나눠 보냄
+// - 요청마다 제한 시간. 시간이 지나면 AC_TIMEOUT 으로 끝내고 늦게 온 응답은 버림
+// 루프와 그 루프의 연결은 한 스레드에서만 다룹니다 (스레드마다 루프 하나).
+// 콜백 안에서 새 요청을 보내는 것은 되지만, 연결을 닫거나(ac_close) 루프를 다시 돌리는 호출(ac_call, ac_future_wait)은 안 됩니다.
+// =====================================================================
+
+enum { AC_OK, AC_TIMEOUT, AC_CLOSED };
+
+#define AC_NO_TIMEOUT 0
+
+typedef struct AcLoop AcLoop;
+typedef struct AcConn AcConn;
+typedef struct AcPool AcPool;
+typedef struct AcFuture AcFuture;
+
+typedef struct {
+    int status;             // AC_OK / AC_TIMEOUT / AC_CLOSED
+    int code;               // 응답 코드 (200, 503 = 혼잡 거절), AC_OK 일 때만
+    int page;               // "페이지|메시지" 의 페이지 필드
+    const char* msg;        // 메시지 (NUL 종료, 수신 버퍼를 그대로 가리키므로 콜백 안에서만 유효)
+    size_t len;
+    uint32_t rid;
+} AcResult;
+
+typedef void (*AcCallback)(const AcResult* res, void* arg);
+typedef void (*AcPushHandler)(int code, const char* payload, void* arg);
+
+AcLoop* ac_loop_new(void);
+void ac_loop_free(AcLoop* loop);                        // 남은 연결을 모두 닫음
+int ac_run_once(AcLoop* loop, int timeout_ms);          // 한 번 poll 후 입출력/시간 초과 처리 -> 호출한 콜백 수 (-1 = poll 오류)
+int ac_inflight(AcLoop* loop);                          // 응답을 기다리는 요청 수
+
+// 논블로킹 접속 후 접속 인사(99, payload = 매장 ID)를 먼저 보내 둠. 그 뒤 요청은 접속을 기다리지 않고 바로 쌓을 수 있음
+AcConn* ac_connect(AcLoop* loop, const char* host, int port, uint32_t cid, const char* store_id);
+AcConn* ac_attach(AcLoop* loop, int sock, uint32_t cid);   // 이미 접속한 소켓을 넘겨받음 (논블로킹으로 바꿈)
+void ac_close(AcConn* conn);                            // 남은 요청은 AC_CLOSED 로 끝냄
+int ac_is_open(const AcConn* conn);
+int ac_conn_inflight(const AcConn* conn);
+void ac_set_cid(AcConn* conn, uint32_t cid);             // 이후 요청 헤더에 넣을 단말기 ID
+void ac_on_push(AcConn* conn, AcPushHandler handler, void* arg);   // 서버가 먼저 보내는 프레임(300~399)
+
+// 요청 보내기 -> 요청 ID (0 = 연결이 닫혀 보내지 못함). rid 를 직접 주면 재전송용으로 그 ID 를 씀
+uint32_t ac_submit(AcConn* conn, uint32_t cmd, const char* payload, int timeout_ms, AcCallback cb, void* arg);
+uint32_t ac_submit_rid(AcConn* conn, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms, AcCallback cb, void* arg);
+
+// 퓨처: 결과를 복사해 두었다가 ac_future_wait 가 끝날 때까지 루프를 돌림
+AcFuture* ac_submit_future(AcConn* conn, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms);
+const AcResult* ac_future_wait(AcFuture* f);            // 끝난 결과 (ac_future_free 전까지 유효)
+int ac_future_done(const AcFuture* f);
+void ac_future_free(AcFuture* f);
+
+// 블로킹 호출: 응답을 out 에 복사 -> 응답 코드, 시간 초과/단절 시 -1
+int ac_call(AcConn* conn, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms, char* out, size_t size, int* out_page);
+
+// 연결 풀: 응답 대기 중인 요청이 가장 적은 연결로 보냄. 닫힌 연결은 다음 요청 때 다시 접속
+AcPool* ac_pool_new(AcLoop* loop, const char* host, int port, uint32_t cid, const char* store_id, int size);
+uint32_t ac_pool_submit(AcPool* pool, uint32_t cmd, const char* payload, int timeout_ms, AcCallback cb, void* arg);
+void ac_pool_free(AcPool* pool);
+
+uint32_t ac_next_request_id(void);                      // 프로세스 안에서 겹치지 않는 요청 ID (0 제외)
+
+#endif // ACLIENT_H
@@ -0,0 +1,19 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// [판매 가능 수량 캐시]
+// 서버가 재고 버전 변경을 푸시하므로, 버전이 바뀌지 않았으면 메뉴판과 장바구니 검증을 로컬에서 처리합니다.
+void cache_reset(int push_enabled);              // 재연결 시 호출 (구독 실패 시 0 -> 매번 서버 조회)
+void cache_note_version(uint64_t version);        // 푸시 수신 시 (network.c)
+void cache_note_alert(const char* text);           // 분류별 재고 알림 수신 시 (network.c)
+void cache_invalidate(void);                      // 자신의 변경 요청(결제 등) 직후 즉시 무효화
+int cache_refresh(int sock, uint32_t cid);        // 필요할 때만 스냅샷 재조회 (통신 실패 시 -1)
+void cache_render_menu(char* out, size_t size);   // 서버 메뉴판(cmd 15)과 같은 형식
+int cache_available(const char* name);            // 판매 가능 수량 (없으면 0)
+int cache_ready(void);                            // 스냅샷을 한 번이라도 받았는지 (오프라인 판매 가능 여부)
+void cache_take(const char* name, int qty);       // 오프라인 판매/담기로 로컬 판매 가능 수량 차감 (음수 = 되돌림)
+
+#endif // CACHE_H
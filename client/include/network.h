@@ -4,13 +4,46 @@
 #include <stdint.h>
 #include "utils.h"
 
+#define CMD_MENU_SNAPSHOT   20    // 판매 가능 수량 스냅샷 (응답 "버전\n상품명\t판매 가능\t예약\n...")
+#define CMD_SUBSCRIBE       21    // 재고 버전 변경 알림 구독 (응답 "현재 버전")
+#define CMD_WATCH           22    // 분류별 재고 이벤트 구독 "분류명|마스크|임계값" (분류명 "*" = 전체)
+#define CMD_CART_RELEASE    23    // 장바구니 예약 해제 (payload "" = 전체)
+#define CMD_SESSION         24    // 세션 시작/이어받기 (payload "" 또는 이전 토큰, 응답 "토큰\n상품명\t예약 수량\n...", 페이지 1 = 이어받음)
+                                  // 장바구니 예약은 세션에 묶임 (다른 세션/연결은 풀 수 없음)
+#define CMD_PING            25    // 입력 대기 중 연결 유지 확인 (서버는 90초 동안 아무것도 받지 못하면 연결을 정리)
+#define CMD_STOCK_VALUE     26    // 분류별 재고 금액
+#define CMD_LOT_ITEMS       27    // 로트 번호로 상품 조회 "로트|페이지" (응답 페이지 필드 = 전체 페이지 수)
+#define CMD_OFFLINE_SYNC    28    // 오프라인 판매 일괄 반영 "단말기태그\n판매번호\t상품명\t수량\n..."
+                                  // (응답 "반영된 마지막 판매번호\n판매번호\t상품명\t요청\t판매\n...", 페이지 필드 = 충돌 줄 수)
+#define CMD_ID_LEASE        29    // 상품 번호 구간 임대 "수량" (응답 "첫 번호\t끝 번호", 단일 입고 ID 칸에 번호만 보내면 서버가 분류 접두어를 붙임)
+#define CMD_BULK_STATUS     30    // 일괄 삭제(5/12/13) 작업 진행 상황 "작업 번호" (삭제 요청의 응답 페이지 필드가 작업 번호,
+                                  //  조회 응답 페이지 필드 = 진행률 0~99, 끝 100, 없는 작업 -1)
+#define META_TEXT_LEN       24    // 로트/공급사/진열 위치 최대 23바이트 (공백, '|' 불가)
+#define PUSH_INVALIDATE     300   // 서버가 먼저 보내는 프레임: payload "새 버전"
+#define PUSH_LOW_STOCK      301   // payload "분류명|남은 수량"
+#define PUSH_EXPIRED        302   // payload "분류명|새로 만료된 수량"
+#define PUSH_SOLD_OUT       303   // payload "분류명"
+#define REQ_ID_FLAG         0x80000000u  // 명령 코드에 켜면 payload 앞 4바이트가 요청 ID (응답 헤더 client_id 로 돌아옴)
+#define IS_PUSH(code)       ((code) >= 300 && (code) < 400)
+#define RESP_BUSY           503   // 서버 혼잡/요청 한도 초과로 처리되지 않음 (payload 는 일반 응답과 같은 "0|안내")
+#define WATCH_ALL           7     // 임계값 미만(1) | 만료(2) | 품절(4)
+#define LOW_STOCK_THRESHOLD 3
+#define HEARTBEAT_SEC       30    // 입력 대기 중 이 시간마다 CMD_PING
+#define RECONNECT_MAX_SEC   30    // 재연결 대기 시간 상한 (1, 2, 4, ... 초로 늘어남)
+#define REQUEST_TIMEOUT_SEC 60    // 이 시간 안에 응답이 없으면 연결이 끊긴 것으로 보고 재연결
+
 int connect_to_server(const char* ip, int port);
 void disconnect_from_server(int sock);
 
-int send_request(int sock, uint32_t cid, uint32_t cmd, const char* payload);
-int receive_response(int sock, char* out_payload, int* out_page);
+// 화면 코드용 블로킹 래퍼: 요청/응답은 비동기 클라이언트(aclient.h) 연결 하나로 주고받음
+int drain_pushes(int sock);                                         // 이미 도착한 푸시 프레임을 모두 처리 (단절 시 -1)
+int send_heartbeat(int sock);                                       // CMD_PING 왕복 (단절 시 -1)
 
 // 중복 코드 제거를 위한 통합 헬퍼 함수
-int send_and_receive(int sock, uint32_t cid, uint32_t cmd, const char* payload, char* out_msg, int* out_page);
+int send_and_receive(int sock, uint32_t cid, uint32_t cmd, const char* payload, char* out_msg, int* out_page);   // out_msg 는 MAX_PAYLOAD 바이트, 반환: 응답 코드 (단절 -1)
+
+// [요청 ID] 변경 요청을 같은 ID 로 다시 보내면 서버는 다시 실행하지 않고 처음 응답을 돌려줌 (약 5분 동안)
+uint32_t next_request_id(void);
+int send_and_receive_rid(int sock, uint32_t cid, uint32_t cmd, uint32_t rid, const char* payload, char* out_msg, int* out_page);
 
 #endif // NETWORK_H
\ No newline at end of file
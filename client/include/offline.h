@@ -0,0 +1,21 @@
+#ifndef OFFLINE_H
+#define OFFLINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pos.h"
+
+#define OFFLINE_JOURNAL     "pos_offline.journal"       // 매장 ID 가 있으면 "pos_offline_<매장>.journal"
+#define OFFLINE_REPORT      "pos_offline_conflicts.txt" // 동기화 충돌 보고 (사람이 읽는 기록, 이어 붙임)
+#define OFFLINE_BATCH_BYTES 6000                        // 동기화 요청 하나에 담을 판매 줄 (한 판매는 쪼개지 않음)
+
+// [오프라인 판매 저널] 서버에 닿지 않는 동안의 결제를 로컬 파일에 한 건씩 fsync 해 두었다가
+// 재접속하면 판매번호 순서대로 서버에 보냅니다. 서버가 판매번호로 중복을 거르므로 몇 번 다시 보내도 한 번만 반영됩니다.
+int offline_open(const char* store_id);                 // 저널을 읽어 밀린 판매를 복구 (실패 시 -1)
+int offline_record_sale(const CartItem* items, int n);  // 결제 한 건 기록 (디스크에 남기면 0, 실패 시 -1)
+int offline_pending(void);                              // 아직 서버에 반영되지 않은 판매 건수
+// 밀린 판매를 배치로 보냄. 충돌 줄은 report 에 이어 쓰고 OFFLINE_REPORT 에도 남김
+// 반환: 충돌 줄 수, 통신 단절 시 -1
+int offline_sync(int sock, uint32_t cid, char* report, size_t size);
+
+#endif // OFFLINE_H
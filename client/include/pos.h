@@ -2,6 +2,7 @@
 #define POS_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 // [장바구니 아이템 구조체]
 typedef struct {
@@ -12,8 +13,18 @@ typedef struct {
 // 시스템 초기화
 void init_pos_system(void);
 
+// 재접속 세션: 예약은 서버가 세션마다 정한 주인에 묶이므로 접속 인사 직후 bind_session 으로 먼저 이어받고
+// (반환: 이어받음 1, 새 세션 0, 통신 단절/거절 -1), 판매 재전송 등을 마친 뒤 resume_session 으로 장바구니를 맞춤
+int bind_session(int sock, uint32_t cid, char* token, size_t size);
+int resume_session(int sock, uint32_t cid, char* token, size_t size, int was_resumed);
+int cart_size(void);
+// 결제 도중 끊긴 판매 줄을 같은 요청 ID 로 다시 보냄 (이미 반영됐다면 서버가 처음 결과만 돌려줌), 통신 단절 시 -1
+int retry_in_doubt_sale(int sock, uint32_t cid);
+
 // 메인 실행 루프 (정상: 0, 통신에러: -1 반환)
 int run_pos_mode(int sock, uint32_t cid);
 int run_admin_mode(int sock, uint32_t cid);
+// 서버 없이 마지막 메뉴 캐시로 판매하고 결제는 오프라인 저널에 기록 (0 입력 시 복귀)
+int run_offline_mode(uint32_t cid);
 
 #endif // POS_H
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "aclient.h"
+#include "network.h"
+
+#define AC_MAX_FRAME (1u << 20)     // 이보다 긴 응답 본문은 프로토콜 오류로 보고 연결을 닫음
+#define AC_READ_CHUNK 16384
+
+enum { CONN_CONNECTING, CONN_OPEN, CONN_CLOSED };
+
+// 응답을 기다리는 요청 (연결마다 보낸 순서대로, 서버도 순서대로 답하므로 보통 맨 앞에서 짝이 맞음)
+typedef struct AcRequest {
+    uint32_t rid;
+    int64_t deadline;       // CLOCK_MONOTONIC ms (0 = 제한 없음)
+    AcCallback cb;
+    void* arg;
+    struct AcRequest* next;
+} AcRequest;
+
+struct AcConn {
+    AcLoop* loop;
+    int fd, state;
+    uint32_t cid;
+    char host[64], store[48];   // 다시 접속할 때 사용 (ac_attach 로 넘겨받은 연결은 host 가 비어 있음)
+    int port;
+    char* out; size_t out_len, out_off, out_cap;
+    char* in; size_t in_len, in_cap;
+    AcRequest *head, *tail;
+    int inflight;
+    AcPushHandler push;
+    void* push_arg;
+};
+
+struct AcLoop {
+    AcConn** conns;
+    int count, cap;
+    struct pollfd* pfds;
+    int* pidx;
+    int pfd_cap;
+    int inflight;
+};
+
+struct AcPool {
+    AcLoop* loop;
+    AcConn** conns;
+    int size;
+};
+
+struct AcFuture {
+    AcLoop* loop;
+    int done;
+    AcResult res;
+    char* msg;
+};
+
+static int64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int reserve(char** buf, size_t* cap, size_t need) {
+    if (need <= *cap) return 0;
+    size_t grown = *cap ? *cap : 4096;
+    while (grown < need) grown *= 2;
+    char* p = realloc(*buf, grown);
+    if (!p) return -1;
+    *buf = p; *cap = grown;
+    return 0;
+}
+
+uint32_t ac_next_request_id(void) {
+    // 실행마다 무작위로 시작: 다시 실행한 단말기의 ID 가 서버에 남은 이전 ID 와 겹치지 않도록
+    static _Atomic uint32_t next = 0;
+    uint32_t cur = atomic_load(&next);
+    if (cur == 0) {
+        uint32_t seed = 0;
+        FILE* ur = fopen("/dev/urandom", "rb");
+        if (!ur || fread(&seed, sizeof(seed), 1, ur) != 1) seed = (uint32_t)rand() ^ (uint32_t)getpid() ^ (uint32_t)time(NULL);
+        if (ur) fclose(ur);
+        atomic_compare_exchange_strong(&next, &cur, seed ? seed : 1);
+    }
+    uint32_t rid;
+    while ((rid = atomic_fetch_add(&next, 1) + 1) == 0) {}
+    return rid;
+}
+
+// ---------------------------------------------------------------------
+// 요청 목록
+// ---------------------------------------------------------------------
+static AcRequest* take_request(AcConn* c, uint32_t rid) {
+    AcRequest *prev = NULL, *r = c->head;
+    while (r && rid && r->rid != rid) { prev = r; r = r->next; }
+    if (!r) return NULL;
+    if (prev) prev->next = r->next; else c->head = r->next;
+    if (c->tail == r) c->tail = prev;
+    c->inflight--;
+    c->loop->inflight--;
+    return r;
+}
+
+static void finish(AcRequest* r, const AcResult* res) {
+    if (r->cb) r->cb(res, r->arg);
+    free(r);
+}
+
+// 연결을 닫고 남은 요청을 모두 AC_CLOSED 로 끝냄 -> 호출한 콜백 수
+static int fail_conn(AcConn* c) {
+    if (c->state == CONN_CLOSED) return 0;
+    if (c->fd >= 0) close(c->fd);
+    c->fd = -1;
+    c->state = CONN_CLOSED;
+    c->out_len = c->out_off = c->in_len = 0;
+    int fired = 0;
+    AcRequest* r;
+    while ((r = take_request(c, 0)) != NULL) {
+        AcResult res = { .status = AC_CLOSED, .msg = "", .rid = r->rid };
+        finish(r, &res);
+        fired++;
+    }
+    return fired;
+}
+
+// ---------------------------------------------------------------------
+// 입출력
+// ---------------------------------------------------------------------
+static int flush_out(AcConn* c) {
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n > 0) { c->out_off += n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        return -1;
+    }
+    c->out_len = c->out_off = 0;
+    return 0;
+}
+
+// 프레임 하나 처리 (body 는 NUL 종료되어 있음) -> 호출한 콜백 수
+static int handle_frame(AcConn* c, int code, uint32_t rid, char* body, size_t len) {
+    if (IS_PUSH(code)) {
+        if (c->push) c->push(code, body, c->push_arg);
+        return 0;
+    }
+    AcRequest* r = take_request(c, rid);
+    if (!r) return 0;       // 이미 시간 초과로 끝낸 요청의 늦은 응답
+
+    // "페이지|메시지" (구분자가 없으면 본문 전체가 메시지)
+    AcResult res = { .status = AC_OK, .code = code, .msg = body, .len = len, .rid = r->rid };
+    char* bar = memchr(body, '|', len);
+    if (bar) {
+        res.page = atoi(body);
+        res.msg = bar + 1;
+        res.len = len - (size_t)(bar + 1 - body);
+    }
+    finish(r, &res);
+    return 1;
+}
+
+static int read_conn(AcConn* c) {
+    int fired = 0, eof = 0;
+    while (1) {
+        if (reserve(&c->in, &c->in_cap, c->in_len + AC_READ_CHUNK + 1) < 0) return fail_conn(c);
+        ssize_t n = recv(c->fd, c->in + c->in_len, AC_READ_CHUNK, 0);
+        if (n > 0) { c->in_len += n; if (n < AC_READ_CHUNK) break; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        eof = 1;            // 서버가 닫기 전에 보낸 응답은 처리한 뒤 닫음
+        break;
+    }
+
+    // 완성된 프레임을 복사 없이 수신 버퍼 위에서 처리: 본문 바로 뒤 바이트를 잠시 NUL 로 바꿔 둠
+    size_t off = 0;
+    while (c->in_len - off >= sizeof(NetHeader)) {
+        NetHeader h;
+        memcpy(&h, c->in + off, sizeof(h));
+        uint32_t len = ntohl(h.length);
+        if (len > AC_MAX_FRAME) return fired + fail_conn(c);
+        if (c->in_len - off < sizeof(h) + len) break;
+        char* body = c->in + off + sizeof(h);
+        char saved = body[len];
+        body[len] = '\0';
+        fired += handle_frame(c, (int)ntohl(h.code), ntohl(h.client_id), body, len);
+        body[len] = saved;
+        off += sizeof(h) + len;
+    }
+    if (off > 0) {
+        memmove(c->in, c->in + off, c->in_len - off);
+        c->in_len -= off;
+    }
+    return eof ? fired + fail_conn(c) : fired;
+}
+
+static int expire_requests(AcLoop* loop, int64_t now) {
+    int fired = 0;
+    for (int i = 0; i < loop->count; i++) {
+        AcConn* c = loop->conns[i];
+        for (AcRequest* r = c->head; r; ) {
+            AcRequest* next = r->next;
+            if (r->deadline && r->deadline <= now) {
+                take_request(c, r->rid);
+                AcResult res = { .status = AC_TIMEOUT, .msg = "", .rid = r->rid };
+                finish(r, &res);
+                fired++;
+            }
+            r = next;
+        }
+    }
+    return fired;
+}
+
+// ---------------------------------------------------------------------
+// 루프
+// ---------------------------------------------------------------------
+AcLoop* ac_loop_new(void) {
+    return calloc(1, sizeof(AcLoop));
+}
+
+void ac_loop_free(AcLoop* loop) {
+    if (!loop) return;
+    while (loop->count > 0) ac_close(loop->conns[loop->count - 1]);
+    free(loop->conns);
+    free(loop->pfds);
+    free(loop->pidx);
+    free(loop);
+}
+
+int ac_inflight(AcLoop* loop) {
+    return loop->inflight;
+}
+
+int ac_run_once(AcLoop* loop, int timeout_ms) {
+    int fired = 0;
+    int64_t now = now_ms();
+
+    // 콜백과 ac_submit 이 쌓아 둔 요청을 먼저 한 번에 내보냄 (파이프라이닝된 요청은 send 한 번으로 나감)
+    for (int i = 0; i < loop->count; i++) {
+        AcConn* c = loop->conns[i];
+        if (c->state == CONN_OPEN && c->out_len > c->out_off && flush_out(c) < 0) fired += fail_conn(c);
+    }
+
+    // 대기 시간 = 요청받은 시간과 가장 가까운 요청 제한 시간 중 짧은 쪽
+    int wait = timeout_ms;
+    if (loop->pfd_cap < loop->count) {
+        struct pollfd* p = realloc(loop->pfds, sizeof(struct pollfd) * loop->count);
+        if (p) loop->pfds = p;
+        int* x = realloc(loop->pidx, sizeof(int) * loop->count);
+        if (x) loop->pidx = x;
+        if (!p || !x) return -1;
+        loop->pfd_cap = loop->count;
+    }
+    int n = 0;
+    for (int i = 0; i < loop->count; i++) {
+        AcConn* c = loop->conns[i];
+        for (AcRequest* r = c->head; r; r = r->next) {
+            if (!r->deadline) continue;
+            int64_t left = r->deadline > now ? r->deadline - now : 0;
+            if (wait < 0 || left < wait) wait = (int)left;
+        }
+        if (c->fd < 0) continue;
+        short ev = POLLIN;
+        if (c->state == CONN_CONNECTING || c->out_len > c->out_off) ev |= POLLOUT;
+        loop->pfds[n] = (struct pollfd){ .fd = c->fd, .events = ev };
+        loop->pidx[n++] = i;
+    }
+    if (n == 0 && wait < 0) return fired;      // 기다릴 것이 없음
+
+    int ready = poll(loop->pfds, n, wait);
+    if (ready < 0 && errno != EINTR) return -1;
+
+    for (int k = 0; ready > 0 && k < n; k++) {
+        short rev = loop->pfds[k].revents;
+        AcConn* c = loop->conns[loop->pidx[k]];
+        if (!rev || c->fd != loop->pfds[k].fd) continue;
+        if (c->state == CONN_CONNECTING) {
+            int err = 0;
+            socklen_t elen = sizeof(err);
+            if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &elen) < 0 || err != 0) { fired += fail_conn(c); continue; }
+            c->state = CONN_OPEN;
+        }
+        if ((rev & POLLOUT) && flush_out(c) < 0) { fired += fail_conn(c); continue; }
+        if (rev & (POLLIN | POLLHUP | POLLERR)) fired += read_conn(c);
+    }
+    return fired + expire_requests(loop, now_ms());
+}
+
+// ---------------------------------------------------------------------
+// 연결
+// ---------------------------------------------------------------------
+static AcConn* new_conn(AcLoop* loop, uint32_t cid) {
+    if (loop->count >= loop->cap) {
+        int cap = loop->cap ? loop->cap * 2 : 8;
+        AcConn** grown = realloc(loop->conns, sizeof(AcConn*) * cap);
+        if (!grown) return NULL;
+        loop->conns = grown; loop->cap = cap;
+    }
+    AcConn* c = calloc(1, sizeof(AcConn));
+    if (!c) return NULL;
+    c->loop = loop;
+    c->fd = -1;
+    c->state = CONN_CLOSED;
+    c->cid = cid;
+    loop->conns[loop->count++] = c;
+    return c;
+}
+
+// 논블로킹 접속 시작 후 접속 인사를 쌓아 둠
+static int open_conn(AcConn* c) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(c->port) };
+    if (inet_pton(AF_INET, c->host, &addr.sin_addr) <= 0) return -1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));  // 요청은 루프가 모아서 보내므로 Nagle 지연이 필요 없음
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) c->state = CONN_OPEN;
+    else if (errno == EINPROGRESS) c->state = CONN_CONNECTING;
+    else { close(fd); return -1; }
+    c->fd = fd;
+    return ac_submit_rid(c, 99, 0, c->store, AC_NO_TIMEOUT, NULL, NULL) ? 0 : -1;
+}
+
+AcConn* ac_connect(AcLoop* loop, const char* host, int port, uint32_t cid, const char* store_id) {
+    AcConn* c = new_conn(loop, cid);
+    if (!c) return NULL;
+    snprintf(c->host, sizeof(c->host), "%s", host);
+    snprintf(c->store, sizeof(c->store), "%s", store_id ? store_id : "");
+    c->port = port;
+    if (open_conn(c) < 0) fail_conn(c);
+    return c;
+}
+
+AcConn* ac_attach(AcLoop* loop, int sock, uint32_t cid) {
+    AcConn* c = new_conn(loop, cid);
+    if (!c) return NULL;
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    c->fd = sock;
+    c->state = CONN_OPEN;
+    return c;
+}
+
+void ac_close(AcConn* c) {
+    if (!c) return;
+    fail_conn(c);
+    AcLoop* loop = c->loop;
+    for (int i = 0; i < loop->count; i++) {
+        if (loop->conns[i] != c) continue;
+        memmove(&loop->conns[i], &loop->conns[i + 1], sizeof(AcConn*) * (loop->count - i - 1));
+        loop->count--;
+        break;
+    }
+    free(c->out);
+    free(c->in);
+    free(c);
+}
+
+int ac_is_open(const AcConn* c) {
+    return c && c->state != CONN_CLOSED;
+}
+
+int ac_conn_inflight(const AcConn* c) {
+    return c ? c->inflight : 0;
+}
+
+void ac_set_cid(AcConn* c, uint32_t cid) {
+    c->cid = cid;
+}
+
+void ac_on_push(AcConn* c, AcPushHandler handler, void* arg) {
+    c->push = handler;
+    c->push_arg = arg;
+}
+
+uint32_t ac_submit_rid(AcConn* c, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms, AcCallback cb, void* arg) {
+    if (!ac_is_open(c)) return 0;
+    if (rid == 0) rid = ac_next_request_id();
+    uint32_t len = payload ? (uint32_t)strlen(payload) : 0;
+    if (len > MAX_PAYLOAD) len = MAX_PAYLOAD;
+    AcRequest* r = malloc(sizeof(AcRequest));
+    size_t frame = sizeof(NetHeader) + sizeof(uint32_t) + len;
+    if (!r || reserve(&c->out, &c->out_cap, c->out_len + frame) < 0) { free(r); return 0; }
+
+    // 헤더 + 요청 ID + payload 를 출력 버퍼에 이어 붙임 (실제 전송은 ac_run_once)
+    NetHeader h = { htonl(c->cid), htonl(cmd | REQ_ID_FLAG), htonl(sizeof(uint32_t) + len) };
+    uint32_t net_rid = htonl(rid);
+    char* p = c->out + c->out_len;
+    memcpy(p, &h, sizeof(h));
+    memcpy(p + sizeof(h), &net_rid, sizeof(net_rid));
+    if (len > 0) memcpy(p + sizeof(h) + sizeof(net_rid), payload, len);
+    c->out_len += frame;
+
+    *r = (AcRequest){ .rid = rid, .deadline = timeout_ms > 0 ? now_ms() + timeout_ms : 0, .cb = cb, .arg = arg };
+    if (c->tail) c->tail->next = r; else c->head = r;
+    c->tail = r;
+    c->inflight++;
+    c->loop->inflight++;
+    return rid;
+}
+
+uint32_t ac_submit(AcConn* c, uint32_t cmd, const char* payload, int timeout_ms, AcCallback cb, void* arg) {
+    return ac_submit_rid(c, cmd, 0, payload, timeout_ms, cb, arg);
+}
+
+// ---------------------------------------------------------------------
+// 퓨처 / 블로킹 호출
+// ---------------------------------------------------------------------
+static void future_cb(const AcResult* res, void* arg) {
+    AcFuture* f = arg;
+    f->res = *res;
+    f->msg = malloc(res->len + 1);
+    if (f->msg) {
+        memcpy(f->msg, res->msg, res->len);
+        f->msg[res->len] = '\0';
+    } else f->res.len = 0;
+    f->res.msg = f->msg ? f->msg : "";
+    f->done = 1;
+}
+
+AcFuture* ac_submit_future(AcConn* c, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms) {
+    AcFuture* f = calloc(1, sizeof(AcFuture));
+    if (!f) return NULL;
+    f->loop = c->loop;
+    if (!ac_submit_rid(c, cmd, rid, payload, timeout_ms, future_cb, f)) {
+        f->res = (AcResult){ .status = AC_CLOSED, .msg = "" };
+        f->done = 1;
+    }
+    return f;
+}
+
+int ac_future_done(const AcFuture* f) {
+    return f->done;
+}
+
+const AcResult* ac_future_wait(AcFuture* f) {
+    while (!f->done) ac_run_once(f->loop, -1);
+    return &f->res;
+}
+
+void ac_future_free(AcFuture* f) {
+    if (!f) return;
+    free(f->msg);
+    free(f);
+}
+
+typedef struct {
+    int done, status, code, page;
+    char* out;
+    size_t size;
+} CallSlot;
+
+// 응답을 호출자의 버퍼로 바로 한 번만 복사
+static void call_cb(const AcResult* res, void* arg) {
+    CallSlot* s = arg;
+    s->status = res->status;
+    s->code = res->code;
+    s->page = res->page;
+    if (s->out && s->size > 0) {
+        size_t n = res->len < s->size - 1 ? res->len : s->size - 1;
+        memcpy(s->out, res->msg, n);
+        s->out[n] = '\0';
+    }
+    s->done = 1;
+}
+
+int ac_call(AcConn* c, uint32_t cmd, uint32_t rid, const char* payload, int timeout_ms, char* out, size_t size, int* out_page) {
+    CallSlot s = { .out = out, .size = size };
+    if (!ac_submit_rid(c, cmd, rid, payload, timeout_ms, call_cb, &s)) return -1;
+    while (!s.done) ac_run_once(c->loop, -1);
+    if (s.status != AC_OK) return -1;
+    if (out_page) *out_page = s.page;
+    return s.code;
+}
+
+// ---------------------------------------------------------------------
+// 연결 풀
+// ---------------------------------------------------------------------
+AcPool* ac_pool_new(AcLoop* loop, const char* host, int port, uint32_t cid, const char* store_id, int size) {
+    AcPool* pool = calloc(1, sizeof(AcPool));
+    if (!pool || !(pool->conns = calloc(size, sizeof(AcConn*)))) { free(pool); return NULL; }
+    pool->loop = loop;
+    for (int i = 0; i < size; i++) {
+        if (!(pool->conns[i] = ac_connect(loop, host, port, cid, store_id))) break;
+        pool->size++;
+    }
+    return pool;
+}
+
+uint32_t ac_pool_submit(AcPool* pool, uint32_t cmd, const char* payload, int timeout_ms, AcCallback cb, void* arg) {
+    AcConn* best = NULL;
+    int reopened = 0;
+    for (int i = 0; i < pool->size; i++) {
+        AcConn* c = pool->conns[i];
+        // 끊긴 연결은 요청 하나당 하나씩만 다시 접속 (서버가 내려가 있을 때 접속 폭주 방지)
+        if (!ac_is_open(c) && !reopened) {
+            reopened = 1;
+            c->in_len = c->out_len = c->out_off = 0;
+            if (open_conn(c) < 0) fail_conn(c);
+        }
+        if (ac_is_open(c) && (!best || c->inflight < best->inflight)) best = c;
+    }
+    return best ? ac_submit(best, cmd, payload, timeout_ms, cb, arg) : 0;
+}
+
+void ac_pool_free(AcPool* pool) {
+    if (!pool) return;
+    for (int i = 0; i < pool->size; i++) ac_close(pool->conns[i]);
+    free(pool->conns);
+    free(pool);
+}
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#include "network.h"
+#include "utils.h"
+
+#define MAX_MENU 100
+#define MAX_ALERTS 3
+
+// =====================================================================
+// [데이터 구조: Client-Side Menu Cache]
+// 마지막으로 받은 스냅샷의 버전(cached_version)과 푸시로 알게 된 최신 버전(latest_version)을
+// 비교해, 서버 재고가 바뀐 경우에만 cmd 20 으로 다시 받아옵니다.
+// =====================================================================
+typedef struct {
+    char name[50];
+    int count;
+    int held;           // 단말기들의 장바구니에 예약된 수량
+} MenuEntry;
+
+static MenuEntry menu[MAX_MENU];
+static int menu_count = 0;
+static int valid = 0;
+static int loaded = 0;          // 스냅샷을 한 번이라도 받음 (재연결로 무효화되어도 오프라인 판매 기준으로 씀)
+static int push_on = 0;
+static uint64_t cached_version = 0;
+static uint64_t latest_version = 0;
+
+// 서버가 푸시한 재고 알림 (최근 MAX_ALERTS 건만 메뉴판 아래에 표시)
+static char alerts[MAX_ALERTS][128];
+static int alert_count = 0;
+
+void cache_reset(int push_enabled) {
+    valid = 0;
+    push_on = push_enabled;
+    cached_version = latest_version = 0;
+}
+
+void cache_note_version(uint64_t version) {
+    if (version > latest_version) latest_version = version;
+}
+
+void cache_note_alert(const char* text) {
+    if (alert_count == MAX_ALERTS) {
+        memmove(alerts[0], alerts[1], sizeof(alerts[0]) * (MAX_ALERTS - 1));
+        alert_count--;
+    }
+    snprintf(alerts[alert_count++], sizeof(alerts[0]), "%s", text);
+}
+
+void cache_invalidate(void) {
+    valid = 0;
+}
+
+int cache_refresh(int sock, uint32_t cid) {
+    // 구독 중이고 그 사이 알림이 없었다면 서버에 묻지 않음
+    if (drain_pushes(sock) < 0) return -1;
+    if (valid && push_on && latest_version <= cached_version) return 0;
+
+    char res_msg[MAX_PAYLOAD];
+    if (send_and_receive(sock, cid, CMD_MENU_SNAPSHOT, "", res_msg, NULL) < 0) return -1;
+
+    // [파싱] 첫 줄은 버전, 이후 "상품명\t판매 가능\t예약" 줄
+    char *saveptr;
+    char *line = strtok_r(res_msg, "\n", &saveptr);
+    if (!line) return 0;
+    cached_version = strtoull(line, NULL, 10);
+    if (cached_version > latest_version) latest_version = cached_version;
+
+    menu_count = 0;
+    while ((line = strtok_r(NULL, "\n", &saveptr)) != NULL && menu_count < MAX_MENU) {
+        char* tab = strchr(line, '\t');
+        if (!tab) continue;
+        *tab = '\0';
+        snprintf(menu[menu_count].name, sizeof(menu[menu_count].name), "%.49s", line);
+        menu[menu_count].count = atoi(tab + 1);
+        char* held = strchr(tab + 1, '\t');
+        menu[menu_count].held = held ? atoi(held + 1) : 0;
+        menu_count++;
+    }
+    valid = loaded = 1;
+    return 0;
+}
+
+void cache_render_menu(char* out, size_t size) {
+    size_t len = snprintf(out, size, "\n=== 판매 가능 메뉴판 ===\n");
+    if (menu_count == 0 && len < size) snprintf(out + len, size - len, "상품이 없습니다.\n");
+    for (int i = 0; i < menu_count && len < size; i++) {
+        len += snprintf(out + len, size - len, " - %-15.40s : %d개", menu[i].name, menu[i].count);
+        if (menu[i].held > 0 && len < size) len += snprintf(out + len, size - len, " (예약 %d개)", menu[i].held);
+        if (len < size) len += snprintf(out + len, size - len, "\n");
+    }
+    for (int i = 0; i < alert_count && len < size; i++)
+        len += snprintf(out + len, size - len, " [알림] %s\n", alerts[i]);
+}
+
+int cache_available(const char* name) {
+    for (int i = 0; i < menu_count; i++)
+        if (strcmp(menu[i].name, name) == 0) return menu[i].count;
+    return 0;
+}
+
+int cache_ready(void) {
+    return loaded;
+}
+
+void cache_take(const char* name, int qty) {
+    for (int i = 0; i < menu_count; i++)
+        if (strcmp(menu[i].name, name) == 0) { menu[i].count -= qty; return; }
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <signal.h>
@@ -8,6 +9,8 @@
 #include "ui.h"
 #include "pos.h"
 #include "utils.h"
+#include "cache.h"
+#include "offline.h"
 
 // =====================================================================
 // [스마트 편의점 POS 클라이언트 메인]
@@ -15,7 +18,7 @@
 // 서버가 갑자기 종료되더라도 튕기지 않고 스스로 재연결하는 기능이 핵심입니다.
 // =====================================================================
 
-int main(void) {
+int main(int argc, char* argv[]) {
     // 1. [안전 장치] 서버가 죽은 상태에서 데이터를 보내면 OS가 클라이언트를 
     // 강제 종료(SIGPIPE)시켜버리므로, 이 시그널을 무시하도록 설정합니다.
     signal(SIGPIPE, SIG_IGN); 
@@ -27,9 +30,20 @@ int main(void) {
     // 장바구니 데이터 등 로컬 시스템 초기화
     init_pos_system(); // POS 시스템 초기화 (장바구니, 세팅 등)
 
+    // 접속할 매장 파티션 ID (인자로 지정하지 않으면 서버의 기본 매장)
+    const char* store_id = (argc > 1) ? argv[1] : "";
+
+    // 오프라인 판매 저널 (지난 실행에서 보내지 못한 판매가 있으면 접속 후 전송)
+    if (offline_open(store_id) < 0) printf("[경고] 오프라인 판매 저널을 열 수 없어 오프라인 판매를 쓸 수 없습니다.\n");
+
     // 소켓 초기 상태는 연결되지 않음(-1)으로 설정
     int sock = -1;
-    char trash[1024]; // 응답을 버릴 때 사용하는 임시 버퍼
+    char trash[MAX_PAYLOAD]; // 응답을 버릴 때 사용하는 임시 버퍼
+
+    // 재연결 상태: 대기 시간(1, 2, 4, ... RECONNECT_MAX_SEC 초), 세션 토큰, 끊기기 전에 있던 모드
+    int backoff = 1, first_connect = 1, resume_mode = 0;
+    char session_token[64] = "";
+    int offline_used = 0;   // 이번 단절 동안 오프라인 판매 화면을 썼는지
 
     // 3. [메인 프로그램 루프] 사용자가 시스템 종료(0)를 누를 때까지 무한 반복
     while (1) {
@@ -48,9 +62,13 @@ int main(void) {
             while ((sock = connect_to_server(SERVER_IP, PORT)) < 0) {
                 int exit_flag = 0;
                 
-                // 대기 중 로그 도배를 막기 위해 3초 동안 제자리 카운트다운(새로고침)
-                for (int i = 3; i > 0; i--) {
-                    printf("\r\033[K[네트워크] 서버 응답 없음. 재연결 대기 중... %d초 (종료: q + Enter)", i);
+                // 대기 중 로그 도배를 막기 위해 제자리 카운트다운(새로고침).
+                // 실패할 때마다 대기 시간을 두 배로 늘리고(상한 RECONNECT_MAX_SEC), 여러 단말기가 한꺼번에
+                // 몰리지 않도록 0~1초를 무작위로 더함
+                int wait_sec = backoff + rand() % 2;
+                backoff = (backoff * 2 > RECONNECT_MAX_SEC) ? RECONNECT_MAX_SEC : backoff * 2;
+                for (int i = wait_sec; i > 0; i--) {
+                    printf("\r\033[K[네트워크] 서버 응답 없음. 재연결 대기 중... %d초 (오프라인 판매: o + Enter, 종료: q + Enter)", i);
                     fflush(stdout);
                     
                     // 입력 감시 설정 (1초 동안 사용자가 키보드를 치는지 감시)
@@ -68,6 +86,14 @@ int main(void) {
                             exit_flag = 1; // 종료 플래그 활성화
                             break;
                         }
+                        if (c == 'o' || c == 'O') {
+                            // 서버가 돌아올 때까지 계산대를 멈추지 않고 로컬 저널에 판매 기록. 나오면 바로 재연결 시도
+                            offline_used = 1;
+                            run_offline_mode(cid);
+                            clear_screen();
+                            printf("서버 연결 대기 중...\n");
+                            break;
+                        }
                     }
                 }
                 
@@ -80,11 +106,83 @@ int main(void) {
             }
             
             // 연결 성공 시 안내 메시지 출력 및 서버에 최초 접속 인사(cmd 99) 전송
+            // (재연결이면 확인 대기 없이 바로 이전 작업으로 돌아감)
             printf("\r\033[K\n[System] 서버 연결 성공!\n");
-            pause_screen(-1); // 메시지 확인 대기
+            if (first_connect) pause_screen(-1); // 메시지 확인 대기
+            first_connect = 0;
+            backoff = 1;
+
+            if (send_and_receive(sock, cid, 99, store_id, trash, NULL) < 0) {
+                disconnect_from_server(sock);
+                sock = -1;
+                continue;
+            }
+
+            // 서버가 매장 ID를 거절한 경우 재시도해도 소용없으므로 종료
+            if (strncmp(trash, "[오류]", strlen("[오류]")) == 0) {
+                print_system_message(trash);
+                disconnect_from_server(sock);
+                exit(1);
+            }
+
+            // 재고 버전 변경 알림 구독 (구독하지 못하면 메뉴 캐시는 매번 서버에 조회)
+            send_and_receive(sock, cid, CMD_SUBSCRIBE, "", trash, NULL);
+            cache_reset(strncmp(trash, "[오류]", strlen("[오류]")) != 0);
+
+            // 모든 분류의 재고 부족/만료/품절 알림 구독
+            char watch[32];
+            snprintf(watch, sizeof(watch), "*|%d|%d", WATCH_ALL, LOW_STOCK_THRESHOLD);
+            send_and_receive(sock, cid, CMD_WATCH, watch, trash, NULL);
+
+            // 세션부터 이어받음: 예약은 세션 주인에 묶여 있어 아래 판매 재전송/예약 해제가 끊기기 전 예약에 닿으려면 먼저
+            int bound = bind_session(sock, cid, session_token, sizeof(session_token));
+            if (bound < 0) {
+                disconnect_from_server(sock);
+                sock = -1;
+                continue;
+            }
 
-            send_request(sock, cid, 99, ""); 
-            receive_response(sock, trash, NULL); 
+            // 결제 도중 끊긴 줄부터 확정 (끊기기 전 예약이 남아 있을 때 보내야 예약분으로 팔림)
+            if (retry_in_doubt_sale(sock, cid) < 0) {
+                disconnect_from_server(sock);
+                sock = -1;
+                continue;
+            }
+
+            // 오프라인으로 판매했다면 끊기기 전 예약 중 일부는 이미 팔린 품목이므로 먼저 풀어 두고,
+            // 아래에서 새 세션으로 남은 장바구니만 다시 예약 (예약이 밀린 판매를 막지 않도록 전송보다 먼저)
+            if (offline_used) {
+                if (send_and_receive(sock, cid, CMD_CART_RELEASE, "", trash, NULL) < 0) {
+                    disconnect_from_server(sock);
+                    sock = -1;
+                    continue;
+                }
+                session_token[0] = '\0';
+                offline_used = 0;
+            }
+
+            // 밀린 오프라인 판매 전송. 서버가 채우지 못한 줄이 있으면 충돌 보고를 보여 줌
+            if (offline_pending() > 0) {
+                char report[MAX_PAYLOAD];
+                int conflicts = offline_sync(sock, cid, report, sizeof(report));
+                if (conflicts < 0) {
+                    disconnect_from_server(sock);
+                    sock = -1;
+                    continue;
+                }
+                if (conflicts > 0) {
+                    printf("\n[오프라인] 서버 재고가 모자라 반영하지 못한 판매 줄 %d개 (기록: %s)\n%s", conflicts, OFFLINE_REPORT, report);
+                    pause_screen(-1);
+                }
+                cache_invalidate();
+            }
+
+            // 세션 시작/이어받기: 끊기기 전 장바구니 예약을 그대로 이어받음
+            if (resume_session(sock, cid, session_token, sizeof(session_token), bound) < 0) {
+                disconnect_from_server(sock);
+                sock = -1;
+                continue;
+            }
         }
 
         // -------------------------------------------------------------
@@ -92,14 +190,21 @@ int main(void) {
         // 사용자가 선택할 수 있는 주요 메뉴를 출력하고, 입력을 받습니다.
         // 서버와의 연결이 끊어진 경우 재연결을 시도합니다.
         // -------------------------------------------------------------
-        draw_main_mode_selection();  // 메인 모드 선택 화면 그리기
-        
         int choice;
-        // 사용자 입력 대기. (get_int_input 내부에서 서버 끊김을 감시함)
-        // 리턴값이 0보다 작으면 입력 대기 중 서버가 죽은 것이므로 재연결 블록으로 점프!
-        if (get_int_input(sock, "모드 선택 >> ", &choice) < 0) {
-            sock = -1;  // 서버와의 연결이 끊어졌으므로 소켓 초기화
-            continue;   // 재연결 시도
+        if (resume_mode) {
+            // 판매 도중 끊겼다면 메인 메뉴를 거치지 않고 이어받은 장바구니와 함께 판매 모드로 복귀
+            choice = resume_mode;
+            resume_mode = 0;
+        } else {
+            draw_main_mode_selection();  // 메인 모드 선택 화면 그리기
+
+            // 사용자 입력 대기. (get_int_input 내부에서 서버 끊김을 감시함)
+            // 리턴값이 0보다 작으면 입력 대기 중 서버가 죽은 것이므로 재연결 블록으로 점프!
+            if (get_int_input(sock, "모드 선택 >> ", &choice) < 0) {
+                disconnect_from_server(sock);
+                sock = -1;  // 서버와의 연결이 끊어졌으므로 소켓 초기화
+                continue;   // 재연결 시도
+            }
         }
 
         // 0 입력 시 메인 루프 탈출 -> 프로그램 정상 종료
@@ -129,6 +234,7 @@ int main(void) {
             print_system_message("\n[경고] 서버와의 연결이 끊어졌습니다. (즉시 재연결 시도)");
             disconnect_from_server(sock); // 기존 찌꺼기 소켓 정리
             sock = -1; // 소켓 상태를 초기화하여 다음 루프에서 재연결 유도
+            resume_mode = (choice == 1) ? 1 : 0;
             sleep(1);  // 경고 메시지를 사용자가 짧게 인지할 수 있도록 1초 대기
         }
     }
@@ -136,8 +242,7 @@ int main(void) {
     // 4. [정상 종료 처리] 사용자가 0을 눌러 정상적으로 끝내는 경우
     if (sock >= 0) {
         // 서버에 정상 접속 종료(cmd 100)를 알림
-        send_request(sock, cid, 100, ""); 
-        receive_response(sock, trash, NULL);
+        send_and_receive(sock, cid, 100, "", trash, NULL);
         disconnect_from_server(sock);
     }
 
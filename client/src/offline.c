@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "offline.h"
+#include "network.h"
+
+// =====================================================================
+// [오프라인 판매 저널]
+// 파일은 한 줄짜리 레코드를 이어 붙이기만 합니다.
+//   "T\t태그"                 단말기 태그 (판매번호와 함께 서버 쪽 중복 판별 키, 파일마다 한 번)
+//   "S\t번호\t상품명\t수량"    판매 줄 (결제 한 건이 여러 줄)
+//   "E\t번호"                 결제 한 건의 끝 - E 가 없는 S 줄은 기록 도중 끊긴 것으로 보고 버림
+//   "A\t번호"                 서버가 이 번호까지 반영했음
+// 결제 한 건은 write 한 번 + fdatasync 한 번이라 서버 왕복 없이 로컬 디스크 지연만으로 끝납니다.
+// 열 때와 밀린 판매를 모두 보낸 뒤에는 남은 판매만으로 파일을 다시 써서 크기를 줄입니다.
+// =====================================================================
+
+typedef struct {
+    uint64_t seq;
+    char name[50];
+    int qty;
+} SaleLine;
+
+static char journal_path[128];
+static char tag[17];
+static int journal_fd = -1;
+static uint64_t next_seq = 1, acked = 0;
+
+// 서버에 반영되지 않은 판매 줄 (번호 오름차순)
+static SaleLine* lines = NULL;
+static int line_count = 0, line_cap = 0;
+
+static int push_line(uint64_t seq, const char* name, int qty) {
+    if (line_count >= line_cap) {
+        int cap = line_cap ? line_cap * 2 : 64;
+        SaleLine* grown = realloc(lines, sizeof(SaleLine) * cap);
+        if (!grown) return -1;
+        lines = grown; line_cap = cap;
+    }
+    SaleLine* l = &lines[line_count++];
+    l->seq = seq;
+    snprintf(l->name, sizeof(l->name), "%.49s", name);
+    l->qty = qty;
+    return 0;
+}
+
+static int write_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n <= 0) return -1;
+        buf += n; len -= n;
+    }
+    return 0;
+}
+
+// 판매 줄 i 부터 같은 번호인 줄들을 "S..." + "E..." 로 out 에 씀 -> 다음 판매의 시작 위치
+static int format_sale(int i, char* out, size_t size, size_t* len) {
+    uint64_t seq = lines[i].seq;
+    for (; i < line_count && lines[i].seq == seq && *len < size; i++)
+        *len += snprintf(out + *len, size - *len, "S\t%llu\t%s\t%d\n", (unsigned long long)seq, lines[i].name, lines[i].qty);
+    if (*len < size) *len += snprintf(out + *len, size - *len, "E\t%llu\n", (unsigned long long)seq);
+    return i;
+}
+
+// 태그, 반영 위치, 남은 판매만으로 저널을 다시 쓰고 이어 쓰기용으로 다시 엶
+static int rewrite_journal(void) {
+    char tmp[140], buf[MAX_PAYLOAD];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", journal_path);
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    // 남은 판매가 없으면 반영 위치가 곧 마지막 번호이므로 A 한 줄로 번호가 이어짐
+    size_t len = snprintf(buf, sizeof(buf), "T\t%s\nA\t%llu\n", tag, (unsigned long long)acked);
+    int ok = write_all(fd, buf, len) == 0;
+    for (int i = 0; ok && i < line_count; ) {
+        len = 0;
+        i = format_sale(i, buf, sizeof(buf), &len);
+        ok = write_all(fd, buf, len) == 0;
+    }
+    ok = ok && fdatasync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp, journal_path) != 0) { unlink(tmp); return -1; }
+
+    if (journal_fd >= 0) close(journal_fd);
+    journal_fd = open(journal_path, O_WRONLY | O_APPEND);
+    return journal_fd < 0 ? -1 : 0;
+}
+
+int offline_open(const char* store_id) {
+    if (store_id && store_id[0]) snprintf(journal_path, sizeof(journal_path), "pos_offline_%.40s.journal", store_id);
+    else snprintf(journal_path, sizeof(journal_path), "%s", OFFLINE_JOURNAL);
+
+    FILE* fp = fopen(journal_path, "r");
+    if (fp) {
+        char buf[256], name[50];
+        int committed = 0, qty;
+        unsigned long long seq;
+        while (fgets(buf, sizeof(buf), fp)) {
+            if (!strchr(buf, '\n')) break;      // 마지막 줄이 잘림
+            if (sscanf(buf, "T\t%16s", tag) == 1) continue;
+            if (sscanf(buf, "S\t%llu\t%49[^\t]\t%d", &seq, name, &qty) == 3) {
+                if (line_count > committed && lines[line_count - 1].seq != seq) line_count = committed;
+                if (push_line(seq, name, qty) < 0) break;
+            } else if (sscanf(buf, "E\t%llu", &seq) == 1) {
+                committed = line_count;
+                if (seq >= next_seq) next_seq = seq + 1;
+            } else if (sscanf(buf, "A\t%llu", &seq) == 1) {
+                if (seq > acked) acked = seq;
+                if (seq >= next_seq) next_seq = seq + 1;
+            }
+        }
+        line_count = committed;
+        fclose(fp);
+    }
+
+    // 이미 반영된 판매는 버림
+    int kept = 0;
+    for (int i = 0; i < line_count; i++) if (lines[i].seq > acked) lines[kept++] = lines[i];
+    line_count = kept;
+
+    // 태그가 없으면 새로 만듦: /dev/urandom 8바이트 (읽지 못하면 시각과 rand 로 대체)
+    if (tag[0] == '\0') {
+        unsigned long long r = 0;
+        FILE* ur = fopen("/dev/urandom", "rb");
+        if (!ur || fread(&r, sizeof(r), 1, ur) != 1) r = ((unsigned long long)rand() << 32) ^ (unsigned long long)time(NULL) ^ rand();
+        if (ur) fclose(ur);
+        snprintf(tag, sizeof(tag), "%016llx", r);
+    }
+    return rewrite_journal();
+}
+
+int offline_record_sale(const CartItem* items, int n) {
+    if (journal_fd < 0 || n <= 0) return -1;
+    char buf[MAX_PAYLOAD];
+    size_t len = 0;
+    uint64_t seq = next_seq;
+    for (int i = 0; i < n && len < sizeof(buf); i++)
+        len += snprintf(buf + len, sizeof(buf) - len, "S\t%llu\t%s\t%d\n", (unsigned long long)seq, items[i].name, items[i].qty);
+    if (len < sizeof(buf)) len += snprintf(buf + len, sizeof(buf) - len, "E\t%llu\n", (unsigned long long)seq);
+    if (len >= sizeof(buf) || write_all(journal_fd, buf, len) < 0 || fdatasync(journal_fd) < 0) return -1;
+
+    int before = line_count;
+    for (int i = 0; i < n; i++) {
+        if (push_line(seq, items[i].name, items[i].qty) < 0) { line_count = before; return -1; }
+    }
+    next_seq++;
+    return 0;
+}
+
+int offline_pending(void) {
+    int sales = 0;
+    for (int i = 0; i < line_count; i++) if (i == 0 || lines[i].seq != lines[i - 1].seq) sales++;
+    return sales;
+}
+
+// "번호\t상품명\t요청\t판매" 충돌 줄을 화면용 report 와 OFFLINE_REPORT 파일에 남김
+static void note_conflict(char* line, char* report, size_t size, FILE* fp) {
+    unsigned long long seq; char name[50]; int want, sold;
+    if (sscanf(line, "%llu\t%49[^\t]\t%d\t%d", &seq, name, &want, &sold) != 4) return;
+    char text[160];
+    snprintf(text, sizeof(text), "오프라인 판매 #%llu %s: 요청 %d개 중 %d개만 반영 (부족 %d개)", seq, name, want, sold, want - sold);
+    size_t len = strlen(report);
+    if (len < size) snprintf(report + len, size - len, " - %s\n", text);
+    if (fp) {
+        char ts[32]; time_t now = time(NULL);
+        strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        fprintf(fp, "[%s] [%s] %s\n", ts, tag, text);
+    }
+}
+
+int offline_sync(int sock, uint32_t cid, char* report, size_t size) {
+    char payload[MAX_PAYLOAD], res_msg[MAX_PAYLOAD], ack[32];
+    int conflicts = 0, sent = 0;
+    report[0] = '\0';
+
+    while (line_count > 0) {
+        // 판매 단위로 배치 구성 (첫 판매는 크기와 관계없이 담음)
+        size_t len = snprintf(payload, sizeof(payload), "%s\n", tag);
+        for (int i = 0; i < line_count; ) {
+            size_t sale_len = 0;
+            int j = i;
+            for (; j < line_count && lines[j].seq == lines[i].seq; j++)
+                sale_len += snprintf(NULL, 0, "%llu\t%s\t%d\n", (unsigned long long)lines[j].seq, lines[j].name, lines[j].qty);
+            if (i > 0 && len + sale_len > OFFLINE_BATCH_BYTES) break;
+            for (; i < j && len < sizeof(payload); i++)
+                len += snprintf(payload + len, sizeof(payload) - len, "%llu\t%s\t%d\n", (unsigned long long)lines[i].seq, lines[i].name, lines[i].qty);
+        }
+
+        int nconf = 0;
+        if (send_and_receive(sock, cid, CMD_OFFLINE_SYNC, payload, res_msg, &nconf) < 0) return -1;
+
+        // 첫 줄 = 서버가 반영을 마친 번호. 숫자가 아니거나(혼잡/오류) 앞으로 나가지 않았으면 다음 접속 때 다시 보냄
+        char* end;
+        uint64_t done = strtoull(res_msg, &end, 10);
+        if (end == res_msg || *end != '\n' || done < lines[0].seq) break;
+
+        len = snprintf(ack, sizeof(ack), "A\t%llu\n", (unsigned long long)done);
+        if (write_all(journal_fd, ack, len) < 0 || fdatasync(journal_fd) < 0) break;
+        acked = done;
+        int kept = 0;
+        for (int i = 0; i < line_count; i++) if (lines[i].seq > done) lines[kept++] = lines[i];
+        line_count = kept;
+        sent++;
+
+        if (nconf > 0) {
+            FILE* fp = fopen(OFFLINE_REPORT, "a");
+            char *saveptr, *line;
+            for (line = strtok_r(end + 1, "\n", &saveptr); line; line = strtok_r(NULL, "\n", &saveptr)) {
+                note_conflict(line, report, size, fp);
+                conflicts++;
+            }
+            if (fp) fclose(fp);
+        }
+    }
+    if (sent > 0 && line_count == 0) rewrite_journal();
+    return conflicts;
+}
@@ -1,12 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "pos.h"
 #include "ui.h"
 #include "network.h"
 #include "utils.h"
+#include "cache.h"
+#include "offline.h"
 
 #define MAX_CART 100
+#define BULK_POLL_MS 300    // 일괄 삭제 작업 진행 상황 조회 간격
+#define BUSY_RETRIES 4      // 혼잡(503) 응답을 받은 판매 줄을 다시 보내는 횟수
+#define BUSY_BACKOFF_MS 250 // 첫 재시도 간격 (회마다 두 배)
 
 // =====================================================================
 // [데이터 구조: Client-Side Inventory State]
@@ -31,21 +37,109 @@ void show_cart(void) {
     }
 }
 
-void clear_cart(void) {
+// 장바구니를 비우면서 서버에 잡아 둔 예약도 함께 해제
+static int clear_cart(int sock, uint32_t cid) {
+    char res_msg[MAX_PAYLOAD];
+    if (cart_count > 0 && send_and_receive(sock, cid, CMD_CART_RELEASE, "", res_msg, NULL) < 0) return -1;
     cart_count = 0;
+    cache_invalidate();
     print_system_message("[안내] 장바구니가 비워졌습니다.");
+    return 0;
+}
+
+int cart_size(void) {
+    return cart_count;
+}
+
+// CMD_SESSION 전송: 혼잡(503)이면 간격을 늘려 가며 다시 보내고, 끝내 거절되면 재접속으로 넘김
+// 성공 시 token 을 서버가 준 토큰으로 갱신하고 res_msg 에는 예약 목록 줄만 남김. 반환: 이어받음 1, 새 세션 0, 실패 -1
+static int send_session(int sock, uint32_t cid, char* token, size_t size, char* res_msg) {
+    int code, resumed = 0, delay = BUSY_BACKOFF_MS;
+    for (int t = 0; (code = send_and_receive(sock, cid, CMD_SESSION, token, res_msg, &resumed)) == RESP_BUSY && t < BUSY_RETRIES; t++) {
+        usleep(delay * 1000);
+        delay *= 2;
+    }
+    if (code < 0 || code == RESP_BUSY) return -1;
+    char* nl = strchr(res_msg, '\n');
+    if (!nl) return -1;
+    *nl = '\0';
+    snprintf(token, size, "%s", res_msg);
+    memmove(res_msg, nl + 1, strlen(nl + 1) + 1);
+    return resumed != 0;
+}
+
+int bind_session(int sock, uint32_t cid, char* token, size_t size) {
+    char res_msg[MAX_PAYLOAD];
+    return send_session(sock, cid, token, size, res_msg);
 }
 
 /**
- * @brief 서버 재고 확인 및 로컬 장바구니 업데이트
+ * @brief 재접속 직후 세션 이어받기 (CMD_SESSION)
+ * [이어받음] 서버가 돌려준 예약 수량이 곧 장바구니이므로 품목마다 다시 예약하지 않고 그대로 맞춤
+ *           (결제 도중 끊겼다면 이미 판매된 품목은 예약 목록에 없으므로 장바구니에서도 빠짐)
+ * [새 세션] 토큰이 없거나 만료되어 서버가 예약을 풀었으면, 남은 장바구니 품목을 하나씩 다시 예약(cmd 17)
+ * * @param token 이전 토큰 (처음이면 ""), 성공 시 새 토큰으로 갱신
+ * * @param was_resumed 앞서 bind_session 이 끊기기 전 세션을 이어받았는지 (아니면 지금 세션에는 예약이 없음)
+ * @return int 성공 시 0, 통신 단절/거절 시 -1
+ */
+int resume_session(int sock, uint32_t cid, char* token, size_t size, int was_resumed) {
+    char res_msg[MAX_PAYLOAD], payload[128];
+    int resumed = send_session(sock, cid, token, size, res_msg);
+    if (resumed < 0) return -1;
+
+    if (resumed && was_resumed) {
+        // "상품명\t수량" 줄로 장바구니를 다시 구성
+        int n = 0;
+        CartItem held[MAX_CART];
+        char *saveptr, *line = strtok_r(res_msg, "\n", &saveptr);
+        for (; line != NULL && n < MAX_CART; line = strtok_r(NULL, "\n", &saveptr)) {
+            char* tab = strchr(line, '\t');
+            if (!tab) continue;
+            *tab = '\0';
+            snprintf(held[n].name, sizeof(held[n].name), "%.49s", line);
+            held[n].qty = atoi(tab + 1);
+            n++;
+        }
+        if (cart_count > 0 || n > 0) {
+            memcpy(cart, held, sizeof(CartItem) * n);
+            cart_count = n;
+            // 재접속 직후 판매 화면이 바로 다시 그려지므로 메뉴판 아래 알림으로 표시
+            snprintf(payload, sizeof(payload), "재접속: 장바구니 %d개 품목 이어받음", n);
+            cache_note_alert(payload);
+        }
+        return 0;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < cart_count; i++) {
+        int got = 0;
+        snprintf(payload, sizeof(payload), "%s|%d", cart[i].name, cart[i].qty);
+        if (send_and_receive(sock, cid, 17, payload, res_msg, &got) < 0) return -1;
+        if (got > 0) { cart[kept] = cart[i]; cart[kept++].qty = got; }
+    }
+    if (cart_count > 0) {
+        snprintf(payload, sizeof(payload), "재접속: 세션 만료로 장바구니 다시 예약 (%d/%d개 품목)", kept, cart_count);
+        cache_note_alert(payload);
+        cache_invalidate();
+    }
+    cart_count = kept;
+    return 0;
+}
+
+/**
+ * @brief 재고 예약 및 로컬 장바구니 업데이트
  * [단계 1] 로컬 상태(Cart Full 여부) 및 입력값 유효성 선행 검증
- * [단계 2] 서버 통신(cmd 17)을 통한 DB상의 실재고 가용성 확인
- * [단계 3] 서버 승인(OK) 시 로컬 배열에 데이터 병합 또는 신규 할당
+ * [단계 2] 메뉴 캐시로 명백한 품절은 서버 왕복 없이 거절
+ * [단계 3] 서버에 품목 총수량만큼 예약(cmd 17)하고, 실제 확보된 수량으로 장바구니를 맞춤
+ *          (예약분은 결제 때 그대로 확정되므로 결제 시점의 부분판매를 막음)
  * * @return int 통신 성공 및 데이터 처리 완료 시 0, 서버 단절 시 -1
  */
 static int add_to_cart(int sock, uint32_t cid, const char* name, int qty) {
+    int idx = -1;
+    for (int i = 0; i < cart_count; i++) if (strcmp(cart[i].name, name) == 0) idx = i;
+
     // [예외 케이스] 배열 인덱스 초과 방지 (Memory Safety)
-    if (cart_count >= MAX_CART) { 
+    if (idx < 0 && cart_count >= MAX_CART) { 
         print_system_message("[실패] 장바구니가 가득 찼습니다."); 
         return 0; 
     }
@@ -56,35 +150,36 @@ static int add_to_cart(int sock, uint32_t cid, const char* name, int qty) {
         return 0; 
     }
 
-    char payload[256], res_msg[MAX_PAYLOAD];
-    
-    /* * [버퍼 안전성 확보] 
-     * snprintf()는 널 문자를 포함하여 지정된 크기만큼만 기록하므로 버퍼 오버플로우를 방지합니다.
-     * %.49s는 입력 소스(name)가 아무리 길어도 최대 49자만 복사하도록 강제합니다.
-     */
-    snprintf(payload, sizeof(payload), "%.49s|%d", name, qty);
-    
-    // [서버 통신] 실시간 재고 가용성 쿼리 전송
-    if (send_and_receive(sock, cid, 17, payload, res_msg, NULL) < 0) return -1;
-
-    // [데이터 처리] 서버 응답 분석 후 로컬 상태 동기화
-    if (strncmp(res_msg, "OK", 2) == 0) {
-        for (int i = 0; i < cart_count; i++) {
-            if (strcmp(cart[i].name, name) == 0) {
-                cart[i].qty += qty; // 기존 품목 존재 시 수량 업데이트
-                printf("\n[안내] '%s' 장바구니 추가됨. (현재 %d개)\n", name, cart[i].qty);
-                return 0;
-            }
-        }
+    // [캐시 조회] 이미 예약해 둔 품목이 아니고 판매 가능 수량이 0이면 서버에 묻지 않음
+    if (cache_refresh(sock, cid) < 0) return -1;
+    if (idx < 0 && cache_available(name) <= 0) {
+        char res_msg[128];
+        snprintf(res_msg, sizeof(res_msg), "[실패] '%.49s' 상품은 존재하지 않거나 재고가 없습니다.", name);
+        print_system_message(res_msg); // 서버 cmd 17 과 같은 거절 사유
+        return 0;
+    }
+
+    // [예약] "상품명|총수량" -> 페이지 필드로 실제 예약된 수량이 돌아옴
+    char payload[128], res_msg[MAX_PAYLOAD];
+    int want = (idx >= 0 ? cart[idx].qty : 0) + qty, held = 0;
+    snprintf(payload, sizeof(payload), "%s|%d", name, want);
+    if (send_and_receive(sock, cid, 17, payload, res_msg, &held) < 0) return -1;
+    cache_invalidate();
+
+    if (held <= 0) {
+        if (idx >= 0) cart[idx] = cart[--cart_count];   // 예약이 모두 사라진 품목은 장바구니에서 뺌
+        print_system_message(res_msg);
+        return 0;
+    }
+    if (idx < 0) {
         // 신규 품목 추가 시 문자열 안전 복사(strncpy) 및 널 종료 보장
-        strncpy(cart[cart_count].name, name, 49); 
-        cart[cart_count].name[49] = '\0';
-        cart[cart_count].qty = qty; 
-        cart_count++;
-        printf("\n[안내] '%s' 장바구니 추가됨.\n", name);
-    } else {
-        print_system_message(res_msg); // 서버 측 거절 사유(예: 재고 부족) 사용자 알림
+        idx = cart_count++;
+        strncpy(cart[idx].name, name, 49); 
+        cart[idx].name[49] = '\0';
     }
+    cart[idx].qty = held;
+    if (held < want) print_system_message(res_msg);
+    else printf("\n[안내] '%s' 장바구니 추가됨. (현재 %d개 예약)\n", name, held);
     return 0;
 }
 
@@ -95,6 +190,59 @@ static int add_to_cart(int sock, uint32_t cid, const char* name, int qty) {
  * 서버측에서 일괄 처리(All-or-Nothing)를 지원하는 원자적(Atomic) 패킷 구조 도입을 권장합니다.
  * * @return int 전체 프로세스 정상 완료 시 0, 중간 단절 시 -1
  */
+// 단일 입고에서 ID 를 비우면 쓰는 임대 구간 (lease_next > lease_last = 비어 있음, 다 쓰면 ID_LEASE_BATCH 개씩 새로 받음)
+#define ID_LEASE_BATCH 32
+static unsigned long long lease_next = 1, lease_last = 0;
+
+// 다음 상품 번호를 out 에 씀 -> 0, 임대 실패 1 (res_msg 에 사유), 통신 단절 -1
+static int next_leased_id(int sock, uint32_t cid, char* out, size_t size, char* res_msg) {
+    if (lease_next > lease_last) {
+        char payload[16];
+        unsigned long long first, last;
+        snprintf(payload, sizeof(payload), "%d", ID_LEASE_BATCH);
+        if (send_and_receive_rid(sock, cid, CMD_ID_LEASE, next_request_id(), payload, res_msg, NULL) < 0) return -1;
+        if (sscanf(res_msg, "%llu\t%llu", &first, &last) != 2) return 1;
+        lease_next = first; lease_last = last;
+    }
+    snprintf(out, size, "%llu", lease_next++);
+    return 0;
+}
+
+// 판매 요청: 혼잡(503)으로 거절되면 같은 요청 ID 로 간격을 늘려 가며 다시 보냄
+// (거절된 요청은 서버가 실행하지 않았으므로 같은 ID 로 보내도 새로 처리됨). 반환: 응답 코드, 통신 단절 -1
+static int sell_with_backoff(int sock, uint32_t cid, uint32_t rid, const char* payload, char* res_msg) {
+    int code, delay = BUSY_BACKOFF_MS;
+    for (int t = 0; (code = send_and_receive_rid(sock, cid, 14, rid, payload, res_msg, NULL)) == RESP_BUSY && t < BUSY_RETRIES; t++) {
+        usleep(delay * 1000);
+        delay *= 2;
+    }
+    return code;
+}
+
+// 결제 도중 끊겨 반영 여부를 모르는 판매 줄 (in_doubt_rid 0 = 없음)
+static CartItem in_doubt;
+static uint32_t in_doubt_rid = 0;
+
+int retry_in_doubt_sale(int sock, uint32_t cid) {
+    if (in_doubt_rid == 0) return 0;
+    char payload[256], res_msg[MAX_PAYLOAD];
+    snprintf(payload, sizeof(payload), "%s|%d", in_doubt.name, in_doubt.qty);
+    int code = sell_with_backoff(sock, cid, in_doubt_rid, payload, res_msg);
+    if (code < 0) return -1;
+    char text[192];
+    if (code == RESP_BUSY && cart_count < MAX_CART) {
+        // 처음 요청이 반영됐다면 서버가 보관한 응답을 돌려줬을 것이므로 팔리지 않은 줄: 장바구니로 되돌림
+        memmove(cart + 1, cart, sizeof(CartItem) * cart_count);
+        cart[0] = in_doubt;
+        cart_count++;
+        snprintf(text, sizeof(text), "끊기기 직전 결제 미반영 (서버 혼잡): %.49s %d개를 장바구니에 되돌림", in_doubt.name, in_doubt.qty);
+    } else snprintf(text, sizeof(text), "끊기기 직전 결제 확인: %.90s", res_msg);
+    cache_note_alert(text);     // 다음 판매 화면 알림으로 보여 줌
+    in_doubt_rid = 0;
+    cache_invalidate();
+    return 0;
+}
+
 static int process_checkout(int sock, uint32_t cid) {
     if (cart_count == 0) { 
         print_system_message("[안내] 결제할 상품이 없습니다."); 
@@ -107,8 +255,25 @@ static int process_checkout(int sock, uint32_t cid) {
     // [트랜잭션 리스크] 통신 장애 시 루프가 중단되며, 이때까지 전송된 건만 서버 DB에 반영됨
     for (int i = 0; i < cart_count; i++) {
         snprintf(payload, sizeof(payload), "%s|%d", cart[i].name, cart[i].qty);
-        if (send_and_receive(sock, cid, 14, payload, res_msg, NULL) < 0) {
-            // 결제 실패 시 후속 처리: 남은 장바구니 유지 및 상위 재연결 로직으로 제어권 위임
+        uint32_t rid = next_request_id();
+        int code = sell_with_backoff(sock, cid, rid, payload, res_msg);
+        if (code == RESP_BUSY) {
+            // 계속 혼잡: 팔린 줄만 빼고 이 줄부터는 장바구니에 남김 (나중에 다시 결제)
+            memmove(cart, cart + i, sizeof(CartItem) * (cart_count - i));
+            cart_count -= i;
+            if (i > 0) cache_invalidate();
+            snprintf(res_msg, sizeof(res_msg), "[안내] 서버가 혼잡해 %d개 품목을 결제하지 못했습니다. 장바구니에 남겼으니 잠시 후 다시 결제하세요.", cart_count);
+            print_system_message(res_msg);
+            return 0;
+        }
+        if (code < 0) {
+            // 결제 실패 시 후속 처리: 이미 판매된 줄과 응답을 받지 못한 줄을 빼고 남은 장바구니 유지 후 상위 재연결 로직으로 제어권 위임
+            // (오프라인으로 이어서 결제해도 앞서 팔린 품목을 다시 팔지 않도록)
+            // 응답을 받지 못한 줄은 서버에 반영됐는지 알 수 없으므로 재접속 후 같은 요청 ID 로 다시 보냄
+            in_doubt = cart[i];
+            in_doubt_rid = rid;
+            memmove(cart, cart + i + 1, sizeof(CartItem) * (cart_count - i - 1));
+            cart_count -= i + 1;
             return -1; 
         }
         printf("%s\n", res_msg); 
@@ -116,10 +281,89 @@ static int process_checkout(int sock, uint32_t cid) {
     
     // [확정] 모든 서버 응답이 수신된 경우에만 로컬 데이터 초기화
     cart_count = 0;
+    cache_invalidate(); // 방금 판매한 수량은 푸시를 기다리지 않고 다음 화면에 반영
+
     print_system_message("[안내] 결제가 완료되어 장바구니를 비웠습니다.");
     return 0;
 }
 
+// =====================================================================
+// [오프라인 판매] 서버에 닿지 않는 동안 마지막으로 받은 메뉴 캐시를 기준으로 팔고 결제는 로컬 저널에 기록
+// 담을 때 로컬 판매 가능 수량에서 바로 빼 두므로(비우면 되돌림) 같은 단말기가 캐시보다 많이 팔지 않습니다.
+// 끊기기 전에 서버에 예약해 둔 품목은 캐시 수량에 이미 빠져 있으므로 그대로 결제할 수 있습니다.
+// =====================================================================
+static void offline_add(const char* name, int qty) {
+    int idx = -1;
+    for (int i = 0; i < cart_count; i++) if (strcmp(cart[i].name, name) == 0) idx = i;
+    if (idx < 0 && cart_count >= MAX_CART) { print_system_message("[실패] 장바구니가 가득 찼습니다."); return; }
+    if (qty <= 0) { print_system_message("[실패] 수량은 1개 이상이어야 합니다."); return; }
+
+    int avail = cache_available(name);
+    if (avail < qty) {
+        char res_msg[160];
+        snprintf(res_msg, sizeof(res_msg), "[실패] '%.49s' 재고 부족 (마지막으로 받은 재고 기준 %d개)", name, avail > 0 ? avail : 0);
+        print_system_message(res_msg);
+        return;
+    }
+    cache_take(name, qty);
+    if (idx < 0) {
+        idx = cart_count++;
+        snprintf(cart[idx].name, sizeof(cart[idx].name), "%.49s", name);
+        cart[idx].qty = 0;
+    }
+    cart[idx].qty += qty;
+    printf("\n[안내] '%s' 장바구니 추가됨. (현재 %d개, 오프라인)\n", name, cart[idx].qty);
+}
+
+static void offline_checkout(void) {
+    if (cart_count == 0) { print_system_message("[안내] 결제할 상품이 없습니다."); return; }
+    if (offline_record_sale(cart, cart_count) < 0) {
+        print_system_message("[오류] 오프라인 판매 기록에 실패했습니다. 결제되지 않았습니다.");
+        return;
+    }
+    cart_count = 0;
+    print_system_message("[안내] 오프라인 결제가 기록되었습니다. 서버에 다시 연결되면 자동으로 전송합니다.");
+}
+
+int run_offline_mode(uint32_t cid) {
+    char res_msg[MAX_PAYLOAD], input_buf[100];
+    if (!cache_ready()) {
+        print_system_message("[오프라인] 받아 둔 재고 정보가 없어 오프라인 판매를 할 수 없습니다.");
+        pause_screen(-1);
+        return 0;
+    }
+    while (1) {
+        cache_render_menu(res_msg, sizeof(res_msg));
+        clear_screen();
+        printf("======================================\n");
+        printf("   [오프라인 판매] POS-%04d\n", cid);
+        printf("======================================\n");
+        printf("%s", res_msg);
+        printf("--------------------------------------\n");
+        show_cart();
+        printf(" 📦 미전송 판매: %d건 (서버에 연결되면 자동 전송)\n", offline_pending());
+        printf("======================================\n");
+        printf(" 👉 추가: [상품명] [수량] (예: 콜라 2)\n");
+        printf(" 👉 명령: [결제: pay] [비우기: clear] [재연결 시도: 0]\n");
+        get_string_input(-1, " >> ", input_buf, sizeof(input_buf));
+
+        if (strcmp(input_buf, "0") == 0) break;
+        else if (strcmp(input_buf, "pay") == 0) offline_checkout();
+        else if (strcmp(input_buf, "clear") == 0) {
+            for (int i = 0; i < cart_count; i++) cache_take(cart[i].name, -cart[i].qty);
+            cart_count = 0;
+            print_system_message("[안내] 장바구니가 비워졌습니다.");
+        } else {
+            char name[50];
+            int qty = 0;
+            if (sscanf(input_buf, "%49s %d", name, &qty) == 2) offline_add(name, qty);
+            else print_system_message("[오류] 입력 형식이 올바르지 않습니다.");
+        }
+        pause_screen(-1);
+    }
+    return 0;
+}
+
 /**
  * @brief POS 메인 제어 루프 및 I/O Multiplexing 관리
  * [I/O 전략] select() 함수를 통한 동기식 비차단(Synchronous Non-blocking) 감시 적용.
@@ -130,8 +374,9 @@ int run_pos_mode(int sock, uint32_t cid) {
     char res_msg[MAX_PAYLOAD], input_buf[100];
     
     while (1) {
-        // [Data Sync] 화면 갱신 전 서버로부터 최신 판매 품목 리스트 수신
-        if (send_and_receive(sock, cid, 15, "", res_msg, NULL) < 0) return -1;
+        // [Data Sync] 재고 버전이 바뀐 경우에만 서버에서 판매 품목 스냅샷을 다시 받고, 메뉴판은 캐시에서 렌더링
+        if (cache_refresh(sock, cid) < 0) return -1;
+        cache_render_menu(res_msg, sizeof(res_msg));
 
         // [View] 메뉴판과 현재 장바구니 상태 통합 렌더링
         clear_screen();
@@ -158,7 +403,7 @@ int run_pos_mode(int sock, uint32_t cid) {
             if (pause_screen(sock) < 0) return -1; 
         } 
         else if (strcmp(input_buf, "clear") == 0) { 
-            clear_cart(); 
+            if (clear_cart(sock, cid) < 0) return -1; 
             if (pause_screen(sock) < 0) return -1; 
         } 
         else {
@@ -178,6 +423,29 @@ int run_pos_mode(int sock, uint32_t cid) {
     return 0;
 }
 
+/**
+ * @brief 일괄 삭제(cmd 5/12/13)를 요청하고 작업이 끝날 때까지 진행 상황을 보여줌
+ * 서버는 접수 즉시 작업 번호(페이지 필드)를 돌려주고 삭제는 뒤에서 나눠 처리하므로,
+ * 그동안 다른 계산대의 판매는 멈추지 않습니다. 끝나면 res_msg 에 최종 결과가 남습니다.
+ * @return int 성공 시 0, 통신 단절 시 -1
+ */
+static int run_bulk_delete(int sock, uint32_t cid, int cmd, const char* name, char* res_msg) {
+    char payload[16];
+    int job_id = 0, pct = 0;
+    if (send_and_receive(sock, cid, cmd, name, res_msg, &job_id) < 0) return -1;
+    if (job_id <= 0) return 0;      // 접수 실패: res_msg 에 사유
+    snprintf(payload, sizeof(payload), "%d", job_id);
+    while (1) {
+        if (send_and_receive(sock, cid, CMD_BULK_STATUS, payload, res_msg, &pct) < 0) return -1;
+        if (pct < 0 || pct >= 100) break;
+        printf("\r %s    ", res_msg);
+        fflush(stdout);
+        usleep(BULK_POLL_MS * 1000);
+    }
+    printf("\n");
+    return 0;
+}
+
 /**
  * @brief 특정 상품의 상세 목록 조회 및 개별/일괄 삭제 관리
  * [단계 1] 서버에 상품명과 페이지 번호를 전달하여 상세 데이터 요청 (Paging)
@@ -230,7 +498,7 @@ static int manage_inventory_detail(int sock, uint32_t cid, int is_expired_mode,
         else if (strcmp(action, "all") == 0) { 
             // 삭제 모드 설정: 전체 삭제(12) 또는 만료분만 삭제(13)
             int del_cmd = is_expired_mode ? 13 : 12; 
-            if (send_and_receive(sock, cid, del_cmd, name, res_msg, NULL) < 0) return -1;
+            if (run_bulk_delete(sock, cid, del_cmd, name, res_msg) < 0) return -1;
             
             print_system_message(res_msg); 
             if (pause_screen(sock) < 0) return -1;
@@ -267,6 +535,28 @@ static int manage_inventory_detail(int sock, uint32_t cid, int is_expired_mode,
     return 0; // 정상적인 사용자 종료 시 제어권 반환
 }
 
+/**
+ * @brief 로트 번호로 찾은 상품 목록을 페이지 단위로 보여줌
+ * @return int 성공 시 0, 통신 단절 시 -1
+ */
+static int view_lot_items(int sock, uint32_t cid, const char* lot) {
+    char payload[64], res_msg[MAX_PAYLOAD], action[50];
+    int page = 1;
+    while (1) {
+        int total_pages = 1;
+        snprintf(payload, sizeof(payload), "%.23s|%d", lot, page);
+        if (send_and_receive(sock, cid, CMD_LOT_ITEMS, payload, res_msg, &total_pages) < 0) return -1;
+        clear_screen();
+        printf("%s\n--------------------------------------\n", res_msg);
+        printf(" 👉 [0: 뒤로] [페이지 번호]\n");
+        if (get_string_input(sock, " >> ", action, sizeof(action)) < 0) return -1;
+        int parsed_page = atoi(action);
+        if (strcmp(action, "0") == 0) break;
+        if (parsed_page > 0 && parsed_page <= total_pages) page = parsed_page;
+    }
+    return 0;
+}
+
 /**
  * @brief 재고 관리 요약 화면(Dashboard) 표시 및 일괄 처리 로직 담당
  * [역할 1] 서버로부터 카테고리별 재고 통계(Summary)를 수신하여 시각화
@@ -310,8 +600,9 @@ static int manage_inventory_summary(int sock, uint32_t cid, int is_expired_mode)
         
         // 4-2. 시스템 초기화 또는 일괄 폐기 실행 (가장 강력한 마스터 권한 명령)
         else if (strcmp(action, "clear") == 0) {
-            // 서버에 일괄 처리 요청 전송 (cmd: 5 또는 16)
-            if (send_and_receive(sock, cid, bulk_clear_cmd, "", res_msg, NULL) < 0) return -1;
+            // 서버에 일괄 처리 요청 전송 (cmd 5 는 작업으로 접수되어 끝날 때까지 진행 상황 표시, 16 은 바로 처리)
+            if (bulk_clear_cmd == 5 ? run_bulk_delete(sock, cid, 5, "", res_msg) < 0
+                                    : send_and_receive(sock, cid, bulk_clear_cmd, "", res_msg, NULL) < 0) return -1;
             
             print_system_message(res_msg); // 서버 측 처리 결과(삭제된 개수 등) 출력
             if (pause_screen(sock) < 0) return -1; // 사용자 확인 대기
@@ -355,6 +646,7 @@ int run_admin_mode(int sock, uint32_t cid) {
 
         // [단계 3] 종료 조건 확인: '0' 입력 시 관리자 모드 루프 탈출 및 메인 메뉴 복귀
         if (choice == 0) break; 
+        cache_invalidate(); // 입고/삭제 결과는 푸시를 기다리지 않고 판매 화면에 반영
 
         // [단계 4] 메뉴 선택에 따른 기능 분기 처리 (Switch-Case)
         switch (choice) {
@@ -364,7 +656,7 @@ int run_admin_mode(int sock, uint32_t cid) {
                 int h;
 
                 // [데이터 입력] 각 항목별 입력을 순차적으로 수신 (입력 중 서버 단절 감시)
-                if (get_string_input(sock, "상품 ID: ", id, sizeof(id)) < 0) return -1;
+                if (get_string_input(sock, "상품 ID(자동 발급 Enter): ", id, sizeof(id)) < 0) return -1;
                 if (get_string_input(sock, "상품명: ", name, sizeof(name)) < 0) return -1;
                 if (get_int_input(sock, "유효시간(시간): ", &h) < 0) return -1;
                 
@@ -374,12 +666,29 @@ int run_admin_mode(int sock, uint32_t cid) {
                     if (pause_screen(sock) < 0) return -1;
                     break; // 해당 switch문 탈출 후 루프 재시작
                 }
+                // ID 를 비우면 임대받은 구간의 번호를 씀 (서버가 상품명 분류 접두어를 붙임)
+                if (id[0] == '\0') {
+                    int r = next_leased_id(sock, cid, id, sizeof(id), res_msg);
+                    if (r < 0) return -1;
+                    if (r > 0) {
+                        print_system_message(res_msg);
+                        if (pause_screen(sock) < 0) return -1;
+                        break;
+                    }
+                }
+
+                // [선택 입력] 부가 정보는 Enter 로 건너뛸 수 있음 (서버가 형식 검증)
+                char price[16], lot[META_TEXT_LEN], supplier[META_TEXT_LEN], shelf[META_TEXT_LEN];
+                if (get_string_input(sock, "가격(원, 생략 Enter): ", price, sizeof(price)) < 0) return -1;
+                if (get_string_input(sock, "로트 번호(생략 Enter): ", lot, sizeof(lot)) < 0) return -1;
+                if (get_string_input(sock, "공급사(생략 Enter): ", supplier, sizeof(supplier)) < 0) return -1;
+                if (get_string_input(sock, "진열 위치(생략 Enter): ", shelf, sizeof(shelf)) < 0) return -1;
 
                 /* [데이터 패키징] 
                  * 구분자('|')를 사용하여 서버가 파싱하기 쉬운 프로토콜 형식으로 결합
                  * %.19s, %.49s를 사용하여 고정된 배열 크기를 초과하지 않도록 안전하게 기록
                  */
-                snprintf(payload, sizeof(payload), "%.19s|%.49s|%d", id, name, h);
+                snprintf(payload, sizeof(payload), "%.19s|%.49s|%d|%s|%s|%s|%s", id, name, h, price, lot, supplier, shelf);
                 
                 // [서버 요청: cmd 1] 서버로 단일 입고 패킷 전송 및 결과 수신
                 if (send_and_receive(sock, cid, 1, payload, res_msg, NULL) < 0) return -1;
@@ -416,6 +725,20 @@ int run_admin_mode(int sock, uint32_t cid) {
                 // [기능 4] 만료 재고 요약 및 드릴다운 관리 화면 진입 (is_expired_mode = 1)
                 if (manage_inventory_summary(sock, cid, 1) < 0) return -1; 
                 break;
+            case 5:
+                // [기능 5] 분류별 재고 금액 (가격이 등록된 판매 가능 상품 기준)
+                if (send_and_receive(sock, cid, CMD_STOCK_VALUE, "", res_msg, NULL) < 0) return -1;
+                clear_screen();
+                printf("%s\n", res_msg);
+                if (pause_screen(sock) < 0) return -1;
+                break;
+            case 6: {
+                // [기능 6] 로트 번호로 상품 조회 (회수/반품 대상 확인용)
+                char lot[META_TEXT_LEN];
+                if (get_string_input(sock, "로트 번호: ", lot, sizeof(lot)) < 0) return -1;
+                if (lot[0] && view_lot_items(sock, cid, lot) < 0) return -1;
+                break;
+            }
             default: 
                 // [예외 처리] 메뉴 번호 이외의 잘못된 값 입력 시 안내
                 print_system_message("[오류] 잘못된 입력입니다."); 
@@ -2,11 +2,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/select.h>
-#include <sys/socket.h>
 #include <unistd.h>
-#include <errno.h>
+#include <time.h>
 #include "ui.h"
 #include "utils.h"
+#include "network.h"
 
 /**
  * @brief 키보드 입력과 서버 연결 상태를 동시에 감시 (I/O Multiplexing)
@@ -18,6 +18,7 @@
  */
 static int check_input_or_disconnect(int sock) {
     fd_set read_fds;
+    time_t next_ping = time(NULL) + HEARTBEAT_SEC;
     while(1) {
         FD_ZERO(&read_fds);  // 읽기 이벤트 집합 초기화
         FD_SET(STDIN_FILENO, &read_fds);  // 1. 키보드 표준 입력 감시 등록
@@ -26,18 +27,20 @@ static int check_input_or_disconnect(int sock) {
         // 감시할 디스크립터 중 가장 큰 값 + 1 설정
         int max_fd = (sock > STDIN_FILENO) ? sock : STDIN_FILENO;
 
-        // 이벤트가 발생할 때까지 대기 (timeout NULL은 무한 대기)
-        int ret = select(max_fd + 1, &read_fds, NULL, NULL, NULL);
-        if (ret > 0) {
+        // 이벤트가 발생할 때까지 대기. 오래 입력이 없으면 서버가 유휴 연결로 정리하지 않도록 CMD_PING
+        // (푸시가 자주 와도 서버 쪽 수신은 없으므로 대기 시작 시점 기준으로 셈)
+        time_t now = time(NULL);
+        struct timeval tv = { .tv_sec = next_ping > now ? next_ping - now : 0, .tv_usec = 0 };
+        int ret = select(max_fd + 1, &read_fds, NULL, NULL, sock >= 0 ? &tv : NULL);
+        if (ret == 0) {
+            if (send_heartbeat(sock) < 0) return -1;
+            next_ping = time(NULL) + HEARTBEAT_SEC;
+        }
+        else if (ret > 0) {
             // [사례 A] 서버 소켓에 데이터가 있거나 연결이 끊긴 경우
             if (sock >= 0 && FD_ISSET(sock, &read_fds)) {
-                char c;
-                // MSG_PEEK: 데이터를 실제로 읽지 않고 확인만 함
-                // MSG_DONTWAIT: 즉시 리턴하여 블로킹 방지
-                int n = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
-                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
-                    return -1; // 서버가 연결을 끊었거나 에러 발생 시 즉시 감지
-                }
+                // 서버 푸시(재고 버전 변경)는 처리하고 계속 대기, 연결이 끊겼으면 즉시 감지
+                if (drain_pushes(sock) < 0) return -1;
             }
             // [사례 B] 사용자가 키보드로 무언가 입력한 경우
             if (FD_ISSET(STDIN_FILENO, &read_fds)) {
@@ -113,6 +116,8 @@ void draw_admin_menu(uint32_t cid) {
     printf(" [조회 및 관리]\n");
     printf(" 3. 전체 재고 조회 (상세 검색 및 창고 비우기)\n");
     printf(" 4. 만료 재고 조회 (상세 검색 및 일괄 폐기)\n");
+    printf(" 5. 분류별 재고 금액\n");
+    printf(" 6. 로트 번호로 상품 조회\n");
     printf(" 0. 메인 화면으로 돌아가기\n");
     printf("======================================\n");
 }
@@ -0,0 +1,243 @@
+// =====================================================================
+// [부하 생성기] 요청 수락 제어(admission) 확인용 도구
+// 남용 단말기는 같은 명령을 쉬지 않고 반복하고, 일반 단말기는 일정한 간격으로
+// 메뉴판/스냅샷을 조회합니다. 종료 후 그룹별 처리량, 거절 수, 지연 시간을 출력해
+// 남용 단말기가 있어도 일반 단말기가 자기 몫을 처리받는지 보여줍니다.
+// -m sell 이면 일반 단말기가 조회 대신 장바구니 예약(cmd 17) 후 결제(cmd 14)를 반복하므로,
+// 남용 명령을 보고서(cmd 7, 9 등)로 주고 -f 로 재고를 채워 두면 보고서가 도는 동안의 판매 지연을 잴 수 있습니다.
+// -q 로 남용 단말기가 응답을 기다리지 않고 한 연결에 겹쳐 보내는 요청 수(파이프라이닝 깊이)를 정합니다.
+// 통신은 모두 비동기 클라이언트(src/aclient.c)로 합니다: 단말기 스레드마다 이벤트 루프 하나.
+//
+// 사용법: loadgen [-h 호스트] [-p 포트] [-a 남용 단말기 수] [-n 일반 단말기 수]
+//                 [-t 초] [-c 남용 명령 번호] [-i 일반 단말기 요청 간격(ms)]
+//                 [-m menu|sell] [-f 시작 전 랜덤입고 수량] [-q 남용 파이프라이닝 깊이]
+// =====================================================================
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "network.h"
+#include "aclient.h"
+
+#define MAX_SAMPLES 100000
+#define REQ_TIMEOUT_MS 10000
+
+typedef struct {
+    uint32_t cid;
+    int abuser;
+    unsigned long ok, busy, errors;
+    double active_ms;               // 접속 후 요청을 보낸 시간
+    double* lat_ms;
+    int n_lat;
+    AcLoop* loop;
+    AcConn* conn;
+    int failed;
+} Terminal;
+
+// 파이프라이닝한 요청 하나 (보낸 시각을 응답 콜백까지 들고 감)
+typedef struct {
+    Terminal* t;
+    double start;
+} Pending;
+
+static char host[64] = "127.0.0.1";
+static int port = 8080;
+static int duration = 10;
+static int abuse_cmd = 2;
+static int interval_ms = 100;
+static int sell_mode = 0;
+static int depth = 1;
+static volatile int running = 1;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// 요청 하나를 보내고 응답 코드를 돌려줌 (푸시 프레임은 루프가 건너뜀, 통신 오류/시간 초과 -1)
+static int request(AcConn* conn, uint32_t cmd, const char* payload) {
+    return ac_call(conn, cmd, 0, payload, REQ_TIMEOUT_MS, NULL, 0, NULL);
+}
+
+// 접속 + 접속 인사. 인사 응답을 기다려 접속 여부를 확인
+static AcConn* open_terminal(AcLoop* loop, uint32_t cid) {
+    AcConn* conn = ac_connect(loop, host, port, cid, "");
+    if (!conn) return NULL;
+    if (request(conn, CMD_PING, "") < 0) { ac_close(conn); return NULL; }
+    return conn;
+}
+
+// 남용 명령별 payload (랜덤입고는 5개씩, 상세 목록은 첫 페이지)
+static const char* abuse_payload(void) {
+    switch (abuse_cmd) {
+        case 2: return "5";
+        case 9: case 11: return "김밥|1";
+        case 18: return "0|0";
+        default: return "";
+    }
+}
+
+// 측정 전 재고 채우기: 랜덤입고는 요청 한도가 낮으므로 단말기 번호를 바꿔 가며 10000개씩
+static void prefill(int total) {
+    AcLoop* loop = ac_loop_new();
+    for (int i = 0; loop && total > 0; i++) {
+        AcConn* conn = open_terminal(loop, 8000 + i);
+        if (!conn) { fprintf(stderr, "[부하] 재고 채우기 접속 실패\n"); break; }
+        char payload[16];
+        snprintf(payload, sizeof(payload), "%d", total < 10000 ? total : 10000);
+        if (request(conn, 2, payload) != RESP_BUSY) total -= atoi(payload);
+        request(conn, 100, "");
+        ac_close(conn);
+    }
+    ac_loop_free(loop);
+}
+
+static void record(Terminal* t, const AcResult* res, double start) {
+    if (res->status != AC_OK) { t->errors++; t->failed = 1; return; }
+    if (res->code == RESP_BUSY) { t->busy++; return; }
+    t->ok++;
+    if (t->n_lat < MAX_SAMPLES) t->lat_ms[t->n_lat++] = now_ms() - start;
+}
+
+static void submit_abuse(Terminal* t);
+
+// 남용 요청 응답: 기록하고 바로 다음 요청을 보내 깊이를 유지
+static void abuse_cb(const AcResult* res, void* arg) {
+    Pending* p = arg;
+    Terminal* t = p->t;
+    record(t, res, p->start);
+    free(p);
+    if (running && !t->failed) submit_abuse(t);
+}
+
+static void submit_abuse(Terminal* t) {
+    Pending* p = malloc(sizeof(Pending));
+    if (!p) { t->failed = 1; return; }
+    *p = (Pending){ t, now_ms() };
+    if (!ac_submit(t->conn, abuse_cmd, abuse_payload(), REQ_TIMEOUT_MS, abuse_cb, p)) { free(p); t->failed = 1; t->errors++; }
+}
+
+// 남용 단말기: 응답을 기다리지 않고 depth 개를 겹쳐 보냄 (이벤트 루프 + 콜백)
+static void run_pipelined(Terminal* t) {
+    for (int i = 0; i < depth; i++) submit_abuse(t);
+    while (running && !t->failed) ac_run_once(t->loop, 100);
+    // 남은 응답을 받아 둠 (종료 인사 전에 보낸 요청이 모두 끝나도록)
+    while (ac_inflight(t->loop) > 0 && ac_run_once(t->loop, 1000) >= 0 && ac_is_open(t->conn)) {}
+}
+
+static void* terminal_thread(void* arg) {
+    Terminal* t = arg;
+    t->loop = ac_loop_new();
+    t->conn = t->loop ? open_terminal(t->loop, t->cid) : NULL;
+    if (!t->conn) { t->errors++; ac_loop_free(t->loop); return NULL; }
+
+    int turn = 0;
+    double begin = now_ms(), next = begin;
+    if (t->abuser && depth > 1) run_pipelined(t);
+    while (running && !(t->abuser && depth > 1)) {
+        double start = now_ms();
+        int code;
+        if (t->abuser) code = request(t->conn, abuse_cmd, abuse_payload());
+        else if (sell_mode) {
+            // 한 건의 판매 = 장바구니 예약 + 결제 (둘을 합친 시간을 지연으로 기록)
+            code = request(t->conn, 17, "콜라|1");
+            if (code >= 0 && code != RESP_BUSY) code = request(t->conn, 14, "콜라|1");
+        } else code = request(t->conn, (turn++ & 1) ? 15 : CMD_MENU_SNAPSHOT, "");
+        double end = now_ms();
+        if (code < 0) { t->errors++; break; }
+        if (code == RESP_BUSY) t->busy++;
+        else {
+            t->ok++;
+            if (t->n_lat < MAX_SAMPLES) t->lat_ms[t->n_lat++] = end - start;
+        }
+        if (!t->abuser) {
+            // 일반 단말기: 고정 간격 (응답이 늦으면 바로 다음 요청)
+            next += interval_ms;
+            double wait = next - now_ms();
+            if (wait > 0) usleep((useconds_t)(wait * 1000));
+            else next = now_ms();
+        }
+    }
+    t->active_ms = now_ms() - begin;
+    if (ac_is_open(t->conn)) request(t->conn, 100, "");
+    ac_loop_free(t->loop);
+    return NULL;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char* title, Terminal* ts, int n) {
+    if (n == 0) return;
+    unsigned long ok = 0, busy = 0, errors = 0, min_ok = (unsigned long)-1, max_ok = 0;
+    int total_lat = 0;
+    for (int i = 0; i < n; i++) {
+        ok += ts[i].ok; busy += ts[i].busy; errors += ts[i].errors; total_lat += ts[i].n_lat;
+        if (ts[i].ok < min_ok) min_ok = ts[i].ok;
+        if (ts[i].ok > max_ok) max_ok = ts[i].ok;
+    }
+    double* all = malloc(sizeof(double) * (total_lat ? total_lat : 1));
+    int k = 0;
+    for (int i = 0; i < n; i++) for (int j = 0; j < ts[i].n_lat; j++) all[k++] = ts[i].lat_ms[j];
+    qsort(all, k, sizeof(double), cmp_double);
+    printf("[%s] 단말기 %d개 | 처리 %lu건 (%.1f건/초) | 거절 %lu건 | 오류 %lu건\n",
+           title, n, ok, (double)ok / duration, busy, errors);
+    printf("        단말기당 처리 최소 %lu / 최대 %lu건 | 지연 p50 %.2fms, p99 %.2fms\n",
+           min_ok, max_ok, k ? all[k / 2] : 0.0, k ? all[(int)(k * 0.99)] : 0.0);
+    free(all);
+}
+
+int main(int argc, char* argv[]) {
+    int n_abusers = 2, n_normal = 8, fill = 0, opt;
+    while ((opt = getopt(argc, argv, "h:p:a:n:t:c:i:m:f:q:")) != -1) {
+        switch (opt) {
+            case 'h': snprintf(host, sizeof(host), "%s", optarg); break;
+            case 'p': port = atoi(optarg); break;
+            case 'a': n_abusers = atoi(optarg); break;
+            case 'n': n_normal = atoi(optarg); break;
+            case 't': duration = atoi(optarg); break;
+            case 'c': abuse_cmd = atoi(optarg); break;
+            case 'i': interval_ms = atoi(optarg); break;
+            case 'm': sell_mode = strcmp(optarg, "sell") == 0; break;
+            case 'f': fill = atoi(optarg); break;
+            case 'q': depth = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+            default:
+                fprintf(stderr, "사용법: %s [-h 호스트] [-p 포트] [-a 남용 단말기 수] [-n 일반 단말기 수] [-t 초] [-c 남용 명령] [-i 간격ms] [-m menu|sell] [-f 채울 재고] [-q 깊이]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (fill > 0) prefill(fill);
+
+    int n = n_abusers + n_normal;
+    Terminal* ts = calloc(n, sizeof(Terminal));
+    pthread_t* tids = calloc(n, sizeof(pthread_t));
+    for (int i = 0; i < n; i++) {
+        ts[i].abuser = i < n_abusers;
+        ts[i].cid = ts[i].abuser ? 9000 + i : 1000 + (i - n_abusers);
+        ts[i].lat_ms = malloc(sizeof(double) * MAX_SAMPLES);
+        pthread_create(&tids[i], NULL, terminal_thread, &ts[i]);
+    }
+    printf("[부하] %s:%d | 남용 단말기 %d개 (cmd %d 반복, 깊이 %d) | 일반 단말기 %d개 (%s, %dms 간격) | %d초\n",
+           host, port, n_abusers, abuse_cmd, depth, n_normal, sell_mode ? "예약+결제" : "메뉴판 조회", interval_ms, duration);
+    sleep(duration);
+    running = 0;
+    for (int i = 0; i < n; i++) pthread_join(tids[i], NULL);
+
+    report("남용", ts, n_abusers);
+    report("일반", ts + n_abusers, n_normal);
+    if (n_normal > 0) {
+        // 일반 단말기가 간격대로 보냈을 때 기대되는 처리량 대비 실제 처리 비율
+        double expected = 0, ok = 0;
+        for (int i = n_abusers; i < n; i++) { expected += ts[i].active_ms / interval_ms; ok += ts[i].ok; }
+        printf("[결과] 일반 단말기 처리율 %.1f%% (기대 %.0f건 중 %.0f건)\n", ok * 100.0 / expected, expected, ok);
+    }
+    for (int i = 0; i < n; i++) free(ts[i].lat_ms);
+    free(ts); free(tids);
+    return 0;
+}
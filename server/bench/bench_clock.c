@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "utils.h"
+#include "vclock.h"
+
+// =====================================================================
+// [가상 시계 벤치마크]
+//  - read : 가상 시각 한 번 읽는 비용
+//      legacy  = 이전 구현 (time() + difftime, 배속/기준점은 락 없는 전역 변수 둘)
+//      seconds = get_virtual_time() (vclock 초 단위)
+//      ns      = vclock_now_ns()
+//  - race : 읽는 스레드들이 시각을 연속으로 읽는 동안 한 스레드가 배속을 1 <-> 3600 으로 계속 바꿈.
+//           시각이 뒤로 간 횟수(backwards)와, x3600 에서 1초 안의 서로 다른 값 개수(distinct)를 셉니다.
+// 출력은 한 줄에 하나씩 key=value 형식입니다.
+// 사용법: bench_clock [읽기 횟수]
+// =====================================================================
+
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+// [이전 구현 복제본]
+static volatile int legacy_speed = 1;
+static volatile time_t legacy_real, legacy_virtual;
+
+static time_t legacy_now(void) {
+    time_t now; time(&now);
+    return legacy_virtual + (time_t)(difftime(now, legacy_real) * legacy_speed);
+}
+
+static void legacy_set_speed(int s) {
+    time_t now; time(&now);
+    legacy_virtual = legacy_virtual + (time_t)(difftime(now, legacy_real) * legacy_speed);
+    legacy_real = now;
+    legacy_speed = s;
+}
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#define READERS 3
+static volatile int racing = 1;
+static int use_legacy = 0;
+
+typedef struct { long reads, backwards; } RaceResult;
+
+static void* reader(void* arg) {
+    RaceResult* r = arg;
+    int64_t prev = use_legacy ? (int64_t)legacy_now() * VCLOCK_NS_PER_SEC : vclock_now_ns();
+    while (racing) {
+        int64_t t = use_legacy ? (int64_t)legacy_now() * VCLOCK_NS_PER_SEC : vclock_now_ns();
+        if (t < prev) r->backwards++;
+        prev = t;
+        r->reads++;
+    }
+    return NULL;
+}
+
+static void race(const char* impl, double seconds) {
+    RaceResult res[READERS] = {{0}};
+    pthread_t tids[READERS];
+    racing = 1;
+    for (int i = 0; i < READERS; i++) pthread_create(&tids[i], NULL, reader, &res[i]);
+    long flips = 0;
+    double end = now_sec() + seconds;
+    while (now_sec() < end) {
+        int s = (flips++ & 1) ? 1 : 3600;
+        if (use_legacy) legacy_set_speed(s); else vclock_set_speed(s);
+    }
+    racing = 0;
+    long reads = 0, backwards = 0;
+    for (int i = 0; i < READERS; i++) { pthread_join(tids[i], NULL); reads += res[i].reads; backwards += res[i].backwards; }
+    printf("bench=clock_race impl=%s readers=%d speed_changes=%ld reads=%ld backwards=%ld\n",
+           impl, READERS, flips, reads, backwards);
+}
+
+// x3600 에서 실제 1초 동안 읽은 값 중 서로 다른 값의 개수 (해상도)
+static long distinct_in_second(int legacy) {
+    long distinct = 0;
+    int64_t prev = -1;
+    double end = now_sec() + 1.0;
+    while (now_sec() < end) {
+        int64_t t = legacy ? (int64_t)legacy_now() : vclock_now_ns();
+        if (t != prev) distinct++;
+        prev = t;
+    }
+    return distinct;
+}
+
+int main(int argc, char* argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : 5000000;
+    init_config(1);
+    legacy_real = legacy_virtual = time(NULL);
+
+    volatile int64_t sink = 0;
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) sink += legacy_now();
+    double legacy_sec = now_sec() - t0;
+    t0 = now_sec();
+    for (int i = 0; i < n; i++) sink += get_virtual_time();
+    double sec_sec = now_sec() - t0;
+    t0 = now_sec();
+    for (int i = 0; i < n; i++) sink += vclock_now_ns();
+    double ns_sec = now_sec() - t0;
+    (void)sink;
+
+    printf("bench=clock_read impl=legacy ops=%d ns_per_op=%.1f\n", n, legacy_sec * 1e9 / n);
+    printf("bench=clock_read impl=seconds ops=%d ns_per_op=%.1f\n", n, sec_sec * 1e9 / n);
+    printf("bench=clock_read impl=ns ops=%d ns_per_op=%.1f\n", n, ns_sec * 1e9 / n);
+
+    legacy_set_speed(3600); vclock_set_speed(3600);
+    printf("bench=clock_resolution impl=legacy speed=3600 distinct_per_real_sec=%ld\n", distinct_in_second(1));
+    printf("bench=clock_resolution impl=ns speed=3600 distinct_per_real_sec=%ld\n", distinct_in_second(0));
+
+    use_legacy = 1; race("legacy", 1.0);
+    use_legacy = 0; race("vclock", 1.0);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <glob.h>
+#include "inventory.h"
+#include "compact.h"
+#include "history.h"
+#include "logger.h"
+#include "store.h"
+#include "utils.h"
+
+// =====================================================================
+// [재고 핵심 경로 벤치마크]
+// 소켓/화면 없이 inventory 모듈을 직접 불러 매장 규모별로 다음을 잽니다.
+//  - load        : load_data (병렬 적재 + 색인 + 이력 열기 + 시동 스냅샷 저널)
+//  - sell        : handle_sell 1개씩 (분류는 인기도 비율로 고름)
+//  - cart_hold   : handle_cart_hold 로 단말기마다 2개 예약 / cart_release 는 그 예약 해제
+//  - summary     : make_category_summary (전체 재고/만료/메뉴판 모드)
+//  - detail      : make_detail_page 첫 페이지 (이름 일치 행 수집 + 정렬)
+//  - expire_scan : check_and_update_expirations (만료될 상품이 없을 때 / 하루 뒤로 넘겨 일부가 만료될 때)
+//  - save        : 압축 스레드가 하는 DB 전체 다시 쓰기 (save_data 는 이력이 있으면 압축 요청만 남김)
+// 합성 DB: 분류별 인기도(생수/컵라면/콜라가 많음)와 유통기한(김밥/도시락은 하루, 음료는 1년)을 따르고
+// 유통기한이 짧은 상품 일부는 이미 만료된 상태로 시작합니다.
+// 출력은 한 줄에 하나씩 key=value 형식이라 이전 결과와 줄 단위로 비교할 수 있습니다.
+// 파일은 현재 디렉토리에 만들었다가 지웁니다.
+// 사용법: bench_inventory [상품 수 ...]   (기본 10000 100000 1000000, 10000000 까지 권장)
+// =====================================================================
+
+extern char log_filename[50];
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+#define DB_FILE "bench_inventory_db.txt"
+#define LOG_FILE "bench_inventory.log"
+#define MIN_SEC 0.3             // 반복 측정은 최소 이 시간 또는 최대 횟수까지
+#define MAX_POINT_OPS 20000     // 판매/예약 같은 단건 명령 최대 횟수
+
+static const char* names[10] = {"김밥", "샌드위치", "우유", "도시락", "컵라면", "콜라", "생수", "과자", "아이스크림", "커피"};
+static const int weight[10] = { 8, 6, 10, 7, 14, 13, 16, 12, 6, 8 };                      // 재고 비율 (%)
+static const int shelf_hours[10] = { 24, 48, 240, 24, 4320, 8760, 8760, 4320, 8760, 4320 };  // 유통기한
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int pick_category(void) {
+    int r = rand() % 100;
+    for (int c = 0; c < 10; c++) if ((r -= weight[c]) < 0) return c;
+    return 9;
+}
+
+// 입고 시점이 유통기한 구간에 고르게 퍼져 있다고 보고 남은 시간을 정함 (구간의 10% 는 이미 지남)
+static void make_db(long n, time_t now) {
+    FILE* fp = fopen(DB_FILE, "w");
+    if (!fp) { perror(DB_FILE); exit(1); }
+    long seq[10] = {0};
+    srand(42);
+    for (long i = 0; i < n; i++) {
+        int c = pick_category();
+        long span = shelf_hours[c] * 3600L;
+        long left = (long)(((double)rand() / RAND_MAX) * span * 1.1) - span / 10;
+        fprintf(fp, "%c_%04ld %s %ld %d\n", 'A' + c, ++seq[c], names[c], (long)now + left, left < 0);
+    }
+    fclose(fp);
+}
+
+static Store* new_store(void) {
+    Store* st = calloc(1, sizeof(Store));
+    pthread_mutex_init(&st->list_mutex, NULL);
+    snprintf(st->db_filename, sizeof(st->db_filename), "%s", DB_FILE);
+    init_inventory(st);
+    return st;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 단건 명령 지연 분포 출력
+static void report_ops(const char* bench, long items, double* lat_us, int ops, double total_sec) {
+    qsort(lat_us, ops, sizeof(double), cmp_double);
+    printf("bench=%s items=%ld ops=%d total_ms=%.1f us_per_op=%.2f p50_us=%.2f p99_us=%.2f max_us=%.2f\n",
+           bench, items, ops, total_sec * 1e3, ops ? total_sec * 1e6 / ops : 0.0,
+           ops ? lat_us[ops / 2] : 0.0, ops ? lat_us[(int)(ops * 0.99)] : 0.0, ops ? lat_us[ops - 1] : 0.0);
+}
+
+// 전체 훑기 명령: MIN_SEC 이 지나도록 반복 (최소 1번, 최대 50번)
+#define REPEAT_SCAN(bench_name, items, call) do {                                  \
+        double t0_ = now_sec(), el_; int ops_ = 0;                                 \
+        do { call; ops_++; } while ((el_ = now_sec() - t0_) < MIN_SEC && ops_ < 50); \
+        printf("bench=%s items=%ld ops=%d ms_per_op=%.3f\n", bench_name, items, ops_, el_ * 1e3 / ops_); \
+    } while (0)
+
+static void bench_size(long n) {
+    time_t now = get_virtual_time();
+    make_db(n, now);
+
+    Store* st = new_store();
+    double t0 = now_sec();
+    load_data(st);
+    printf("bench=load items=%ld loaded=%ld ms=%.1f\n", n, st->item_count, (now_sec() - t0) * 1e3);
+
+    char pin[64], msg[MAX_PAYLOAD], out[MAX_PAYLOAD + 512];
+    int point_ops = n / 4 < MAX_POINT_OPS ? (int)(n / 4) : MAX_POINT_OPS;
+    double* lat = malloc(sizeof(double) * (point_ops > 0 ? point_ops : 1));
+
+    // 예약: 단말기마다 인기 분류 하나에서 2개
+    double total = 0;
+    for (int i = 0; i < point_ops; i++) {
+        snprintf(pin, sizeof(pin), "%s|2", names[pick_category()]);
+        double s = now_sec();
+        handle_cart_hold(st, 1000 + i, pin, msg);
+        lat[i] = (now_sec() - s) * 1e6; total += lat[i] / 1e6;
+    }
+    report_ops("cart_hold", n, lat, point_ops, total);
+
+    // 메뉴판 모드는 예약이 남아 있을 때 (예약 수량 따로 집계)
+    REPEAT_SCAN("summary_menu", n, make_category_summary(st, out, 2, "메뉴판"));
+
+    total = 0;
+    for (int i = 0; i < point_ops; i++) {
+        double s = now_sec();
+        handle_cart_release(st, 1000 + i, "", msg);
+        lat[i] = (now_sec() - s) * 1e6; total += lat[i] / 1e6;
+    }
+    report_ops("cart_release", n, lat, point_ops, total);
+
+    total = 0;
+    for (int i = 0; i < point_ops; i++) {
+        snprintf(pin, sizeof(pin), "%s|1", names[pick_category()]);
+        msg[0] = '\0';
+        double s = now_sec();
+        handle_sell(st, 1, 1, pin, msg);
+        lat[i] = (now_sec() - s) * 1e6; total += lat[i] / 1e6;
+    }
+    report_ops("sell", n, lat, point_ops, total);
+    free(lat);
+
+    REPEAT_SCAN("summary_all", n, make_category_summary(st, out, 0, "전체 재고"));
+    REPEAT_SCAN("summary_expired", n, make_category_summary(st, out, 1, "만료 재고"));
+    REPEAT_SCAN("detail_page", n, make_detail_page(st, out, "생수", 1, 0));
+    REPEAT_SCAN("detail_page_expired", n, make_detail_page(st, out, "김밥", 1, 1));
+
+    // 만료 검사: 지금 시각(새로 만료될 상품 없음)과 하루 뒤(판매로 앞쪽이 빠진 뒤에도 짧은 상품 일부가 만료됨)
+    REPEAT_SCAN("expire_scan_idle", n, check_and_update_expirations(st, now));
+    int avail[NUM_CATEGORIES], before[NUM_CATEGORIES], after[NUM_CATEGORIES];
+    count_categories(st, avail, before);
+    t0 = now_sec();
+    check_and_update_expirations(st, now + 24 * 3600);
+    double adv_ms = (now_sec() - t0) * 1e3;
+    count_categories(st, avail, after);
+    long expired = 0;
+    for (int c = 0; c < NUM_CATEGORIES; c++) expired += after[c] - before[c];
+    printf("bench=expire_scan_advance items=%ld expired=%ld ms=%.1f\n", n, expired, adv_ms);
+
+    t0 = now_sec();
+    compact_locked(st);
+    printf("bench=save impl=compact items=%ld ms=%.1f\n", st->item_count, (now_sec() - t0) * 1e3);
+
+    history_close(st);
+    free_all_resources(st);
+    free(st);
+
+    // DB, 이력, 압축 때 남긴 시점 스냅샷(.snap.*, .snapidx) 정리
+    glob_t g;
+    if (glob("bench_inventory_db*", 0, NULL, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; i++) remove(g.gl_pathv[i]);
+        globfree(&g);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    init_config(1);
+    strcpy(log_filename, LOG_FILE);
+    long defaults[] = { 10000, 100000, 1000000 };
+    int count = argc > 1 ? argc - 1 : 3;
+    for (int i = 0; i < count; i++) bench_size(argc > 1 ? atol(argv[i + 1]) : defaults[i]);
+
+    flush_logs();
+    remove(LOG_FILE); remove(LOG_FILE ".idx");
+    for (int s = 1; ; s++) {
+        char seg[80]; snprintf(seg, sizeof(seg), "%s.%d", LOG_FILE, s);
+        if (remove(seg) != 0) break;
+    }
+    return 0;
+}
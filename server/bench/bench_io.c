@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include "iobackend.h"
+
+// =====================================================================
+// [저장 I/O 벤치마크]
+// 이력 한 줄 크기의 레코드를 파일에 이어 쓰면서 호출 스레드가 쓰기 한 번에 묶여 있는 시간을 잽니다.
+//  - stdio : 기존 방식 (fprintf + fflush, 레코드마다 write 시스템 호출)
+//  - sync  : io_init 전 저장 I/O (호출 스레드에서 바로 pwrite)
+//  - 백엔드: io_init 후 (버퍼에 복사 + I/O 스레드 깨우기, 커널 쓰기는 I/O 스레드가 묶어서)
+// 처리량은 마지막 레코드가 파일에 다 쓰일 때까지(io_drain)의 시간으로 셉니다.
+// 파일은 현재 디렉토리에 만들고 끝나면 지웁니다. 출력은 한 줄에 하나씩 key=value 형식입니다.
+// 사용법: bench_io [uring|pwrite] [레코드 수]
+// =====================================================================
+
+#define BENCH_FILE "bench_io.tmp"
+
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int make_record(char* buf, size_t size, int i) {
+    return snprintf(buf, size, "S %ld POS-%04d P%08d 우유 %d 1700000000 %d\n", 1700000000L + i, i % 10000, i, i % 7 + 1, i);
+}
+
+static void report(const char* impl, double* lat, int n, double total, uint64_t writes, uint64_t batches) {
+    qsort(lat, n, sizeof(double), cmp_double);
+    printf("bench=append impl=%s records=%d p50_us=%.2f p99_us=%.2f max_us=%.1f records_per_sec=%.0f kernel_writes=%llu batches=%llu\n",
+           impl, n, lat[n / 2] * 1e6, lat[(long)n * 99 / 100] * 1e6, lat[n - 1] * 1e6, n / total,
+           (unsigned long long)writes, (unsigned long long)batches);
+}
+
+static void run_stdio(double* lat, int n) {
+    FILE* fp = fopen(BENCH_FILE, "w");
+    if (!fp) { perror(BENCH_FILE); exit(1); }
+    char line[128];
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) {
+        make_record(line, sizeof(line), i);
+        double s = now_sec();
+        fputs(line, fp);
+        fflush(fp);
+        lat[i] = now_sec() - s;
+    }
+    fclose(fp);
+    report("stdio", lat, n, now_sec() - t0, n, n);
+    remove(BENCH_FILE);
+}
+
+static void run_io(const char* impl, double* lat, int n) {
+    IoFile* f = io_open(BENCH_FILE, IO_CREATE);
+    if (!f) { perror(BENCH_FILE); exit(1); }
+    uint64_t w0, b0, w1, b1;
+    io_counters(&w0, &b0);
+    char line[128];
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) {
+        int len = make_record(line, sizeof(line), i);
+        double s = now_sec();
+        io_append(f, line, len);
+        io_submit(f);
+        lat[i] = now_sec() - s;
+    }
+    io_drain(f);
+    double total = now_sec() - t0;
+    io_counters(&w1, &b1);
+    report(impl, lat, n, total, w1 - w0, b1 - b0);
+    io_close(f);
+    io_flush_all();
+    remove(BENCH_FILE);
+}
+
+int main(int argc, char* argv[]) {
+    int want = (argc > 1 && strcmp(argv[1], "pwrite") == 0) ? IO_BACKEND_PWRITE : IO_BACKEND_URING;
+    int n = (argc > 2) ? atoi(argv[2]) : 200000;
+    if (n < 1) n = 1;
+    double* lat = malloc(sizeof(double) * n);
+    if (!lat) return 1;
+
+    run_stdio(lat, n);
+    run_io("sync", lat, n);
+
+    io_init(want);
+    printf("bench=io_backend name=%s\n", io_backend_name());
+    run_io(io_backend() == IO_BACKEND_URING ? "uring" : "pwrite", lat, n);
+
+    free(lat);
+    return 0;
+}
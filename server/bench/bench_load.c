@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "inventory.h"
+#include "history.h"
+#include "compact.h"
+#include "parallel.h"
+#include "store.h"
+#include "utils.h"
+
+// =====================================================================
+// [DB 적재/압축 벤치마크]
+// 상품 N개짜리 DB 파일을 현재 디렉토리에 만들어 두고 다음을 잽니다.
+//  - load legacy   : 이전 read_products 복제본 (fscanf 한 줄씩 + 맨 앞에 연결 + sscanf ID 번호)
+//  - load parallel : read_products_file (스레드 1개 / CPU 수 / 4개, 색인 포함)
+//  - journal_all   : 적재 직후 R + A 레코드를 저널/이력에 남기는 비용 (시동 시간의 나머지)
+//  - compact       : 목록 복사(list_mutex 보유 구간)와 전체 다시 쓰기(락 밖) 시간,
+//                    이전 save_data 처럼 락 안에서 fprintf 로 전부 쓰는 시간과 비교
+// 출력은 한 줄에 하나씩 key=value 형식입니다. (1코어 기계에서는 스레드 수를 늘려도 빨라지지 않음)
+// 사용법: bench_load [상품 수]
+// =====================================================================
+
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+#define DB_FILE "bench_load_db.txt"
+#define LEGACY_FILE "bench_load_legacy.txt"
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static const char* names[10] = {"김밥", "샌드위치", "우유", "도시락", "컵라면", "콜라", "생수", "과자", "아이스크림", "커피"};
+
+static void make_db(const char* path, long n) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) { perror(path); exit(1); }
+    srand(7);
+    for (long i = 0; i < n; i++) {
+        int c = rand() % 10;
+        fprintf(fp, "%c_%04ld %s %ld %d\n", 'A' + c, i, names[c], 1900000000L + rand() % 1000000, rand() % 10 == 0);
+    }
+    fclose(fp);
+}
+
+// [이전 구현 복제본] Product 는 inventory.c 에 숨겨져 있으므로 같은 크기의 구조체로 대신함
+typedef struct LegacyProduct {
+    char id[20]; char name[50]; time_t expire_time; int is_expired;
+    int heap_pos; void* hold; struct LegacyProduct *hold_prev, *hold_next, *prev, *next;
+} LegacyProduct;
+
+static long legacy_load(const char* path, LegacyProduct** head, int* r_counts) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return -1;
+    char id[20], name[50]; long et; int ie; long cnt = 0;
+    while (fscanf(fp, "%19s %49s %ld %d", id, name, &et, &ie) == 4) {
+        LegacyProduct* n = calloc(1, sizeof(LegacyProduct));
+        if (!n) break;
+        strcpy(n->id, id); strcpy(n->name, name);
+        n->expire_time = (time_t)et; n->is_expired = ie; n->heap_pos = -1;
+        n->next = *head; if (*head) (*head)->prev = n; *head = n;
+        cnt++;
+        char pre; int num;
+        if (sscanf(id, "%c_%d", &pre, &num) == 2 && pre >= 'A' && pre <= 'J' && num > r_counts[pre - 'A']) r_counts[pre - 'A'] = num;
+    }
+    fclose(fp);
+    return cnt;
+}
+
+static Store* new_store(void) {
+    Store* st = calloc(1, sizeof(Store));
+    pthread_mutex_init(&st->list_mutex, NULL);
+    snprintf(st->db_filename, sizeof(st->db_filename), "%s", DB_FILE);
+    init_inventory(st);
+    return st;
+}
+
+static void bench_parallel(long n, int threads) {
+    parallel_set_threads(threads);
+    Store* st = new_store();
+    double t0 = now_sec();
+    long cnt = read_products_file(st, DB_FILE, 1, NULL);
+    double sec = now_sec() - t0;
+    printf("bench=load impl=parallel threads=%d items=%ld loaded=%ld ms=%.1f\n", parallel_threads(), n, cnt, sec * 1e3);
+    free_all_resources(st);
+    free(st);
+}
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? atol(argv[1]) : 1000000;
+    init_config(1);
+    make_db(DB_FILE, n);
+
+    LegacyProduct* head = NULL; int r_counts[10] = {0};
+    double t0 = now_sec();
+    long cnt = legacy_load(DB_FILE, &head, r_counts);
+    printf("bench=load impl=legacy threads=1 items=%ld loaded=%ld ms=%.1f\n", n, cnt, (now_sec() - t0) * 1e3);
+
+    // 이전 save_data: 락을 쥔 채 fprintf 로 전부 씀
+    t0 = now_sec();
+    FILE* fp = fopen(LEGACY_FILE, "w");
+    for (LegacyProduct* c = head; c; c = c->next)
+        fprintf(fp, "%s %s %ld %d\n", c->id, c->name, (long)c->expire_time, c->is_expired);
+    fclose(fp);
+    printf("bench=save impl=legacy lock_held_ms=%.1f total_ms=%.1f\n", (now_sec() - t0) * 1e3, (now_sec() - t0) * 1e3);
+    while (head) { LegacyProduct* next = head->next; free(head); head = next; }
+    remove(LEGACY_FILE);
+
+    bench_parallel(n, 1);
+    bench_parallel(n, 0);
+    bench_parallel(n, 4);
+    parallel_set_threads(0);
+
+    Store* st = new_store();
+    read_products_file(st, DB_FILE, 1, NULL);
+    history_open(st);
+    t0 = now_sec();
+    journal_all_products(st);
+    printf("bench=journal_all items=%ld ms=%.1f\n", st->item_count, (now_sec() - t0) * 1e3);
+
+    // 압축: 복사 구간(락)과 전체 시간
+    t0 = now_sec();
+    long rows_n; char* extras;
+    ProductRow* rows = copy_product_rows(st, &rows_n, &extras);
+    double copy_ms = (now_sec() - t0) * 1e3;
+    free(rows); free(extras);
+    t0 = now_sec();
+    compact_locked(st);
+    printf("bench=save impl=compact threads=%d lock_held_ms=%.1f total_ms=%.1f\n", parallel_threads(), copy_ms, (now_sec() - t0) * 1e3);
+
+    history_close(st);
+    free_all_resources(st);
+    char path[160];
+    make_history_path(st, ".history", path, sizeof(path));
+    remove(path);
+    remove(DB_FILE);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "logger.h"
+#include "utils.h"
+
+// =====================================================================
+// [로그 이력 경합 벤치마크]
+// 여러 스레드가 동시에 update_log 를 호출하는 동안 대시보드 역할의 읽기 스레드가
+// 최근 15줄을 계속 읽습니다. 기존 방식(log_mutex + 1KB 고정 슬롯 + 매번 fopen)을
+// 그대로 옮긴 legacy_update_log 와 현재 무잠금 링 구현을 같은 조건에서 비교합니다.
+// 출력은 한 줄에 하나씩 key=value 형식입니다.
+// 사용법: bench_log [쓰기 스레드 수] [스레드당 호출 수]
+// =====================================================================
+
+extern char log_filename[50];
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+// [기존 구현 복제본]
+static char legacy_history[1000][1024];
+static int legacy_head = 0;
+static pthread_mutex_t legacy_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void legacy_update_log(const char* msg) {
+    time_t vt = get_virtual_time();
+    struct tm tm_info; localtime_r(&vt, &tm_info);
+    char t_str[32]; strftime(t_str, sizeof(t_str), "%Y-%m-%d %H:%M:%S", &tm_info);
+    char formatted_msg[1024];
+    snprintf(formatted_msg, sizeof(formatted_msg), "[%s] %.800s", t_str, msg);
+
+    pthread_mutex_lock(&legacy_mutex);
+    FILE *fp = fopen(log_filename, "a");
+    if (fp) { fprintf(fp, "%s\n", formatted_msg); fclose(fp); }
+    memcpy(legacy_history[legacy_head], formatted_msg, sizeof(formatted_msg));
+    legacy_head = (legacy_head + 1) % 1000;
+    pthread_mutex_unlock(&legacy_mutex);
+}
+
+static void legacy_read_dashboard(char* sink) {
+    pthread_mutex_lock(&legacy_mutex);
+    for (int i = 0; i < 15; i++) memcpy(sink, legacy_history[(legacy_head - 1 - i + 1000) % 1000], 128);
+    pthread_mutex_unlock(&legacy_mutex);
+}
+
+static void ring_read_dashboard(char* sink) {
+    // draw_dashboard 는 화면 출력과 묶여 있으므로 같은 무잠금 읽기 경로인 read_recent_logs 사용
+    read_recent_logs(sink, 15 * 128, 15);
+}
+
+typedef struct {
+    int legacy;
+    int iters;
+} WriterArg;
+
+static atomic_int stop_reader;
+static atomic_long reader_reads;
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* writer(void* arg) {
+    WriterArg* w = arg;
+    char msg[128];
+    for (int i = 0; i < w->iters; i++) {
+        snprintf(msg, sizeof(msg), "[POS-%04d] 판매완료: 우유 %d개", i % 10000, i % 7 + 1);
+        if (w->legacy) legacy_update_log(msg); else update_log(msg);
+    }
+    return NULL;
+}
+
+static void* reader(void* arg) {
+    int legacy = *(int*)arg;
+    char sink[15 * 128];
+    while (!atomic_load(&stop_reader)) {
+        if (legacy) legacy_read_dashboard(sink); else ring_read_dashboard(sink);
+        atomic_fetch_add(&reader_reads, 1);
+    }
+    return NULL;
+}
+
+static void run(int legacy, int threads, int iters) {
+    pthread_t tids[64], rtid;
+    WriterArg w = { legacy, iters };
+    atomic_store(&stop_reader, 0);
+    atomic_store(&reader_reads, 0);
+    pthread_create(&rtid, NULL, reader, &legacy);
+
+    double t0 = now_sec();
+    for (int i = 0; i < threads; i++) pthread_create(&tids[i], NULL, writer, &w);
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    double el = now_sec() - t0;
+
+    atomic_store(&stop_reader, 1);
+    pthread_join(rtid, NULL);
+
+    long ops = (long)threads * iters;
+    printf("bench=update_log impl=%s threads=%d ops=%ld sec=%.4f ns_per_op=%.1f ops_per_sec=%.0f dashboard_reads=%ld\n",
+           legacy ? "mutex" : "ring", threads, ops, el, el * 1e9 / ops, ops / el, atomic_load(&reader_reads));
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = (argc > 1) ? atoi(argv[1]) : 8;
+    int iters = (argc > 2) ? atoi(argv[2]) : 20000;
+    if (max_threads > 64) max_threads = 64;
+
+    init_config(1);
+    strcpy(log_filename, "/dev/null");   // 디스크 속도가 아닌 로그 경로 자체의 비용만 측정
+
+    for (int t = 1; t <= max_threads; t *= 2) {
+        run(1, t, iters);
+        run(0, t, iters);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "logger.h"
+#include "store.h"
+#include "utils.h"
+
+// =====================================================================
+// [이진 이벤트 로그 벤치마크]
+// 판매 로그 한 건을 기록하는 비용과 디스크 사용량을 비교합니다.
+//  - text : 이전 방식 (호출자 snprintf -> 시각 문자열 포맷 -> 텍스트 줄 write -> 링에 텍스트 복사)
+//  - event: 현재 log_event (24바이트 레코드를 쓰기 버퍼와 링에 복사, 문장은 만들지 않음)
+//  - render: 대시보드/로그 브라우저가 레코드 한 건을 문장으로 렌더링하는 비용
+// 로그 파일은 현재 디렉토리에 만들었다가 지웁니다. 출력은 한 줄에 하나씩 key=value 형식입니다.
+// 사용법: bench_logevent [기록 건수]
+// =====================================================================
+
+extern char log_filename[50];
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+#define TEXT_FILE "bench_logevent.txt"
+#define EVENT_FILE "bench_logevent.bin"
+
+// [이전 구현 복제본] 링은 1KB 슬롯 대신 줄 길이만큼 복사하는 것으로 단순화
+static char text_ring[1000][1024];
+static int text_head = 0;
+
+static void text_log(int fd, uint32_t cid, int qty) {
+    char msg[8192];
+    snprintf(msg, sizeof(msg), "[POS-%04d] 판매완료: %s %d개", cid, "우유", qty);
+
+    time_t vt = get_virtual_time();
+    struct tm tm_info; localtime_r(&vt, &tm_info);
+    char t_str[32]; strftime(t_str, sizeof(t_str), "%Y-%m-%d %H:%M:%S", &tm_info);
+    char line[1024];
+    int len = snprintf(line, sizeof(line), "[%s] %.800s\n", t_str, msg);
+    if (write(fd, line, len) < 0) exit(1);
+    memcpy(text_ring[text_head], line, len - 1);
+    text_head = (text_head + 1) % 1000;
+}
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long file_size(const char* path) {
+    struct stat sb;
+    return stat(path, &sb) == 0 ? (long)sb.st_size : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int n = (argc > 1) ? atoi(argv[1]) : 200000;
+    init_config(1);
+    remove(TEXT_FILE); remove(EVENT_FILE); remove(EVENT_FILE ".idx");
+
+    int fd = open(TEXT_FILE, O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) { perror(TEXT_FILE); return 1; }
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) text_log(fd, i % 10000, i % 7 + 1);
+    double text_sec = now_sec() - t0;
+    close(fd);
+    long text_bytes = file_size(TEXT_FILE);
+
+    strcpy(log_filename, EVENT_FILE);
+    t0 = now_sec();
+    for (int i = 0; i < n; i++) log_event(NULL, EV_SELL, i % 10000, 2, i % 7 + 1, i % 7 + 1, NULL);
+    flush_logs();
+    double event_sec = now_sec() - t0;
+    long event_bytes = file_size(EVENT_FILE);   // 교체된 세그먼트까지 합산
+    for (int s = 1; ; s++) {
+        char seg[80]; snprintf(seg, sizeof(seg), "%s.%d", EVENT_FILE, s);
+        long b = file_size(seg);
+        if (b == 0) break;
+        event_bytes += b; remove(seg);
+    }
+
+    // 렌더링 비용: 대시보드가 최근 15건을 그리는 것과 같은 경로
+    char sink[15 * 128];
+    int rounds = n / 15;
+    t0 = now_sec();
+    for (int i = 0; i < rounds; i++) read_recent_logs(sink, sizeof(sink), 15);
+    double render_sec = now_sec() - t0;
+
+    printf("bench=log_write impl=text ops=%d sec=%.4f ns_per_op=%.1f bytes_per_event=%.1f\n",
+           n, text_sec, text_sec * 1e9 / n, (double)text_bytes / n);
+    printf("bench=log_write impl=event ops=%d sec=%.4f ns_per_op=%.1f bytes_per_event=%.1f\n",
+           n, event_sec, event_sec * 1e9 / n, (double)event_bytes / n);
+    printf("bench=log_render impl=event ops=%d sec=%.4f ns_per_op=%.1f\n",
+           rounds * 15, render_sec, render_sec * 1e9 / (rounds * 15));
+
+    remove(TEXT_FILE); remove(EVENT_FILE); remove(EVENT_FILE ".idx");
+    return 0;
+}
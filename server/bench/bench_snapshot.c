@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "inventory.h"
+#include "snapfile.h"
+#include "parallel.h"
+#include "store.h"
+#include "utils.h"
+
+// =====================================================================
+// [스냅샷 형식 벤치마크] 텍스트 DB 형식과 압축 스냅샷 형식(snapfile.c)을 같은 행으로 비교합니다.
+//  - size   : 파일 크기와 텍스트 대비 비율, 블록 본문의 압축 전/후 크기
+//  - encode : 행 배열 -> 파일 내용 (텍스트는 압축 스레드가 하던 한 줄씩 snprintf, 스냅샷은 스레드 1개 / CPU 수)
+//  - decode : 블록만 풀기 (행 콜백은 세기만 함, 스레드 1개)
+//  - load   : read_products_file 로 매장에 적재 (상품 할당/색인 포함, CPU 수 스레드)
+// 합성 행: 분류별 인기도와 유통기한은 bench_inventory 와 같고, 행의 30% 에 가격/로트/공급사/위치가 있습니다.
+// 출력은 한 줄에 하나씩 key=value 형식입니다. 파일은 현재 디렉토리에 만들었다가 지웁니다.
+// 사용법: bench_snapshot [상품 수 ...]   (기본 100000 1000000)
+// =====================================================================
+
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+#define TEXT_FILE "bench_snapshot_db.txt"
+#define SNAP_FILE "bench_snapshot_db.snap"
+#define ROW_TEXT_MAX (112 + 96)
+
+static const char* names[10] = {"김밥", "샌드위치", "우유", "도시락", "컵라면", "콜라", "생수", "과자", "아이스크림", "커피"};
+static const int weight[10] = { 8, 6, 10, 7, 14, 13, 16, 12, 6, 8 };
+static const int shelf_hours[10] = { 24, 48, 240, 24, 4320, 8760, 8760, 4320, 8760, 4320 };
+static const char* suppliers[4] = { "CJ", "OTTOGI", "LOTTE", "NONGSHIM" };
+
+static double now_sec(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int pick_category(void) {
+    int r = rand() % 100;
+    for (int c = 0; c < 10; c++) if ((r -= weight[c]) < 0) return c;
+    return 9;
+}
+
+// 번호는 랜덤입고처럼 매장 전체 일련번호, 목록 순서는 입고 순서
+static ProductRow* make_rows(long n, char** extras) {
+    ProductRow* rows = malloc(sizeof(ProductRow) * n);
+    size_t cap = (size_t)n * 40 + 64, len = 0;
+    *extras = malloc(cap);
+    if (!rows || !*extras) { perror("malloc"); exit(1); }
+    long now = 1790000000L;
+    srand(42);
+    for (long i = 0; i < n; i++) {
+        int c = pick_category();
+        long span = shelf_hours[c] * 3600L;
+        long left = (long)(((double)rand() / RAND_MAX) * span * 1.1) - span / 10;
+        ProductRow* r = &rows[i];
+        snprintf(r->id, sizeof(r->id), "%c_%04ld", 'A' + c, (i + 1) % 100000000L);
+        snprintf(r->name, sizeof(r->name), "%s", names[c]);
+        r->expire_time = now + left;
+        r->is_expired = left < 0;
+        r->extra = -1;
+        if (rand() % 10 < 3) {
+            r->extra = (long)len;
+            len += snprintf(*extras + len, cap - len, " %d LOT-%04d-%02d %s R%d-%02d", 500 + c * 300, 2026, rand() % 52,
+                            suppliers[c % 4], c, rand() % 20) + 1;
+        }
+    }
+    return rows;
+}
+
+static char* encode_text(const ProductRow* rows, long n, const char* extras, size_t* out_len) {
+    char* buf = malloc((size_t)n * ROW_TEXT_MAX + 64);
+    char* p = buf;
+    p += sprintf(p, "# history_offset 0\n");
+    for (long i = 0; i < n; i++) {
+        const ProductRow* r = &rows[i];
+        p += snprintf(p, ROW_TEXT_MAX, "%s %s %ld %d%s\n", r->id, r->name, r->expire_time, r->is_expired,
+                      r->extra >= 0 ? extras + r->extra : "");
+    }
+    *out_len = p - buf;
+    return buf;
+}
+
+static void write_file(const char* path, const char* buf, size_t len) {
+    FILE* fp = fopen(path, "w");
+    if (!fp || fwrite(buf, 1, len, fp) != len) { perror(path); exit(1); }
+    fclose(fp);
+}
+
+static void count_row(void* arg, const SnapRow* r) { (void)r; (*(long*)arg)++; }
+
+static void bench_load(const char* impl, const char* path, long n) {
+    Store* st = calloc(1, sizeof(Store));
+    pthread_mutex_init(&st->list_mutex, NULL);
+    init_inventory(st);
+    double t0 = now_sec();
+    long cnt = read_products_file(st, path, 1, NULL);
+    printf("bench=load impl=%s threads=%d items=%ld loaded=%ld ms=%.1f\n", impl, parallel_threads(), n, cnt, (now_sec() - t0) * 1e3);
+    free_all_resources(st);
+    free(st);
+}
+
+static void bench_size(long n) {
+    char* extras;
+    ProductRow* rows = make_rows(n, &extras);
+
+    double t0 = now_sec();
+    size_t text_len;
+    char* text = encode_text(rows, n, extras, &text_len);
+    double text_ms = (now_sec() - t0) * 1e3;
+    printf("bench=encode impl=text threads=1 items=%ld ms=%.1f mb_per_s=%.1f\n", n, text_ms, text_len / 1e6 / (text_ms / 1e3));
+
+    size_t snap_len = 0;
+    char* snap = NULL;
+    int threads[2] = { 1, 0 };
+    for (int k = 0; k < 2; k++) {
+        parallel_set_threads(threads[k]);
+        if (k > 0 && parallel_threads() == 1) break;       // 1코어 기계: 같은 측정 반복 안 함
+        free(snap);
+        t0 = now_sec();
+        snap = snap_encode(rows, n, extras, 0, &snap_len);
+        double ms = (now_sec() - t0) * 1e3;
+        printf("bench=encode impl=snap threads=%d items=%ld ms=%.1f text_mb_per_s=%.1f\n", parallel_threads(), n, ms, text_len / 1e6 / (ms / 1e3));
+    }
+    if (!snap) { fprintf(stderr, "snap_encode failed\n"); exit(1); }
+
+    SnapBlock* blocks;
+    long nb = snap_index(snap, snap_len, &blocks, NULL);
+    size_t raw = 0, stored = 0;
+    for (long b = 0; b < nb; b++) { raw += blocks[b].raw_len; stored += blocks[b].comp_len ? blocks[b].comp_len : blocks[b].raw_len; }
+    printf("bench=size items=%ld text_bytes=%zu snap_bytes=%zu ratio=%.3f bytes_per_item=%.2f blocks=%ld raw_bytes=%zu lz_ratio=%.3f\n",
+           n, text_len, snap_len, (double)snap_len / text_len, (double)snap_len / n, nb, raw, raw ? (double)stored / raw : 0.0);
+
+    long decoded = 0;
+    t0 = now_sec();
+    for (long b = 0; b < nb; b++) snap_decode_block(snap, &blocks[b], count_row, &decoded);
+    double dec_ms = (now_sec() - t0) * 1e3;
+    printf("bench=decode impl=snap threads=1 items=%ld decoded=%ld ms=%.1f text_mb_per_s=%.1f\n", n, decoded, dec_ms, text_len / 1e6 / (dec_ms / 1e3));
+    free(blocks);
+
+    parallel_set_threads(0);
+    write_file(TEXT_FILE, text, text_len);
+    write_file(SNAP_FILE, snap, snap_len);
+    bench_load("text", TEXT_FILE, n);
+    bench_load("snap", SNAP_FILE, n);
+    remove(TEXT_FILE); remove(SNAP_FILE);
+
+    free(text); free(snap); free(rows); free(extras);
+}
+
+int main(int argc, char* argv[]) {
+    init_config(1);
+    long defaults[] = { 100000, 1000000 };
+    int count = argc > 1 ? argc - 1 : 2;
+    for (int i = 0; i < count; i++) bench_size(argc > 1 ? atol(argv[i + 1]) : defaults[i]);
+    return 0;
+}
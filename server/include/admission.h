@@ -0,0 +1,35 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <stdint.h>
+
+#define RESP_OK     200
+#define RESP_BUSY   503     // 혼잡/요청 한도 초과로 처리하지 않음 (payload 는 "0|안내 메시지")
+
+// [요청 등급] 등급마다 단말기별 토큰 버킷을 따로 둡니다 (열쇠는 단말기가 고른 cid 가 아닌 예약 주인 번호, session.h)
+enum {
+    ADM_READ,               // 요약/상세/스냅샷 조회
+    ADM_WRITE,              // 입고/판매/삭제/예약 등 단건 변경
+    ADM_BULK,               // 랜덤입고/창고 비움/일괄 삭제 (요청마다 DB 전체 재작성)
+    ADM_CLASSES,
+    ADM_EXEMPT = -1         // 접속/종료/구독 같은 제어 명령
+};
+
+// 전체 동시 처리 한도와 대기열
+#define ADM_MAX_INFLIGHT    16
+#define ADM_MAX_QUEUED      64
+#define ADM_WAIT_MS         1000
+
+// admission_enter 결과
+enum { ADM_OK, ADM_LIMITED, ADM_BUSY };
+
+int admission_class(uint32_t cmd);
+int admission_enter(uint32_t owner, uint32_t cid, int cls, int urgent);    // ADM_OK 이면 처리 후 반드시 admission_leave (urgent 는 대기열 앞쪽에 섬)
+void admission_leave(void);
+void admission_forget(uint32_t owner);      // 연결 종료 시 그 주인의 토큰 버킷 정리
+const char* admission_reject_msg(int verdict);
+
+// 관리자 콘솔 출력용 통계
+void print_admission_stats(void);
+
+#endif // ADMISSION_H
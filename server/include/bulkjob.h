@@ -0,0 +1,21 @@
+#ifndef BULKJOB_H
+#define BULKJOB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "store.h"
+
+#define CMD_BULK_STATUS     30    // 클라이언트 -> 서버: 일괄 삭제 작업 진행 상황 "작업 번호"
+                                  // (응답 페이지 필드 = 진행률 0~99, 끝났으면 100, 없는 작업 -1)
+#define BULK_CHUNK          2048  // 작업 스레드가 list_mutex 를 한 번 쥐고 처리하는 상품 수
+#define BULK_JOBS_MAX       64    // 진행 상황을 조회할 수 있는 최근 작업 수 (대기/진행 중 포함)
+
+// [일괄 삭제 작업] cmd 5/12/13 은 작업으로 접수하고 바로 작업 번호를 돌려줍니다. 실제 삭제는 작업 스레드가
+// BULK_CHUNK 개씩 나눠 하며 조각 사이에 락을 놓으므로 그동안에도 판매/조회가 처리됩니다 (inventory.c 의 bulk_delete_*).
+void init_bulk_jobs(void);          // 작업 스레드 시작
+// 접수 (list_mutex 없이 호출). 반환: 작업 번호 (실패 0, msg 에 사유)
+uint32_t bulk_job_submit(Store* st, uint32_t cmd, uint32_t cid, const char* name, char* msg, size_t size);
+// CMD_BULK_STATUS: 이 매장의 작업 번호 pin 의 상태를 msg 에 (반환: 진행률, 끝 100, 없으면 -1)
+int bulk_job_status(Store* st, const char* pin, char* msg, size_t size);
+
+#endif // BULKJOB_H
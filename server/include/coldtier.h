@@ -0,0 +1,38 @@
+#ifndef COLDTIER_H
+#define COLDTIER_H
+
+#include <stdint.h>
+#include <time.h>
+#include "store.h"
+
+// [만료 재고 보관소] 만료된 상품은 판매 목록과 재고 색인에서 빠져 여기로 옮겨집니다.
+// 판매/메뉴판/예약/만료 검사는 판매 가능한 상품만 보고, 만료 조회(cmd 10/11)와 폐기(cmd 5/6/13)만 이곳을 봅니다.
+// 항목은 상품명별 묶음의 고정 크기 블록에 모여 있고 크기는 상품 구조체의 1/3 이하입니다. 블록은 옮겨지지 않으므로
+// 항목 주소는 다른 항목을 뺄 때 맨 뒤 항목이 빈 자리로 옮겨 오는 경우에만 바뀝니다 (ID 색인/부가 정보 owner 는 함께 고침).
+typedef struct ColdItem {
+    char id[20];
+    uint16_t group;                 // 상품명 묶음 번호
+    uint32_t meta;                  // 부가 정보 슬롯 (itemmeta.c, 0 = 없음, owner 는 이 항목)
+    time_t expire_time;
+} ColdItem;
+
+// 모두 list_mutex 보유 상태에서 호출. 매장의 item_count/mem_bytes 도 함께 갱신
+ColdItem* cold_add(Store* st, const char* id, const char* name, time_t expire_time, uint32_t meta);   // 메모리 부족 NULL
+ColdItem* cold_find(Store* st, const char* id);
+void cold_remove(Store* st, ColdItem* c);       // 부가 정보 슬롯 해제는 호출자 몫
+const char* cold_name(Store* st, const ColdItem* c);
+
+// 조회: name NULL = 전체. 콜백 안에서 넣거나 빼지 말 것
+long cold_count(Store* st, const char* name);
+int cold_names(Store* st, const char** names, long* counts, int max);     // 상품명별 개수 (빈 묶음 제외), 반환: 채운 수
+void cold_each(Store* st, const char* name, void (*fn)(void* arg, const ColdItem* c), void* arg);
+// 통째로 비움: 항목마다 fn 을 부른 뒤 뺌 (반환: 뺀 수)
+long cold_clear(Store* st, const char* name, void (*fn)(void* arg, const ColdItem* c), void* arg);
+// 나눠 비움: 묶음 뒤쪽부터 최대 max 개만 fn 을 부른 뒤 뺌 (일괄 삭제 작업의 한 조각, 반환: 뺀 수)
+long cold_take(Store* st, const char* name, long max, void (*fn)(void* arg, const ColdItem* c), void* arg);
+
+void cold_reset(Store* st);                     // 보관소 해제 (매장 통계는 호출자가 초기화)
+void cold_move(Store* dst, Store* src);         // 목록을 통째로 옮길 때 보관소도 함께 (dst 의 것은 해제)
+size_t cold_bytes(Store* st);                   // 블록 여유분과 ID 색인 (항목 자체는 mem_bytes 에 포함)
+
+#endif // COLDTIER_H
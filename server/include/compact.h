@@ -0,0 +1,14 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "store.h"
+
+#define COMPACT_DELAY_MS 1000   // 첫 변경 후 이 시간 동안 모인 변경을 DB 다시 쓰기 한 번으로 합침
+
+// [DB 압축] 매장 DB 파일을 현재 목록으로 다시 씀
+void init_compactor(void);          // 백그라운드 압축 스레드 시작
+void compact_request(Store* st);    // 변경 알림 (list_mutex 보유 여부 무관, 바로 반환)
+void compact_locked(Store* st);     // 호출자가 list_mutex 보유 - 그 자리에서 바로 씀 (이력 파일이 없는 매장)
+void compact_flush(Store* st);      // 종료 시: 락 없이 바로 씀 (시그널 핸들러에서 호출)
+
+#endif // COMPACT_H
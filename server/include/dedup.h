@@ -0,0 +1,30 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// [요청 ID] 명령 코드에 REQ_ID_FLAG 를 켜고 payload 앞 4바이트(네트워크 바이트 순서)에 단말기가 정한 요청 ID 를 붙이면,
+// 서버는 그 4바이트를 떼고 처리하며 응답 헤더의 client_id 자리에 같은 요청 ID 를 돌려줍니다.
+// 변경 명령이면 (cid, 요청 ID) 로 응답을 보관해 두었다가, 시간 안에 같은 요청이 다시 오면 다시 실행하지 않고 보관한 응답을 보냅니다.
+#define REQ_ID_FLAG         0x80000000u
+
+#define DEDUP_WINDOW_SEC    300     // 이 시간(실제 초)이 지난 요청 ID 는 새 요청으로 처리
+// 보관하는 응답 수: 기간 안의 응답은 버리지 않으므로 기간 x 서버 전체 변경 요청 처리량(초당 약 200건) 보다 크게.
+// 그래도 가득 차면 새 요청을 RESP_BUSY 로 거절 (기간 안의 응답을 버리면 그 요청의 재전송이 한 번 더 실행됨)
+#define DEDUP_CAPACITY      65536
+#define DEDUP_WAIT_MS       5000    // 같은 요청이 아직 처리 중이면 결과를 기다리는 최대 시간
+
+enum { DEDUP_NEW, DEDUP_HIT };
+
+// DEDUP_NEW: 처음 온 요청 -> 실행 후 반드시 dedup_complete 또는 dedup_abort
+// DEDUP_HIT: 보관된 응답을 code/out_p/msg 에 채움 (처리 중이던 같은 요청은 끝날 때까지 기다림)
+//            표가 기간 안의 요청으로 가득 차 넣을 수 없으면 RESP_BUSY (실행하지 않음)
+int dedup_begin(uint32_t cid, uint32_t rid, uint32_t cmd, int* code, int* out_p, char* msg, size_t size);
+void dedup_complete(uint32_t cid, uint32_t rid, int code, int out_p, const char* msg);
+void dedup_abort(uint32_t cid, uint32_t rid);     // 실행하지 않은 요청 (혼잡 거절 등) - 재시도하면 새로 실행
+
+// 관리자 콘솔 출력용 통계
+void print_dedup_stats(void);
+
+#endif // DEDUP_H
@@ -0,0 +1,61 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <time.h>
+#include <limits.h>
+#include <stddef.h>
+#include "store.h"
+
+#define SNAPSHOT_EVERY 1000   // 매장별 레코드 N건마다 스냅샷 보관
+#define SNAPSHOT_KEEP  24     // 보관하는 최근 스냅샷 수 (그보다 오래된 스냅샷과 그 앞의 이력은 지움)
+
+// [이력 기록] list_mutex 보유 상태에서 호출
+void history_open(Store* st);
+void history_append(Store* st, uint64_t lsn, time_t vt, char op, const char* args);
+void history_batch(Store* st, int on);    // 켜 둔 동안은 레코드마다 I/O 스레드를 깨우지 않고 끌 때 한 번에 (대량 R + A)
+// 파일은 iobackend.c 로 쓰므로 반환 시점에는 아직 I/O 스레드 버퍼에 있을 수 있음
+long history_size(Store* st);             // 논리 크기 = 다음 레코드의 파일 위치 (이력 파일이 없으면 -1)
+void history_sync(Store* st);             // 지금까지 남긴 레코드가 파일에 쓰일 때까지 대기 (list_mutex 불필요)
+void history_close(Store* st);            // 남은 레코드를 쓰고 닫음 (벤치/종료용)
+
+// [스냅샷/재생] 락 없이 파일만 다룸 (compact.c 의 압축 스레드, 시점 조회, DB 적재에서 사용)
+// "oper_db_gangnam.txt" + ".history" -> "oper_db_gangnam.history"
+void make_history_path(const Store* st, const char* suffix, char* out, size_t size);
+// 스냅샷 목록에 "오프셋 가상시각 파일명" 한 줄 추가 (스냅샷 파일을 다 쓴 뒤 호출)
+void history_add_snapshot(Store* st, long offset, time_t vt, const char* path);
+// 보관 정책: 최근 SNAPSHOT_KEEP 개보다 오래된 스냅샷을 지우고 가장 오래 남은 스냅샷 앞의 이력 공간을 돌려줌 (압축 스레드)
+void history_prune(Store* st);
+long history_pruned(Store* st);           // 지운 이력의 끝 위치 (이 앞으로는 재생할 수 없음, 지운 적 없으면 0)
+// 가장 최근 스냅샷을 dst 에 읽음 (반환: 그 스냅샷의 이력 위치, 없거나 못 읽으면 -1)
+long history_load_latest(Store* st, Store* dst);
+// st 의 이력 파일을 offset 부터 가상 시각 until 까지 dst 에 재생 (반환: 적용한 레코드 수)
+long history_replay(Store* st, Store* dst, long offset, time_t until);
+// 적재용: offset 부터 끝까지 st 에 재생하고, 기록 도중 멈춰 닫히지 않은 묶음이 있으면 취소 레코드를 덧붙임
+long history_recover(Store* st, long offset);
+
+// [묶음 레코드] B 와 K 사이의 레코드는 재생/복제에서 K 를 만나야 한꺼번에 반영됩니다 (U 를 만나거나 K 없이 끝나면 버림).
+// 한 묶음은 list_mutex 를 쥔 채 이어서 남기므로 매장 이력 안에서 끼어드는 레코드가 없습니다.
+typedef struct HistoryGroup HistoryGroup;
+// 레코드 1건을 묶음 규칙에 따라 dst 에 적용 (*g 는 열린 묶음, 없으면 NULL). 반환: 이번에 적용한 레코드 수
+long history_group_apply(Store* dst, HistoryGroup** g, char op, const char* args);
+void history_group_free(HistoryGroup** g);
+#define HISTORY_UNTIL_END ((time_t)LONG_MAX)
+
+// [시점 조회] 라이브 매장의 락을 잡지 않고 스냅샷 + 이력 재생으로 과거 상태를 재구성
+// 결과는 history_free_shadow 로 해제. 보관 기간 이전 시점이면 NULL 에 *too_old = 1
+Store* history_build_asof(Store* st, time_t t, int* too_old);
+// 지난 압축본(DB 파일) + 이력을 파일 위치 end 앞까지 재생한 사본 (압축 스레드용, 압축본에 이력 위치가 없으면 NULL)
+Store* history_build_at(Store* st, long end);
+void history_free_shadow(Store* shadow);
+
+void make_asof_summary(Store* st, time_t t, char* out, int mode);
+int make_asof_detail(Store* st, time_t t, char* out, const char* name, int page, int mode);
+
+// [시점 복원] 라이브 매장을 t 시점 상태로 되돌림 (복원 자체도 이력에 남아 되돌릴 수 있음)
+void restore_store_to(Store* st, time_t t, char* msg);
+
+// "YYYY-MM-DD HH:MM[:SS]" -> time_t (성공 1)
+int parse_time_str(const char* str, time_t* out);
+
+#endif // HISTORY_H
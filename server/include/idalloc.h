@@ -0,0 +1,28 @@
+#ifndef IDALLOC_H
+#define IDALLOC_H
+
+#include <stdint.h>
+#include "store.h"
+
+#define CMD_ID_LEASE        29    // 클라이언트 -> 서버: 상품 번호 구간 임대 "수량" (응답 "첫 번호\t끝 번호")
+#define ID_LEASE_MAX        100000
+#define ID_RESERVE_BLOCK    65536 // 발급 한도를 파일에 기록할 때 미리 잡아 두는 폭 (기록은 이 폭마다 한 번)
+#define ID_NUMBER_MAX       99999999999999999ULL    // 17자리: "X_" + 번호 + '\0' 이 상품 ID 칸(20바이트)에 들어가는 최대 번호
+
+enum { ID_TAKE_EXHAUSTED = -1, ID_TAKE_FAILED = 0, ID_TAKE_OK = 1 };
+
+// [상품 ID 발급] ID 는 "분류 접두어_번호" (예: A_0012). 번호는 분류와 관계없이 매장마다 하나인 64비트 일련번호이고,
+// 발급 한도(high-water mark)를 "<DB 이름>.ids" 에 먼저 기록한 뒤 그 아래 번호만 내주므로 다시 시작해도 번호가 겹치지 않습니다.
+// 단말기/대량 입고 도구는 CMD_ID_LEASE 로 구간을 한 번에 받아 ID 를 직접 만들고 단일 입고(cmd 1)로 보냅니다.
+// 모두 list_mutex 보유 상태에서 호출
+int idalloc_load(Store* st);                                // load_data 시작 때: 한도 파일을 읽음 (없으면 0 -> DB 의 ID 를 훑어 맞춤)
+int idalloc_take(Store* st, uint64_t n, uint64_t* first);   // 연속 번호 n 개 발급 (한도 기록 실패 ID_TAKE_FAILED, ID_NUMBER_MAX 초과 ID_TAKE_EXHAUSTED)
+const char* idalloc_error(int r);                           // idalloc_take 실패 사유 안내문
+void idalloc_observe(Store* st, const char* id);            // 이력 재생/예전 DB 의 ID 번호는 다시 발급하지 않음
+// 직접 입고(cmd 1)의 ID 검사: 번호 형식이면 이미 발급한 번호(임대/대량 입고)여야 함 (번호 형식이 아니면 1)
+// 발급하지 않은 큰 번호를 받아 주면 다음 번호가 그 뒤로 밀려 한 건으로도 발급이 영영 소진될 수 있음
+int idalloc_issued(Store* st, const char* id);
+uint64_t id_number(const char* id);                         // "X_123" -> 123, 형식이 다르면 0
+void handle_id_lease(Store* st, uint32_t cid, char* pin, char* msg);
+
+#endif // IDALLOC_H
@@ -1,29 +1,72 @@
 #ifndef INVENTORY_H
 #define INVENTORY_H
 
+#include <stdio.h>
 #include <stdint.h>
 #include <time.h>
+#include "store.h"
 
-// 시스템 초기화 및 DB 관리
-void init_inventory(void);
-void load_data(void);
-void save_data(void);
-void free_all_resources(void);
-void clear_inventory_db(void);
+#define CMD_CART_RELEASE 23         // 장바구니 예약 해제 (payload "" = 전체, "상품명" = 해당 분류)
+#define HOLD_TTL (15 * 60)          // 장바구니 예약 유지 시간 (가상 시간 초, 예약 요청마다 장바구니 전체 연장)
+
+// 시스템 초기화 및 DB 관리 (모든 API는 대상 매장 파티션을 받습니다)
+void init_inventory(Store* st);
+void load_data(Store* st);
+void save_data(Store* st);
+void free_all_resources(Store* st);
+void clear_inventory_db(Store* st);
 
 // 비즈니스 로직 API (네트워크 계층에서 호출)
-void handle_single_import(uint32_t cid, char* pin, char* msg);
-void handle_random_import(uint32_t cid, char* pin, char* msg);
-void handle_sell(uint32_t cid, char* pin, char* msg);
-void handle_cart_verify(char* pin, char* msg);
-void handle_delete_operations(uint32_t cmd, uint32_t cid, char* pin, char* msg);
+void handle_single_import(Store* st, uint32_t cid, char* pin, char* msg);
+void handle_random_import(Store* st, uint32_t cid, char* pin, char* msg);
+// 장바구니 예약은 서버가 정한 예약 주인(owner, session.h)으로 묶음. cid 는 로그 표시용
+void handle_sell(Store* st, uint32_t cid, uint32_t owner, char* pin, char* msg);
+int handle_offline_sync(Store* st, uint32_t cid, char* pin, char* msg);    // CMD_OFFLINE_SYNC, 반환: 충돌 줄 수
+int handle_cart_hold(Store* st, uint32_t owner, char* pin, char* msg);     // cmd 17, 반환: 예약된 수량
+void handle_cart_release(Store* st, uint32_t owner, const char* pin, char* msg);
+int list_cart_holds(Store* st, uint32_t owner, char* out, size_t size);   // 재접속 이어받기용 "상품명\t수량\n..."
+void handle_delete_operations(Store* st, uint32_t cmd, uint32_t cid, char* pin, char* msg);     // 단일 삭제 6/8
+
+// 일괄 삭제 5/12/13 을 조각으로 나눠 실행 (bulkjob.c 의 작업 스레드에서 호출, 락은 각 함수가 잡음)
+typedef struct BulkDelete BulkDelete;
+BulkDelete* bulk_delete_begin(Store* st, uint32_t cmd, uint32_t cid, const char* name);    // 메모리 부족 NULL
+// 최대 budget 개를 처리하고 진행 상황을 채움 (반환: 1 = 끝). total 은 첫 조각 때 센 대상 수 (근사치)
+int bulk_delete_step(BulkDelete* d, int budget, long* deleted, long* done, long* total);
+int bulk_delete_log(BulkDelete* d, int budget);     // 삭제가 끝난 뒤: 지운 ID 를 최대 budget 개씩 D 묶음으로 기록 (다 기록했으면 1)
+void bulk_delete_end(BulkDelete* d, char* msg, size_t size);   // 기록이 끝난 뒤: DB 저장 + 이벤트 기록, 결과 문구를 msg 에 (d 해제)
+int bulk_delete_holds(Store* st, const char* id);   // 진행 중인 일괄 삭제가 지웠지만 아직 기록하지 않은 ID (list_mutex 보유)
+
+// 상품 분류 (r_types 순서, 분류표에 없으면 -1)
+int category_of(const char* name);
+const char* category_name(int idx);
 
 // 조회 및 포맷팅 로직
-void make_category_summary(char* out, int mode, const char* title);
-int make_detail_page(char* out, const char* name, int page, int mode);
+void make_category_summary(Store* st, char* out, int mode, const char* title);
+void make_menu_snapshot(Store* st, char* out);
+void count_categories(Store* st, int* avail, int* expired);   // 분류별 판매 가능/만료 수량 (push.c)
+int make_detail_page(Store* st, char* out, const char* name, int page, int mode);
+void make_stock_value(Store* st, char* out);                            // CMD_STOCK_VALUE
+int make_lot_page(Store* st, char* out, const char* lot, int page);     // CMD_LOT_ITEMS, 반환: 전체 페이지 수
 
 // 만료 모니터링 API
-int check_and_update_expirations(time_t current_vt);
-void recover_missed_expirations(time_t current_vt);
+int check_and_update_expirations(Store* st, time_t current_vt);
+void recover_missed_expirations(Store* st, time_t current_vt);
+
+// [압축용 행 복사] list_mutex 보유 상태에서 호출. 목록 순서대로 복사한 배열(호출자가 free)
+// 부가 정보가 있는 행은 extra 가 *extras 버퍼(호출자가 free) 안의 줄 꼬리 위치 (-1 = 없음)
+typedef struct { char id[20]; char name[50]; long expire_time; int is_expired; long extra; } ProductRow;
+ProductRow* copy_product_rows(Store* st, long* count, char** extras);
+
+// 복제 API (replication.c 에서 호출)
+char* dump_store_snapshot(Store* st, uint64_t* out_lsn);   // 반환 버퍼는 호출자가 free
+int apply_journal_record(Store* st, uint64_t lsn, time_t vt, char op, const char* args);
+
+// 이력/스냅샷 API (history.c 에서 호출, list_mutex 보유 상태 또는 비공유 매장)
+// DB/스냅샷 파일을 병렬로 읽어 목록 앞에 추가 (반환: 읽은 개수, 파일이 없으면 -1).
+// with_index 이고 매장이 비어 있으면 재고 색인도 함께 만듦. history_offset 에는 머리말의 이력 위치(없으면 -1)
+long read_products_file(Store* st, const char* path, int with_index, long* history_offset);
+void apply_history_record(Store* st, char op, const char* args);
+void replace_products(Store* dst, Store* src);
+void journal_all_products(Store* st);
 
-#endif // INVENTORY_H
\ No newline at end of file
+#endif // INVENTORY_H
@@ -0,0 +1,45 @@
+#ifndef IOBACKEND_H
+#define IOBACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define IO_BUF_SIZE     (32 * 1024)   // 스테이징 버퍼 하나 (io_uring 에 등록)
+#define IO_BUFS         128           // 스테이징 버퍼 수 (모자라면 쓰는 쪽이 빌 때까지 대기)
+#define IO_QUEUE_DEPTH  64            // io_uring 제출 큐 길이 (한 번의 io_uring_enter 로 넘기는 최대 쓰기 수)
+
+enum {
+    IO_BACKEND_SYNC,        // io_init 전 (벤치/도구): 부른 스레드에서 바로 pwrite
+    IO_BACKEND_PWRITE,      // I/O 스레드가 pwrite
+    IO_BACKEND_URING        // I/O 스레드가 모아서 io_uring 으로 한 번에 제출 (등록 버퍼는 WRITE_FIXED)
+};
+
+enum { IO_APPEND, IO_CREATE };      // io_open: 끝에 이어 쓰기 / 비우고 새로
+
+// [저장 I/O 백엔드]
+// 이력/로그/설정/스냅샷 파일 쓰기는 스테이징 버퍼에 복사만 하고 돌아옵니다. 커널에 쓰는 일은 I/O 스레드가
+// 모아서 하므로 요청 스레드는 저장 장치 때문에 커널에서 멈추지 않습니다 (버퍼가 모두 쓰기 중일 때만 대기).
+// 파일마다 논리 크기를 따로 세고 위치 지정 쓰기를 하므로 한 묶음 안의 쓰기는 순서 없이 끝나도 됩니다.
+typedef struct IoFile IoFile;
+
+int io_init(int backend);           // I/O 스레드 시작. io_uring 을 쓸 수 없으면 pwrite 로 (반환: 실제 백엔드)
+int io_backend(void);
+const char* io_backend_name(void);
+
+IoFile* io_open(const char* path, int mode);            // 실패 NULL
+void io_append(IoFile* f, const void* data, size_t len); // 버퍼에 복사 (가득 찬 버퍼는 바로 I/O 스레드로)
+void io_write_ref(IoFile* f, const void* data, size_t len); // 복사 없이 data 를 그대로 씀 (io_drain 전까지 data 유지)
+void io_replace(IoFile* f, const void* data, size_t len);   // 파일 앞부분을 data 로 덮어씀 (길이가 줄면 호출자가 채움)
+void io_submit(IoFile* f);          // 모으는 중인 내용을 곧 쓰도록 I/O 스레드를 깨움 (기다리지 않음)
+void io_drain(IoFile* f);           // 지금까지 넣은 내용이 파일에 다 쓰일 때까지 대기 (읽기 전/압축 스레드)
+int io_fsync(IoFile* f);            // io_drain + fsync (실패한 쓰기가 있었으면 0)
+off_t io_size(IoFile* f);           // 논리 크기 (아직 쓰지 않은 것 포함)
+void io_truncate(IoFile* f);        // io_drain 후 길이 0 으로
+void io_close(IoFile* f);           // 남은 내용을 다 쓴 뒤 I/O 스레드가 닫음 (이후 f 사용 금지)
+void io_flush_all(void);            // 종료 시: 넘긴 모든 내용이 쓰일 때까지 대기
+
+// 벤치/통계: 커널에 넘긴 쓰기 수, 제출 횟수 (io_uring_enter 또는 pwrite 묶음)
+void io_counters(uint64_t* writes, uint64_t* batches);
+
+#endif // IOBACKEND_H
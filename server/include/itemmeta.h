@@ -0,0 +1,48 @@
+#ifndef ITEMMETA_H
+#define ITEMMETA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "store.h"
+
+#define CMD_STOCK_VALUE     26    // 분류별 재고 금액 (payload "")
+#define CMD_LOT_ITEMS       27    // 로트 번호로 상품 조회 "로트|페이지"
+
+#define META_TEXT_LEN       24    // 로트/공급사/진열 위치 최대 23바이트 (공백, '|' 불가)
+#define META_PRICE_SCALE    100   // 가격은 1/100 원 단위 고정소수점 ("1500.50" -> 150050)
+#define META_NO_PRICE       (-1)
+#define META_DICT_MAX       65535 // 매장별 로트/공급사/진열 위치 종류 수 상한 (2바이트 코드)
+#define META_LINE_LEN       96    // meta_format 결과 최대 길이 (NUL 포함)
+
+// [상품 부가 정보] 입력/출력용으로 풀어 둔 형태. 매장 안에서는 열 단위로 압축 보관됩니다
+typedef struct {
+    int32_t price;                  // META_NO_PRICE = 없음
+    char lot[META_TEXT_LEN];        // "" = 없음
+    char supplier[META_TEXT_LEN];
+    char shelf[META_TEXT_LEN];
+} ItemMeta;
+
+// 각 값은 NULL, "", "-" 이면 없음. 형식이 틀리면 0 (가격 음수/초과, 너무 긴 글자, 공백/'|' 포함)
+int meta_parse(const char* price, const char* lot, const char* supplier, const char* shelf, ItemMeta* out);
+int meta_is_empty(const ItemMeta* m);
+// DB/저널 줄 뒤에 붙는 " 가격 로트 공급사 위치" (없는 값은 "-"). 부가 정보가 없으면 ""
+void meta_format(const ItemMeta* m, char* out, size_t size);
+void meta_format_price(int32_t price, char* out, size_t size);     // "1500" / "1500.50"
+
+// [매장별 열 저장소] list_mutex 보유 상태에서 호출. 슬롯 0 = 부가 정보 없음
+uint32_t meta_store(Store* st, const ItemMeta* m, int category, void* owner);   // 실패하면 0
+void meta_get(Store* st, uint32_t slot, ItemMeta* out);
+void meta_drop(Store* st, uint32_t slot);
+void meta_mark_expired(Store* st, uint32_t slot);
+void meta_set_owner(Store* st, uint32_t slot, void* owner);     // 상품이 옮겨질 때 (만료 보관소)
+void meta_reset(Store* st);                     // 매장 비움 (열과 사전 모두 해제)
+void meta_move(Store* dst, Store* src);         // 목록을 통째로 옮길 때 열 저장소도 함께 (dst 의 것은 해제)
+size_t meta_bytes(Store* st);                   // 열 저장소 메모리 사용량
+
+// [조회] 열만 훑으므로 상품 목록을 따라가지 않음
+void meta_stock_value(Store* st, int64_t* value, long* priced);  // 분류별 판매 가능(만료 아님) 재고 금액 합/가격 있는 개수
+// 로트가 lot 인 상품 중 skip 개를 건너뛴 뒤 최대 max 개의 owner 를 채움 (반환: 전체 개수)
+// expired[i] 가 1 이면 owner 는 만료 보관소 항목 (coldtier.h), 아니면 판매 목록의 상품
+long meta_find_lot(Store* st, const char* lot, long skip, void** owners, int* expired, long max);
+
+#endif // ITEMMETA_H
@@ -0,0 +1,39 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "store.h"
+
+#define JOURNAL_RING 16384
+#define JOURNAL_LINE 256
+
+// [변경 저널 레코드 형식] "<lsn> <가상시각> <op> <매장ID|-> <인자...>"
+//  A id name expire is_expired : 상품 추가
+//  D id                        : 상품 삭제
+//  X id                        : 만료 표시
+//  C                           : 매장 전체 비움
+//  R                           : 스냅샷 시작 (뒤따르는 레코드로 매장을 재구성)
+//  F                           : 전체 동기화 시작 (링에는 들어가지 않음)
+//  S id name expire is_expired : 전체 동기화 전용 스냅샷 항목 (링에는 들어가지 않음)
+//  O tag seq                   : 오프라인 판매 원장 - 단말기 태그가 seq 번 판매까지 반영됨
+//  B / K / U                   : 묶음 시작 / 확정 / 취소 (B~K 사이 레코드는 K 에서 한꺼번에 반영, history.h)
+
+// 변경 1건 기록 (매장의 list_mutex 보유 상태에서 호출) -> 부여된 LSN 반환
+uint64_t journal_append(Store* st, char op, const char* args);
+
+// 복제본이 주 서버의 LSN을 그대로 이어받아 기록할 때 사용
+void journal_append_raw(uint64_t lsn, const char* line);
+
+uint64_t journal_current_lsn(void);
+
+// after_lsn 바로 다음 레코드를 out 에 복사 (1: 성공, 0: 아직 없음, -1: 링에서 밀려남)
+int journal_read_next(uint64_t after_lsn, char* out, size_t size);
+
+// 새 레코드가 생기거나 timeout_ms 가 지날 때까지 대기
+void journal_wait(uint64_t after_lsn, int timeout_ms);
+
+// 매장 ID 인코딩 ("" <-> "-")
+const char* journal_store_token(const Store* st);
+
+#endif // JOURNAL_H
@@ -0,0 +1,52 @@
+#ifndef LOGEVENT_H
+#define LOGEVENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// [로그 이벤트 종류] 파일에 숫자로 저장되므로 기존 값의 순서를 바꾸지 말고 뒤에만 추가
+enum {
+    EV_TEXT = 0,            // 자유 형식 메시지 (text = 본문)
+    EV_IMPORT,              // 단일입고 (pos, category, text = 상품 ID)
+    EV_RANDOM_IMPORT,       // 랜덤입고 (pos, qty)
+    EV_SELL,                // 판매 (pos, category, qty = 판매 수량, aux = 요청 수량)
+    EV_DELETE_EXPIRED,      // 만료 일괄 폐기 (pos, qty)
+    EV_DELETE_ONE,          // 단일삭제 (pos, category, text = 상품 ID)
+    EV_DELETE_KIND,         // 종류삭제 (pos, category, qty)
+    EV_DELETE_KIND_EXPIRED, // 종류 중 만료삭제 (pos, category, qty)
+    EV_EXPIRE,              // 만료 발생 (category)
+    EV_EXPIRE_RECOVERED,    // 재시작 복구 만료 (category, aux = 원래 만료 시각이 vt 보다 몇 초 전인지)
+    EV_CLEAR,               // 창고 비움 (pos)
+    EV_CONNECT,             // 단말기 접속 (pos, text = IP)
+    EV_DISCONNECT,          // 단말기 종료 (pos)
+    EV_DROPPED,             // 단말기 연결 끊김 - 예약/세션 유지 (pos, aux = 1 이면 응답 없음 시간 초과)
+    EV_RESUME,              // 재접속 세션 이어받음 (pos, qty = 예약 품목 수)
+    EV_OFFLINE_SYNC,        // 오프라인 판매 동기화 (pos, qty = 반영한 판매 건수, aux = 충돌 줄 수, text = 단말기 태그)
+    EV_TYPE_COUNT
+};
+
+#define EV_NO_CATEGORY 0xFF     // 분류표에 없는 상품명 -> text 에 상품명
+
+// [이진 로그 레코드] 24바이트 헤더 + text_len 바이트 본문(NUL 없음)
+// 시각 문자열과 한국어 문장은 저장하지 않고, 대시보드/로그 브라우저/검색/내보내기에서만 렌더링합니다.
+typedef struct {
+    int64_t vt;
+    uint32_t pos;
+    int32_t qty;
+    int32_t aux;
+    uint16_t text_len;
+    uint8_t type;
+    uint8_t category;
+} LogEvent;
+
+#define LOG_TEXT_MAX 800            // 기존 텍스트 로그의 %.800s 제한과 동일
+#define LOG_EVENT_MAX (sizeof(LogEvent) + LOG_TEXT_MAX)
+
+// 헤더 + 본문을 buf 에 이어 붙임 -> 레코드 길이 (본문은 LOG_TEXT_MAX 바이트까지)
+size_t logevent_encode(char* buf, int type, time_t vt, uint32_t pos, int category, int qty, int aux, const char* text);
+
+// 레코드를 "[YYYY-MM-DD HH:MM:SS] <tag> 메시지" 한 줄로 렌더링 (tag 가 NULL 이면 생략) -> 길이
+int logevent_render(const char* rec, size_t len, const char* tag, char* out, size_t size);
+
+#endif // LOGEVENT_H
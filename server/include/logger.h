@@ -1,12 +1,19 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <stdint.h>
 #include <time.h>
+#include "store.h"
+#include "logevent.h"
 
 // 로그 관리
 void load_persistent_logs(void);
 void clear_persistent_logs(void);
-void update_log(const char* msg);
+void flush_logs(void);                               // 모아 둔 로그 레코드를 I/O 스레드에 넘김 (모니터 스레드가 주기적으로 호출, 기다리지 않음)
+void log_event(Store* st, int type, uint32_t pos, int category, int qty, int aux, const char* text); // 구조화 이벤트 (logevent.h 의 EV_*)
+void update_log(const char* msg);                    // 시스템/기본 매장 로그
+void update_store_log(Store* st, const char* msg);  // 매장 파티션별 로그
+int read_recent_logs(char* out, size_t size, int n); // 최근 n줄을 줄바꿈으로 이어 복사 (락 없음)
 
 // UI 관리
 void draw_dashboard(const char* time_str);
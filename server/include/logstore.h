@@ -0,0 +1,28 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <stddef.h>
+#include <time.h>
+
+#define LOG_SEGMENT_SIZE (4 * 1024 * 1024)   // 활성 세그먼트가 이 크기를 넘으면 교체
+#define LOG_INDEX_EVERY 64                    // 희소 인덱스: N건마다 (가상시각, 세그먼트, 오프셋) 1건
+
+// [세그먼트 로그 파일]
+// 활성 세그먼트는 원래 파일명(oper_server.log)을 그대로 쓰고, 교체된 세그먼트는
+// "<파일명>.<번호>", 인덱스는 "<파일명>.idx" 에 "가상시각 세그먼트번호 오프셋" 으로 남깁니다.
+typedef struct LogFile LogFile;
+
+LogFile* logstore_open(const char* path);
+void logstore_append(LogFile* lf, time_t vt, const char* rec, size_t len);    // rec: 이진 이벤트 레코드 1건
+void logstore_clear(LogFile* lf);                                            // 모든 세그먼트와 인덱스 삭제
+void logstore_flush(LogFile* lf);                                            // 쌓인 레코드를 곧 쓰도록 I/O 스레드에 넘김 (기다리지 않음)
+void logstore_sync(LogFile* lf);                                             // 쌓인 레코드가 파일에 쓰일 때까지 대기 (읽기 전)
+void logstore_close(LogFile* lf);
+
+// 마지막 max_lines 건만 읽어 콜백으로 전달 (파일 전체를 읽지 않음)
+int logstore_load_tail(const char* path, int max_lines, void (*cb)(const char* rec, size_t len, void* ctx), void* ctx);
+
+// [from, to] 구간의 레코드를 인덱스로 찾아가 순서대로 콜백에 전달 (콜백이 0 을 반환하면 중단) -> 전달한 건수
+int logstore_scan(const char* path, time_t from, time_t to, int (*cb)(const char* rec, size_t len, void* ctx), void* ctx);
+
+#endif // LOGSTORE_H
@@ -0,0 +1,22 @@
+#ifndef OFFLINE_H
+#define OFFLINE_H
+
+#include <stdint.h>
+#include "store.h"
+
+#define CMD_OFFLINE_SYNC    28    // 클라이언트 -> 서버: 오프라인 판매 일괄 반영 "단말기태그\n판매번호\t상품명\t수량\n..."
+                                  // 응답 "적용된 마지막 판매번호\n판매번호\t상품명\t요청\t판매\n..." (페이지 필드 = 충돌 줄 수)
+#define OFFLINE_TAG_LEN     16    // 단말기 태그: 16진수 1~16글자 (단말기가 처음 오프라인 저널을 만들 때 정함)
+
+// [오프라인 판매 원장] 단말기 태그마다 마지막으로 적용한 판매번호를 기억해, 같은 판매를 다시 보내도 한 번만 반영합니다.
+// 단말기는 판매번호 순서대로 보내므로 번호 하나(최대값)만 두면 됩니다. list_mutex 보유 상태에서 호출
+int offline_valid_tag(const char* tag);
+uint64_t offline_applied(Store* st, const char* tag);         // 없으면 0
+void offline_mark(Store* st, const char* tag, uint64_t seq);  // 메모리 갱신 + O 레코드 (판매의 D 들과 같은 묶음 안에서)
+void offline_apply(Store* st, const char* args);              // 재생/복제: O 레코드 인자 "태그 번호" 반영 (저널에 남기지 않음)
+// 압축 시점 원장 파일 ("<DB>.offline", 한 줄에 "태그 번호")
+void offline_load(Store* st, const char* path);               // 파일이 없으면 그대로
+char* offline_dump(Store* st, const char* prefix, size_t* len);  // 줄마다 prefix 를 붙인 사본 (호출자가 free, 비었으면 NULL)
+void offline_free(Store* st);
+
+#endif // OFFLINE_H
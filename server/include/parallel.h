@@ -0,0 +1,16 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#define PARALLEL_MAX_THREADS 8
+
+// 이 기계에서 쓸 작업 스레드 수 (온라인 CPU 수, 1 ~ PARALLEL_MAX_THREADS)
+int parallel_threads(void);
+void parallel_set_threads(int n);   // 스레드 수 고정 (벤치마크용, 0 = CPU 수로 되돌림)
+
+// [분할 작업 실행] fn(args + i * stride) 를 i = 0..n-1 (n <= PARALLEL_MAX_THREADS) 각각 별도 스레드에서 실행하고 모두 끝날 때까지 기다림.
+// 스레드를 만들지 못한 몫은 호출한 스레드가 직접 실행하므로 결과는 항상 n 개 모두 채워짐
+void parallel_run(int n, void* (*fn)(void*), void* args, size_t stride);
+
+#endif // PARALLEL_H
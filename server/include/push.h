@@ -0,0 +1,72 @@
+#ifndef PUSH_H
+#define PUSH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "store.h"
+
+#define CMD_MENU_SNAPSHOT   20    // 클라이언트 -> 서버: 판매 가능 수량 스냅샷 요청 (응답 "버전\n상품명\t판매 가능\t예약\n...")
+#define CMD_SUBSCRIBE       21    // 클라이언트 -> 서버: 현재 매장 재고 버전 변경 알림 구독 (응답 "현재 버전")
+#define CMD_WATCH           22    // 클라이언트 -> 서버: 분류별 이벤트 구독 "분류명|마스크|임계값" (분류명 "*" = 전체, 마스크 0 = 해제)
+
+#define PUSH_INVALIDATE     300   // 서버 -> 클라이언트: payload "새 버전" (캐시 무효화)
+#define PUSH_LOW_STOCK      301   // payload "분류명|남은 수량" (임계값 미만으로 내려감)
+#define PUSH_EXPIRED        302   // payload "분류명|새로 만료된 수량"
+#define PUSH_SOLD_OUT       303   // payload "분류명" (판매 가능 수량 0)
+
+#define WATCH_LOW_STOCK     1
+#define WATCH_EXPIRED       2
+#define WATCH_SOLD_OUT      4
+#define WATCH_ALL           7
+
+// 구독자별 대기 큐 길이. 같은 (종류, 분류) 이벤트는 큐 안에서 최신 값으로 합치고,
+// 가득 차면 큐를 비우고 캐시 무효화 1건으로 대체합니다 (클라이언트는 스냅샷을 다시 받음).
+#define PUSH_QUEUE_LEN      32
+
+typedef struct {
+    uint16_t code;
+    int8_t category;                // PUSH_INVALIDATE 는 -1
+    uint64_t value;                 // 버전 또는 수량
+} PushEvent;
+
+// [클라이언트 연결] 응답과 푸시가 같은 소켓을 쓰므로 송신은 send_mutex 로 직렬화
+typedef struct Conn {
+    int sock;
+    Store* st;                      // 구독 대상 매장 (cmd 99 로 바뀔 수 있음)
+    int subscribed;
+    uint64_t pushed_version;        // 마지막으로 알린 버전 (팬아웃 스레드 전용)
+
+    // 분류별 구독 (conns_mutex 보호)
+    int watching;
+    uint8_t watch_mask[NUM_CATEGORIES];
+    int watch_threshold[NUM_CATEGORIES];
+
+    // 푸시 대기 큐와 보내다 만 프레임 (send_mutex 보호, 전송은 논블로킹)
+    PushEvent queue[PUSH_QUEUE_LEN];
+    int q_head, q_len;
+    char out[96];
+    size_t out_len, out_off;
+    int broken;                     // 송신 오류 - 이후 푸시는 버림
+    unsigned long pushed, dropped;
+    unsigned long skipped;          // 송신 중이라 건너뛴 회차의 분류 이벤트 수 (conns_mutex 보호)
+
+    pthread_mutex_t send_mutex;
+    struct Conn* next;
+} Conn;
+
+void init_push(void);                       // 팬아웃 스레드 시작
+Conn* conn_register(int sock);
+void conn_unregister(Conn* c);
+int conn_send(Conn* c, uint32_t cid, uint32_t code, const char* payload, size_t len);
+void conn_subscribe(Conn* c, Store* st);
+int conn_watch(Conn* c, Store* st, const char* spec, char* msg, size_t size);   // 성공 0, 형식 오류 -1 (msg 에 응답)
+
+// 매장 재고가 바뀌었음을 알림 (저널 기록/복제 적용/장바구니 예약에서 list_mutex 보유 상태로 호출, 전송은 팬아웃 스레드가 수행)
+void store_changed(Store* st);
+uint64_t store_version(Store* st);
+
+// 관리자 콘솔 출력용 구독자 통계
+void print_push_stats(void);
+
+#endif // PUSH_H
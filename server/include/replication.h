@@ -0,0 +1,27 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stdint.h>
+
+// [복제 프로토콜 코드]
+#define REPL_SUBSCRIBE      98    // 복제본 -> 주 서버: payload "epoch|마지막 LSN"
+#define REPL_FRAME_RECORD   210   // 주 서버 -> 복제본: 저널 레코드 1줄
+#define REPL_FRAME_EPOCH    212   // 주 서버 세대 번호 (재시작 감지용)
+#define REPL_FRAME_HEARTBEAT 213  // 유휴 상태 생존 신호
+#define REPL_FRAME_STREAM   214   // 전체 동기화 종료, 이후 레코드는 이 LSN 다음부터
+
+// 역할 조회 및 전환
+int is_replica(void);
+void set_replica_source(const char* host, int port); // 복제본 역할 지정 (DB 로드 전에 호출)
+void start_replica(void);                         // 주 서버 저널 수신 스레드 시작
+void promote_replica(void);                       // 주 서버 승격 (관리자 콘솔 'promote')
+
+// 복제본이 처리해도 되는 읽기 전용 명령인지
+int is_read_only_cmd(uint32_t cmd);
+
+// 주 서버: cmd 98 을 받은 연결을 저널 스트리밍 전용으로 사용 (연결이 끊기면 반환)
+void serve_replication(int sock, const char* pin);
+
+void print_replication_status(void);
+
+#endif // REPLICATION_H
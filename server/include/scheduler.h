@@ -0,0 +1,50 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "store.h"
+
+#define SCHED_WORKERS 4
+
+// [작업 우선순위 등급] 값은 store.h 의 SCHED_CLASSES 와 맞춤
+enum {
+    SCHED_CRITICAL,         // 판매/결제/장바구니 예약 - 손님 응답 지연에 직결
+    SCHED_BULK,             // 입고/삭제 - 변경이지만 급하지 않음
+    SCHED_BACKGROUND        // 요약/상세/과거 시점 보고서 - 길고 미뤄도 됨
+};
+
+#define SCHED_YIELD_MAX_MS 20   // 긴 조회가 급한 작업에 락을 양보하고 기다리는 최대 시간
+
+// [요청 작업 단위]
+// 연결 스레드가 스택에 만들어 제출하고, 워커가 실행을 마치면 done 을 세웁니다.
+typedef struct Job {
+    Store* st;
+    uint32_t cid;
+    uint32_t owner;         // 장바구니 예약 주인 (session.h)
+    uint32_t cmd;
+    int cls;                // SCHED_CRITICAL / SCHED_BULK / SCHED_BACKGROUND
+    char* pin;
+    char* msg;
+    int out_p;
+    void (*run)(struct Job* job);
+
+    int done;
+    pthread_cond_t done_cond;
+    struct Job* next;
+} Job;
+
+// 공유 워커 풀 시작 (등급별 준비 큐를 가중치 라운드 로빈으로 돌며 처리)
+void init_scheduler(int n_workers);
+
+// 작업을 해당 매장/등급 큐에 넣고 처리 완료까지 대기
+void submit_and_wait(Job* job);
+
+// 긴 조회용: 이 매장에 급한 작업이 기다리는지, 있으면 끝날 때까지(최대 SCHED_YIELD_MAX_MS) 대기
+int sched_urgent_pending(Store* st);
+void sched_wait_urgent(Store* st);
+
+// 통계용: 매장의 등급별 대기 수와 처리 수를 sched_mutex 안에서 복사
+void sched_store_stats(Store* st, int q_len[SCHED_CLASSES], unsigned long* served);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,38 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdint.h>
+#include "store.h"
+
+#define CMD_SESSION         24    // 클라이언트 -> 서버: "" = 새 세션, "토큰" = 재접속 이어받기
+                                  // 응답 "토큰\n상품명\t예약 수량\n..." (페이지 필드 1 = 이어받음, 0 = 새 세션)
+                                  // 이후 이 연결의 장바구니 예약/판매/해제는 그 세션의 예약 주인으로 처리
+#define CMD_PING            25    // 클라이언트 -> 서버: 입력 대기 중 연결 유지 확인 (응답 "pong")
+
+// [연결 유지] 단말기는 CLIENT_HEARTBEAT_SEC 마다 CMD_PING 을 보내므로,
+// 그 몇 배 동안 아무것도 받지 못한 연결은 죽은 것으로 보고 정리합니다.
+#define CLIENT_IDLE_TIMEOUT_SEC 90
+#define TCP_KEEPALIVE_IDLE_SEC  30    // 커널 keepalive: 유휴 30초 후 10초 간격으로 3번 실패하면 끊김
+#define TCP_KEEPALIVE_INTVL_SEC 10
+#define TCP_KEEPALIVE_COUNT     3
+
+// 세션은 마지막 사용 후 이 시간(실제 초)이 지나면 이어받을 수 없음.
+// 장바구니 예약 TTL(HOLD_TTL)은 가상 시간이라 시뮬레이션 배속에서는 훨씬 먼저 끝날 수 있음:
+// 이어받기는 예약을 되살리지 않고, 응답에는 그 시점에 남아 있는 예약만 실림
+#define SESSION_RESUME_SEC      (15 * 60)
+#define SESSION_TOKEN_LEN       16
+
+// 단말기 소켓에 keepalive 와 유휴 수신 시간 제한 설정
+void tune_client_socket(int sock);
+
+// [예약 주인] 장바구니 예약과 단말기별 요청 한도는 단말기가 고른 cid 가 아니라 서버가 정한 주인 번호로 묶습니다.
+// 연결마다 새 번호로 시작하고, CMD_SESSION 으로 세션을 받거나 이어받으면 그 세션의 번호를 씁니다.
+uint32_t session_new_owner(void);
+// 토큰의 세션을 이어받을 수 있으면 그 주인 번호 (매장 일치, 시간 내, 아니면 0). 성공하면 사용 시각 갱신
+uint32_t session_resume(Store* st, const char* token);
+// 새 세션 발급 -> out 에 SESSION_TOKEN_LEN 글자 + NUL (반환: 새 주인 번호)
+uint32_t session_issue(Store* st, char* out);
+void session_touch(const char* token);  // 비정상 단절 시: 이어받기 시간을 이 시점부터 다시 셈
+void session_end(const char* token);    // 정상 종료(cmd 100) 시
+
+#endif // SESSION_H
@@ -0,0 +1,46 @@
+#ifndef SNAPFILE_H
+#define SNAPFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "inventory.h"
+
+// [압축 스냅샷 형식] DB 파일과 시점 조회용 스냅샷(.snap.*)을 이진 블록으로 저장합니다.
+// 파일: 매직 8바이트 + 이력 오프셋 + 블록 수, 그 뒤로 블록마다 (원래 길이, 압축 길이, 체크섬) 머리말과 본문.
+// 블록은 상품명이 같은 행을 유통기한 순으로 최대 SNAP_BLOCK_ROWS 개 묶은 것이고 다른 블록 없이 풀 수 있어
+// 적재할 때 블록을 스레드별로 나눠 병렬로 풉니다. 예전 텍스트 파일은 매직이 없으므로 그대로 읽힙니다.
+#define SNAP_MAGIC          "INVSNAP1"
+#define SNAP_MAGIC_LEN      8
+#define SNAP_BLOCK_ROWS     8192
+
+typedef struct {
+    size_t pos;                     // 파일 안 본문 위치
+    uint32_t raw_len, comp_len;     // comp_len 0 = 압축하지 않고 그대로 저장
+    uint32_t checksum;              // 풀어 낸 본문의 FNV-1a
+} SnapBlock;
+
+// 풀어 낸 행 하나 (name/extra 는 블록 버퍼를 가리키므로 콜백 안에서만 유효)
+typedef struct {
+    char id[20];
+    const char* name;
+    long expire_time;
+    int is_expired;
+    const char* extra;              // DB 줄 꼬리 " 가격 로트 공급사 위치" (없으면 "")
+    size_t extra_len;
+} SnapRow;
+
+// 행 배열 -> 파일 내용 전체 (호출자가 free, 실패 NULL). history_offset -1 = 없음. 블록 부호화는 병렬
+char* snap_encode(const ProductRow* rows, long n, const char* extras, long history_offset, size_t* out_len);
+
+// 읽기: 매직이 맞으면 1
+int snap_is_snapshot(const char* data, size_t len);
+// 블록 목록 (호출자가 free) -> 블록 수, 형식 오류 -1
+long snap_index(const char* data, size_t len, SnapBlock** blocks, long* history_offset);
+// 블록 하나를 풀어 행마다 콜백 -> 행 수, 손상 -1
+long snap_decode_block(const char* data, const SnapBlock* b, void (*row)(void* arg, const SnapRow* r), void* arg);
+
+// 블록 압축기 (LZ77 계열, 64KB 창). 압축 결과가 cap 을 넘으면 0
+size_t snap_lz_compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap);
+int snap_lz_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_len);   // 성공 1
+
+#endif // SNAPFILE_H
@@ -0,0 +1,105 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "trace.h"
+
+#define MAX_STORES 64
+#define STORE_ID_LEN 32
+#define NUM_CATEGORIES 10
+#define SCHED_CLASSES 3             // 작업 우선순위 등급 수 (scheduler.h)
+
+struct Product;
+struct Job;
+struct LogFile;
+struct StockIndex;
+struct MetaTable;
+struct ScanCursor;
+struct OfflineLedger;
+struct IdIndex;
+struct ColdTier;
+struct IoFile;
+struct HistoryGroup;
+
+// [매장 파티션 구조체]
+// 하나의 서버 프로세스가 여러 매장을 호스팅하며, 매장마다 재고/DB 파일/로그 파일이 독립적입니다.
+typedef struct Store {
+    char id[STORE_ID_LEN];          // "" = 기본 매장 (기존 단일 매장 파일 그대로 사용)
+    char db_filename[128];
+    char log_filename[128];
+    struct LogFile* log_file;       // 세그먼트 로그 (logger.c 가 처음 쓸 때 엶, 그 전엔 NULL)
+
+    struct Product* head;
+    struct StockIndex* stock_index; // 분류별 FEFO 힙 + 장바구니 예약 (inventory.c, 처음 판매/예약 때 생성)
+    struct MetaTable* meta;         // 가격/로트/공급사/진열 위치 열 저장소 (itemmeta.c, 처음 쓸 때 생성)
+    struct OfflineLedger* offline;  // 단말기별 적용한 오프라인 판매번호 (offline.c, 처음 동기화 때 엶)
+    struct IdIndex* id_index;       // ID -> 상품 해시 색인 (inventory.c, 중복 검사/단일 삭제용, 처음 쓸 때 생성)
+    struct ColdTier* cold;          // 만료 재고 보관소 (coldtier.c, head 목록에는 판매 가능한 상품만, 처음 만료될 때 생성)
+    pthread_mutex_t list_mutex;
+    struct ScanCursor* scan_cursors;    // 락을 잠시 양보한 긴 조회들의 다음 위치 (inventory.c, list_mutex 보호)
+
+    // 상품 번호 발급 상태 (idalloc.c, list_mutex 보호)
+    uint64_t id_next;               // 다음에 발급할 번호
+    uint64_t id_limit;              // "<DB>.ids" 에 기록한 발급 한도 (0 = 아직 기록 안 함)
+    int id_durable;                 // 1 = 한도를 파일에 기록하는 실제 매장 (시점 조회용 임시 매장은 0)
+
+    // 메모리 사용량 통계 (list_mutex 보호) - 만료 보관소 항목 포함
+    long item_count;
+    size_t mem_bytes;
+
+    // 스케줄러 상태 (scheduler.c 의 sched_mutex 보호) - 우선순위 등급마다 독립된 큐
+    struct Job* q_head[SCHED_CLASSES];
+    struct Job* q_tail[SCHED_CLASSES];
+    int q_len[SCHED_CLASSES];
+    int in_ready[SCHED_CLASSES];    // 해당 등급 준비 큐에 올라가 있는지
+    int running[SCHED_CLASSES];     // 워커가 현재 이 매장의 해당 등급 작업을 수행 중인지
+    struct Store* ready_next[SCHED_CLASSES];
+    unsigned long served;
+    int urgent;                     // 대기/실행 중인 SCHED_CRITICAL 작업 수 (원자적 접근, 긴 조회가 보고 양보)
+
+    // 복제본에서 마지막으로 적용한 주 서버 LSN
+    uint64_t applied_lsn;
+    struct HistoryGroup* pending_group;     // 복제본: 받는 중인 묶음 레코드 (K 전까지 반영 보류, history.h)
+
+    // 재고 버전 = 이 매장의 변경 횟수 (push.c, 구독 단말기 캐시 무효화용)
+    // 저널에 남지 않는 장바구니 예약 변경도 세므로 LSN 과는 별개
+    uint64_t version;
+
+    // 분류별 이벤트 감지 상태 (push.c 팬아웃 스레드 전용)
+    int watch_ready;                // 기준 수량을 한 번이라도 셌는지
+    uint64_t watch_version;         // 마지막으로 센 재고 버전
+    unsigned long watch_round;      // 이번 팬아웃 회차에 새로 셌으면 그 회차 번호
+    int watch_avail[NUM_CATEGORIES];
+    int watch_prev_avail[NUM_CATEGORIES];
+    int watch_expired[NUM_CATEGORIES];
+    int watch_new_expired[NUM_CATEGORIES];
+
+    // 변경 이력 파일 (history.c, list_mutex 보호, 쓰기는 iobackend.c) - 시점 조회용 임시 매장은 NULL
+    struct IoFile* history_io;
+    long history_records;           // 마지막 스냅샷 이후 기록된 레코드 수
+    int history_batch;              // 1 = 대량 기록 중 (레코드마다 I/O 스레드를 깨우지 않음)
+    struct BulkDelete* bulk_running;    // 진행 중인 일괄 삭제 (삭제 기록을 끝난 뒤 묶음 단위로 남김, inventory.c)
+
+    // DB 파일 압축 대기 (compact.c 의 compact_mutex 보호)
+    int db_dirty;                   // 압축 큐에 올라가 있음 = DB 파일에 아직 없는 변경이 있음
+} Store;
+
+// 매장 재고 락 (list_mutex). 추적을 켜면 대기/보유 시간이 남음
+static inline void store_lock(Store* st) { trace_mutex_lock(&st->list_mutex, "list_mutex"); }
+static inline void store_unlock(Store* st) { trace_mutex_unlock(&st->list_mutex); }
+
+// 매장 레지스트리 관리
+void init_stores(void);
+Store* get_default_store(void);
+Store* open_store(const char* store_id);  // 없으면 생성 후 DB 로드, 잘못된 ID면 NULL
+Store* find_store(const char* store_id);  // 관리자 조회용: 열려 있거나 디스크에 DB/이력이 있는 매장만 (없으면 NULL, 새로 만들지 않음)
+int get_store_count(void);
+Store* get_store_at(int idx);
+
+// 관리자 콘솔 출력용 매장별 통계
+void print_store_stats(void);
+
+#endif // STORE_H
@@ -0,0 +1,42 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <pthread.h>
+
+#define TRACE_EVENTS        (1 << 16)   // 링 크기 (넘치면 오래된 것부터 덮어씀, 처음 켤 때 할당)
+#define TRACE_LOCK_DEPTH    8           // 스레드마다 동시에 쥐고 있는 추적 대상 락 수
+#define TRACE_DUMP_SEC      10          // trace dump 기본 구간 (최근 N초)
+
+// [내장 추적기]
+// 요청/락/저장/만료 처리 구간을 링 버퍼에 남겼다가 관리자 콘솔의 trace dump 로 Chrome trace JSON 을 씁니다
+// (chrome://tracing, ui.perfetto.dev 에서 열기). 꺼져 있을 때 각 지점의 비용은 전역 플래그 읽기와 분기 하나입니다.
+// 이름/분류는 문자열 상수만 넘길 것 (포인터만 저장).
+extern int trace_on;
+
+#define TRACE_ENABLED()             __builtin_expect(__atomic_load_n(&trace_on, __ATOMIC_RELAXED), 0)
+#define TRACE_BEGIN(cat, name, arg) do { if (TRACE_ENABLED()) trace_emit('B', cat, name, arg, 0); } while (0)
+#define TRACE_END(cat, name, arg)   do { if (TRACE_ENABLED()) trace_emit('E', cat, name, arg, 0); } while (0)
+
+void trace_emit(char ph, const char* cat, const char* name, long arg, long long dur_ns);
+long long trace_now_ns(void);
+
+int trace_start(void);                  // 켬 (링 할당 실패 0)
+void trace_stop(void);
+int trace_dump(const char* path, int seconds);     // 최근 seconds 초 구간을 JSON 으로 (반환: 쓴 이벤트 수, 실패 -1)
+
+// [락 추적] 꺼져 있으면 pthread_mutex_lock/unlock 그대로.
+// 켜져 있으면 기다린 시간("<이름> 대기")과 쥐고 있던 시간("<이름>")을 완료 이벤트로 남깁니다.
+void trace_lock_slow(pthread_mutex_t* m, const char* name);
+void trace_unlock_slow(pthread_mutex_t* m);
+
+static inline void trace_mutex_lock(pthread_mutex_t* m, const char* name) {
+    if (TRACE_ENABLED()) trace_lock_slow(m, name);
+    else pthread_mutex_lock(m);
+}
+
+static inline void trace_mutex_unlock(pthread_mutex_t* m) {
+    if (TRACE_ENABLED()) trace_unlock_slow(m);
+    else pthread_mutex_unlock(m);
+}
+
+#endif // TRACE_H
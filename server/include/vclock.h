@@ -0,0 +1,23 @@
+#ifndef VCLOCK_H
+#define VCLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+#define VCLOCK_NS_PER_SEC 1000000000LL
+
+// [가상 시계] CLOCK_MONOTONIC 기준이라 벽시계(NTP) 조정에 영향을 받지 않고,
+// 배속이 커도(예: x3600) 1초 안의 순서가 나노초 단위로 유지됩니다.
+// 읽기는 락 없이(seqlock) 처리되므로 요청/로그마다 불러도 됩니다. 변경은 드물고 직렬화됩니다.
+int64_t vclock_now_ns(void);                    // 가상 시각 (유닉스 기준 나노초)
+time_t vclock_now(void);                        // 가상 시각 (초, 버림)
+int vclock_speed(void);
+
+void vclock_set(int64_t virtual_ns, int speed); // 가상 시각과 배속을 한 번에 다시 맞춤 (초기화/세션 복구)
+void vclock_set_speed(int speed);               // 현재 가상 시각에서 끊김 없이 배속만 바꿈
+
+// virt_ns + real_elapsed_ns * speed 를 128비트로 계산해 int64 범위로 포화 (넘침으로 시각이 뒤집히지 않게)
+int64_t vclock_advance(int64_t virt_ns, int64_t real_elapsed_ns, int speed);
+int64_t vclock_wall_ns(void);                   // 벽시계 (CLOCK_REALTIME) - 재시작 사이 경과 계산용
+
+#endif // VCLOCK_H
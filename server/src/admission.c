@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "admission.h"
+#include "push.h"
+#include "inventory.h"
+#include "logger.h"
+#include "offline.h"
+#include "idalloc.h"
+#include "session.h"
+
+// =====================================================================
+// [요청 수락 제어]
+// 1) 단말기별 토큰 버킷 (예약 주인 번호로 묶음, session.h): 등급마다 초당 보충량과 최대 버스트가 정해져 있어
+//    한 단말기가 같은 요청을 반복해도 자기 몫 이상은 바로 거절됩니다.
+// 2) 전체 동시 처리 한도: 워커에 올라간 요청이 ADM_MAX_INFLIGHT 개를 넘으면 FIFO 로 기다리고,
+//    대기열이 가득 찼거나 ADM_WAIT_MS 안에 차례가 오지 않으면 RESP_BUSY 로 돌려보냅니다.
+// =====================================================================
+
+typedef struct {
+    const char* name;
+    double rate;            // 초당 보충 토큰
+    double burst;           // 버킷 크기
+} AdmClassConf;
+
+static const AdmClassConf class_conf[ADM_CLASSES] = {
+    [ADM_READ]  = { "조회", 20.0, 40.0 },
+    [ADM_WRITE] = { "변경", 30.0, 60.0 },
+    [ADM_BULK]  = { "대량",  1.0,  3.0 },
+};
+
+#define BUCKET_SLOTS 256
+
+typedef struct ClientBucket {
+    uint32_t owner;                 // 예약 주인 번호 (연결/세션, session.h)
+    uint32_t cid;                   // 표시용
+    double tokens[ADM_CLASSES];
+    int64_t last_ns[ADM_CLASSES];
+    unsigned long limited;
+    struct ClientBucket* next;
+} ClientBucket;
+
+static ClientBucket* buckets[BUCKET_SLOTS];
+static pthread_mutex_t bucket_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 대기 중인 요청 (연결 스레드 스택에 있음)
+typedef struct Waiter {
+    pthread_cond_t cond;
+    int admitted;
+    int urgent;
+    struct Waiter* next;
+} Waiter;
+
+static pthread_mutex_t adm_mutex = PTHREAD_MUTEX_INITIALIZER;
+static Waiter *wait_head = NULL, *wait_tail = NULL;
+static int inflight = 0, queued = 0, peak_inflight = 0, peak_queued = 0;
+
+// 통계 (adm_mutex 보호)
+static unsigned long admitted[ADM_CLASSES], limited[ADM_CLASSES];
+static unsigned long waited = 0, busy_full = 0, busy_timeout = 0;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int admission_class(uint32_t cmd) {
+    switch (cmd) {
+        case 99: case 100: case CMD_SUBSCRIBE: case CMD_WATCH: return ADM_EXEMPT;
+        case 1: case 6: case 8: case 14: case 17: case CMD_CART_RELEASE: case CMD_ID_LEASE: case CMD_SESSION: return ADM_WRITE;
+        case 2: case 5: case 12: case 13: case 16: case CMD_OFFLINE_SYNC: return ADM_BULK;
+        default: return ADM_READ;
+    }
+}
+
+// 토큰 하나를 쓸 수 있으면 1
+static int take_token(uint32_t owner, uint32_t cid, int cls) {
+    const AdmClassConf* conf = &class_conf[cls];
+    int64_t now = now_ns();
+    pthread_mutex_lock(&bucket_mutex);
+    ClientBucket* b = buckets[owner % BUCKET_SLOTS];
+    while (b && b->owner != owner) b = b->next;
+    if (!b && (b = calloc(1, sizeof(ClientBucket)))) {
+        b->owner = owner;
+        for (int i = 0; i < ADM_CLASSES; i++) { b->tokens[i] = class_conf[i].burst; b->last_ns[i] = now; }
+        b->next = buckets[owner % BUCKET_SLOTS];
+        buckets[owner % BUCKET_SLOTS] = b;
+    }
+    if (b) b->cid = cid;
+    int ok = 1;
+    if (b) {
+        b->tokens[cls] += (now - b->last_ns[cls]) / 1e9 * conf->rate;
+        if (b->tokens[cls] > conf->burst) b->tokens[cls] = conf->burst;
+        b->last_ns[cls] = now;
+        if (b->tokens[cls] >= 1.0) b->tokens[cls] -= 1.0;
+        else { ok = 0; b->limited++; }
+    }
+    pthread_mutex_unlock(&bucket_mutex);
+    return ok;
+}
+
+int admission_enter(uint32_t owner, uint32_t cid, int cls, int urgent) {
+    if (cls == ADM_EXEMPT) return ADM_OK;
+    if (!take_token(owner, cid, cls)) {
+        pthread_mutex_lock(&adm_mutex);
+        limited[cls]++;
+        pthread_mutex_unlock(&adm_mutex);
+        return ADM_LIMITED;
+    }
+
+    pthread_mutex_lock(&adm_mutex);
+    if (inflight < ADM_MAX_INFLIGHT && !wait_head) {
+        if (++inflight > peak_inflight) peak_inflight = inflight;
+        admitted[cls]++;
+        pthread_mutex_unlock(&adm_mutex);
+        return ADM_OK;
+    }
+    if (queued >= ADM_MAX_QUEUED) {
+        busy_full++;
+        pthread_mutex_unlock(&adm_mutex);
+        return ADM_BUSY;
+    }
+
+    Waiter w = { .admitted = 0, .urgent = urgent, .next = NULL };
+    pthread_cond_init(&w.cond, NULL);
+    // 급한 요청(판매/결제)은 앞서 기다리는 급한 요청들 바로 뒤로 끼어듦 (급한 요청끼리는 FIFO)
+    Waiter* after = NULL;
+    if (urgent) for (Waiter* x = wait_head; x && x->urgent; x = x->next) after = x;
+    else after = wait_tail;
+    if (after) { w.next = after->next; after->next = &w; }
+    else { w.next = wait_head; wait_head = &w; }
+    if (wait_tail == after) wait_tail = &w;
+    if (++queued > peak_queued) peak_queued = queued;
+    waited++;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ADM_WAIT_MS / 1000;
+    ts.tv_nsec += (ADM_WAIT_MS % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+    while (!w.admitted && pthread_cond_timedwait(&w.cond, &adm_mutex, &ts) != ETIMEDOUT) {}
+
+    int verdict = ADM_OK;
+    if (w.admitted) admitted[cls]++;
+    else {
+        // 시간 초과: 대기열에서 빠짐
+        Waiter* prev = NULL;
+        for (Waiter* x = wait_head; x; prev = x, x = x->next) {
+            if (x != &w) continue;
+            if (prev) prev->next = w.next; else wait_head = w.next;
+            if (wait_tail == &w) wait_tail = prev;
+            break;
+        }
+        queued--;
+        busy_timeout++;
+        verdict = ADM_BUSY;
+    }
+    pthread_mutex_unlock(&adm_mutex);
+    pthread_cond_destroy(&w.cond);
+    return verdict;
+}
+
+void admission_forget(uint32_t owner) {
+    pthread_mutex_lock(&bucket_mutex);
+    for (ClientBucket** pp = &buckets[owner % BUCKET_SLOTS]; *pp; pp = &(*pp)->next) {
+        if ((*pp)->owner != owner) continue;
+        ClientBucket* b = *pp;
+        *pp = b->next;
+        free(b);
+        break;
+    }
+    pthread_mutex_unlock(&bucket_mutex);
+}
+
+void admission_leave(void) {
+    pthread_mutex_lock(&adm_mutex);
+    Waiter* w = wait_head;
+    if (w) {
+        // 처리 슬롯을 대기열 맨 앞 요청에 그대로 넘김 (inflight 유지)
+        wait_head = w->next;
+        if (!wait_head) wait_tail = NULL;
+        queued--;
+        w->admitted = 1;
+        pthread_cond_signal(&w->cond);
+    } else {
+        inflight--;
+    }
+    pthread_mutex_unlock(&adm_mutex);
+}
+
+const char* admission_reject_msg(int verdict) {
+    return verdict == ADM_LIMITED ? "[제한] 요청이 너무 잦습니다. 잠시 후 다시 시도해주세요."
+                                  : "[혼잡] 서버 처리 대기열이 가득 찼습니다. 잠시 후 다시 시도해주세요.";
+}
+
+void print_admission_stats(void) {
+    char buf[256];
+    pthread_mutex_lock(&adm_mutex);
+    snprintf(buf, sizeof(buf), "[수락] 처리 중 %d/%d (최대 %d) | 대기 %d/%d (최대 %d) | 대기 후 처리 %lu | 혼잡 거절 %lu (가득 참 %lu, 시간 초과 %lu)",
+             inflight, ADM_MAX_INFLIGHT, peak_inflight, queued, ADM_MAX_QUEUED, peak_queued,
+             waited - busy_timeout, busy_full + busy_timeout, busy_full, busy_timeout);
+    update_log(buf);
+    for (int i = 0; i < ADM_CLASSES; i++) {
+        snprintf(buf, sizeof(buf), "[수락] %s: 초당 %.0f건 (버스트 %.0f) | 수락 %lu | 한도 초과 %lu",
+                 class_conf[i].name, class_conf[i].rate, class_conf[i].burst, admitted[i], limited[i]);
+        update_log(buf);
+    }
+    pthread_mutex_unlock(&adm_mutex);
+
+    // 한도 초과가 가장 많은 단말기 상위 3개
+    ClientBucket* top[3] = { NULL, NULL, NULL };
+    pthread_mutex_lock(&bucket_mutex);
+    for (int i = 0; i < BUCKET_SLOTS; i++) {
+        for (ClientBucket* b = buckets[i]; b; b = b->next) {
+            if (b->limited == 0) continue;
+            for (int k = 0; k < 3; k++) {
+                if (top[k] && top[k]->limited >= b->limited) continue;
+                memmove(&top[k + 1], &top[k], sizeof(top[0]) * (2 - k));
+                top[k] = b;
+                break;
+            }
+        }
+    }
+    for (int k = 0; k < 3 && top[k]; k++) {
+        snprintf(buf, sizeof(buf), "[수락] 한도 초과 %d위: [POS-%04u] %lu건", k + 1, top[k]->cid, top[k]->limited);
+        update_log(buf);
+    }
+    pthread_mutex_unlock(&bucket_mutex);
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "bulkjob.h"
+#include "inventory.h"
+#include "scheduler.h"
+#include "utils.h"
+
+// =====================================================================
+// [일괄 삭제 작업 스레드]
+// 접수된 작업은 최근 BULK_JOBS_MAX 개짜리 표에 남고, 작업 스레드가 번호 순서대로 하나씩 처리합니다.
+// 조각 하나를 끝낼 때마다 락을 놓고, 판매 같은 급한 요청이 기다리면 끝날 때까지(최대 SCHED_YIELD_MAX_MS) 비켜 줍니다.
+// 진행 상황은 조각마다 표에 옮겨 적으므로 조회는 list_mutex 를 잡지 않습니다.
+// =====================================================================
+
+enum { JOB_WAITING, JOB_RUNNING, JOB_DONE };
+
+typedef struct {
+    uint32_t id;                // 0 = 빈 칸
+    Store* st;
+    uint32_t cmd;
+    char name[50];
+    int state;
+    long deleted, done, total;
+    BulkDelete* work;
+    char result[160];
+} BulkJob;
+
+static BulkJob jobs[BULK_JOBS_MAX];
+static uint32_t next_id = 1;
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
+
+// job_mutex 보유 상태에서 호출. 가장 먼저 접수된 대기 작업
+static BulkJob* next_waiting(void) {
+    BulkJob* best = NULL;
+    for (int i = 0; i < BULK_JOBS_MAX; i++)
+        if (jobs[i].id && jobs[i].state == JOB_WAITING && (!best || jobs[i].id < best->id)) best = &jobs[i];
+    return best;
+}
+
+static void* bulk_thread(void* arg) {
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&job_mutex);
+        BulkJob* j;
+        while (!(j = next_waiting())) pthread_cond_wait(&job_cond, &job_mutex);
+        j->state = JOB_RUNNING;
+        BulkDelete* work = j->work;
+        Store* st = j->st;
+        pthread_mutex_unlock(&job_mutex);
+
+        long deleted, done, total;
+        int finished;
+        do {
+            finished = bulk_delete_step(work, BULK_CHUNK, &deleted, &done, &total);
+            pthread_mutex_lock(&job_mutex);
+            j->deleted = deleted; j->done = done; j->total = total;
+            pthread_mutex_unlock(&job_mutex);
+            if (sched_urgent_pending(st)) sched_wait_urgent(st);
+            else sched_yield();
+        } while (!finished);
+        // 지운 ID 기록도 묶음마다 락을 놓아 판매와 복제 송신이 밀리지 않게 함
+        while (!bulk_delete_log(work, BULK_CHUNK)) {
+            if (sched_urgent_pending(st)) sched_wait_urgent(st);
+            else sched_yield();
+        }
+
+        char result[sizeof(j->result)];
+        bulk_delete_end(work, result, sizeof(result));
+        pthread_mutex_lock(&job_mutex);
+        snprintf(j->result, sizeof(j->result), "%s", result);
+        j->work = NULL;
+        j->state = JOB_DONE;
+        pthread_mutex_unlock(&job_mutex);
+    }
+    return NULL;
+}
+
+void init_bulk_jobs(void) {
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, bulk_thread, NULL) == 0) pthread_detach(tid);
+}
+
+uint32_t bulk_job_submit(Store* st, uint32_t cmd, uint32_t cid, const char* name, char* msg, size_t size) {
+    pthread_mutex_lock(&job_mutex);
+    // 빈 칸이 없으면 가장 오래된 끝난 작업 자리를 씀
+    BulkJob* slot = NULL;
+    for (int i = 0; i < BULK_JOBS_MAX; i++) {
+        BulkJob* j = &jobs[i];
+        if (!j->id) { slot = j; break; }
+        if (j->state == JOB_DONE && (!slot || j->id < slot->id)) slot = j;
+    }
+    BulkDelete* work = slot ? bulk_delete_begin(st, cmd, cid, name) : NULL;
+    if (!work) {
+        pthread_mutex_unlock(&job_mutex);
+        snprintf(msg, size, slot ? "[실패] 메모리 부족" : "[실패] 밀린 일괄 삭제 작업이 너무 많습니다. 잠시 후 다시 시도해주세요.");
+        return 0;
+    }
+    memset(slot, 0, sizeof(*slot));
+    slot->id = next_id++;
+    slot->st = st; slot->cmd = cmd; slot->work = work;
+    snprintf(slot->name, sizeof(slot->name), "%s", name);
+    slot->state = JOB_WAITING;
+    uint32_t id = slot->id;
+    pthread_cond_signal(&job_cond);
+    pthread_mutex_unlock(&job_mutex);
+    snprintf(msg, size, "[POS-%04d] 일괄 삭제 작업 #%u 접수", cid, id);
+    return id;
+}
+
+int bulk_job_status(Store* st, const char* pin, char* msg, size_t size) {
+    uint32_t id = (uint32_t)strtoul(pin, NULL, 10);
+    int pct = -1;
+    pthread_mutex_lock(&job_mutex);
+    BulkJob* j = NULL;
+    for (int i = 0; id && i < BULK_JOBS_MAX && !j; i++) if (jobs[i].id == id && jobs[i].st == st) j = &jobs[i];
+    if (!j) {
+        snprintf(msg, size, "[실패] 작업 #%s 없음", pin);
+    } else if (j->state == JOB_DONE) {
+        pct = 100;
+        snprintf(msg, size, "[작업 #%u 완료] %s", id, j->result);
+    } else {
+        char what[80];
+        if (j->cmd == 5) snprintf(what, sizeof(what), "만료 일괄 폐기");
+        else snprintf(what, sizeof(what), "%s %s", j->cmd == 13 ? "만료삭제" : "종류삭제", j->name);
+        pct = j->total > 0 ? (int)(j->done * 100 / j->total) : 0;
+        if (pct > 99) pct = 99;
+        if (j->state == JOB_WAITING) snprintf(msg, size, "[작업 #%u 대기 중] %s", id, what);
+        else snprintf(msg, size, "[작업 #%u 진행 중] %s: %ld개 삭제 (%d%%)", id, what, j->deleted, pct);
+    }
+    pthread_mutex_unlock(&job_mutex);
+    return pct;
+}
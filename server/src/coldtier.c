@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coldtier.h"
+#include "itemmeta.h"
+
+// =====================================================================
+// [만료 재고 보관소]
+// 상품명마다 묶음 하나: COLD_BLOCK 개짜리 블록 배열에 빈틈 없이 채움 (빼면 맨 뒤 항목이 그 자리로).
+// 블록 배열만 늘리고 블록은 옮기지 않으므로 항목 주소를 ID 색인과 부가 정보 owner 에 그대로 씁니다.
+// ID 색인은 선형 탐사 개방 주소 표이고 지울 때 뒤 칸을 당겨 오므로 빈 칸 표시가 없습니다 (inventory.c 의 ID 색인과 같은 방식).
+// =====================================================================
+
+#define COLD_BLOCK      1024
+#define COLD_GROUPS_MAX 65535
+
+typedef struct {
+    char name[50];
+    ColdItem** blocks;
+    long len;
+    int n_blocks, cap_blocks;
+} ColdGroup;
+
+typedef struct ColdTier {
+    ColdGroup* groups;
+    int n_groups, cap_groups;
+    long count;
+    ColdItem** slots;               // ID 색인 (cap 은 2의 거듭제곱, len 은 cap 의 70% 이하)
+    long cap, len;
+} ColdTier;
+
+static ColdItem* item_at(ColdGroup* g, long i) {
+    return &g->blocks[i / COLD_BLOCK][i % COLD_BLOCK];
+}
+
+// ---------------------------------------------------------------------
+// ID 색인
+// ---------------------------------------------------------------------
+static unsigned long hash_id(const char* id) {
+    unsigned long h = 1469598103934665603UL;
+    for (; *id; id++) h = (h ^ (unsigned char)*id) * 1099511628211UL;
+    return h;
+}
+
+static void hash_put(ColdTier* t, ColdItem* c) {
+    long mask = t->cap - 1, i = hash_id(c->id) & mask;
+    while (t->slots[i]) i = (i + 1) & mask;
+    t->slots[i] = c; t->len++;
+}
+
+static int hash_grow(ColdTier* t) {
+    long cap = t->cap ? t->cap * 2 : 1024;
+    ColdItem** old = t->slots;
+    long old_cap = t->cap;
+    if (!(t->slots = calloc(cap, sizeof(ColdItem*)))) { t->slots = old; return 0; }
+    t->cap = cap; t->len = 0;
+    for (long i = 0; i < old_cap; i++) if (old[i]) hash_put(t, old[i]);
+    free(old);
+    return 1;
+}
+
+// c 를 가리키는 칸 (없으면 -1)
+static long hash_slot_of(ColdTier* t, const ColdItem* c) {
+    long mask = t->cap - 1, i = hash_id(c->id) & mask;
+    while (t->slots[i] && t->slots[i] != c) i = (i + 1) & mask;
+    return t->slots[i] ? i : -1;
+}
+
+static void hash_remove(ColdTier* t, const ColdItem* c) {
+    long i = hash_slot_of(t, c), mask = t->cap - 1;
+    if (i < 0) return;
+    t->slots[i] = NULL; t->len--;
+    for (long j = (i + 1) & mask; t->slots[j]; j = (j + 1) & mask) {
+        long home = hash_id(t->slots[j]->id) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) { t->slots[i] = t->slots[j]; t->slots[j] = NULL; i = j; }
+    }
+}
+
+// ---------------------------------------------------------------------
+// 묶음
+// ---------------------------------------------------------------------
+static int find_group(ColdTier* t, const char* name) {
+    for (int g = 0; g < t->n_groups; g++) if (strcmp(t->groups[g].name, name) == 0) return g;
+    return -1;
+}
+
+static int add_group(ColdTier* t, const char* name) {
+    if (t->n_groups >= COLD_GROUPS_MAX) return -1;
+    if (t->n_groups == t->cap_groups) {
+        int cap = t->cap_groups ? t->cap_groups * 2 : 16;
+        ColdGroup* g = realloc(t->groups, sizeof(ColdGroup) * cap);
+        if (!g) return -1;
+        t->groups = g; t->cap_groups = cap;
+    }
+    ColdGroup* g = &t->groups[t->n_groups];
+    memset(g, 0, sizeof(*g));
+    snprintf(g->name, sizeof(g->name), "%s", name);
+    return t->n_groups++;
+}
+
+static int add_block(ColdGroup* g) {
+    if (g->n_blocks == g->cap_blocks) {
+        int cap = g->cap_blocks ? g->cap_blocks * 2 : 4;
+        ColdItem** b = realloc(g->blocks, sizeof(ColdItem*) * cap);
+        if (!b) return 0;
+        g->blocks = b; g->cap_blocks = cap;
+    }
+    if (!(g->blocks[g->n_blocks] = malloc(sizeof(ColdItem) * COLD_BLOCK))) return 0;
+    g->n_blocks++;
+    return 1;
+}
+
+static void free_blocks(ColdGroup* g) {
+    for (int b = 0; b < g->n_blocks; b++) free(g->blocks[b]);
+    free(g->blocks);
+    g->blocks = NULL; g->n_blocks = g->cap_blocks = 0; g->len = 0;
+}
+
+// ---------------------------------------------------------------------
+// 공개 API
+// ---------------------------------------------------------------------
+ColdItem* cold_add(Store* st, const char* id, const char* name, time_t expire_time, uint32_t meta) {
+    ColdTier* t = st->cold;
+    if (!t && !(t = st->cold = calloc(1, sizeof(ColdTier)))) return NULL;
+    if ((t->len + 1) * 10 > t->cap * 7 && !hash_grow(t)) return NULL;
+    int gi = find_group(t, name);
+    if (gi < 0 && (gi = add_group(t, name)) < 0) return NULL;
+    ColdGroup* g = &t->groups[gi];
+    if (g->len == (long)g->n_blocks * COLD_BLOCK && !add_block(g)) return NULL;
+
+    ColdItem* c = item_at(g, g->len++);
+    snprintf(c->id, sizeof(c->id), "%s", id);
+    c->group = (uint16_t)gi;
+    c->meta = meta;
+    c->expire_time = expire_time;
+    hash_put(t, c);
+    meta_set_owner(st, meta, c);
+    t->count++;
+    st->item_count++; st->mem_bytes += sizeof(ColdItem);
+    return c;
+}
+
+ColdItem* cold_find(Store* st, const char* id) {
+    ColdTier* t = st->cold;
+    if (!t || !t->cap) return NULL;
+    long mask = t->cap - 1;
+    for (long i = hash_id(id) & mask; t->slots[i]; i = (i + 1) & mask)
+        if (strcmp(t->slots[i]->id, id) == 0) return t->slots[i];
+    return NULL;
+}
+
+void cold_remove(Store* st, ColdItem* c) {
+    ColdTier* t = st->cold;
+    ColdGroup* g = &t->groups[c->group];
+    hash_remove(t, c);
+    ColdItem* last = item_at(g, g->len - 1);
+    if (last != c) {
+        // 맨 뒤 항목을 빈 자리로: 색인 칸과 부가 정보 owner 를 새 주소로
+        long slot = hash_slot_of(t, last);
+        *c = *last;
+        if (slot >= 0) t->slots[slot] = c;
+        meta_set_owner(st, c->meta, c);
+    }
+    if (--g->len % COLD_BLOCK == 0) free(g->blocks[--g->n_blocks]);     // 마지막 블록이 비면 반납
+    t->count--;
+    st->item_count--; st->mem_bytes -= sizeof(ColdItem);
+}
+
+const char* cold_name(Store* st, const ColdItem* c) {
+    return st->cold->groups[c->group].name;
+}
+
+long cold_count(Store* st, const char* name) {
+    ColdTier* t = st->cold;
+    if (!t) return 0;
+    if (!name) return t->count;
+    int g = find_group(t, name);
+    return g < 0 ? 0 : t->groups[g].len;
+}
+
+int cold_names(Store* st, const char** names, long* counts, int max) {
+    ColdTier* t = st->cold;
+    int n = 0;
+    for (int g = 0; t && g < t->n_groups && n < max; g++) {
+        if (!t->groups[g].len) continue;
+        names[n] = t->groups[g].name; counts[n] = t->groups[g].len;
+        n++;
+    }
+    return n;
+}
+
+void cold_each(Store* st, const char* name, void (*fn)(void* arg, const ColdItem* c), void* arg) {
+    ColdTier* t = st->cold;
+    for (int g = 0; t && g < t->n_groups; g++) {
+        ColdGroup* grp = &t->groups[g];
+        if (name && strcmp(grp->name, name) != 0) continue;
+        for (long i = 0; i < grp->len; i += COLD_BLOCK) {
+            ColdItem* b = grp->blocks[i / COLD_BLOCK];
+            long n = grp->len - i < COLD_BLOCK ? grp->len - i : COLD_BLOCK;
+            for (long k = 0; k < n; k++) fn(arg, &b[k]);
+        }
+    }
+}
+
+long cold_clear(Store* st, const char* name, void (*fn)(void* arg, const ColdItem* c), void* arg) {
+    ColdTier* t = st->cold;
+    if (!t) return 0;
+    long removed = 0;
+    for (int g = 0; g < t->n_groups; g++) {
+        ColdGroup* grp = &t->groups[g];
+        if (!grp->len || (name && strcmp(grp->name, name) != 0)) continue;
+        for (long i = 0; i < grp->len; i++) {
+            ColdItem* c = item_at(grp, i);
+            if (fn) fn(arg, c);
+            if (name) hash_remove(t, c);     // 전체 비움이면 색인은 끝에서 한 번에
+        }
+        removed += grp->len;
+        free_blocks(grp);
+    }
+    if (!name && t->slots) { memset(t->slots, 0, sizeof(ColdItem*) * t->cap); t->len = 0; }
+    t->count -= removed;
+    st->item_count -= removed; st->mem_bytes -= sizeof(ColdItem) * removed;
+    return removed;
+}
+
+long cold_take(Store* st, const char* name, long max, void (*fn)(void* arg, const ColdItem* c), void* arg) {
+    ColdTier* t = st->cold;
+    long removed = 0;
+    for (int g = 0; t && g < t->n_groups && removed < max; g++) {
+        ColdGroup* grp = &t->groups[g];
+        if (name && strcmp(grp->name, name) != 0) continue;
+        for (; grp->len && removed < max; removed++) {
+            ColdItem* c = item_at(grp, grp->len - 1);       // 맨 뒤부터: 옮겨 오는 항목 없음
+            if (fn) fn(arg, c);
+            cold_remove(st, c);
+        }
+    }
+    return removed;
+}
+
+void cold_reset(Store* st) {
+    ColdTier* t = st->cold;
+    if (!t) return;
+    for (int g = 0; g < t->n_groups; g++) free_blocks(&t->groups[g]);
+    free(t->groups); free(t->slots);
+    free(t);
+    st->cold = NULL;
+}
+
+void cold_move(Store* dst, Store* src) {
+    cold_reset(dst);
+    dst->cold = src->cold;
+    src->cold = NULL;
+}
+
+size_t cold_bytes(Store* st) {
+    ColdTier* t = st->cold;
+    if (!t) return 0;
+    size_t blocks = 0;
+    for (int g = 0; g < t->n_groups; g++) blocks += (size_t)t->groups[g].n_blocks * COLD_BLOCK;
+    return sizeof(ColdTier) + sizeof(ColdGroup) * t->cap_groups + sizeof(ColdItem*) * t->cap +
+           sizeof(ColdItem) * (blocks - t->count);
+}
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "compact.h"
+#include "inventory.h"
+#include "history.h"
+#include "snapfile.h"
+#include "logger.h"
+#include "utils.h"
+#include "iobackend.h"
+#include "trace.h"
+#include "offline.h"
+
+// =====================================================================
+// [백그라운드 DB 압축]
+// 모든 변경은 이미 이력 파일(<DB>.history)에 한 줄씩 남으므로, 요청 처리 중에는 DB 파일을
+// 다시 쓰지 않고 매장을 압축 큐에 올리기만 합니다. 압축 스레드가 모인 변경을 한 번에 반영합니다.
+//  1. list_mutex 안: 그 순간의 이력 파일 위치만 기록 (매장 크기와 무관하게 짧음)
+//  2. 락 밖: 지난 압축본과 그 뒤 이력을 기록한 위치까지 재생해 사본을 만들고(history_build_at, 재시작 때의
+//     적재와 같은 과정) 사본에서 행 배열을 복사. 라이브 목록은 훑지 않으므로 압축이 판매를 막지 않음
+//     (압축본에 이력 위치가 없는 예전 DB 의 첫 압축과 락을 쥔 채 부르는 경로만 락 안에서 목록을 복사)
+//  3. 락 밖: 행 배열을 압축 스냅샷 형식으로 부호화(snapfile.c, 블록별 병렬) -> 임시 파일 -> fsync -> rename
+//     (파일 쓰기는 iobackend.c 에 복사 없이 넘기고, 기록한 이력 위치까지 이력 파일이 다 쓰인 뒤에 rename)
+// 파일 머리말의 이력 오프셋은 이 파일에 반영된 마지막 이력 위치이며, 적재 시
+// 그 뒤의 이력을 재생해 압축 전에 멈췄더라도 최신 상태로 복구합니다.
+// SNAPSHOT_EVERY 건이 쌓였으면 같은 행으로 시점 조회용 스냅샷도 함께 씁니다.
+// 오프라인 판매 원장(offline.c)은 행에 들어가지 않으므로 같은 시점의 원장을 <DB>.offline 에 DB 파일보다 먼저 씁니다.
+// 락 안에서 목록을 복사할 때는 일괄 삭제 작업 도중이면 압축하지 않습니다: 목록에서는 이미 빠졌지만
+// D 는 나중에 이력에 남으므로 그 사이의 DB 파일은 작업 절반만 반영하게 됩니다 (작업 끝의 save_data 가 다시 압축 큐에 올림).
+// 이력 재생 사본은 이력에 남은 것만 담으므로 이 문제가 없습니다.
+// =====================================================================
+
+static Store* queue[MAX_STORES];
+static int queue_len = 0;
+static pthread_mutex_t compact_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t compact_cond = PTHREAD_COND_INITIALIZER;
+static volatile int shutting_down = 0;
+
+// 임시 파일(path + tmp_suffix)에 다 쓰고 fsync 한 뒤 rename (중간에 죽어도 이전 파일은 온전함)
+static int write_rows_file(const char* path, const char* tmp_suffix, const char* image, size_t len, int is_final) {
+    char tmp[200];
+    snprintf(tmp, sizeof(tmp), "%s%s", path, tmp_suffix);
+    IoFile* f = io_open(tmp, IO_CREATE);
+    if (!f) return 0;
+    TRACE_BEGIN("persist", "파일 쓰기", (long)len);
+    io_write_ref(f, image, len);
+    int ok = io_fsync(f);
+    io_close(f);
+    TRACE_END("persist", "파일 쓰기", 0);
+    // 종료 중이면 종료 경로가 쓴 최종본을 덮지 않음
+    if (!ok || (shutting_down && !is_final)) { remove(tmp); return 0; }
+    return rename(tmp, path) == 0;
+}
+
+// take_lock = 0 이면 호출자가 list_mutex 를 쥐고 있거나(compact_locked) 락 없이 쓰는 종료 경로
+static void compact_store(Store* st, int take_lock, const char* tmp_suffix, int is_final) {
+    TRACE_BEGIN("persist", "DB 압축", 0);
+    long n_rows = 0;
+    size_t ledger_len = 0;
+    char *extras = NULL, *ledger = NULL;
+    ProductRow* rows = NULL;
+    if (take_lock) store_lock(st);
+    long offset = history_size(st);
+    time_t vt = get_virtual_time();
+    int rebuilt = 0;
+    if (take_lock && offset >= 0) {
+        store_unlock(st);
+        Store* shadow = history_build_at(st, offset);
+        if (shadow) {
+            rebuilt = 1;
+            rows = copy_product_rows(shadow, &n_rows, &extras);
+            ledger = offline_dump(shadow, "", &ledger_len);
+            history_free_shadow(shadow);
+        }
+        store_lock(st);
+        if (!rebuilt) { offset = history_size(st); vt = get_virtual_time(); }   // 락 안에서 목록 복사로
+    }
+    if (!rebuilt) {
+        if (st->bulk_running && st->history_io) {
+            if (take_lock) store_unlock(st);
+            TRACE_END("persist", "DB 압축", 0);
+            return;
+        }
+        rows = copy_product_rows(st, &n_rows, &extras);
+        ledger = offline_dump(st, "", &ledger_len);
+    }
+    int snapshot = rows && offset >= 0 && st->history_records >= SNAPSHOT_EVERY;
+    if (snapshot) st->history_records = 0;
+    if (take_lock) store_unlock(st);
+    if (!rows) {
+        free(ledger);
+        update_store_log(st, "[경고] 메모리 부족으로 DB 압축을 미룹니다");
+        compact_request(st);
+        TRACE_END("persist", "DB 압축", 0);
+        return;
+    }
+
+    size_t len = 0;
+    char* image = snap_encode(rows, n_rows, extras, offset, &len);
+    history_sync(st);               // 머리말의 이력 위치 앞은 이미 파일에 있어야 함
+    if (image && ledger) {
+        // 원장은 DB 파일보다 먼저: 원장이 더 앞선 시점이어도 이후 O 재생은 최대값이라 그대로
+        char path[160];
+        make_history_path(st, ".offline", path, sizeof(path));
+        write_rows_file(path, tmp_suffix, ledger, ledger_len, is_final);
+    }
+    if (!image) {
+        compact_request(st);            // 메모리 부족: 다음 차례에 다시
+    } else if (write_rows_file(st->db_filename, tmp_suffix, image, len, is_final) && snapshot) {
+        char path[160], suffix[48];
+        snprintf(suffix, sizeof(suffix), ".snap.%ld", offset);
+        make_history_path(st, suffix, path, sizeof(path));
+        if (write_rows_file(path, tmp_suffix, image, len, 1)) {
+            history_add_snapshot(st, offset, vt, path);
+            history_prune(st);
+        }
+    }
+    free(image);
+    free(rows);
+    free(extras);
+    free(ledger);
+    TRACE_END("persist", "DB 압축", n_rows);
+}
+
+static void* compact_thread(void* arg) {
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&compact_mutex);
+        while (queue_len == 0) pthread_cond_wait(&compact_cond, &compact_mutex);
+        pthread_mutex_unlock(&compact_mutex);
+
+        usleep(COMPACT_DELAY_MS * 1000);   // 연달아 오는 변경(판매 행렬)을 한 번의 다시 쓰기로 모음
+
+        pthread_mutex_lock(&compact_mutex);
+        Store* batch[MAX_STORES];
+        int n = queue_len;
+        memcpy(batch, queue, sizeof(Store*) * n);
+        for (int i = 0; i < n; i++) batch[i]->db_dirty = 0;
+        queue_len = 0;
+        pthread_mutex_unlock(&compact_mutex);
+
+        for (int i = 0; i < n && !shutting_down; i++) compact_store(batch[i], 1, ".tmp", 0);
+    }
+    return NULL;
+}
+
+void init_compactor(void) {
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, compact_thread, NULL) == 0) pthread_detach(tid);
+}
+
+void compact_request(Store* st) {
+    pthread_mutex_lock(&compact_mutex);
+    if (!st->db_dirty && queue_len < MAX_STORES) {
+        st->db_dirty = 1;
+        queue[queue_len++] = st;
+        pthread_cond_signal(&compact_cond);
+    }
+    pthread_mutex_unlock(&compact_mutex);
+}
+
+void compact_locked(Store* st) {
+    compact_store(st, 0, ".tmp.sync", 1);
+}
+
+void compact_flush(Store* st) {
+    shutting_down = 1;
+    compact_store(st, 0, ".tmp.final", 1);
+}
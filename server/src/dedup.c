@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "dedup.h"
+#include "admission.h"
+#include "logger.h"
+
+// =====================================================================
+// [요청 중복 제거]
+// 보관한 응답은 고정 크기 링(ring)에 도착 순서대로 놓이고, (cid, 요청 ID) 해시 버킷이 링 칸 번호를 체인으로 가리킵니다.
+// 찾기/넣기는 버킷 체인 하나만 보므로 재고 규모와 관계없이 일정하고, 만료는 링의 가장 오래된 쪽부터 잘라냅니다.
+// 표는 메모리에만 있으므로 서버를 다시 시작하면 비워집니다.
+// =====================================================================
+
+#define DEDUP_BUCKETS 65536     // 2의 거듭제곱
+
+enum { SLOT_EMPTY, SLOT_PENDING, SLOT_DONE };
+
+typedef struct {
+    uint32_t cid, rid, cmd;
+    int state;
+    int code, out_p;
+    char* msg;              // 처리 결과 (SLOT_DONE 일 때)
+    time_t at;              // CLOCK_MONOTONIC 초
+    int next;               // 같은 버킷의 다음 칸 (-1 끝)
+} DedupSlot;
+
+static DedupSlot ring[DEDUP_CAPACITY];
+static int buckets[DEDUP_BUCKETS];
+static int oldest = 0, count = 0;   // 링의 가장 오래된 칸과 사용 중인 칸 수 (중간에 비운 칸 포함)
+static int initialized = 0;
+static pthread_mutex_t dedup_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dedup_cond = PTHREAD_COND_INITIALIZER;
+
+// 통계 (dedup_mutex 보호)
+static unsigned long stored = 0, hits = 0, waits = 0, expired = 0, refused = 0;
+
+static time_t now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+static unsigned bucket_of(uint32_t cid, uint32_t rid) {
+    return ((cid * 2654435761u) ^ (rid * 0x9E3779B1u) ^ (rid >> 16)) & (DEDUP_BUCKETS - 1);
+}
+
+static void init_table(void) {
+    for (int i = 0; i < DEDUP_BUCKETS; i++) buckets[i] = -1;
+    initialized = 1;
+}
+
+static int find_slot(uint32_t cid, uint32_t rid) {
+    for (int i = buckets[bucket_of(cid, rid)]; i >= 0; i = ring[i].next)
+        if (ring[i].cid == cid && ring[i].rid == rid) return i;
+    return -1;
+}
+
+// 칸을 버킷 체인에서 떼고 비움
+static void clear_slot(int idx) {
+    DedupSlot* s = &ring[idx];
+    if (s->state == SLOT_EMPTY) return;
+    int* link = &buckets[bucket_of(s->cid, s->rid)];
+    while (*link >= 0 && *link != idx) link = &ring[*link].next;
+    if (*link == idx) *link = s->next;
+    free(s->msg);
+    memset(s, 0, sizeof(*s));
+    s->next = -1;
+}
+
+// 링 앞쪽의 빈 칸과 시간이 지난 완료 칸을 잘라냄 (처리 중인 칸은 끝날 때까지 둠)
+static void trim_expired(time_t now) {
+    while (count > 0) {
+        DedupSlot* s = &ring[oldest];
+        if (s->state == SLOT_PENDING) break;
+        if (s->state == SLOT_DONE) {
+            if (now - s->at < DEDUP_WINDOW_SEC) break;
+            clear_slot(oldest);
+            expired++;
+        }
+        oldest = (oldest + 1) % DEDUP_CAPACITY;
+        count--;
+    }
+}
+
+int dedup_begin(uint32_t cid, uint32_t rid, uint32_t cmd, int* code, int* out_p, char* msg, size_t size) {
+    pthread_mutex_lock(&dedup_mutex);
+    if (!initialized) init_table();
+    time_t now = now_sec();
+    trim_expired(now);
+
+    int idx = find_slot(cid, rid);
+    if (idx >= 0 && ring[idx].state == SLOT_DONE && now - ring[idx].at >= DEDUP_WINDOW_SEC) {
+        clear_slot(idx);
+        idx = -1;
+    }
+    if (idx >= 0 && ring[idx].cmd != cmd) {
+        pthread_mutex_unlock(&dedup_mutex);
+        *code = RESP_OK; *out_p = 0;
+        snprintf(msg, size, "[오류] 이미 다른 명령에 쓰인 요청 ID 입니다 (#%u)", rid);
+        return DEDUP_HIT;
+    }
+
+    if (idx >= 0) {
+        // 같은 요청이 아직 처리 중이면 끝나기를 기다림 (칸이 다른 요청에 넘어가면 그만 기다림)
+        if (ring[idx].state == SLOT_PENDING) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += DEDUP_WAIT_MS / 1000;
+            ts.tv_nsec += (DEDUP_WAIT_MS % 1000) * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+            waits++;
+            while ((idx = find_slot(cid, rid)) >= 0 && ring[idx].state == SLOT_PENDING &&
+                   pthread_cond_timedwait(&dedup_cond, &dedup_mutex, &ts) != ETIMEDOUT) {}
+        }
+        if (idx >= 0 && ring[idx].state == SLOT_DONE) {
+            *code = ring[idx].code;
+            *out_p = ring[idx].out_p;
+            snprintf(msg, size, "%s", ring[idx].msg ? ring[idx].msg : "");
+            hits++;
+            pthread_mutex_unlock(&dedup_mutex);
+            return DEDUP_HIT;
+        }
+        if (idx >= 0) {
+            // 기다려도 끝나지 않음: 다시 실행하지 않고 나중에 같은 ID 로 물어보게 함
+            pthread_mutex_unlock(&dedup_mutex);
+            *code = RESP_BUSY; *out_p = 0;
+            snprintf(msg, size, "[안내] 같은 요청을 아직 처리 중입니다. 잠시 후 다시 시도해 주세요.");
+            return DEDUP_HIT;
+        }
+        // 처리 중이던 요청이 거절되어 빠짐 -> 새로 실행
+    }
+
+    // 링이 가득 참: 앞쪽의 빈 칸과 기간이 지난 칸은 trim_expired 가 이미 잘라냈으므로 가장 오래된 칸은
+    // 처리 중이거나 기간 안의 완료 칸. 버리면 그 요청의 재전송이 표에서 빠져 한 번 더 실행되므로 새 요청을 거절
+    // (거절은 실행하지 않은 것이므로 같은 ID 로 다시 보내면 됨)
+    if (count == DEDUP_CAPACITY) {
+        refused++;
+        pthread_mutex_unlock(&dedup_mutex);
+        *code = RESP_BUSY; *out_p = 0;
+        snprintf(msg, size, "[안내] 보관 중인 요청이 많습니다. 잠시 후 다시 시도해 주세요.");
+        return DEDUP_HIT;
+    }
+    idx = (oldest + count) % DEDUP_CAPACITY;
+    count++;
+    DedupSlot* s = &ring[idx];
+    s->cid = cid; s->rid = rid; s->cmd = cmd;
+    s->state = SLOT_PENDING;
+    s->at = now;
+    s->msg = NULL;
+    unsigned b = bucket_of(cid, rid);
+    s->next = buckets[b];
+    buckets[b] = idx;
+    pthread_mutex_unlock(&dedup_mutex);
+    return DEDUP_NEW;
+}
+
+void dedup_complete(uint32_t cid, uint32_t rid, int code, int out_p, const char* msg) {
+    char* copy = strdup(msg ? msg : "");
+    pthread_mutex_lock(&dedup_mutex);
+    int idx = find_slot(cid, rid);
+    if (idx >= 0 && ring[idx].state == SLOT_PENDING && copy) {
+        DedupSlot* s = &ring[idx];
+        s->state = SLOT_DONE;
+        s->code = code;
+        s->out_p = out_p;
+        s->msg = copy;
+        s->at = now_sec();      // 기간은 처리가 끝난 시점부터 셈
+        copy = NULL;
+        stored++;
+    } else if (idx >= 0 && ring[idx].state == SLOT_PENDING) {
+        clear_slot(idx);        // 메모리 부족: 보관하지 못하면 재전송이 다시 실행되는 편이 기다리게 하는 것보다 나음
+    }
+    pthread_cond_broadcast(&dedup_cond);
+    pthread_mutex_unlock(&dedup_mutex);
+    free(copy);
+}
+
+void dedup_abort(uint32_t cid, uint32_t rid) {
+    pthread_mutex_lock(&dedup_mutex);
+    int idx = find_slot(cid, rid);
+    if (idx >= 0 && ring[idx].state == SLOT_PENDING) clear_slot(idx);
+    pthread_cond_broadcast(&dedup_cond);
+    pthread_mutex_unlock(&dedup_mutex);
+}
+
+void print_dedup_stats(void) {
+    char buf[256];
+    pthread_mutex_lock(&dedup_mutex);
+    int live = 0;
+    for (int i = 0; i < count; i++) if (ring[(oldest + i) % DEDUP_CAPACITY].state != SLOT_EMPTY) live++;
+    snprintf(buf, sizeof(buf), "[중복 제거] 보관 %d/%d (기간 %d초) | 저장 %lu | 재전송 응답 %lu (처리 중 대기 %lu) | 만료 %lu | 가득 차 거절 %lu",
+             live, DEDUP_CAPACITY, DEDUP_WINDOW_SEC, stored, hits, waits, expired, refused);
+    pthread_mutex_unlock(&dedup_mutex);
+    update_log(buf);
+}
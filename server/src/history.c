@@ -0,0 +1,378 @@
+#define _GNU_SOURCE     // fallocate (이력 앞부분 공간 돌려주기)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <unistd.h>
+#include "history.h"
+#include "journal.h"
+#include "inventory.h"
+#include "logger.h"
+#include "utils.h"
+#include "iobackend.h"
+#include "offline.h"
+
+// =====================================================================
+// [시점 복구 및 과거 시점 조회]
+// 매장마다 변경 이력 파일(<DB>.history)에 모든 레코드를 가상 시각과 함께 남기고,
+// SNAPSHOT_EVERY 건마다 전체 상태 스냅샷(<DB>.snap.<오프셋>)을 보관합니다. (스냅샷은 compact.c 가 DB 압축과 함께 씀)
+// 스냅샷 목록(<DB>.snapidx)의 각 줄은 "이력 오프셋 가상시각 파일명" 이며,
+// 과거 시점 t 는 t 이전 마지막 스냅샷 + 그 이후 이력 재생으로 재구성합니다.
+// 보관 정책: 최근 SNAPSHOT_KEEP 개의 스냅샷만 남기고, 가장 오래 남은 스냅샷 앞의 이력은 파일에 구멍을 뚫어
+// (FALLOC_FL_PUNCH_HOLE) 디스크 공간만 돌려줍니다. 오프셋이 그대로라 DB 머리말/스냅샷 목록의 위치는 바뀌지 않고,
+// 지운 끝 위치는 <DB>.histbase 에 남겨 그 앞을 재생하려는 조회를 보관 기간 밖으로 거절합니다.
+// 재구성은 별도의 임시 매장 구조체에서 이루어지므로 라이브 쓰기 경로를 막지 않습니다.
+// =====================================================================
+
+// "oper_db_gangnam.txt" + ".history" -> "oper_db_gangnam.history"
+void make_history_path(const Store* st, const char* suffix, char* out, size_t size) {
+    const char* dot = strrchr(st->db_filename, '.');
+    int stem = dot ? (int)(dot - st->db_filename) : (int)strlen(st->db_filename);
+    snprintf(out, size, "%.*s%s", stem, st->db_filename, suffix);
+}
+
+void history_open(Store* st) {
+    if (st->history_io) return;
+    char path[160];
+    make_history_path(st, ".history", path, sizeof(path));
+    st->history_io = io_open(path, IO_APPEND);
+    st->history_records = 0;
+}
+
+// 줄을 저장 I/O 버퍼에 넣기만 하고, 대량 기록 중이 아니면 I/O 스레드를 깨움 (파일 쓰기는 I/O 스레드가)
+void history_append(Store* st, uint64_t lsn, time_t vt, char op, const char* args) {
+    if (!st->history_io) return;
+    char line[JOURNAL_LINE + 64];
+    int len = snprintf(line, sizeof(line), "%llu %ld %c %s\n", (unsigned long long)lsn, (long)vt, op, args);
+    if (len >= (int)sizeof(line)) { len = sizeof(line) - 1; line[len - 1] = '\n'; }
+    io_append(st->history_io, line, len);
+    if (!st->history_batch) io_submit(st->history_io);
+    st->history_records++;
+}
+
+void history_batch(Store* st, int on) {
+    st->history_batch = on;
+    if (!on && st->history_io) io_submit(st->history_io);
+}
+
+long history_size(Store* st) {
+    return st->history_io ? (long)io_size(st->history_io) : -1;
+}
+
+void history_sync(Store* st) {
+    if (st->history_io) io_drain(st->history_io);
+}
+
+void history_close(Store* st) {
+    io_close(st->history_io);
+    st->history_io = NULL;
+}
+
+void history_add_snapshot(Store* st, long offset, time_t vt, const char* path) {
+    char idx_path[160];
+    make_history_path(st, ".snapidx", idx_path, sizeof(idx_path));
+    FILE* idx = fopen(idx_path, "a");
+    if (idx) {
+        fprintf(idx, "%ld %ld %s\n", offset, (long)vt, path);
+        fclose(idx);
+    }
+}
+
+// 스냅샷 목록 읽기 (반환: 줄 수, *out 은 호출자가 해제)
+typedef struct { long offset, vt; char path[160]; } SnapEntry;
+
+static int read_snapidx(Store* st, SnapEntry** out) {
+    char idx_path[160];
+    make_history_path(st, ".snapidx", idx_path, sizeof(idx_path));
+    *out = NULL;
+    FILE* idx = fopen(idx_path, "r");
+    if (!idx) return 0;
+    int n = 0, cap = 0;
+    SnapEntry e;
+    while (fscanf(idx, "%ld %ld %159s", &e.offset, &e.vt, e.path) == 3) {
+        if (n == cap) {
+            SnapEntry* grown = realloc(*out, sizeof(SnapEntry) * (cap = cap ? cap * 2 : 32));
+            if (!grown) break;
+            *out = grown;
+        }
+        (*out)[n++] = e;
+    }
+    fclose(idx);
+    return n;
+}
+
+long history_pruned(Store* st) {
+    char path[160];
+    long base = 0;
+    make_history_path(st, ".histbase", path, sizeof(path));
+    FILE* fp = fopen(path, "r");
+    if (fp) { if (fscanf(fp, "%ld", &base) != 1) base = 0; fclose(fp); }
+    return base;
+}
+
+void history_prune(Store* st) {
+    SnapEntry* list;
+    int n = read_snapidx(st, &list);
+    if (n <= SNAPSHOT_KEEP) { free(list); return; }
+    int drop = n - SNAPSHOT_KEEP;
+    long keep_from = list[drop].offset;
+
+    // 1. 목록을 먼저 바꿔 끼움 (지울 스냅샷을 새 조회가 고르지 않게)
+    char idx_path[160], tmp[170], base_path[160];
+    make_history_path(st, ".snapidx", idx_path, sizeof(idx_path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", idx_path);
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) { free(list); return; }
+    for (int i = drop; i < n; i++) fprintf(fp, "%ld %ld %s\n", list[i].offset, list[i].vt, list[i].path);
+    if (fclose(fp) != 0 || rename(tmp, idx_path) != 0) { remove(tmp); free(list); return; }
+
+    // 2. 지운 끝 위치를 기록한 뒤에 이력 앞부분 공간을 돌려줌 (기록 전에 멈추면 이력이 그대로 남을 뿐)
+    make_history_path(st, ".histbase", base_path, sizeof(base_path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", base_path);
+    if ((fp = fopen(tmp, "w")) != NULL) {
+        fprintf(fp, "%ld\n", keep_from);
+        int ok = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+        if (fclose(fp) == 0 && ok && rename(tmp, base_path) == 0) {
+            char path[160];
+            make_history_path(st, ".history", path, sizeof(path));
+            int fd = open(path, O_WRONLY);
+            // 구멍 뚫기를 지원하지 않는 파일 시스템이면 이력은 그대로 남음 (스냅샷 정리는 계속)
+            if (fd >= 0) { fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, keep_from); close(fd); }
+        } else remove(tmp);
+    }
+
+    // 3. 오래된 스냅샷 파일 삭제 (읽는 중인 조회는 열어 둔 파일로 끝까지 읽음)
+    for (int i = 0; i < drop; i++) remove(list[i].path);
+    free(list);
+
+    char buf[160];
+    snprintf(buf, sizeof(buf), "[System] 오래된 시점 스냅샷 %d개와 그 앞의 이력을 정리했습니다 (최근 %d개 보관)", drop, SNAPSHOT_KEEP);
+    update_store_log(st, buf);
+}
+
+long history_load_latest(Store* st, Store* dst) {
+    SnapEntry* list;
+    int n = read_snapidx(st, &list);
+    long offset = -1;
+    for (int i = n - 1; i >= 0 && offset < 0; i--) {
+        free_all_resources(dst);
+        if (read_products_file(dst, list[i].path, 1, NULL) >= 0) offset = list[i].offset;
+    }
+    free(list);
+    return offset;
+}
+
+// 열린 묶음: K 를 만날 때까지 "op 인자" 줄을 모아 둠
+struct HistoryGroup {
+    char* buf;
+    size_t len, cap;
+    int direct;                     // 메모리 부족으로 모으지 못함: 남은 레코드는 바로 적용
+};
+
+static long apply_group(Store* dst, HistoryGroup* g) {
+    long n = 0;
+    for (char* p = g->buf; p && p < g->buf + g->len; p += strlen(p) + 1, n++) apply_history_record(dst, p[0], p + 1);
+    g->len = 0;
+    return n;
+}
+
+long history_group_apply(Store* dst, HistoryGroup** g, char op, const char* args) {
+    if (op == 'B') {
+        history_group_free(g);      // 앞 묶음이 닫히지 않았으면 버림
+        *g = calloc(1, sizeof(HistoryGroup));
+        return 0;
+    }
+    if (op == 'K' || op == 'U') {
+        long n = (*g && op == 'K') ? apply_group(dst, *g) : 0;
+        history_group_free(g);
+        return n;
+    }
+    if (!*g) { apply_history_record(dst, op, args); return 1; }
+    if ((*g)->direct) { apply_history_record(dst, op, args); return 1; }
+    size_t need = strlen(args) + 2;
+    if ((*g)->len + need > (*g)->cap) {
+        size_t cap = (*g)->cap ? (*g)->cap * 2 : 4096;
+        while (cap < (*g)->len + need) cap *= 2;
+        char* grown = realloc((*g)->buf, cap);
+        if (!grown) {
+            long n = apply_group(dst, *g) + 1;
+            (*g)->direct = 1;
+            apply_history_record(dst, op, args);
+            return n;
+        }
+        (*g)->buf = grown; (*g)->cap = cap;
+    }
+    (*g)->buf[(*g)->len] = op;
+    memcpy((*g)->buf + (*g)->len + 1, args, need - 1);
+    (*g)->len += need;
+    return 0;
+}
+
+void history_group_free(HistoryGroup** g) {
+    if (!*g) return;
+    free((*g)->buf);
+    free(*g);
+    *g = NULL;
+}
+
+// offset 부터 파일 위치 end 앞까지, 가상 시각 until 까지의 레코드를 재생 (끝날 때 열린 묶음은 *g 에 남음)
+static long replay_range(Store* st, Store* dst, long offset, long end, time_t until, HistoryGroup** g) {
+    char path[160];
+    make_history_path(st, ".history", path, sizeof(path));
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+
+    long applied = 0, pos = offset > 0 ? offset : 0;
+    char line[JOURNAL_LINE];
+    if (offset > 0) fseek(fp, offset, SEEK_SET);
+    while (pos < end && fgets(line, sizeof(line), fp)) {
+        size_t len = strlen(line);
+        if (len == 0 || line[len - 1] != '\n') break;   // 기록 중인 마지막 줄은 건너뜀
+        pos += len;
+        line[len - 1] = '\0';
+
+        unsigned long long lsn; long vt; char op; int off = 0;
+        if (sscanf(line, "%llu %ld %c %n", &lsn, &vt, &op, &off) < 3) continue;
+        if ((time_t)vt > until) break;
+        applied += history_group_apply(dst, g, op, line + off);
+    }
+    fclose(fp);
+    return applied;
+}
+
+long history_replay(Store* st, Store* dst, long offset, time_t until) {
+    HistoryGroup* g = NULL;
+    long applied = replay_range(st, dst, offset, LONG_MAX, until, &g);
+    history_group_free(&g);
+    return applied;
+}
+
+long history_recover(Store* st, long offset) {
+    HistoryGroup* g = NULL;
+    long applied = replay_range(st, st, offset, LONG_MAX, HISTORY_UNTIL_END, &g);
+    // 기록 도중 멈춰 닫히지 않은 묶음: 취소(U)를 남겨 다음 재생이 뒤에 붙는 레코드를 그 묶음으로 읽지 않게
+    if (g) history_append(st, journal_current_lsn(), get_virtual_time(), 'U', "");
+    history_group_free(&g);
+    return applied;
+}
+
+static Store* new_shadow(void) {
+    Store* shadow = calloc(1, sizeof(Store));
+    if (!shadow) return NULL;
+    pthread_mutex_init(&shadow->list_mutex, NULL);
+    init_inventory(shadow);
+    return shadow;
+}
+
+void history_free_shadow(Store* shadow) {
+    if (!shadow) return;
+    free_all_resources(shadow);
+    offline_free(shadow);
+    pthread_mutex_destroy(&shadow->list_mutex);
+    free(shadow);
+}
+
+Store* history_build_asof(Store* st, time_t t, int* too_old) {
+    *too_old = 0;
+    Store* shadow = new_shadow();
+    if (!shadow) return NULL;
+    history_sync(st);              // 아직 I/O 스레드에 있는 최근 이력까지 파일에서 읽히도록
+
+    // 1. t 이전의 마지막 스냅샷 찾기
+    SnapEntry* list;
+    int n = read_snapidx(st, &list);
+    long base_offset = 0;
+    const char* snap_path = NULL;
+    for (int i = 0; i < n; i++) if ((time_t)list[i].vt <= t) { base_offset = list[i].offset; snap_path = list[i].path; }
+    if (snap_path && read_products_file(shadow, snap_path, 0, NULL) < 0) {
+        free_all_resources(shadow);
+        base_offset = 0;           // 스냅샷이 사라졌으면 처음부터 재생
+    }
+    free(list);
+    // 재생을 시작할 이력이 보관 정책으로 지워졌으면 재구성할 수 없음
+    if (base_offset < history_pruned(st)) {
+        history_free_shadow(shadow);
+        *too_old = 1;
+        return NULL;
+    }
+
+    // 2. 스냅샷 이후 이력을 t 까지 재생
+    history_replay(st, shadow, base_offset, t);
+    return shadow;
+}
+
+Store* history_build_at(Store* st, long end) {
+    Store* shadow = new_shadow();
+    if (!shadow) return NULL;
+    // 지난 압축본이 반영한 이력 위치부터 end 까지 재생 (재시작 때 적재하는 것과 같은 과정)
+    long base = -1;
+    if (read_products_file(shadow, st->db_filename, 0, &base) < 0 || base < 0 || base > end || base < history_pruned(st)) {
+        history_free_shadow(shadow);
+        return NULL;
+    }
+    // 원장은 DB 파일에 없으므로 압축 때 함께 쓴 원장 파일에서 (이후 O 레코드는 재생으로)
+    char path[160];
+    make_history_path(st, ".offline", path, sizeof(path));
+    offline_load(shadow, path);
+    history_sync(st);
+    HistoryGroup* g = NULL;
+    replay_range(st, shadow, base, end, HISTORY_UNTIL_END, &g);
+    history_group_free(&g);
+    return shadow;
+}
+
+// 재구성 실패 안내 (보관 기간 밖 / 메모리 부족)
+static void asof_error(int too_old, char* out) {
+    if (too_old) snprintf(out, MAX_PAYLOAD, "[오류] 보관 기간(최근 스냅샷 %d개) 이전 시점은 조회할 수 없습니다", SNAPSHOT_KEEP);
+    else snprintf(out, MAX_PAYLOAD, "[오류] 메모리 부족");
+}
+
+void make_asof_summary(Store* st, time_t t, char* out, int mode) {
+    int too_old;
+    Store* shadow = history_build_asof(st, t, &too_old);
+    if (!shadow) { asof_error(too_old, out); return; }
+
+    char ts[26], title[80];
+    print_time_str(t, ts);
+    snprintf(title, sizeof(title), "%s 시점 %s", ts, mode == 1 ? "만료 재고" : (mode == 2 ? "판매 가능 재고" : "전체 재고"));
+    make_category_summary(shadow, out, mode, title);
+    history_free_shadow(shadow);
+}
+
+int make_asof_detail(Store* st, time_t t, char* out, const char* name, int page, int mode) {
+    int too_old;
+    Store* shadow = history_build_asof(st, t, &too_old);
+    if (!shadow) { asof_error(too_old, out); return 1; }
+    int tp = make_detail_page(shadow, out, name, page, mode);
+    history_free_shadow(shadow);
+    return tp;
+}
+
+void restore_store_to(Store* st, time_t t, char* msg) {
+    int too_old;
+    Store* shadow = history_build_asof(st, t, &too_old);
+    if (!shadow) { asof_error(too_old, msg); return; }
+
+    char ts[26]; print_time_str(t, ts);
+    store_lock(st);
+    replace_products(st, shadow);
+    journal_all_products(st);      // 복원 결과를 R + A 로 남겨 복제본/이력이 따라오게 함
+    long cnt = st->item_count;
+    save_data(st);
+    store_unlock(st);
+    history_free_shadow(shadow);
+
+    snprintf(msg, MAX_PAYLOAD, "[복원] %s 시점으로 재고 복원 완료 (%ld개)", ts, cnt);
+    update_store_log(st, msg);
+}
+
+int parse_time_str(const char* str, time_t* out) {
+    struct tm tm_info; memset(&tm_info, 0, sizeof(tm_info));
+    int n = sscanf(str, "%d-%d-%d %d:%d:%d", &tm_info.tm_year, &tm_info.tm_mon, &tm_info.tm_mday,
+                   &tm_info.tm_hour, &tm_info.tm_min, &tm_info.tm_sec);
+    if (n < 5) return 0;
+    tm_info.tm_year -= 1900; tm_info.tm_mon -= 1; tm_info.tm_isdst = -1;
+    *out = mktime(&tm_info);
+    return *out != (time_t)-1;
+}
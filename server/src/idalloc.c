@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "idalloc.h"
+#include "history.h"
+#include "logger.h"
+#include "utils.h"
+
+// =====================================================================
+// [상품 번호 발급기]
+// 파일: "<DB 이름>.ids" 에 발급 한도 한 줄. 한도는 항상 지금까지 내준 번호보다 크게 먼저 기록하므로
+// 서버가 죽으면 한도 아래의 안 쓴 번호만 건너뛸 뿐 같은 번호를 두 번 내주지 않습니다.
+// 파일이 없는 예전 DB 는 적재 때 접두어별 번호 대신 모든 ID 번호의 최댓값을 다음 번호로 삼고 바로 파일을 만듭니다.
+// =====================================================================
+
+uint64_t id_number(const char* id) {
+    if (!id[0] || id[1] != '_' || !id[2]) return 0;
+    uint64_t n = 0;
+    for (const char* p = id + 2; *p; p++) {
+        if (*p < '0' || *p > '9' || n > (UINT64_MAX - 9) / 10) return 0;
+        n = n * 10 + (*p - '0');
+    }
+    return n;
+}
+
+// 임시 파일에 쓰고 디스크에 내린 뒤 바꿔 끼움 (기록 중에 죽어도 이전 한도가 남음)
+static int write_limit(Store* st, uint64_t limit) {
+    char path[160], tmp[170];
+    make_history_path(st, ".ids", path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* fp = fopen(tmp, "w");
+    if (!fp) return 0;
+    fprintf(fp, "%llu\n", (unsigned long long)limit);
+    int ok = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    if (fclose(fp) != 0 || !ok || rename(tmp, path) != 0) { remove(tmp); return 0; }
+    st->id_limit = limit;
+    return 1;
+}
+
+int idalloc_load(Store* st) {
+    char path[160];
+    unsigned long long limit = 0;
+    st->id_durable = 1;
+    make_history_path(st, ".ids", path, sizeof(path));
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+    int ok = fscanf(fp, "%llu", &limit) == 1 && limit > 0;
+    fclose(fp);
+    if (!ok) return 0;
+    // 지난번에 잡아 둔 구간의 남은 번호는 버리고 한도부터 시작 (어디까지 내줬는지는 기록하지 않으므로)
+    if (limit > st->id_next) st->id_next = limit;
+    st->id_limit = limit;
+    return 1;
+}
+
+int idalloc_take(Store* st, uint64_t n, uint64_t* first) {
+    if (st->id_next == 0) st->id_next = 1;
+    // 마지막 번호까지 17자리 안이어야 함 (넘으면 ID 가 잘려 서로 겹침) - 잘라서 내주지 않고 발급 자체를 거절
+    if (n > 0 && (st->id_next > ID_NUMBER_MAX || n > ID_NUMBER_MAX - st->id_next + 1)) return ID_TAKE_EXHAUSTED;
+    if (st->id_durable && (st->id_limit == 0 || st->id_next + n > st->id_limit) &&
+        !write_limit(st, st->id_next + n + ID_RESERVE_BLOCK)) return ID_TAKE_FAILED;
+    if (first) *first = st->id_next;
+    st->id_next += n;
+    return ID_TAKE_OK;
+}
+
+const char* idalloc_error(int r) {
+    return r == ID_TAKE_EXHAUSTED ? "[오류] 상품 번호가 소진되었습니다 (17자리 초과)" : "[오류] 상품 번호 한도를 기록하지 못했습니다";
+}
+
+int idalloc_issued(Store* st, const char* id) {
+    uint64_t num = id_number(id);
+    return num == 0 || num < st->id_next;
+}
+
+void idalloc_observe(Store* st, const char* id) {
+    uint64_t num = id_number(id);
+    if (num < st->id_next || num == UINT64_MAX) return;
+    st->id_next = num + 1;
+    // 한도 위의 번호가 이미 쓰였으면 다음 발급을 기다리지 않고 바로 한도를 올림 (다시 시작한 뒤 겹치지 않도록)
+    // 한도 파일이 아직 없는 적재 도중에는 load_data 가 끝에서 한 번만 기록
+    if (st->id_durable && st->id_limit && st->id_next > st->id_limit) write_limit(st, st->id_next + ID_RESERVE_BLOCK);
+}
+
+void handle_id_lease(Store* st, uint32_t cid, char* pin, char* msg) {
+    store_lock(st);
+    long n = atol(pin);
+    uint64_t first;
+    int r = 0;
+    if (n <= 0 || n > ID_LEASE_MAX) snprintf(msg, MAX_PAYLOAD, "[오류] 임대 수량은 1~%d 입니다", ID_LEASE_MAX);
+    else if ((r = idalloc_take(st, (uint64_t)n, &first)) != ID_TAKE_OK) {
+        snprintf(msg, MAX_PAYLOAD, "%s", idalloc_error(r));
+        update_store_log(st, msg);
+    } else {
+        snprintf(msg, MAX_PAYLOAD, "%llu\t%llu", (unsigned long long)first, (unsigned long long)(first + n - 1));
+        char buf[128];
+        snprintf(buf, sizeof(buf), "[POS-%04d] 상품 번호 임대 %llu~%llu", cid, (unsigned long long)first, (unsigned long long)(first + n - 1));
+        update_store_log(st, buf);
+    }
+    store_unlock(st);
+}
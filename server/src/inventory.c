@@ -2,94 +2,806 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "inventory.h"
 #include "utils.h"
 #include "logger.h"
+#include "journal.h"
+#include "replication.h"
+#include "history.h"
+#include "push.h"
+#include "scheduler.h"
+#include "parallel.h"
+#include "compact.h"
+#include "itemmeta.h"
+#include "offline.h"
+#include "idalloc.h"
+#include "snapfile.h"
+#include "coldtier.h"
+#include "trace.h"
 
 // [내부 데이터 구조체 은닉]
+// 상품 목록은 이중 연결 리스트이고, 예약되지 않은 상품은 분류별 FEFO 힙에도 들어 있습니다.
+// 만료된 상품은 목록에서 빠져 만료 보관소(coldtier.c)로 옮겨지므로 목록에는 판매 가능한 상품만 남습니다.
 typedef struct Product {
     char id[20]; 
     char name[50]; 
     time_t expire_time; 
-    int is_expired;
-    struct Product* next;
+    int heap_pos;                       // 분류별 FEFO 힙 내 위치 (-1 = 힙 밖: 만료/예약/색인 없음)
+    uint32_t meta;                      // 가격/로트 등 부가 정보 슬롯 (itemmeta.c, 0 = 없음) - 정렬 빈 자리라 크기 그대로
+    struct Reservation* hold;           // 이 상품을 잡아 둔 예약 (NULL = 자유 재고)
+    struct Product *hold_prev, *hold_next;
+    struct Product *prev, *next;
 } Product;
 
-static Product* head = NULL;
-pthread_mutex_t list_mutex = PTHREAD_MUTEX_INITIALIZER;
+// [장바구니 예약] 단말기(cid)가 분류 하나에 대해 잡아 둔 수량. 상품은 유통기한 순으로 매달림
+typedef struct Reservation {
+    uint32_t owner;                     // 예약 주인 (session.h, 단말기가 고른 cid 가 아님)
+    int category;
+    int qty;
+    time_t until;                       // 이 가상 시각이 지나면 자동 해제
+    Product *items, *items_tail;
+    struct Reservation *older, *newer;  // 만료 순서 큐 (TTL 이 일정하므로 until 오름차순 유지)
+    struct Reservation* hnext;          // 주인 번호 해시 체인
+} Reservation;
 
-extern char db_filename[50];
+#define HOLD_BUCKETS 64
+
+// [재고 색인] 분류별 FEFO 최소 힙 + 예약 표. 처음 필요할 때 목록에서 만들고,
+// 목록이 통째로 바뀌면(비움/복원/전체 동기화) 버렸다가 다시 만듭니다. (시점 조회용 임시 매장은 만들지 않음)
+// 분류표에 없는 이름의 상품은 마지막 칸(OTHER_SLOT) 힙에 모아 만료 검사가 목록을 훑지 않게 합니다.
+#define OTHER_SLOT NUM_CATEGORIES
+#define HEAP_SLOTS (NUM_CATEGORIES + 1)
+
+typedef struct StockIndex {
+    Product** heap[HEAP_SLOTS];
+    int len[HEAP_SLOTS], cap[HEAP_SLOTS];
+    int held[NUM_CATEGORIES];
+    Reservation* buckets[HOLD_BUCKETS];
+    Reservation *oldest, *newest;
+    int stale;                          // 힙 확장 실패로 빠진 상품이 있음 -> 다음 사용 때 다시 만듦
+} StockIndex;
 
 static char r_types[10][50] = {"김밥", "샌드위치", "우유", "도시락", "컵라면", "콜라", "생수", "과자", "아이스크림", "커피"};
 static char r_prefixes[10] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J'};
-static int r_counts[10] = {0};
+
+int category_of(const char* name) {
+    for (int i = 0; i < NUM_CATEGORIES; i++) if (strcmp(name, r_types[i]) == 0) return i;
+    return -1;
+}
+
+const char* category_name(int idx) {
+    return (idx >= 0 && idx < NUM_CATEGORIES) ? r_types[idx] : "?";
+}
+
+static int heap_slot(const char* name) {
+    int cat = category_of(name);
+    return cat < 0 ? OTHER_SLOT : cat;
+}
 
 // [내부 헬퍼 함수]
-static int compare_products(const void* a, const void* b) {
-    Product* p1 = *(Product**)a; Product* p2 = *(Product**)b;
+// 상세 목록 한 줄 (락을 양보하는 동안 상품이 삭제될 수 있으므로 포인터 대신 필드를 복사)
+typedef struct { char id[20]; time_t expire_time; int is_expired; } DetailRow;
+
+static int compare_rows(const void* a, const void* b) {
+    const DetailRow* p1 = a; const DetailRow* p2 = b;
     return (p1->expire_time < p2->expire_time) ? -1 : (p1->expire_time > p2->expire_time);
 }
 
-static int is_id_exists(char* id) {
-    for(Product* c = head; c; c = c->next) if(strcmp(c->id, id) == 0) return 1;
-    return 0;
+// =====================================================================
+// [FEFO 힙] 분류별로 유통기한이 가장 이른 판매 가능 상품이 맨 앞
+// =====================================================================
+static void heap_swap(Product** h, int i, int j) {
+    Product* t = h[i]; h[i] = h[j]; h[j] = t;
+    h[i]->heap_pos = i; h[j]->heap_pos = j;
+}
+
+static void heap_up(Product** h, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (h[parent]->expire_time <= h[i]->expire_time) break;
+        heap_swap(h, i, parent); i = parent;
+    }
+}
+
+static void heap_down(Product** h, int n, int i) {
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && h[l]->expire_time < h[m]->expire_time) m = l;
+        if (r < n && h[r]->expire_time < h[m]->expire_time) m = r;
+        if (m == i) break;
+        heap_swap(h, i, m); i = m;
+    }
+}
+
+// 판매 가능 상품을 힙에 넣음 (색인이 없거나 대상이 아니면 무시)
+static void index_add(Store* st, Product* p) {
+    StockIndex* ix = st->stock_index;
+    int cat = heap_slot(p->name);
+    if (!ix || p->hold || p->heap_pos >= 0) return;
+    if (ix->len[cat] == ix->cap[cat]) {
+        int cap = ix->cap[cat] ? ix->cap[cat] * 2 : 64;
+        Product** h = realloc(ix->heap[cat], sizeof(Product*) * cap);
+        if (!h) { ix->stale = 1; return; }
+        ix->heap[cat] = h; ix->cap[cat] = cap;
+    }
+    int i = ix->len[cat]++;
+    ix->heap[cat][i] = p; p->heap_pos = i;
+    heap_up(ix->heap[cat], i);
+}
+
+static void index_remove(Store* st, Product* p) {
+    StockIndex* ix = st->stock_index;
+    if (!ix || p->heap_pos < 0) return;
+    int cat = heap_slot(p->name);
+    Product** h = ix->heap[cat];
+    int i = p->heap_pos, last = --ix->len[cat];
+    p->heap_pos = -1;
+    if (i == last) return;
+    h[i] = h[last]; h[i]->heap_pos = i;
+    heap_up(h, i);
+    heap_down(h, ix->len[cat], h[i]->heap_pos);
+}
+
+// =====================================================================
+// [예약 표] 예약 주인 번호 해시로 찾고, 만료 순서 큐의 앞에서부터 TTL 이 지난 예약을 해제
+// =====================================================================
+static Reservation* find_hold(StockIndex* ix, uint32_t owner, int cat) {
+    for (Reservation* r = ix->buckets[owner % HOLD_BUCKETS]; r; r = r->hnext)
+        if (r->owner == owner && r->category == cat) return r;
+    return NULL;
+}
+
+// 예약을 만료 순서 큐의 맨 뒤로 옮기고 만료 시각 갱신
+static void touch_hold(StockIndex* ix, Reservation* r, time_t until) {
+    if (r->older || ix->oldest == r) {
+        if (r->older) r->older->newer = r->newer; else ix->oldest = r->newer;
+        if (r->newer) r->newer->older = r->older; else ix->newest = r->older;
+    }
+    r->until = until;
+    r->older = ix->newest; r->newer = NULL;
+    if (ix->newest) ix->newest->newer = r; else ix->oldest = r;
+    ix->newest = r;
+}
+
+// 예약에서 상품 하나를 뗌 (힙으로 돌려보내는 것은 호출자 몫)
+static void unhold_unit(StockIndex* ix, Product* p) {
+    Reservation* r = p->hold;
+    if (p->hold_prev) p->hold_prev->hold_next = p->hold_next; else r->items = p->hold_next;
+    if (p->hold_next) p->hold_next->hold_prev = p->hold_prev; else r->items_tail = p->hold_prev;
+    p->hold = NULL; p->hold_prev = p->hold_next = NULL;
+    r->qty--; ix->held[r->category]--;
+}
+
+static void hold_unit(StockIndex* ix, Reservation* r, Product* p) {
+    p->hold = r;
+    p->hold_prev = r->items_tail; p->hold_next = NULL;
+    if (r->items_tail) r->items_tail->hold_next = p; else r->items = p;
+    r->items_tail = p;
+    r->qty++; ix->held[r->category]++;
+}
+
+// 예약 해제: 잡아 둔 상품은 자유 재고(힙)로 돌아감
+static void free_hold(Store* st, Reservation* r) {
+    StockIndex* ix = st->stock_index;
+    while (r->items) { Product* p = r->items; unhold_unit(ix, p); index_add(st, p); }
+    if (r->older) r->older->newer = r->newer; else ix->oldest = r->newer;
+    if (r->newer) r->newer->older = r->older; else ix->newest = r->older;
+    for (Reservation** pp = &ix->buckets[r->owner % HOLD_BUCKETS]; *pp; pp = &(*pp)->hnext)
+        if (*pp == r) { *pp = r->hnext; break; }
+    free(r);
+}
+
+static int expire_holds(Store* st, time_t now) {
+    StockIndex* ix = st->stock_index;
+    int n = 0;
+    while (ix && ix->oldest && ix->oldest->until <= now) { free_hold(st, ix->oldest); n++; }
+    return n;
+}
+
+static void drop_index(Store* st) {
+    StockIndex* ix = st->stock_index;
+    if (!ix) return;
+    for (int i = 0; i < HOLD_BUCKETS; i++) {
+        for (Reservation* r = ix->buckets[i]; r; ) { Reservation* next = r->hnext; free(r); r = next; }
+    }
+    for (int i = 0; i < HEAP_SLOTS; i++) free(ix->heap[i]);
+    free(ix);
+    st->stock_index = NULL;
+    for (Product* c = st->head; c; c = c->next) { c->heap_pos = -1; c->hold = NULL; c->hold_prev = c->hold_next = NULL; }
+}
+
+static StockIndex* ensure_index(Store* st) {
+    if (st->stock_index && !st->stock_index->stale) return st->stock_index;
+    drop_index(st);
+    st->stock_index = calloc(1, sizeof(StockIndex));
+    if (!st->stock_index) return NULL;
+    for (Product* c = st->head; c; c = c->next) index_add(st, c);
+    return st->stock_index;
+}
+
+// =====================================================================
+// [ID 색인] ID 문자열 해시 -> 상품. 선형 탐사 개방 주소 표이고, 지울 때는 뒤따르는 칸을 당겨 와 빈 칸 표시가 없습니다.
+// 중복 검사/단일 삭제/이력 재생의 ID 찾기가 목록을 훑지 않도록 처음 찾을 때 만들고, 그 뒤로는 연결/제거 때 함께 갱신합니다.
+// =====================================================================
+typedef struct IdIndex {
+    Product** slots;
+    long cap, len;                      // cap 은 2의 거듭제곱, len 은 cap 의 70% 이하
+} IdIndex;
+
+static unsigned long id_hash(const char* id) {
+    unsigned long h = 1469598103934665603UL;
+    for (; *id; id++) h = (h ^ (unsigned char)*id) * 1099511628211UL;
+    return h;
+}
+
+static void drop_id_index(Store* st) {
+    if (!st->id_index) return;
+    free(st->id_index->slots);
+    free(st->id_index);
+    st->id_index = NULL;
+}
+
+static void id_index_put(IdIndex* ix, Product* p) {
+    long mask = ix->cap - 1, i = id_hash(p->id) & mask;
+    while (ix->slots[i]) i = (i + 1) & mask;
+    ix->slots[i] = p; ix->len++;
+}
+
+static int id_index_grow(IdIndex* ix) {
+    long cap = ix->cap ? ix->cap * 2 : 1024;
+    Product** old = ix->slots;
+    long old_cap = ix->cap;
+    if (!(ix->slots = calloc(cap, sizeof(Product*)))) { ix->slots = old; return 0; }
+    ix->cap = cap; ix->len = 0;
+    for (long i = 0; i < old_cap; i++) if (old[i]) id_index_put(ix, old[i]);
+    free(old);
+    return 1;
+}
+
+// 색인이 있으면 함께 넣음 (늘리지 못하면 색인을 버리고 다음 찾기 때 다시 만듦)
+static void id_index_add(Store* st, Product* p) {
+    IdIndex* ix = st->id_index;
+    if (!ix) return;
+    if ((ix->len + 1) * 10 > ix->cap * 7 && !id_index_grow(ix)) { drop_id_index(st); return; }
+    id_index_put(ix, p);
+}
+
+static void id_index_remove(Store* st, Product* p) {
+    IdIndex* ix = st->id_index;
+    if (!ix) return;
+    long mask = ix->cap - 1, i = id_hash(p->id) & mask;
+    while (ix->slots[i] && ix->slots[i] != p) i = (i + 1) & mask;
+    if (!ix->slots[i]) return;
+    ix->slots[i] = NULL; ix->len--;
+    // 빈 칸 뒤에 이어진 항목 중 원래 자리가 빈 칸 쪽에 있는 것을 당겨 옴
+    for (long j = (i + 1) & mask; ix->slots[j]; j = (j + 1) & mask) {
+        long home = id_hash(ix->slots[j]->id) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) { ix->slots[i] = ix->slots[j]; ix->slots[j] = NULL; i = j; }
+    }
+}
+
+// ID 로 상품 찾기 (색인을 만들 메모리가 없으면 목록을 훑음)
+static Product* find_by_id(Store* st, const char* id) {
+    if (!st->id_index && (st->id_index = calloc(1, sizeof(IdIndex))) != NULL) {
+        long need = 1024;
+        while (need * 7 < (st->item_count + 1) * 10) need *= 2;
+        if ((st->id_index->slots = calloc(need, sizeof(Product*))) == NULL) drop_id_index(st);
+        else {
+            st->id_index->cap = need;
+            for (Product* c = st->head; c; c = c->next) id_index_put(st->id_index, c);
+        }
+    }
+    IdIndex* ix = st->id_index;
+    if (!ix) {
+        for (Product* c = st->head; c; c = c->next) if (strcmp(c->id, id) == 0) return c;
+        return NULL;
+    }
+    long mask = ix->cap - 1;
+    for (long i = id_hash(id) & mask; ix->slots[i]; i = (i + 1) & mask)
+        if (strcmp(ix->slots[i]->id, id) == 0) return ix->slots[i];
+    return NULL;
+}
+
+// =====================================================================
+// [상품 목록] 연결/제거/만료 표시는 모두 여기를 거쳐 색인과 함께 갱신
+// =====================================================================
+// 매장별 메모리 통계를 함께 갱신하는 할당 래퍼
+static Product* alloc_product(Store* st) {
+    Product* n = calloc(1, sizeof(Product));
+    if (n) { n->heap_pos = -1; st->item_count++; st->mem_bytes += sizeof(Product); }
+    return n;
+}
+
+static void link_product(Store* st, Product* p) {
+    p->prev = NULL; p->next = st->head;
+    if (st->head) st->head->prev = p;
+    st->head = p;
+    index_add(st, p);
+    id_index_add(st, p);
+}
+
+// =====================================================================
+// [긴 조회의 락 양보] SCAN_CHUNK 개를 훑을 때마다 급한 작업(판매 등)이 기다리는지 보고,
+// 있으면 다음 위치를 커서로 등록한 채 list_mutex 를 놓았다가 다시 잡습니다.
+// 그 사이 커서가 가리키던 상품이 삭제되면 remove_product 가 커서를 다음 상품으로 옮깁니다.
+// (양보한 조회의 결과는 그 사이의 변경이 일부 섞인 근사치 - 보고서 용도로만 사용)
+// =====================================================================
+#define SCAN_CHUNK 2048
+
+typedef struct ScanCursor {
+    Product* next;
+    struct ScanCursor* link;
+    int cleared;            // 그 사이 목록이 통째로 비워짐 (free_all_resources)
+} ScanCursor;
+
+// 아직 처리하지 않은 상품 c 에서 멈추고, 재개할 상품(삭제됐으면 그 다음, 목록이 비었으면 NULL)을 돌려줌
+static Product* scan_yield(Store* st, Product* c) {
+    if (!sched_urgent_pending(st)) return c;
+    ScanCursor cur = { .next = c, .link = st->scan_cursors };
+    st->scan_cursors = &cur;
+    store_unlock(st);
+    sched_wait_urgent(st);
+    store_lock(st);
+    for (ScanCursor** pp = &st->scan_cursors; *pp; pp = &(*pp)->link)
+        if (*pp == &cur) { *pp = cur.link; break; }
+    return cur.next;
+}
+
+static void remove_product(Store* st, Product* p) {
+    for (ScanCursor* c = st->scan_cursors; c; c = c->link) if (c->next == p) c->next = p->next;
+    if (p->hold) unhold_unit(st->stock_index, p);
+    index_remove(st, p);
+    id_index_remove(st, p);
+    if (p->prev) p->prev->next = p->next; else st->head = p->next;
+    if (p->next) p->next->prev = p->prev;
+    meta_drop(st, p->meta);
+    st->item_count--; st->mem_bytes -= sizeof(Product);
+    free(p);
+}
+
+// 만료된 상태로 보관소에 넣음 (실패하면 부가 정보 슬롯도 놓음)
+static ColdItem* add_cold(Store* st, const char* id, const char* name, time_t expire_time, uint32_t meta) {
+    meta_mark_expired(st, meta);
+    ColdItem* c = cold_add(st, id, name, expire_time, meta);
+    if (!c) meta_drop(st, meta);
+    return c;
+}
+
+// 만료: 목록/색인에서 빼 보관소로 옮김. 보관소에 넣을 메모리가 없으면 목록에 그대로 두고 0 (다음 검사 때 다시)
+static int mark_expired(Store* st, Product* p) {
+    if (!cold_add(st, p->id, p->name, p->expire_time, p->meta)) return 0;
+    meta_mark_expired(st, p->meta);
+    p->meta = 0;                        // 슬롯은 보관소 항목이 이어받음
+    remove_product(st, p);
+    return 1;
+}
+
+// DB/저널 줄의 부가 정보 부분 (" 가격 로트 공급사 위치", 없으면 "")
+static void format_meta(Store* st, uint32_t slot, char* out, size_t size) {
+    ItemMeta m;
+    meta_get(st, slot, &m);
+    meta_format(&m, out, size);
+}
+
+// 변경 사항을 저널에 남김 (A: 전체 필드 + 부가 정보, D/X: ID만)
+static void journal_product(Store* st, char op, const Product* p) {
+    char args[JOURNAL_LINE], extra[META_LINE_LEN];
+    if (op == 'A') {
+        format_meta(st, p->meta, extra, sizeof(extra));
+        snprintf(args, sizeof(args), "%s %s %ld 0%s", p->id, p->name, (long)p->expire_time, extra);
+    }
+    else snprintf(args, sizeof(args), "%s", p->id);
+    journal_append(st, op, args);
+}
+
+// 보관소 항목의 A 레코드 (콜백 인자는 매장)
+static void journal_cold(void* arg, const ColdItem* c) {
+    Store* st = arg;
+    char args[JOURNAL_LINE], extra[META_LINE_LEN];
+    format_meta(st, c->meta, extra, sizeof(extra));
+    snprintf(args, sizeof(args), "%s %s %ld 1%s", c->id, cold_name(st, c), (long)c->expire_time, extra);
+    journal_append(st, 'A', args);
+}
+
+// 폐기: 보관소에서 빼기 전에 D 를 남기고 부가 정보 슬롯을 놓음 (cold_clear 콜백, 인자는 매장)
+static void discard_cold(void* arg, const ColdItem* c) {
+    Store* st = arg;
+    journal_append(st, 'D', c->id);
+    meta_drop(st, c->meta);
 }
 
 // [공개 API 구현]
-void init_inventory(void) {
-    head = NULL;
-    for(int i=0; i<10; i++) r_counts[i] = 0;
+void init_inventory(Store* st) {
+    st->head = NULL;
+    st->item_count = 0; st->mem_bytes = 0;
 }
 
-void save_data(void) {
-    FILE *fp = fopen(db_filename, "w");
-    if (!fp) return;
-    for(Product* c = head; c; c = c->next)
-        fprintf(fp, "%s %s %ld %d\n", c->id, c->name, (long)c->expire_time, c->is_expired);
-    fclose(fp);
-    save_config(); 
+typedef struct {
+    Store* st;
+    ProductRow* rows;
+    long n, max;
+    char* extras;
+    size_t ext_len, ext_cap;
+    int failed;
+} RowCopy;
+
+static void copy_row(RowCopy* rc, const char* id, const char* name, time_t expire_time, int is_expired, uint32_t meta) {
+    if (rc->failed || rc->n >= rc->max) return;
+    ProductRow* r = &rc->rows[rc->n++];
+    memcpy(r->id, id, sizeof(r->id));
+    memcpy(r->name, name, sizeof(r->name));
+    r->expire_time = (long)expire_time;
+    r->is_expired = is_expired;
+    r->extra = -1;
+    if (!meta) return;
+    // 부가 정보가 있는 상품만 별도 버퍼에 줄 꼬리를 미리 만들어 둠
+    if (rc->ext_cap - rc->ext_len < META_LINE_LEN) {
+        char* grown = realloc(rc->extras, rc->ext_cap = rc->ext_cap ? rc->ext_cap * 2 : 64 * META_LINE_LEN);
+        if (!grown) { rc->failed = 1; return; }
+        rc->extras = grown;
+    }
+    r->extra = (long)rc->ext_len;
+    format_meta(rc->st, meta, rc->extras + rc->ext_len, META_LINE_LEN);
+    rc->ext_len += strlen(rc->extras + rc->ext_len) + 1;
 }
 
-void load_data(void) {
-    FILE *fp = fopen(db_filename, "r");
-    if (!fp) { update_log("[System] 새로운 데이터베이스 생성"); return; }
-    
-    char id[20], name[50]; long et; int ie; int cnt = 0;
-    while(fscanf(fp, "%s %s %ld %d", id, name, &et, &ie) == 4) {
-        Product* n = malloc(sizeof(Product));
-        if (n) { 
-            strcpy(n->id, id); strcpy(n->name, name);
-            n->expire_time = (time_t)et; n->is_expired = ie;
-            n->next = head; head = n; cnt++;
-            char pre; int num;
-            if (sscanf(id, "%c_%d", &pre, &num) == 2) {
-                for(int i=0; i<10; i++) if(r_prefixes[i] == pre && num > r_counts[i]) r_counts[i] = num;
-            }
+static void copy_cold_row(void* arg, const ColdItem* c) {
+    RowCopy* rc = arg;
+    copy_row(rc, c->id, cold_name(rc->st, c), c->expire_time, 1, c->meta);
+}
+
+ProductRow* copy_product_rows(Store* st, long* count, char** extras) {
+    *count = 0; *extras = NULL;
+    RowCopy rc = { .st = st, .max = st->item_count };
+    if (!(rc.rows = malloc(sizeof(ProductRow) * (st->item_count > 0 ? st->item_count : 1)))) return NULL;
+    for (Product* c = st->head; c; c = c->next) copy_row(&rc, c->id, c->name, c->expire_time, 0, c->meta);
+    cold_each(st, NULL, copy_cold_row, &rc);
+    if (rc.failed) { free(rc.rows); free(rc.extras); return NULL; }
+    *count = rc.n; *extras = rc.extras;
+    return rc.rows;
+}
+
+// =====================================================================
+// [병렬 적재] DB/스냅샷 파일을 스레드 수만큼 나눠 각 스레드가 따로 읽습니다.
+// 압축 스냅샷 형식(snapfile.h)은 블록 단위로, 예전 텍스트 형식은 줄 경계에서 나눕니다.
+// 스레드마다 자기 몫의 부분 목록, 분류별 판매 가능 상품 배열(부분 색인), ID 번호 최댓값을 만들고
+// 끝나면 합칩니다: 목록은 이어 붙이고, 분류별 배열은 모아서 한 번에 힙으로 만들고(O(n)),
+// 만료된 행은 상품을 만들지 않고 몫의 배열에 모았다가 만료 보관소로 옮기고(보관소는 한 스레드에서만 다룸),
+// 다음 상품 번호는 스레드별 최댓값 중 최댓값입니다 (발급 한도 파일이 없는 예전 DB 일 때만 ID 를 훑음).
+// 텍스트 형식의 목록 순서는 예전처럼 한 줄씩 맨 앞에 붙인 것과 같은 파일의 역순입니다.
+// =====================================================================
+#define LOAD_MIN_BYTES (1 << 20)    // 스레드 하나가 맡을 최소 크기 (작은 파일은 한 스레드로)
+
+typedef struct { char id[20]; char name[50]; uint32_t meta; time_t expire_time; } ColdRow;
+
+typedef struct {
+    const char *begin, *end;
+    const char* image;              // 압축 스냅샷이면 파일 전체, 몫은 blocks (텍스트면 NULL)
+    const SnapBlock* blocks;
+    long n_blocks;
+    int with_index;
+    int scan_ids;                   // ID 번호 최댓값을 구함
+    Product *head, *tail;           // 몫 안에서 파일 역순
+    ColdRow* cold;                  // 만료된 행 (합칠 때 보관소로)
+    long count, n_cold, cap_cold;
+    int failed;                     // 메모리 부족으로 건너뛴 줄이 있음
+    uint64_t id_max;
+    Product** avail[HEAP_SLOTS];
+    int len[HEAP_SLOTS], cap[HEAP_SLOTS];
+    struct { Product* p; long cold; ItemMeta m; }* metas;    // 부가 정보가 있는 줄 (p NULL 이면 cold 번째 만료 행, 사전 부호화는 합칠 때 한 스레드에서)
+    long n_metas, cap_metas;
+} LoadChunk;
+
+// 공백으로 구분된 토큰 하나를 dst 로 복사 (넘치는 글자는 버림). 줄 끝이면 NULL
+static const char* next_token(const char* p, const char* eol, char* dst, size_t size) {
+    while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p >= eol) return NULL;
+    size_t n = 0;
+    for (; p < eol && *p != ' ' && *p != '\t' && *p != '\r'; p++) if (n + 1 < size) dst[n++] = *p;
+    dst[n] = '\0';
+    return p;
+}
+
+static void chunk_add_meta(LoadChunk* c, Product* p, long cold, const ItemMeta* m) {
+    if (c->n_metas == c->cap_metas) {
+        long cap = c->cap_metas ? c->cap_metas * 2 : 256;
+        void* grown = realloc(c->metas, sizeof(*c->metas) * cap);
+        if (!grown) { c->failed = 1; return; }
+        c->metas = grown; c->cap_metas = cap;
+    }
+    c->metas[c->n_metas].p = p; c->metas[c->n_metas].cold = cold; c->metas[c->n_metas].m = *m;
+    c->n_metas++;
+}
+
+// 행 하나를 몫의 목록에 추가. p..eol 은 줄 꼬리의 선택 항목 "가격 로트 공급사 위치"
+static void load_row(LoadChunk* c, const char* id, const char* name, time_t expire_time, int is_expired, const char* p, const char* eol) {
+    char price[16] = "", lot[META_TEXT_LEN + 1] = "", sup[META_TEXT_LEN + 1] = "", shelf[META_TEXT_LEN + 1] = "";
+    if ((p = next_token(p, eol, price, sizeof(price))) && (p = next_token(p, eol, lot, sizeof(lot))) &&
+        (p = next_token(p, eol, sup, sizeof(sup)))) next_token(p, eol, shelf, sizeof(shelf));
+
+    ItemMeta m;
+    int has_meta = price[0] && meta_parse(price, lot, sup, shelf, &m) && !meta_is_empty(&m);
+    if (c->scan_ids) {
+        uint64_t num = id_number(id);
+        if (num > c->id_max) c->id_max = num;
+    }
+
+    if (is_expired) {
+        if (c->n_cold == c->cap_cold) {
+            long cap = c->cap_cold ? c->cap_cold * 2 : 256;
+            ColdRow* grown = realloc(c->cold, sizeof(ColdRow) * cap);
+            if (!grown) { c->failed = 1; return; }
+            c->cold = grown; c->cap_cold = cap;
         }
+        ColdRow* r = &c->cold[c->n_cold];
+        strcpy(r->id, id); strcpy(r->name, name);
+        r->meta = 0; r->expire_time = expire_time;
+        if (has_meta) chunk_add_meta(c, NULL, c->n_cold, &m);
+        c->n_cold++; c->count++;
+        return;
     }
-    fclose(fp);
-    char buf[100]; snprintf(buf, sizeof(buf), "[System] 기존 데이터 %d개 로드됨", cnt);
-    update_log(buf);
+
+    Product* n = calloc(1, sizeof(Product));
+    if (!n) { c->failed = 1; return; }
+    strcpy(n->id, id); strcpy(n->name, name);      // 두 형식 모두 길이가 배열 안으로 제한됨
+    n->expire_time = expire_time;
+    n->heap_pos = -1;
+    n->next = c->head;
+    if (c->head) c->head->prev = n; else c->tail = n;
+    c->head = n;
+    c->count++;
+    if (has_meta) chunk_add_meta(c, n, -1, &m);
+
+    int cat = heap_slot(name);
+    if (!c->with_index) return;
+    if (c->len[cat] == c->cap[cat]) {
+        int cap = c->cap[cat] ? c->cap[cat] * 2 : 256;
+        Product** a = realloc(c->avail[cat], sizeof(Product*) * cap);
+        if (!a) { c->with_index = 0; return; }     // 부분 색인 포기 -> 합친 뒤 색인은 처음 쓸 때 다시 만듦
+        c->avail[cat] = a; c->cap[cat] = cap;
+    }
+    c->avail[cat][c->len[cat]++] = n;
+}
+
+static void load_line(LoadChunk* c, const char* p, const char* eol) {
+    char id[20], name[50], et[24], ie[12];
+    if (!(p = next_token(p, eol, id, sizeof(id))) || !(p = next_token(p, eol, name, sizeof(name))) ||
+        !(p = next_token(p, eol, et, sizeof(et))) || !(p = next_token(p, eol, ie, sizeof(ie)))) return;
+    load_row(c, id, name, (time_t)strtol(et, NULL, 10), atoi(ie), p, eol);
 }
 
-void free_all_resources(void) {
-    Product* cur = head;
+static void load_snap_row(void* arg, const SnapRow* r) {
+    load_row(arg, r->id, r->name, (time_t)r->expire_time, r->is_expired, r->extra, r->extra + r->extra_len);
+}
+
+static void* load_chunk(void* arg) {
+    LoadChunk* c = arg;
+    for (long i = 0; i < c->n_blocks; i++)
+        if (snap_decode_block(c->image, &c->blocks[i], load_snap_row, c) < 0) c->failed = 1;
+    for (const char* p = c->begin; p < c->end; ) {
+        const char* eol = memchr(p, '\n', c->end - p);
+        if (!eol) eol = c->end;
+        if (*p != '#') load_line(c, p, eol);
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+// 스레드별 분류 배열을 이어 붙여 힙을 바닥부터 만듦 (비어 있는 매장 전용)
+static void install_index(Store* st, LoadChunk* chunks, int n) {
+    for (int i = 0; i < n; i++) if (!chunks[i].with_index) return;
+    StockIndex* ix = calloc(1, sizeof(StockIndex));
+    if (!ix) return;
+    for (int cat = 0; cat < HEAP_SLOTS; cat++) {
+        int total = 0;
+        for (int i = 0; i < n; i++) total += chunks[i].len[cat];
+        if (total == 0) continue;
+        Product** h = malloc(sizeof(Product*) * total);
+        if (!h) { ix->stale = 1; continue; }
+        for (int i = 0, k = 0; i < n; i++)
+            for (int j = 0; j < chunks[i].len[cat]; j++, k++) { h[k] = chunks[i].avail[cat][j]; h[k]->heap_pos = k; }
+        for (int i = total / 2 - 1; i >= 0; i--) heap_down(h, total, i);
+        ix->heap[cat] = h; ix->len[cat] = ix->cap[cat] = total;
+    }
+    st->stock_index = ix;
+}
+
+long read_products_file(Store* st, const char* path, int with_index, long* history_offset) {
+    if (history_offset) *history_offset = -1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0) { close(fd); return -1; }
+    if (sb.st_size == 0) { close(fd); return 0; }
+    char* data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+    const char* end = data + sb.st_size;
+
+    // 압축 스냅샷 형식: 블록 목록을 먼저 읽고 블록을 스레드별로 나눔 (손상된 파일은 읽지 않음)
+    SnapBlock* blocks = NULL;
+    long n_blocks = 0;
+    int snap = snap_is_snapshot(data, sb.st_size);
+    if (snap && (n_blocks = snap_index(data, sb.st_size, &blocks, history_offset)) < 0) {
+        munmap(data, sb.st_size);
+        update_store_log(st, "[경고] 스냅샷 파일이 손상되어 읽지 못했습니다");
+        return -1;
+    }
+
+    // 텍스트 머리말: "# history_offset N" (압축 당시 이력 파일 위치, 없으면 예전 형식)
+    if (!snap && history_offset && data[0] == '#') {
+        char head[64]; size_t len = 0;
+        while (len + 1 < sizeof(head) && data + len < end && data[len] != '\n') { head[len] = data[len]; len++; }
+        head[len] = '\0';
+        if (sscanf(head, "# history_offset %ld", history_offset) != 1) *history_offset = -1;
+    }
+
+    int indexing = with_index && !st->head;
+    int n = parallel_threads();
+    if (sb.st_size / LOAD_MIN_BYTES + 1 < n) n = (int)(sb.st_size / LOAD_MIN_BYTES + 1);
+    if (snap && n_blocks < n) n = n_blocks > 0 ? (int)n_blocks : 1;
+    LoadChunk chunks[PARALLEL_MAX_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+    const char* p = data;
+    for (int i = 0; i < n; i++) {
+        if (snap) {
+            long from = n_blocks * i / n, to = n_blocks * (i + 1) / n;
+            chunks[i].image = data; chunks[i].blocks = blocks + from; chunks[i].n_blocks = to - from;
+        } else {
+            const char* cut = (i == n - 1) ? end : data + sb.st_size / n * (i + 1);
+            if (cut < p) cut = p;
+            while (cut < end && cut[-1] != '\n') cut++;     // 줄 중간에서 자르지 않음
+            chunks[i].begin = p; chunks[i].end = cut;
+            p = cut;
+        }
+        chunks[i].with_index = indexing;
+        chunks[i].scan_ids = st->id_limit == 0;
+    }
+    parallel_run(n, load_chunk, chunks, sizeof(LoadChunk));
+    munmap(data, sb.st_size);
+    free(blocks);
+
+    // 합치기: 뒤쪽 몫부터 이어 붙인 뒤 기존 목록 앞에 둠
+    Product *head = NULL, *tail = NULL;
+    long cnt = 0, cold = 0;
+    int failed = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        LoadChunk* c = &chunks[i];
+        cnt += c->count; cold += c->n_cold; failed |= c->failed;
+        if (c->id_max >= st->id_next) st->id_next = c->id_max + 1;
+        if (!c->head) continue;
+        if (tail) { tail->next = c->head; c->head->prev = tail; } else head = c->head;
+        tail = c->tail;
+    }
+    if (head) {
+        if (indexing) drop_index(st);
+        drop_id_index(st);
+        tail->next = st->head;
+        if (st->head) st->head->prev = tail;
+        st->head = head;
+        st->item_count += cnt - cold; st->mem_bytes += sizeof(Product) * (cnt - cold);
+        if (indexing) install_index(st, chunks, n);
+        else if (st->stock_index) st->stock_index->stale = 1;
+    }
+    for (int i = 0; i < n; i++) {
+        for (long k = 0; k < chunks[i].n_metas; k++) {
+            Product* pr = chunks[i].metas[k].p;
+            ColdRow* cr = pr ? NULL : &chunks[i].cold[chunks[i].metas[k].cold];
+            uint32_t slot = meta_store(st, &chunks[i].metas[k].m, category_of(pr ? pr->name : cr->name), pr);
+            if (!slot) failed = 1;
+            if (pr) pr->meta = slot; else cr->meta = slot;
+        }
+        free(chunks[i].metas);
+        for (long k = 0; k < chunks[i].n_cold; k++) {
+            ColdRow* r = &chunks[i].cold[k];
+            if (!add_cold(st, r->id, r->name, r->expire_time, r->meta)) { failed = 1; cnt--; }
+        }
+        free(chunks[i].cold);
+        for (int k = 0; k < HEAP_SLOTS; k++) free(chunks[i].avail[k]);
+    }
+    if (failed) update_store_log(st, "[경고] 메모리 부족 또는 손상된 블록 때문에 DB 일부를 읽지 못했습니다");
+    return cnt;
+}
+
+void save_data(Store* st) {
+    // 변경은 이미 이력 파일에 남았으므로 DB 다시 쓰기는 압축 스레드에 맡김 (이력이 없으면 바로 씀)
+    if (st->history_io) compact_request(st);
+    else compact_locked(st);
+    save_config(); 
+}
+
+void load_data(Store* st) {
+    history_open(st);
+    idalloc_load(st);
+    char ledger[160];
+    make_history_path(st, ".offline", ledger, sizeof(ledger));
+    offline_load(st, ledger);           // 마지막 압축 시점의 원장 (이후 O 는 아래 재생에서)
+    long offset;
+    long cnt = read_products_file(st, st->db_filename, 1, &offset);
+    // DB 파일이 없으면 첫 압축 전에 멈췄을 수 있으므로 이력을 처음부터 재생
+    // (이력 앞부분이 보관 정책으로 지워졌으면 가장 최근 시점 스냅샷부터)
+    if (cnt < 0) { cnt = 0; offset = 0; }
+    if (offset >= 0 && offset < history_pruned(st)) {
+        offset = history_load_latest(st, st);
+        cnt = offset >= 0 ? st->item_count + cold_count(st, NULL) : 0;
+        if (offset < 0) update_store_log(st, "[경고] DB 파일과 시점 스냅샷을 모두 읽지 못해 지워지지 않은 이력만 재생합니다");
+    }
+
+    // 마지막 압축 이후의 변경은 이력 파일에만 있으므로 이어서 재생
+    long replayed = offset >= 0 ? history_recover(st, offset) : 0;
+    // 한도 파일이 없던 예전 DB: 훑어 구한 다음 번호로 바로 기록 (이후 적재는 ID 를 훑지 않음)
+    if (st->id_limit == 0 && idalloc_take(st, 0, NULL) != ID_TAKE_OK) update_store_log(st, "[경고] 상품 번호 한도 파일을 만들지 못했습니다");
+    if (cnt == 0 && replayed == 0 && !st->head) { update_store_log(st, "[System] 새로운 데이터베이스 생성"); return; }
+
+    // 파일에서 읽어 온 상태는 저널에 없으므로 스냅샷(R + A)으로 남겨 복제본이 따라오게 함
+    if (!is_replica()) journal_all_products(st);
+    if (replayed > 0) save_data(st);
+    char buf[128];
+    if (replayed > 0) snprintf(buf, sizeof(buf), "[System] 기존 데이터 %ld개 로드됨 (이력 %ld건 재생)", cnt, replayed);
+    else snprintf(buf, sizeof(buf), "[System] 기존 데이터 %ld개 로드됨", cnt);
+    update_store_log(st, buf);
+}
+
+static void bulk_delete_forget(Store* st);
+
+void free_all_resources(Store* st) {
+    Product* cur = st->head;
     while(cur) { Product* next = cur->next; free(cur); cur = next; }
-    init_inventory();
+    st->head = NULL;
+    meta_reset(st);
+    cold_reset(st);
+    for (ScanCursor* c = st->scan_cursors; c; c = c->link) { c->next = NULL; c->cleared = 1; }
+    bulk_delete_forget(st);
+    drop_index(st);
+    drop_id_index(st);
+    init_inventory(st);
 }
 
-void clear_inventory_db(void) {
-    free_all_resources();
-    remove(db_filename);
+void clear_inventory_db(Store* st) {
+    store_lock(st);
+    free_all_resources(st);
+    journal_append(st, 'C', NULL);
+    save_data(st);                  // 빈 DB 로 압축 (압축 전에 멈춰도 이력의 C 가 재생됨)
+    store_unlock(st);
 }
 
-void handle_single_import(uint32_t cid, char* pin, char* msg) {
-    pthread_mutex_lock(&list_mutex);
+// "a|b||c" -> 빈 칸도 그대로 남기고 '|' 로 나눔 (반환: 칸 수)
+static int split_fields(char* s, char** f, int max) {
+    int n = 0;
+    while (n < max) {
+        f[n++] = s;
+        char* bar = strchr(s, '|');
+        if (!bar) break;
+        *bar = '\0'; s = bar + 1;
+    }
+    return n;
+}
+
+// payload "ID|상품명|유효시간[|가격|로트|공급사|진열위치]" (부가 정보는 칸마다 비워 둘 수 있음)
+// ID 가 번호뿐이면(임대받은 구간에서 단말기가 정한 번호) 상품명의 분류 접두어를 붙여 "A_0012" 로 만듦
+void handle_single_import(Store* st, uint32_t cid, char* pin, char* msg) {
+    store_lock(st);
     char id[20], name[50]; int h;
+    char extra[MAX_PAYLOAD]; char* f[8] = {0};
+    ItemMeta meta;
+    const char* rest = strchr(pin, '|'); if (rest) rest = strchr(rest + 1, '|'); if (rest) rest = strchr(rest + 1, '|');
+    snprintf(extra, sizeof(extra), "%s", rest ? rest + 1 : "");
+    int nf = rest ? split_fields(extra, f, 4) : 0;
     
     if(sscanf(pin, "%19[^|]|%49[^|]|%d", id, name, &h) == 3) {
-        if(is_id_exists(id)) {
+        int cat = category_of(name);
+        if (cat >= 0 && strspn(id, "0123456789") == strlen(id) && strlen(id) <= 17)
+            snprintf(id, sizeof(id), "%c_%04llu", r_prefixes[cat], strtoull(id, NULL, 10));
+        if(!meta_parse(nf > 0 ? f[0] : NULL, nf > 1 ? f[1] : NULL, nf > 2 ? f[2] : NULL, nf > 3 ? f[3] : NULL, &meta)) {
+            snprintf(msg, MAX_PAYLOAD, "[오류] 부가 정보 형식 오류 (가격: 숫자, 로트/공급사/위치: 공백 없이 %d바이트 이하)", META_TEXT_LEN - 1);
+        } else if(find_by_id(st, id) || cold_find(st, id) || bulk_delete_holds(st, id)) {
             snprintf(msg, MAX_PAYLOAD, "[오류] 중복 ID: %s", id);
+        } else if(!idalloc_issued(st, id)) {
+            snprintf(msg, MAX_PAYLOAD, "[오류] 아직 발급되지 않은 상품 번호입니다: %s (번호는 임대받은 구간에서만 사용)", id);
         } else {
             // ==========================================
             // [추가된 로직] ID 접두사와 상품명 매칭 검증
@@ -112,184 +824,525 @@ void handle_single_import(uint32_t cid, char* pin, char* msg) {
             } 
             else if (valid_prefix == 1) {
                 // 검증 통과 시에만 정상 등록
-                Product* n = malloc(sizeof(Product));
+                Product* n = alloc_product(st);
                 if (!n) {
                     snprintf(msg, MAX_PAYLOAD, "[오류] 메모리 부족");
                 } else {
                     strncpy(n->id, id, 19); n->id[19] = '\0';
                     strncpy(n->name, name, 49); n->name[49] = '\0';
                     n->expire_time = get_virtual_time() + (h*3600); 
-                    n->is_expired = 0;
+                    n->meta = meta_store(st, &meta, category_of(name), n);
                     
-                    n->next = head; head = n; 
-                    save_data(); // DB 저장
+                    link_product(st, n);
+                    journal_product(st, 'A', n);
+                    save_data(st); // DB 저장
                     
                     snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 단일입고: %s (%s)", cid, id, name);
-                    update_log(msg); 
+                    log_event(st, EV_IMPORT, cid, category_of(name), 1, 0, id);
                 }
             }
         }
     }
-    pthread_mutex_unlock(&list_mutex);
+    store_unlock(st);
 }
 
-void handle_random_import(uint32_t cid, char* pin, char* msg) {
-    pthread_mutex_lock(&list_mutex);
+void handle_random_import(Store* st, uint32_t cid, char* pin, char* msg) {
+    store_lock(st);
     int q = atoi(pin);
-    if (q > 0) {
-        Product* local_head = NULL, *local_tail = NULL;
+    uint64_t first;
+    int taken = q > 0 ? idalloc_take(st, (uint64_t)q, &first) : ID_TAKE_OK;
+    if (taken != ID_TAKE_OK) {
+        snprintf(msg, MAX_PAYLOAD, "%s", idalloc_error(taken));
+        update_store_log(st, msg);
+    } else if (q > 0) {
+        Product* local_head = NULL;
         int actual_q = 0; 
         for(int i=0; i<q; i++) {
             int r = rand()%10; char nid[20];
-            snprintf(nid, sizeof(nid), "%c_%04d", r_prefixes[r], ++r_counts[r]);
-            Product* n = malloc(sizeof(Product));
+            snprintf(nid, sizeof(nid), "%c_%04llu", r_prefixes[r], (unsigned long long)(first + i));
+            Product* n = alloc_product(st);
             if (!n) { snprintf(msg, MAX_PAYLOAD, "[오류] 메모리 부족"); break; }
             strcpy(n->id, nid); strcpy(n->name, r_types[r]);
             n->expire_time = get_virtual_time() + ((rand()%96+1)*3600);
-            n->is_expired = 0;
             n->next = local_head; local_head = n;
-            if (local_tail == NULL) local_tail = n;
             actual_q++;
         }
-        if (local_tail != NULL) { local_tail->next = head; head = local_head; }
-        save_data(); 
-        if (msg[0] == '\0') snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 랜덤입고 %d개", cid, actual_q);
-        update_log(msg); 
+        for(Product* c = local_head; c; ) {
+            Product* next = c->next;
+            journal_product(st, 'A', c);
+            link_product(st, c);
+            c = next;
+        }
+        save_data(st); 
+        if (msg[0] == '\0') {
+            snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 랜덤입고 %d개", cid, actual_q);
+            log_event(st, EV_RANDOM_IMPORT, cid, -1, actual_q, 0, NULL);
+        } else update_store_log(st, msg);
     }
-    pthread_mutex_unlock(&list_mutex);
+    store_unlock(st);
 }
 
-void handle_sell(uint32_t cid, char* pin, char* msg) {
-    pthread_mutex_lock(&list_mutex);
-    char name[50]; int req_qty, total = 0; 
+// 판매(결제): 이 세션(owner)이 예약해 둔 상품부터 확정하고, 모자라면 자유 재고에서 유통기한 순(FEFO)으로 채움
+void handle_sell(Store* st, uint32_t cid, uint32_t owner, char* pin, char* msg) {
+    store_lock(st);
+    char name[50]; int req_qty = 0; 
     sscanf(pin, "%49[^|]|%d", name, &req_qty);
-    for(Product* c = head; c; c = c->next) {
-        if(strcmp(c->name, name) == 0 && !c->is_expired) total++;
-    }
-    if(total == 0) snprintf(msg, MAX_PAYLOAD, "[실패] %s 재고 없음", name);
+    int cat = category_of(name);
+    StockIndex* ix = (cat >= 0) ? ensure_index(st) : NULL;
+    if (cat >= 0 && !ix) { snprintf(msg, MAX_PAYLOAD, "[오류] 시스템 메모리 부족"); update_store_log(st, msg); }
     else {
-        int actual_qty = (total < req_qty) ? total : req_qty;
-        Product** arr = malloc(sizeof(Product*) * total); 
-        if (!arr) snprintf(msg, MAX_PAYLOAD, "[오류] 시스템 메모리 부족");
+        expire_holds(st, get_virtual_time());
+        Reservation* r = ix ? find_hold(ix, owner, cat) : NULL;
+        int total = ix ? (r ? r->qty : 0) + ix->len[cat] : 0;
+        if(total == 0) snprintf(msg, MAX_PAYLOAD, "[실패] %s 재고 없음", name);
         else {
-            int idx = 0;
-            for(Product* c = head; c; c = c->next) {
-                if(strcmp(c->name, name) == 0 && !c->is_expired) arr[idx++] = c;
-            }
-            qsort(arr, total, sizeof(Product*), compare_products);
+            int actual_qty = (total < req_qty) ? total : req_qty;
             for(int i = 0; i < actual_qty; i++) {
-                Product *t = arr[i], *cur = head, *prev = NULL;
-                while(cur) {
-                    if(cur == t) { 
-                        if(!prev) head = cur->next; else prev->next = cur->next; 
-                        free(cur); break; 
-                    }
-                    prev = cur; cur = cur->next;
-                }
+                Product* t = (r && r->items) ? r->items : ix->heap[cat][0];
+                journal_product(st, 'D', t);
+                remove_product(st, t);
             }
-            free(arr); save_data(); 
+            if (r) free_hold(st, r);    // 결제로 예약 종료 (남은 수량은 자유 재고로)
+            save_data(st); 
             if (total < req_qty) snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 부분판매: %s %d개 (요청:%d)", cid, name, actual_qty, req_qty);
             else snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 판매완료: %s %d개", cid, name, actual_qty);
+            log_event(st, EV_SELL, cid, cat, actual_qty, req_qty, NULL);
         }
-        update_log(msg); 
     }
-    pthread_mutex_unlock(&list_mutex);
+    store_unlock(st);
 }
 
-void handle_cart_verify(char* pin, char* msg) {
-    pthread_mutex_lock(&list_mutex);
-    char name[50]; int req_qty, total = 0; 
-    sscanf(pin, "%49[^|]|%d", name, &req_qty);
-    for(Product* c = head; c; c = c->next) {
-        if(strcmp(c->name, name) == 0 && !c->is_expired) total++;
+// 오프라인 판매 동기화: "단말기태그\n판매번호\t상품명\t수량\n..." (판매번호 오름차순, 한 판매는 한 배치 안에)
+// 원장에 적용된 번호 이하는 재전송으로 보고 건너뜀. 오프라인 판매는 예약이 없으므로 자유 재고에서만 FEFO 로 채우고,
+// 다 채우지 못한 줄은 "판매번호\t상품명\t요청\t판매" 로 돌려줌. msg 첫 줄은 적용이 끝난 마지막 판매번호
+int handle_offline_sync(Store* st, uint32_t cid, char* pin, char* msg) {
+    store_lock(st);
+    char *saveptr, conflicts[MAX_PAYLOAD - 32] = "";
+    char* tag = strtok_r(pin, "\n", &saveptr);
+    StockIndex* ix = NULL;
+    int sales = 0, nconf = 0;
+    size_t clen = 0;
+    if (!offline_valid_tag(tag)) snprintf(msg, MAX_PAYLOAD, "[오류] 형식: 단말기태그\\n판매번호\\t상품명\\t수량");
+    else if (!(ix = ensure_index(st))) snprintf(msg, MAX_PAYLOAD, "[오류] 시스템 메모리 부족");
+    else {
+        uint64_t done = offline_applied(st, tag), cur = 0;
+        expire_holds(st, get_virtual_time());
+        char* line;
+        while ((line = strtok_r(NULL, "\n", &saveptr)) != NULL) {
+            unsigned long long seq; char name[50]; int qty;
+            if (sscanf(line, "%llu\t%49[^\t]\t%d", &seq, name, &qty) != 3 || seq < cur) break;
+            if (seq <= done) continue;
+            if (seq != cur) {
+                // 충돌 보고가 응답에 다 들어가지 않을 만큼 쌓였으면 남은 판매는 다음 배치로
+                if (clen > sizeof(conflicts) / 2) break;
+                // 판매 한 건(D 들 + 원장 O)을 한 묶음으로: 재생/복제본에서 판매만 반영되고 원장이 빠지는 일이 없게
+                if (cur) { offline_mark(st, tag, cur); journal_append(st, 'K', NULL); }
+                journal_append(st, 'B', NULL);
+                cur = seq; sales++;
+            }
+            int cat = category_of(name), sold = 0;
+            while (cat >= 0 && sold < qty && ix->len[cat] > 0) {
+                Product* t = ix->heap[cat][0];
+                journal_product(st, 'D', t);
+                remove_product(st, t);
+                sold++;
+            }
+            if (sold > 0) log_event(st, EV_SELL, cid, cat, sold, qty, NULL);
+            if (sold < qty && clen < sizeof(conflicts)) {
+                clen += snprintf(conflicts + clen, sizeof(conflicts) - clen, "%llu\t%s\t%d\t%d\n", seq, name, qty, sold);
+                nconf++;
+            }
+        }
+        if (cur) { offline_mark(st, tag, cur); journal_append(st, 'K', NULL); done = cur; save_data(st); }
+        snprintf(msg, MAX_PAYLOAD, "%llu\n%s", (unsigned long long)done, conflicts);
+        if (sales) log_event(st, EV_OFFLINE_SYNC, cid, -1, sales, nconf, tag);
     }
-    if (total == 0) snprintf(msg, MAX_PAYLOAD, "[실패] '%s' 상품은 존재하지 않거나 재고가 없습니다.", name);
-    else strcpy(msg, "OK"); 
-    pthread_mutex_unlock(&list_mutex);
+    store_unlock(st);
+    return nconf;
 }
 
-void handle_delete_operations(uint32_t cmd, uint32_t cid, char* pin, char* msg) {
-    pthread_mutex_lock(&list_mutex);
-    Product *cur = head, *prev = NULL; int d = 0; int f = 0;
-    
-    if (cmd == 5) {
-        while(cur) {
-            if(cur->is_expired) { 
-                Product* t=cur; 
-                if(!prev) head=cur->next; else prev->next=cur->next; 
-                cur=cur->next; free(t); d++; 
-            }
-            else { prev=cur; cur=cur->next; }
+// 장바구니 예약: "상품명|수량" -> 이 세션의 해당 분류 예약을 그 수량으로 맞춤 (반환: 실제로 잡아 둔 수량)
+int handle_cart_hold(Store* st, uint32_t owner, char* pin, char* msg) {
+    store_lock(st);
+    char name[50] = ""; int req_qty = 0, held = 0;
+    sscanf(pin, "%49[^|]|%d", name, &req_qty);
+    int cat = category_of(name);
+    StockIndex* ix = (cat >= 0) ? ensure_index(st) : NULL;
+    if (cat >= 0 && !ix) snprintf(msg, MAX_PAYLOAD, "[오류] 시스템 메모리 부족");
+    else {
+        time_t now = get_virtual_time();
+        int changed = expire_holds(st, now);
+        Reservation* r = ix ? find_hold(ix, owner, cat) : NULL;
+        if (!r && ix && req_qty > 0 && ix->len[cat] > 0 && (r = calloc(1, sizeof(Reservation)))) {
+            r->owner = owner; r->category = cat;
+            r->hnext = ix->buckets[owner % HOLD_BUCKETS]; ix->buckets[owner % HOLD_BUCKETS] = r;
+            touch_hold(ix, r, now + HOLD_TTL);
         }
-        snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 삭제: 만료 일괄 폐기 %d개", cid, d);
-        save_data(); update_log(msg);
-    } 
-    else if (cmd == 8 || cmd == 6) {
-        char deleted_name[50] = ""; // 삭제될 상품명을 임시 저장할 버퍼
-        
-        while(cur) {
-            if(strcmp(cur->id, pin)==0) {
-                if(cmd==6 && !cur->is_expired) {
-                    strcpy(msg, "[실패] 미만료 상품");
-                } else { 
-                    // 메모리 해제 전 상품명 백업
-                    strcpy(deleted_name, cur->name); 
-                    
-                    if(!prev) head=cur->next; else prev->next=cur->next; free(cur); 
-                    
-                    // "김밥 [A_0001] 삭제" 형태로 포맷팅
-                    snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 단일삭제: %s [%s] 삭제", cid, deleted_name, pin); 
-                    save_data(); update_log(msg); 
-                }
-                f=1; break;
+        if (r) {
+            int before = r->qty;
+            while (r->qty < req_qty && ix->len[cat] > 0) {
+                Product* p = ix->heap[cat][0];
+                index_remove(st, p);
+                hold_unit(ix, r, p);
+            }
+            // 수량을 줄이면 유통기한이 늦은 것부터 돌려놓음
+            while (r->qty > req_qty && r->qty > 0) {
+                Product* p = r->items_tail;
+                unhold_unit(ix, p);
+                index_add(st, p);
+            }
+            held = r->qty;
+            changed |= (held != before);
+            if (held == 0) free_hold(st, r);
+            else {
+                // 장바구니 단위로 TTL 연장
+                for (Reservation* o = ix->buckets[owner % HOLD_BUCKETS]; o; o = o->hnext)
+                    if (o->owner == owner) touch_hold(ix, o, now + HOLD_TTL);
             }
-            prev=cur; cur=cur->next;
         }
-        if(!f) strcpy(msg, "[실패] ID 없음");
-    } 
-    else { // cmd 12 (종류 전체 삭제) 또는 13 (종류 중 만료 삭제)
-        while(cur) {
-            // pin 변수에는 클라이언트가 보낸 "아이스크림" 같은 상품명이 들어있음
-            if(strcmp(cur->name, pin)==0 && (cmd==12 || cur->is_expired)) {
-                Product* t=cur; if(!prev) head=cur->next; else prev->next=cur->next;
-                cur=cur->next; free(t); d++;
-            } else { prev=cur; cur=cur->next; }
+        if (held == 0) snprintf(msg, MAX_PAYLOAD, "[실패] '%s' 상품은 존재하지 않거나 재고가 없습니다.", name);
+        else if (held < req_qty) snprintf(msg, MAX_PAYLOAD, "[부분] '%s' %d개만 확보했습니다. (요청:%d)", name, held, req_qty);
+        else strcpy(msg, "OK");
+        if (changed) store_changed(st);     // 다른 단말기 메뉴판의 판매 가능 수량이 바뀜
+    }
+    store_unlock(st);
+    return held;
+}
+
+// 예약 해제: "" = 이 세션의 모든 예약, "상품명" = 해당 분류만
+void handle_cart_release(Store* st, uint32_t owner, const char* pin, char* msg) {
+    store_lock(st);
+    StockIndex* ix = st->stock_index;
+    int cat = pin[0] ? category_of(pin) : -1, n = 0;
+    if (ix) {
+        Reservation* r = ix->buckets[owner % HOLD_BUCKETS];
+        while (r) {
+            Reservation* next = r->hnext;
+            if (r->owner == owner && (cat < 0 || r->category == cat)) { n += r->qty; free_hold(st, r); }
+            r = next;
         }
-        
-        //  만료 삭제와 일반 종류 삭제를 구분하여 상세 출력
-        if (cmd == 13) {
-            snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 만료삭제: %s %d개 삭제", cid, pin, d); 
-        } else {
-            snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 종류삭제: %s %d개 삭제", cid, pin, d); 
+    }
+    if (n > 0) store_changed(st);
+    if (msg) snprintf(msg, MAX_PAYLOAD, "[안내] 예약 %d개 해제", n);
+    store_unlock(st);
+}
+
+// 재접속 이어받기: 이 세션의 예약을 "상품명\t수량\n" 으로 나열하고 TTL 연장 (반환: 품목 수)
+int list_cart_holds(Store* st, uint32_t owner, char* out, size_t size) {
+    store_lock(st);
+    StockIndex* ix = st->stock_index;
+    time_t now = get_virtual_time();
+    int n = 0; size_t len = 0;
+    out[0] = '\0';
+    if (ix) {
+        if (expire_holds(st, now)) store_changed(st);
+        for (int cat = 0; cat < NUM_CATEGORIES; cat++) {
+            Reservation* r = find_hold(ix, owner, cat);
+            if (!r) continue;
+            touch_hold(ix, r, now + HOLD_TTL);
+            if (len < size) len += snprintf(out + len, size - len, "%s\t%d\n", r_types[cat], r->qty);
+            n++;
         }
-        save_data(); update_log(msg);
     }
-    pthread_mutex_unlock(&list_mutex);
+    store_unlock(st);
+    return n;
+}
+
+// 단일 삭제 (6: 만료 상품만, 8: 판매 가능 상품 포함). 일괄 삭제(5/12/13)는 아래 일괄 삭제 작업으로
+void handle_delete_operations(Store* st, uint32_t cmd, uint32_t cid, char* pin, char* msg) {
+    store_lock(st);
+    char deleted_name[50] = ""; // 삭제될 상품명을 임시 저장할 버퍼
+    Product* cur = find_by_id(st, pin);
+    ColdItem* old = cur ? NULL : cold_find(st, pin);
+
+    if (!cur && !old) {
+        strcpy(msg, "[실패] ID 없음");
+    } else if (cmd == 6 && cur) {
+        strcpy(msg, "[실패] 미만료 상품");
+    } else {
+        // 메모리 해제 전 상품명 백업
+        if (cur) { strcpy(deleted_name, cur->name); journal_product(st, 'D', cur); remove_product(st, cur); }
+        else { strcpy(deleted_name, cold_name(st, old)); discard_cold(st, old); cold_remove(st, old); }
+
+        // "김밥 [A_0001] 삭제" 형태로 포맷팅
+        snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 단일삭제: %s [%s] 삭제", cid, deleted_name, pin);
+        save_data(st);
+        int cat = category_of(deleted_name);
+        if (cat >= 0) log_event(st, EV_DELETE_ONE, cid, cat, 1, 0, pin);
+        else update_store_log(st, msg);
+    }
+    store_unlock(st);
+}
+
+// =====================================================================
+// [일괄 삭제 작업] 만료 일괄 폐기(5), 종류 전체 삭제(12), 종류 중 만료 삭제(13)
+// bulkjob.c 의 작업 스레드가 bulk_delete_step 을 되풀이해 부르고, 한 번에 list_mutex 를 쥐고
+// 최대 budget 개만 처리한 뒤 락을 놓습니다. 12 는 판매 목록을 먼저 훑는데, 훑기 위치는 조각 사이에도
+// st->scan_cursors 에 등록해 두어 그 사이 삭제/만료된 상품을 remove_product 가 건너뛰게 합니다.
+// 그 사이 만료돼 보관소로 간 상품은 뒤이은 보관소 단계에서 지워지고, 새로 입고된 상품(목록 앞)은 건드리지 않습니다.
+// 지운 ID 는 모아 두었다가 삭제가 끝난 뒤 bulk_delete_log 가 조각마다 D 레코드 묶음(B ~ K)으로 이력/저널에 남기고
+// 묶음 사이에 락을 놓습니다. 묶음 하나는 재생/복제본에서 통째로 반영되거나 빠지므로, 삭제 도중에 서버가 멈추면 재시작 후에는
+// 작업 전 상태이고 기록 도중에 멈추면 남긴 묶음까지만 지워진 상태입니다. 기록이 끝날 때까지 DB 압축의 목록 복사는 미루고(compact.c)
+// 아직 기록하지 않은 ID 로 다시 입고하는 것은 막습니다(기록 전에 새 상품이 생기면 뒤늦은 D 가 그것을 지우므로).
+// =====================================================================
+struct BulkDelete {
+    Store* st;
+    uint32_t cmd, cid;
+    char name[50];
+    ScanCursor cur;         // 12 의 판매 목록 훑기 위치 (started 이후 등록)
+    int started, hot_done, no_mem;
+    long deleted, done, total;
+    char (*ids)[20];        // 지운 ID (앞의 n_logged 개는 기록함)
+    long n_ids, cap_ids, n_logged;
+    long* slots;            // ids 의 ID 해시 (열린 주소, 값 = ids 위치 + 1, 0 = 빈 칸)
+    long slot_cap;
+};
+
+static void held_put(BulkDelete* d, long idx) {
+    long mask = d->slot_cap - 1, i = id_hash(d->ids[idx]) & mask;
+    while (d->slots[i]) i = (i + 1) & mask;
+    d->slots[i] = idx + 1;
+}
+
+// ID n 개까지 채움률 70% 안에 들도록 해시를 미리 늘림 (조각 도중에는 늘리지 않음)
+static int held_reserve(BulkDelete* d, long n) {
+    if (n * 10 <= d->slot_cap * 7) return 1;
+    long cap = d->slot_cap ? d->slot_cap : 1024;
+    while (n * 10 > cap * 7) cap *= 2;
+    long* slots = calloc(cap, sizeof(long));
+    if (!slots) return 0;
+    free(d->slots);
+    d->slots = slots; d->slot_cap = cap;
+    for (long i = 0; i < d->n_ids; i++) held_put(d, i);
+    return 1;
+}
+
+static void hold_id(BulkDelete* d, const char* id) {
+    strcpy(d->ids[d->n_ids], id);
+    held_put(d, d->n_ids++);
+}
+
+// 보관소 항목 폐기: D 는 끝난 뒤 남기도록 ID 만 모음 (cold_take 콜백, 자리는 조각 시작 때 확보)
+static void hold_cold(void* arg, const ColdItem* c) {
+    BulkDelete* d = arg;
+    hold_id(d, c->id);
+    meta_drop(d->st, c->meta);
+}
+
+// 목록을 통째로 비울 때: 뒤따르는 C/R 가 이미 모두 지우므로 남은 D 는 남기지 않음
+static void bulk_delete_forget(Store* st) {
+    BulkDelete* d = st->bulk_running;
+    if (!d) return;
+    d->n_ids = d->n_logged = 0;
+    if (d->slots) memset(d->slots, 0, sizeof(long) * d->slot_cap);
+}
+
+int bulk_delete_holds(Store* st, const char* id) {
+    BulkDelete* d = st->bulk_running;
+    if (!d || !d->slot_cap) return 0;
+    long mask = d->slot_cap - 1;
+    for (long i = id_hash(id) & mask; d->slots[i]; i = (i + 1) & mask) {
+        long k = d->slots[i] - 1;
+        if (k >= d->n_logged && strcmp(d->ids[k], id) == 0) return 1;
+    }
+    return 0;
+}
+
+BulkDelete* bulk_delete_begin(Store* st, uint32_t cmd, uint32_t cid, const char* name) {
+    BulkDelete* d = calloc(1, sizeof(BulkDelete));
+    if (!d) return NULL;
+    d->st = st; d->cmd = cmd; d->cid = cid;
+    snprintf(d->name, sizeof(d->name), "%s", cmd == 5 ? "" : name);
+    d->hot_done = cmd != 12;
+    return d;
+}
+
+int bulk_delete_step(BulkDelete* d, int budget, long* deleted, long* done, long* total) {
+    Store* st = d->st;
+    const char* name = d->cmd == 5 ? NULL : d->name;
+    store_lock(st);
+    // 이번 조각에서 지울 수 있는 만큼 ID 자리와 해시 칸을 미리 확보 (모자라면 지운 것까지만 기록하고 끝냄)
+    void* grown = NULL;
+    if (d->n_ids + budget > d->cap_ids && (grown = realloc(d->ids, sizeof(*d->ids) * (d->cap_ids + budget) * 2)) != NULL) {
+        d->ids = grown; d->cap_ids = (d->cap_ids + budget) * 2;
+    }
+    if (d->n_ids + budget > d->cap_ids || !held_reserve(d, d->n_ids + budget)) {
+        d->no_mem = 1;
+        *deleted = d->deleted; *done = d->done; *total = d->total;
+        store_unlock(st);
+        return 1;
+    }
+    if (!d->started) {
+        // 대상 수는 첫 조각 때 셈 (대기 중 입고된 상품도 포함)
+        d->started = 1;
+        st->bulk_running = d;
+        d->total = cold_count(st, name);
+        if (!d->hot_done) {
+            d->total += st->item_count - cold_count(st, NULL);
+            d->cur = (ScanCursor){ .next = st->head, .link = st->scan_cursors };
+            st->scan_cursors = &d->cur;
+        }
+    }
+    for (Product* p; !d->hot_done && budget > 0; budget--, d->done++) {
+        if (!(p = d->cur.next) || d->cur.cleared) { d->hot_done = 1; break; }
+        d->cur.next = p->next;
+        if (strcmp(p->name, d->name) == 0) { hold_id(d, p->id); remove_product(st, p); d->deleted++; }
+    }
+    int finished = d->cur.cleared;      // 창고 비움(16): 남은 것이 없으므로 그대로 끝냄
+    if (d->hot_done && !finished) {
+        long n = cold_take(st, name, budget, hold_cold, d);
+        d->deleted += n; d->done += n;
+        finished = n < budget;
+    }
+    *deleted = d->deleted; *done = d->done; *total = d->total;
+    store_unlock(st);
+    return finished;
+}
+
+// 모아 둔 D 중 최대 budget 개를 한 묶음(B ~ K)으로 기록 (창고 비움/시점 복원이 있었으면 free_all_resources 가 비워 둠)
+int bulk_delete_log(BulkDelete* d, int budget) {
+    Store* st = d->st;
+    store_lock(st);
+    long end = d->n_ids - d->n_logged > budget ? d->n_logged + budget : d->n_ids;
+    if (d->n_logged < end) {
+        history_batch(st, 1);
+        journal_append(st, 'B', NULL);
+        for (; d->n_logged < end; d->n_logged++) journal_append(st, 'D', d->ids[d->n_logged]);
+        journal_append(st, 'K', NULL);
+        history_batch(st, 0);
+    }
+    int finished = d->n_logged >= d->n_ids;
+    store_unlock(st);
+    return finished;
+}
+
+void bulk_delete_end(BulkDelete* d, char* msg, size_t size) {
+    Store* st = d->st;
+    int d_cnt = (int)d->deleted;
+    store_lock(st);
+    if (d->started && d->cmd == 12)
+        for (ScanCursor** pp = &st->scan_cursors; *pp; pp = &(*pp)->link)
+            if (*pp == &d->cur) { *pp = d->cur.link; break; }
+    st->bulk_running = NULL;
+    const char* note = d->cur.cleared ? " (창고 비움으로 중단)" : d->no_mem ? " (메모리 부족으로 중단)" : "";
+    if (d->cmd == 5) snprintf(msg, size, "[POS-%04d] 삭제: 만료 일괄 폐기 %d개%s", d->cid, d_cnt, note);
+    //  만료 삭제와 일반 종류 삭제를 구분하여 상세 출력
+    else if (d->cmd == 13) snprintf(msg, size, "[POS-%04d] 만료삭제: %s %d개 삭제%s", d->cid, d->name, d_cnt, note);
+    else snprintf(msg, size, "[POS-%04d] 종류삭제: %s %d개 삭제%s", d->cid, d->name, d_cnt, note);
+    save_data(st);
+    if (d->cmd == 5) log_event(st, EV_DELETE_EXPIRED, d->cid, -1, d_cnt, 0, NULL);
+    else {
+        int cat = category_of(d->name);
+        log_event(st, d->cmd == 13 ? EV_DELETE_KIND_EXPIRED : EV_DELETE_KIND, d->cid, cat, d_cnt, 0, cat < 0 ? d->name : NULL);
+    }
+    store_unlock(st);
+    free(d->ids);
+    free(d->slots);
+    free(d);
 }
 
-void make_category_summary(char* out, int mode, const char* title) {
-    pthread_mutex_lock(&list_mutex);
-    typedef struct { char name[50]; int count; } Cat;
-    Cat cats[100]; int n = 0;
-    for(Product* c = head; c; c = c->next) {
-        if((mode==1 && !c->is_expired) || (mode==2 && c->is_expired)) continue;
-        int f = -1; for(int i=0; i<n; i++) if(strcmp(cats[i].name, c->name)==0) { f=i; break; }
-        if(f>=0) cats[f].count++;
-        else if(n<100) { strcpy(cats[n].name, c->name); cats[n++].count = 1; }
+typedef struct { char name[50]; int count; int held; } SummaryRow;
+
+// 상품명 칸 찾기 (없으면 추가, 100개가 차면 -1)
+static int summary_row(SummaryRow* cats, int* n, const char* name) {
+    for(int i=0; i<*n; i++) if(strcmp(cats[i].name, name)==0) return i;
+    if(*n >= 100) return -1;
+    strcpy(cats[*n].name, name); cats[*n].count = cats[*n].held = 0;
+    return (*n)++;
+}
+
+// 모드 0 = 전체, 1 = 만료(보관소 개수만 읽음), 2 = 판매 가능(목록만 훑음)
+void make_category_summary(Store* st, char* out, int mode, const char* title) {
+    store_lock(st);
+    SummaryRow cats[100]; int n = 0, seen = 0;
+    for(Product *c = (mode==1) ? NULL : st->head, *next; c; c = next) {
+        if(seen++ % SCAN_CHUNK == 0 && !(c = scan_yield(st, c))) break;
+        next = c->next;
+        int f = summary_row(cats, &n, c->name);
+        if(f<0) continue;
+        // 메뉴판(모드 2)은 다른 단말기 장바구니에 예약된 수량을 따로 표시
+        if(mode==2 && c->hold) cats[f].held++; else cats[f].count++;
+    }
+    if(mode != 2) {
+        const char* names[100]; long counts[100];
+        int k = cold_names(st, names, counts, 100);
+        for(int i=0; i<k; i++) { int f = summary_row(cats, &n, names[i]); if(f >= 0) cats[f].count += (int)counts[i]; }
     }
     sprintf(out, "\n=== %s ===\n", title);
     if(n==0) strcat(out, "상품이 없습니다.\n");
     else for(int i=0; i<n; i++) {
-        char t[100]; sprintf(t, " - %-15.40s : %d개\n", cats[i].name, cats[i].count); strcat(out, t);
+        char t[140]; int len = sprintf(t, " - %-15.40s : %d개", cats[i].name, cats[i].count);
+        if(cats[i].held) sprintf(t + len, " (예약 %d개)", cats[i].held);
+        strcat(t, "\n"); strcat(out, t);
+    }
+    store_unlock(st);
+}
+
+// 판매 가능 수량 스냅샷 (클라이언트 캐시용): "버전\n상품명\t판매 가능\t예약\n..." - 분류표 순서
+// 재고 색인의 힙 크기와 예약 수만 읽으므로 재고 규모와 무관하게 짧음 (판매와 같은 급한 등급으로 처리)
+void make_menu_snapshot(Store* st, char* out) {
+    store_lock(st);
+    StockIndex* ix = ensure_index(st);
+    int len = snprintf(out, MAX_PAYLOAD, "%llu\n", (unsigned long long)store_version(st));
+    for(int i=0; ix && i<NUM_CATEGORIES && len < MAX_PAYLOAD; i++) {
+        if(ix->len[i] + ix->held[i] == 0) continue;
+        len += snprintf(out + len, MAX_PAYLOAD - len, "%s\t%d\t%d\n", r_types[i], ix->len[i], ix->held[i]);
+    }
+    store_unlock(st);
+}
+
+// 재고 색인의 힙 크기(= 예약되지 않은 판매 가능 수량)와 보관소 묶음 크기만 읽으므로 재고 규모와 무관
+// (색인은 한 번 만들어 두면 판매/입고/만료가 함께 고침. 만들지 못하면 목록을 셈)
+void count_categories(Store* st, int* avail, int* expired) {
+    memset(avail, 0, sizeof(int) * NUM_CATEGORIES);
+    memset(expired, 0, sizeof(int) * NUM_CATEGORIES);
+    store_lock(st);
+    StockIndex* ix = ensure_index(st);
+    if (ix) memcpy(avail, ix->len, sizeof(int) * NUM_CATEGORIES);
+    int seen = 0;
+    for(Product *c = ix ? NULL : st->head, *next; c; c = next) {
+        if(seen++ % SCAN_CHUNK == 0 && !(c = scan_yield(st, c))) break;
+        next = c->next;
+        int cat = category_of(c->name);
+        if(cat >= 0 && !c->hold) avail[cat]++;
+    }
+    const char* names[100]; long counts[100];
+    int k = cold_names(st, names, counts, 100);
+    for(int i=0; i<k; i++) { int cat = category_of(names[i]); if(cat >= 0) expired[cat] += (int)counts[i]; }
+    store_unlock(st);
+}
+
+typedef struct { DetailRow* rows; int total, cap; } DetailList;
+
+static int detail_add(DetailList* l, const char* id, time_t expire_time, int is_expired) {
+    if(l->total == l->cap) {
+        int cap = l->cap ? l->cap * 2 : 64;
+        DetailRow* grown = realloc(l->rows, sizeof(DetailRow) * cap);
+        if(!grown) return 0;
+        l->rows = grown; l->cap = cap;
     }
-    pthread_mutex_unlock(&list_mutex);
+    strcpy(l->rows[l->total].id, id);
+    l->rows[l->total].expire_time = expire_time;
+    l->rows[l->total].is_expired = is_expired;
+    l->total++;
+    return 1;
 }
 
-int make_detail_page(char* out, const char* name, int page, int mode) {
-    pthread_mutex_lock(&list_mutex);
-    int total = 0;
-    for(Product* c = head; c; c = c->next) 
-        if(strcmp(c->name, name)==0 && !(mode==1 && !c->is_expired)) total++;
+static void detail_add_cold(void* arg, const ColdItem* c) { detail_add(arg, c->id, c->expire_time, 1); }
+
+// 모드 0 = 전체(목록 + 보관소), 1 = 만료(보관소만)
+int make_detail_page(Store* st, char* out, const char* name, int page, int mode) {
+    DetailList l = { NULL, 0, 0 }; int seen = 0;
+    store_lock(st);
+    for(Product *c = (mode==1) ? NULL : st->head, *next; c; c = next) {
+        if(seen++ % SCAN_CHUNK == 0 && !(c = scan_yield(st, c))) break;
+        next = c->next;
+        if(strcmp(c->name, name)==0 && !detail_add(&l, c->id, c->expire_time, 0)) break;
+    }
+    cold_each(st, name, detail_add_cold, &l);
+    store_unlock(st);
+    DetailRow* rows = l.rows; int total = l.total;
+
     int items = 15; int tp = (total + items - 1) / items;
     
     if(tp == 0) tp = 1; 
@@ -298,60 +1351,258 @@ int make_detail_page(char* out, const char* name, int page, int mode) {
 
     sprintf(out, "\n=== [%.40s] %s (페이지 %d/%d) ===\n", name, mode==1?"만료 목록":"상세 목록", page, tp);
     if(total > 0) {
-        Product** arr = malloc(sizeof(Product*) * total); int idx = 0;
-        for(Product* c = head; c; c = c->next)
-            if(strcmp(c->name, name)==0 && !(mode==1 && !c->is_expired)) arr[idx++] = c;
-        qsort(arr, total, sizeof(Product*), compare_products);
+        qsort(rows, total, sizeof(DetailRow), compare_rows);
         int start = (page-1)*items; int end = (start+items > total)? total : start+items;
         for(int i=start; i<end; i++) {
-            char t[200], ts[26]; print_time_str(arr[i]->expire_time, ts);
-            snprintf(t, sizeof(t), "  [%s] %s | %s\n", arr[i]->id, arr[i]->is_expired?"만료":"정상", ts);
+            char t[200], ts[26]; print_time_str(rows[i].expire_time, ts);
+            snprintf(t, sizeof(t), "  [%s] %s | %s\n", rows[i].id, rows[i].is_expired?"만료":"정상", ts);
             strcat(out, t);
         }
-        free(arr);
     } else strcat(out, "상품이 없습니다.\n");
-    pthread_mutex_unlock(&list_mutex);
+    free(rows);
     return tp;
 }
 
-int check_and_update_expirations(time_t current_vt) {
-    pthread_mutex_lock(&list_mutex);
-    int ch = 0;
-    for(Product* c = head; c; c = c->next) {
-        if(!c->is_expired && c->expire_time < current_vt) { 
-            c->is_expired = 1; ch = 1; 
-            char buf[256]; snprintf(buf, sizeof(buf), "[만료 발생] %s", c->name);
-            update_log(buf); 
+// 1/100 원 단위 합계 -> "1500" / "1500.50"
+static void format_money(int64_t v, char* out, size_t size) {
+    if (v % META_PRICE_SCALE == 0) snprintf(out, size, "%lld", (long long)(v / META_PRICE_SCALE));
+    else snprintf(out, size, "%lld.%02lld", (long long)(v / META_PRICE_SCALE), (long long)(v % META_PRICE_SCALE));
+}
+
+// 분류별 재고 금액 (만료 제외, 예약 포함). 부가 정보 열만 훑으므로 상품 수에 비해 짧음
+void make_stock_value(Store* st, char* out) {
+    int64_t value[NUM_CATEGORIES]; long priced[NUM_CATEGORIES];
+    store_lock(st);
+    meta_stock_value(st, value, priced);
+    store_unlock(st);
+
+    int64_t total = 0; long total_n = 0; char money[32];
+    int len = snprintf(out, MAX_PAYLOAD, "\n=== 분류별 재고 금액 (판매 가능 + 예약) ===\n");
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        if (!priced[i]) continue;
+        format_money(value[i], money, sizeof(money));
+        len += snprintf(out + len, MAX_PAYLOAD - len, " - %-15.40s : %ld개 | %s원\n", r_types[i], priced[i], money);
+        total += value[i]; total_n += priced[i];
+    }
+    format_money(total, money, sizeof(money));
+    if (!total_n) snprintf(out + len, MAX_PAYLOAD - len, "가격이 등록된 상품이 없습니다.\n");
+    else snprintf(out + len, MAX_PAYLOAD - len, " = 합계 %ld개 | %s원\n", total_n, money);
+}
+
+// 로트 번호로 상품 조회 (페이지당 15개, 반환: 전체 페이지 수)
+int make_lot_page(Store* st, char* out, const char* lot, int page) {
+    int items = 15;
+    void* owners[15]; int expired[15];
+    char lines[15][200]; int shown = 0;
+    if (page < 1) page = 1;
+    store_lock(st);
+    long total = meta_find_lot(st, lot, (long)(page - 1) * items, owners, expired, items);
+    int tp = (int)((total + items - 1) / items);
+    if (tp == 0) tp = 1;
+    if (page > tp) { page = tp; total = meta_find_lot(st, lot, (long)(page - 1) * items, owners, expired, items); }
+    for (long i = (long)(page - 1) * items; i < total && shown < items; i++, shown++) {
+        // 만료된 상품의 owner 는 보관소 항목
+        const Product* p = expired[shown] ? NULL : owners[shown];
+        const ColdItem* c = expired[shown] ? owners[shown] : NULL;
+        ItemMeta m; char ts[26], price[16];
+        meta_get(st, p ? p->meta : c->meta, &m);
+        print_time_str(p ? p->expire_time : c->expire_time, ts);
+        meta_format_price(m.price, price, sizeof(price));
+        snprintf(lines[shown], sizeof(lines[shown]), "  [%s] %s | %s | %s | 위치 %s | %s원\n", p ? p->id : c->id,
+                 p ? p->name : cold_name(st, c), p ? "정상" : "만료", ts, m.shelf[0] ? m.shelf : "-", price);
+    }
+    store_unlock(st);
+
+    int len = snprintf(out, MAX_PAYLOAD, "\n=== [로트 %.23s] 상품 목록 (페이지 %d/%d, 총 %ld개) ===\n", lot, page, tp, total);
+    for (int i = 0; i < shown; i++) len += snprintf(out + len, MAX_PAYLOAD - len, "%s", lines[i]);
+    if (!shown) snprintf(out + len, MAX_PAYLOAD - len, "상품이 없습니다.\n");
+    return tp;
+}
+
+// 상품 하나를 보관소로 옮기고 X 로 남김 (반환: 옮겼으면 1). recovered 면 놓쳤던 만료로 기록
+static int expire_one(Store* st, Product* c, int recovered) {
+    char id[20], name[50]; time_t et = c->expire_time;
+    strcpy(id, c->id); strcpy(name, c->name);
+    if(!mark_expired(st, c)) return 0;
+    journal_append(st, 'X', id);
+    int cat = category_of(name);
+    // 놓쳤던 만료는 원래 만료 시각을 기록 시각으로부터의 차이(초)로 남김
+    if(recovered) log_event(st, EV_EXPIRE_RECOVERED, 0, cat, 0, (int)(get_virtual_time() - et), cat < 0 ? name : NULL);
+    else log_event(st, EV_EXPIRE, 0, cat, 0, 0, cat < 0 ? name : NULL);
+    return 1;
+}
+
+// 만료 시각이 지난 상품을 보관소로 옮김 (반환: 옮긴 수)
+// 힙마다 맨 앞(유통기한이 가장 이른 상품)이 지금 시각 전인 동안만 꺼내므로 만료될 상품 수만큼만 일하고,
+// 힙 밖에 있는 예약된 상품은 예약 표에서 따로 봅니다. 색인을 만들 수 없을 때만 목록 전체를 훑음
+static int expire_due(Store* st, time_t current_vt, int recovered) {
+    int n = 0;
+    StockIndex* ix = ensure_index(st);
+    if(!ix) {
+        for(Product *c = st->head, *next; c; c = next) {
+            next = c->next;
+            if(c->expire_time < current_vt) n += expire_one(st, c, recovered);
         }
+        return n;
+    }
+    for(int s = 0; s < HEAP_SLOTS; s++) {
+        // 보관소 메모리 부족으로 못 옮기면 이 힙은 다음 검사 때 다시
+        while(ix->len[s] > 0 && ix->heap[s][0]->expire_time < current_vt && expire_one(st, ix->heap[s][0], recovered)) n++;
     }
-    if(ch) save_data(); 
-    pthread_mutex_unlock(&list_mutex);
+    for(Reservation* r = ix->oldest; r; r = r->newer) {
+        for(Product *c = r->items, *next; c; c = next) {
+            next = c->hold_next;
+            if(c->expire_time < current_vt) n += expire_one(st, c, recovered);
+        }
+    }
+    return n;
+}
+
+int check_and_update_expirations(Store* st, time_t current_vt) {
+    TRACE_BEGIN("expire", "만료 검사", 0);
+    store_lock(st);
+    int n = expire_due(st, current_vt, 0), ch = n > 0;
+    if(ch) save_data(st); 
+    // TTL 이 지난 장바구니 예약 해제 (저널에 남지 않는 변경이므로 재고 버전만 올림)
+    if(expire_holds(st, current_vt)) store_changed(st);
+    store_unlock(st);
+    TRACE_END("expire", "만료 검사", n);
     return ch;
 }
 
 // src/inventory.c 맨 아래 추가
 
-void recover_missed_expirations(time_t current_vt) {
-    pthread_mutex_lock(&list_mutex);
-    int recovery_count = 0;
-    
-    for(Product* c = head; c; c = c->next) {
-        if(!c->is_expired && c->expire_time < current_vt) { 
-            c->is_expired = 1;
-            
-            char buf[256];
-            char expire_ts[26];
-            print_time_str(c->expire_time, expire_ts); 
-
-            snprintf(buf, sizeof(buf), "[재시작 복구] 중단 중 만료 발생: %s (원래 만료: %s)", c->name, expire_ts);
-            
-            update_log(buf); 
-            recovery_count++;
+void recover_missed_expirations(Store* st, time_t current_vt) {
+    TRACE_BEGIN("expire", "만료 복구", 0);
+    store_lock(st);
+    int recovery_count = expire_due(st, current_vt, 1);
+
+    if(recovery_count > 0) {
+        save_data(st); 
+    }
+    store_unlock(st);
+    TRACE_END("expire", "만료 복구", recovery_count);
+}
+
+// [복제 API 구현]
+
+typedef struct { Store* st; char* buf; size_t len, cap; const char* head; } SnapshotDump;
+
+static void dump_row(SnapshotDump* d, const char* id, const char* name, time_t expire_time, int is_expired, uint32_t meta) {
+    char extra[META_LINE_LEN];
+    format_meta(d->st, meta, extra, sizeof(extra));
+    if (d->len < d->cap)
+        d->len += snprintf(d->buf + d->len, d->cap - d->len, "%s %s %s %ld %d%s\n", d->head, id, name, (long)expire_time, is_expired, extra);
+}
+
+static void dump_cold_row(void* arg, const ColdItem* c) {
+    SnapshotDump* d = arg;
+    dump_row(d, c->id, cold_name(d->st, c), c->expire_time, 1, c->meta);
+}
+
+// 전체 동기화용 스냅샷: "L vt F 매장" + "L vt S 매장 id name expire is_expired" 줄들을 만들어 반환
+char* dump_store_snapshot(Store* st, uint64_t* out_lsn) {
+    store_lock(st);
+    // list_mutex 를 잡고 있는 동안 이 매장의 새 레코드는 생기지 않으므로 L 이후 레코드만 이어 받으면 됨
+    uint64_t lsn = journal_current_lsn();
+    long vt = (long)get_virtual_time();
+    const char* tok = journal_store_token(st);
+    char head[96];
+    snprintf(head, sizeof(head), "%llu %ld S %s", (unsigned long long)lsn, vt, tok);
+    SnapshotDump d = { st, NULL, 0, (size_t)(st->item_count + 1) * JOURNAL_LINE, head };
+    if ((d.buf = malloc(d.cap)) != NULL) {
+        d.len += snprintf(d.buf, d.cap, "%llu %ld F %s\n", (unsigned long long)lsn, vt, tok);
+        for(Product* c = st->head; c; c = c->next) dump_row(&d, c->id, c->name, c->expire_time, 0, c->meta);
+        cold_each(st, NULL, dump_cold_row, &d);
+        // 오프라인 원장: 같은 LSN 의 O 레코드로 (복제본은 F 직후의 같은 LSN O 만 받아들임)
+        char prefix[96];
+        size_t olen;
+        snprintf(prefix, sizeof(prefix), "%llu %ld O %s ", (unsigned long long)lsn, vt, tok);
+        char* ledger = offline_dump(st, prefix, &olen);
+        char* grown = ledger ? realloc(d.buf, d.len + olen + 1) : NULL;
+        if (grown) { memcpy(grown + d.len, ledger, olen + 1); d.buf = grown; d.len += olen; }
+        free(ledger);
+    }
+    store_unlock(st);
+    *out_lsn = lsn;
+    return d.buf;
+}
+
+// 복제본에서 주 서버 레코드 1건 적용 (적용되면 1, 중복/무시되면 0)
+// 레코드 1건을 저널에 남기지 않고 그대로 반영 (R/C: 비움, A: 추가, D: 삭제, X: 만료 표시)
+void apply_history_record(Store* st, char op, const char* args) {
+    if (op == 'R' || op == 'C') { free_all_resources(st); return; }     // 오프라인 원장은 재고와 별개라 남김
+    if (op == 'O') { offline_apply(st, args); return; }
+    if (op == 'A' || op == 'D' || op == 'X') {
+        char id[20] = "", name[50] = ""; long et = 0; int ie = 0;
+        char price[16] = "", lot[META_TEXT_LEN] = "", sup[META_TEXT_LEN] = "", shelf[META_TEXT_LEN] = "";
+        sscanf(args, "%19s %49s %ld %d %15s %23s %23s %23s", id, name, &et, &ie, price, lot, sup, shelf);
+        ItemMeta m;
+        if (op == 'A' && ie) {
+            // 만료된 상품은 바로 보관소로 (owner 는 cold_add 가 항목으로 바꿈)
+            uint32_t slot = meta_parse(price, lot, sup, shelf, &m) ? meta_store(st, &m, category_of(name), NULL) : 0;
+            add_cold(st, id, name, (time_t)et, slot);
+            idalloc_observe(st, id);
+        } else if (op == 'A') {
+            Product* n = alloc_product(st);
+            if (n) {
+                strcpy(n->id, id); strcpy(n->name, name);
+                n->expire_time = (time_t)et;
+                if (meta_parse(price, lot, sup, shelf, &m)) n->meta = meta_store(st, &m, category_of(name), n);
+                link_product(st, n);
+                idalloc_observe(st, id);
+            }
+        } else {
+            Product *cur = find_by_id(st, id);
+            ColdItem* old = cur ? NULL : cold_find(st, id);
+            if (cur && op == 'X') mark_expired(st, cur);
+            else if (cur) remove_product(st, cur);
+            else if (old && op == 'D') { meta_drop(st, old->meta); cold_remove(st, old); }
         }
     }
+}
 
-    if(recovery_count > 0) {
-        save_data(); 
+int apply_journal_record(Store* st, uint64_t lsn, time_t vt, char op, const char* args) {
+    store_lock(st);
+    int applied = 0;
+
+    if (op == 'F') {                                    // 전체 동기화: 무조건 재구성 (받던 묶음은 버림)
+        st->applied_lsn = lsn; applied = 1; op = 'R';
+        history_group_free(&st->pending_group);
+    } else if (op == 'S') {                             // 스냅샷 항목: 직전 F 와 같은 LSN 일 때만
+        if (lsn == st->applied_lsn) op = 'A', applied = 1;
+    } else if (op == 'O' && lsn == st->applied_lsn) {   // 스냅샷의 원장 항목 (최대값이라 다시 받아도 같음)
+        applied = 1;
+    } else if (lsn > st->applied_lsn) {
+        st->applied_lsn = lsn; applied = 1;
+    }
+
+    if (applied) {
+        history_group_apply(st, &st->pending_group, op, args);   // 묶음 안이면 K 를 받을 때 한꺼번에
+        history_append(st, lsn, vt, op, args);        // 복제본도 시점 조회를 할 수 있도록 이력 유지
+        store_changed(st);
     }
-    pthread_mutex_unlock(&list_mutex);
-}
\ No newline at end of file
+    store_unlock(st);
+    return applied;
+}
+
+// 다른 매장 구조체(시점 복원 결과)의 상품 목록을 통째로 가져와 교체
+void replace_products(Store* dst, Store* src) {
+    // 과거 시점으로 돌아가도 이미 발급한 ID 번호는 다시 쓰지 않음 (발급 상태는 매장 구조체에 그대로 남음)
+    free_all_resources(dst);
+    drop_index(src);
+    drop_id_index(src);
+    dst->head = src->head;
+    meta_move(dst, src);
+    cold_move(dst, src);
+    dst->item_count = src->item_count; dst->mem_bytes = src->mem_bytes;
+    src->head = NULL; src->item_count = 0; src->mem_bytes = 0;
+}
+
+void journal_all_products(Store* st) {
+    history_batch(st, 1);
+    journal_append(st, 'R', NULL);
+    for(Product* c = st->head; c; c = c->next) journal_product(st, 'A', c);
+    cold_each(st, NULL, journal_cold, st);
+    history_batch(st, 0);
+}
@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include "iobackend.h"
+#include "trace.h"
+
+// =====================================================================
+// [저장 I/O 백엔드]
+// 쓰는 쪽은 파일의 "모으는 중" 버퍼에 복사만 합니다. 버퍼가 가득 차면 전역 큐로 넘기고,
+// 덜 찬 버퍼는 파일을 dirty 목록에 올려 두었다가 I/O 스레드가 깨어날 때 함께 가져갑니다.
+// I/O 스레드는 큐와 dirty 목록을 한꺼번에 비워 한 묶음으로 만들고, io_uring 이면 SQE 를 한 번에 채워
+// io_uring_enter 한 번으로 제출/완료 대기, pwrite 백엔드면 차례로 pwrite 합니다. 묶음이 끝나야 다음 묶음을
+// 시작하므로 같은 위치를 덮어쓰는 io_replace 는 늦게 넣은 것이 이깁니다.
+// 락 순서: 파일 mutex -> io_mutex. I/O 스레드는 io_mutex 를 놓은 뒤 파일 mutex 를 trylock 으로만 잡습니다
+// (버퍼가 빌 때까지 기다리는 쪽이 파일 mutex 를 쥐고 있을 수 있음).
+// =====================================================================
+
+typedef struct IoBuf {
+    char* data;
+    size_t len;
+    off_t off;
+    int reg;                    // 등록 버퍼 번호 (-1 = io_write_ref 의 호출자 메모리)
+    IoFile* f;
+    uint64_t seq;               // 이 버퍼가 끝나면 f 의 쓰기가 이 순번까지 끝난 것
+    int done;
+    struct IoBuf* next;
+    struct IoBuf* fnext;        // 같은 파일에서 다음에 넘긴 버퍼 (io_mutex)
+} IoBuf;
+
+struct IoFile {
+    int fd;
+    off_t size;                 // 논리 크기 (f->mutex)
+    IoBuf* cur;                 // 모으는 중인 버퍼 (f->mutex)
+    uint64_t seq;               // 넣은 쓰기 수 (f->mutex)
+    uint64_t done_seq;          // 다 쓴 순번 (io_mutex)
+    int pending;                // I/O 스레드에 넘어가 아직 안 끝난 버퍼 수 (io_mutex)
+    IoBuf *flight_head, *flight_tail;   // 넘긴 순서대로 (끝나도 앞의 것이 다 끝날 때까지 남음, io_mutex)
+    int dirty, closing, failed; // (io_mutex)
+    struct IoFile* dirty_next;
+    pthread_mutex_t mutex;
+};
+
+static pthread_mutex_t io_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t io_cond = PTHREAD_COND_INITIALIZER;      // I/O 스레드 깨우기
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;    // 쓰기 완료 / 버퍼 반납
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+static int backend = IO_BACKEND_SYNC;
+static char* pool;
+static IoBuf bufs[IO_BUFS];
+static IoBuf* free_bufs;
+static IoBuf *queue_head, *queue_tail;      // 가득 찬 버퍼와 io_write_ref (io_mutex)
+static IoFile* dirty_head;                  // 모으는 중인 버퍼가 있거나 닫을 파일 (io_mutex)
+static int wake_pending;                    // io_submit 이후 I/O 스레드가 아직 돌지 않음 (io_mutex)
+static int in_flight;                       // 전체 pending 합 (io_mutex)
+static uint64_t n_writes, n_batches;
+
+// ---------------------------------------------------------------------
+// io_uring (liburing 없이 시스템 콜로 직접)
+// ---------------------------------------------------------------------
+static int ring_fd = -1, ring_registered = 0;
+static unsigned *sq_head, *sq_tail, *sq_mask, *sq_array, *cq_head, *cq_tail, *cq_mask, sq_entries;
+static struct io_uring_sqe* sqes;
+static struct io_uring_cqe* cqes;
+
+static int uring_setup(void) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = (int)syscall(__NR_io_uring_setup, IO_QUEUE_DEPTH, &p);
+    if (fd < 0) return 0;
+    size_t sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    int single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && cq_len > sq_len) sq_len = cq_len;
+    char* sq = mmap(NULL, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    char* cq = single ? sq : mmap(NULL, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED) { close(fd); return 0; }
+    sq_head = (unsigned*)(sq + p.sq_off.head); sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    sq_mask = (unsigned*)(sq + p.sq_off.ring_mask); sq_array = (unsigned*)(sq + p.sq_off.array);
+    cq_head = (unsigned*)(cq + p.cq_off.head); cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    sq_entries = p.sq_entries;
+    ring_fd = fd;
+
+    // 스테이징 버퍼를 등록해 두면 쓰기마다 페이지를 고정하지 않음 (memlock 한도로 실패하면 일반 WRITE)
+    struct iovec iov[IO_BUFS];
+    for (int i = 0; i < IO_BUFS; i++) { iov[i].iov_base = bufs[i].data; iov[i].iov_len = IO_BUF_SIZE; }
+    ring_registered = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iov, IO_BUFS) == 0;
+    return 1;
+}
+
+static void pwrite_buf(IoBuf* b) {
+    while (b->len > 0) {
+        ssize_t n = pwrite(b->f->fd, b->data, b->len, b->off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) { b->f->failed = 1; return; }
+        b->data += n; b->len -= n; b->off += n;
+    }
+}
+
+// 묶음을 큐 길이만큼씩 SQE 로 채워 제출하고 모두 끝날 때까지 기다림
+static void uring_write(IoBuf** batch, int n) {
+    for (int i = 0; i < n; ) {
+        int k = n - i < (int)sq_entries ? n - i : (int)sq_entries;
+        unsigned tail = *sq_tail;
+        for (int j = 0; j < k; j++) {
+            IoBuf* b = batch[i + j];
+            unsigned idx = (tail + j) & *sq_mask;
+            struct io_uring_sqe* sqe = &sqes[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = (b->reg >= 0 && ring_registered) ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            if (sqe->opcode == IORING_OP_WRITE_FIXED) sqe->buf_index = (uint16_t)b->reg;
+            sqe->fd = b->f->fd;
+            sqe->addr = (uint64_t)(uintptr_t)b->data;
+            sqe->len = (uint32_t)b->len;
+            sqe->off = (uint64_t)b->off;
+            sqe->user_data = (uint64_t)(i + j);
+            sq_array[idx] = idx;
+        }
+        __atomic_store_n(sq_tail, tail + k, __ATOMIC_RELEASE);
+        int to_submit = k, got = 0;
+        while (got < k) {
+            int r = (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, k - got, IORING_ENTER_GETEVENTS, NULL, 0);
+            if (r < 0 && errno != EINTR) break;
+            if (r > 0) to_submit -= r < to_submit ? r : to_submit;
+            unsigned head = *cq_head;
+            while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                struct io_uring_cqe* cqe = &cqes[head & *cq_mask];
+                IoBuf* b = batch[cqe->user_data];
+                if (cqe->res >= 0 && (size_t)cqe->res <= b->len) {
+                    // 짧게 쓰였으면 나머지는 pwrite 로 (드묾)
+                    b->data += cqe->res; b->len -= cqe->res; b->off += cqe->res;
+                    if (b->len > 0) pwrite_buf(b);
+                } else if (cqe->res == -EAGAIN || cqe->res == -EINTR) pwrite_buf(b);
+                else b->f->failed = 1;
+                head++; got++;
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        }
+        if (got < k) {
+            // 링 오류: 이후로는 pwrite 만 씀 (이미 끝난 것은 len 0, 늦게 온 완료는 읽지 않음)
+            backend = IO_BACKEND_PWRITE;
+            for (int j = i; j < n; j++) pwrite_buf(batch[j]);
+            return;
+        }
+        i += k;
+    }
+}
+
+// ---------------------------------------------------------------------
+// 버퍼 풀
+// ---------------------------------------------------------------------
+static void init_pool(void) {
+    pool = aligned_alloc(4096, (size_t)IO_BUF_SIZE * IO_BUFS);
+    for (int i = 0; i < IO_BUFS; i++) {
+        bufs[i].data = pool ? pool + (size_t)i * IO_BUF_SIZE : NULL;
+        bufs[i].reg = i;
+        bufs[i].next = free_bufs;
+        if (pool) free_bufs = &bufs[i];
+    }
+}
+
+// io_mutex 보유 상태에서 호출
+static void release_buf(IoBuf* b) {
+    if (b->reg < 0) { free(b); return; }
+    b->data = pool + (size_t)b->reg * IO_BUF_SIZE;
+    b->len = 0;
+    b->next = free_bufs; free_bufs = b;
+}
+
+// io_mutex 보유 상태에서 호출. 넘긴 버퍼를 파일의 완료 대기 줄 끝에 붙임
+static void track_locked(IoFile* f, IoBuf* b) {
+    b->done = 0; b->fnext = NULL;
+    if (f->flight_tail) f->flight_tail->fnext = b; else f->flight_head = b;
+    f->flight_tail = b;
+    f->pending++; in_flight++;
+}
+
+// io_mutex 보유 상태에서 호출. 끝난 묶음을 파일별 완료 순번에 반영하고 버퍼 반납
+// 버퍼는 넘긴 순서와 다르게 끝날 수 있으므로(모으던 버퍼를 먼저 넘긴 버퍼보다 먼저 쓰는 경우 등)
+// 완료 순번은 대기 줄 앞에서부터 연달아 끝난 버퍼까지만 올림
+static void complete_locked(IoBuf* list) {
+    for (IoBuf* b = list, *next; b; b = next) {
+        next = b->next;
+        IoFile* f = b->f;
+        b->done = 1;
+        f->pending--; in_flight--;
+        while (f->flight_head && f->flight_head->done) {
+            IoBuf* h = f->flight_head;
+            f->flight_head = h->fnext;
+            if (!f->flight_head) f->flight_tail = NULL;
+            if (h->seq > f->done_seq) f->done_seq = h->seq;
+            release_buf(h);
+        }
+    }
+    pthread_cond_broadcast(&done_cond);
+}
+
+static void destroy_file(IoFile* f) {
+    if (f->fd >= 0) close(f->fd);
+    pthread_mutex_destroy(&f->mutex);
+    free(f);
+}
+
+// io_mutex 보유 상태에서 호출
+static void mark_dirty(IoFile* f) {
+    if (f->dirty) return;
+    f->dirty = 1;
+    f->dirty_next = dirty_head; dirty_head = f;
+}
+
+// io_mutex 보유 상태에서 호출 (동기 모드에서 바로 닫을 때)
+static void unmark_dirty(IoFile* f) {
+    if (!f->dirty) return;
+    for (IoFile** p = &dirty_head; *p; p = &(*p)->dirty_next)
+        if (*p == f) { *p = f->dirty_next; break; }
+    f->dirty = 0;
+}
+
+static void write_list(IoBuf* list) {
+    IoBuf* batch[IO_BUFS + IO_QUEUE_DEPTH];
+    int n = 0;
+    uint64_t writes = 0;
+    TRACE_BEGIN("persist", "I/O 묶음", 0);
+    for (IoBuf* b = list; b; b = b->next) {
+        writes++;
+        if (backend == IO_BACKEND_URING) {
+            batch[n++] = b;
+            if (n == (int)(sizeof(batch) / sizeof(batch[0]))) { uring_write(batch, n); n = 0; }
+        } else pwrite_buf(b);
+    }
+    if (n) uring_write(batch, n);
+    TRACE_END("persist", "I/O 묶음", (long)writes);
+    __atomic_add_fetch(&n_writes, writes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&n_batches, 1, __ATOMIC_RELAXED);
+}
+
+// dirty 목록의 파일에서 모으는 중인 버퍼를 떼어 list 에 붙임. 잡지 못한 파일은 다시 dirty 로 (반환: 못 잡은 수)
+// closing 파일은 더 쓸 것이 없으면 to_close 로
+static int take_partial(IoFile* dirty, IoBuf** list, IoFile** to_close) {
+    int busy = 0;
+    for (IoFile* f = dirty, *next; f; f = next) {
+        next = f->dirty_next;
+        if (pthread_mutex_trylock(&f->mutex) != 0) {
+            pthread_mutex_lock(&io_mutex); mark_dirty(f); pthread_mutex_unlock(&io_mutex);
+            busy++;
+            continue;
+        }
+        IoBuf* b = f->cur;
+        f->cur = NULL;
+        pthread_mutex_lock(&io_mutex);
+        if (b && b->len == 0) { release_buf(b); b = NULL; }
+        if (b) { b->seq = f->seq; track_locked(f, b); b->next = *list; *list = b; }
+        else if (f->pending == 0) f->done_seq = f->seq;     // 쓸 것이 남지 않음
+        if (f->closing) { f->dirty_next = *to_close; *to_close = f; }
+        pthread_mutex_unlock(&io_mutex);
+        pthread_mutex_unlock(&f->mutex);
+    }
+    return busy;
+}
+
+// 큐와 dirty 목록을 한 묶음으로 비움 (I/O 스레드, 또는 동기 모드에서 버퍼가 모자랄 때)
+static int run_batch(void) {
+    pthread_mutex_lock(&io_mutex);
+    IoBuf* list = queue_head;
+    IoFile* dirty = dirty_head;
+    queue_head = queue_tail = NULL; dirty_head = NULL;
+    for (IoFile* f = dirty; f; f = f->dirty_next) f->dirty = 0;
+    wake_pending = 0;
+    pthread_mutex_unlock(&io_mutex);
+
+    IoFile* to_close = NULL;
+    int busy = take_partial(dirty, &list, &to_close);
+    if (list) write_list(list);
+
+    pthread_mutex_lock(&io_mutex);
+    complete_locked(list);
+    for (IoFile* f = to_close, *next; f; f = next) {
+        next = f->dirty_next;
+        if (f->pending == 0) destroy_file(f);
+        else mark_dirty(f);         // 아직 큐에 남은 버퍼가 있으면 다음 묶음 뒤에
+    }
+    pthread_mutex_unlock(&io_mutex);
+    return busy;
+}
+
+static void* io_thread(void* arg) {
+    (void)arg;
+    // 종료 시그널 처리(io_flush_all)가 이 스레드에서 돌면 자기 자신을 기다리게 되므로 시그널은 받지 않음
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+    while (1) {
+        pthread_mutex_lock(&io_mutex);
+        while (!queue_head && !wake_pending) pthread_cond_wait(&io_cond, &io_mutex);
+        pthread_mutex_unlock(&io_mutex);
+        if (run_batch() > 0) {
+            // 쓰는 중이라 못 가져간 파일: 곧 다시
+            pthread_mutex_lock(&io_mutex); wake_pending = 1; pthread_mutex_unlock(&io_mutex);
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// 빈 버퍼 하나 (f->mutex 보유 상태에서 호출). 모두 쓰기 중이면 I/O 스레드를 깨우고 반납될 때까지 대기
+static IoBuf* get_buf(IoFile* f) {
+    pthread_once(&pool_once, init_pool);
+    pthread_mutex_lock(&io_mutex);
+    while (!free_bufs) {
+        if (backend == IO_BACKEND_SYNC) {
+            pthread_mutex_unlock(&io_mutex);
+            run_batch();            // 다른 파일이 쥔 버퍼를 이 스레드에서 바로 씀
+            pthread_mutex_lock(&io_mutex);
+            if (!free_bufs) { pthread_mutex_unlock(&io_mutex); sched_yield(); pthread_mutex_lock(&io_mutex); }
+            continue;
+        }
+        wake_pending = 1;
+        pthread_cond_signal(&io_cond);
+        pthread_cond_wait(&done_cond, &io_mutex);
+    }
+    IoBuf* b = free_bufs;
+    free_bufs = b->next;
+    b->f = f; b->len = 0; b->off = f->size; b->next = NULL;
+    mark_dirty(f);
+    pthread_mutex_unlock(&io_mutex);
+    return b;
+}
+
+// 다 찬 버퍼(또는 io_write_ref)를 I/O 스레드에 넘김 (f->mutex 보유 상태에서 호출)
+static void hand_over(IoFile* f, IoBuf* b) {
+    b->seq = f->seq;
+    pthread_mutex_lock(&io_mutex);
+    track_locked(f, b);
+    b->next = NULL;
+    if (backend == IO_BACKEND_SYNC) {
+        pthread_mutex_unlock(&io_mutex);
+        write_list(b);
+        pthread_mutex_lock(&io_mutex);
+        complete_locked(b);
+    } else {
+        if (queue_tail) queue_tail->next = b; else queue_head = b;
+        queue_tail = b;
+        pthread_cond_signal(&io_cond);
+    }
+    pthread_mutex_unlock(&io_mutex);
+}
+
+// ---------------------------------------------------------------------
+// 공개 API
+// ---------------------------------------------------------------------
+int io_init(int want) {
+    pthread_once(&pool_once, init_pool);
+    if (!pool) return backend;
+    int chosen = (want == IO_BACKEND_URING && uring_setup()) ? IO_BACKEND_URING : IO_BACKEND_PWRITE;
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, io_thread, NULL) != 0) return backend;
+    pthread_detach(tid);
+    backend = chosen;
+    return backend;
+}
+
+int io_backend(void) { return backend; }
+
+const char* io_backend_name(void) {
+    if (backend == IO_BACKEND_URING) return ring_registered ? "io_uring (등록 버퍼)" : "io_uring";
+    return backend == IO_BACKEND_PWRITE ? "pwrite" : "동기 pwrite";
+}
+
+IoFile* io_open(const char* path, int mode) {
+    int fd = open(path, O_WRONLY | O_CREAT | (mode == IO_CREATE ? O_TRUNC : 0), 0644);
+    if (fd < 0) return NULL;
+    IoFile* f = calloc(1, sizeof(IoFile));
+    if (!f) { close(fd); return NULL; }
+    struct stat sb;
+    f->fd = fd;
+    f->size = fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) ? sb.st_size : 0;
+    pthread_mutex_init(&f->mutex, NULL);
+    return f;
+}
+
+void io_append(IoFile* f, const void* data, size_t len) {
+    const char* p = data;
+    if (len == 0) return;
+    pthread_mutex_lock(&f->mutex);
+    while (len > 0) {
+        if (!f->cur && !(f->cur = get_buf(f))) break;
+        IoBuf* b = f->cur;
+        size_t n = IO_BUF_SIZE - b->len < len ? IO_BUF_SIZE - b->len : len;
+        memcpy(b->data + b->len, p, n);
+        b->len += n; f->size += n;
+        p += n; len -= n;
+        if (b->len == IO_BUF_SIZE) { f->cur = NULL; hand_over(f, b); }
+    }
+    f->seq++;
+    pthread_mutex_unlock(&f->mutex);
+}
+
+void io_write_ref(IoFile* f, const void* data, size_t len) {
+    IoBuf* b = malloc(sizeof(IoBuf));
+    if (!b) { io_append(f, data, len); return; }
+    pthread_mutex_lock(&f->mutex);
+    *b = (IoBuf){ .data = (char*)data, .len = len, .off = f->size, .reg = -1, .f = f };
+    f->size += len;
+    f->seq++;
+    hand_over(f, b);
+    pthread_mutex_unlock(&f->mutex);
+}
+
+void io_replace(IoFile* f, const void* data, size_t len) {
+    if (len > IO_BUF_SIZE) len = IO_BUF_SIZE;
+    pthread_mutex_lock(&f->mutex);
+    if (f->cur && f->cur->off != 0) { IoBuf* b = f->cur; f->cur = NULL; hand_over(f, b); }
+    if (f->cur || (f->cur = get_buf(f))) {
+        f->cur->off = 0;
+        memcpy(f->cur->data, data, len);
+        f->cur->len = len;
+        if ((off_t)len > f->size) f->size = len;
+    }
+    f->seq++;
+    pthread_mutex_unlock(&f->mutex);
+    io_submit(f);
+}
+
+void io_submit(IoFile* f) {
+    if (backend == IO_BACKEND_SYNC) {
+        pthread_mutex_lock(&f->mutex);
+        IoBuf* b = f->cur;
+        f->cur = NULL;
+        if (b) hand_over(f, b);
+        pthread_mutex_unlock(&f->mutex);
+        return;
+    }
+    pthread_mutex_lock(&io_mutex);
+    mark_dirty(f);
+    wake_pending = 1;
+    pthread_cond_signal(&io_cond);
+    pthread_mutex_unlock(&io_mutex);
+}
+
+void io_drain(IoFile* f) {
+    pthread_mutex_lock(&f->mutex);
+    uint64_t target = f->seq;
+    pthread_mutex_unlock(&f->mutex);
+    io_submit(f);
+    if (backend == IO_BACKEND_SYNC) return;     // io_submit 이 이미 씀
+    pthread_mutex_lock(&io_mutex);
+    while (f->done_seq < target) {
+        if (!f->dirty && !f->pending) { mark_dirty(f); wake_pending = 1; pthread_cond_signal(&io_cond); }
+        pthread_cond_wait(&done_cond, &io_mutex);
+    }
+    pthread_mutex_unlock(&io_mutex);
+}
+
+int io_fsync(IoFile* f) {
+    io_drain(f);
+    pthread_mutex_lock(&io_mutex);
+    int failed = f->failed;
+    pthread_mutex_unlock(&io_mutex);
+    return !failed && fsync(f->fd) == 0;
+}
+
+off_t io_size(IoFile* f) {
+    pthread_mutex_lock(&f->mutex);
+    off_t size = f->size;
+    pthread_mutex_unlock(&f->mutex);
+    return size;
+}
+
+void io_truncate(IoFile* f) {
+    io_drain(f);
+    pthread_mutex_lock(&f->mutex);
+    if (ftruncate(f->fd, 0) == 0) f->size = 0;
+    pthread_mutex_unlock(&f->mutex);
+}
+
+void io_close(IoFile* f) {
+    if (!f) return;
+    if (backend == IO_BACKEND_SYNC) {
+        io_submit(f);
+        pthread_mutex_lock(&io_mutex); unmark_dirty(f); pthread_mutex_unlock(&io_mutex);
+        destroy_file(f);
+        return;
+    }
+    pthread_mutex_lock(&io_mutex);
+    f->closing = 1;
+    mark_dirty(f);
+    wake_pending = 1;
+    pthread_cond_signal(&io_cond);
+    pthread_mutex_unlock(&io_mutex);
+}
+
+void io_flush_all(void) {
+    if (backend == IO_BACKEND_SYNC) { run_batch(); return; }
+    pthread_mutex_lock(&io_mutex);
+    while (queue_head || dirty_head || in_flight > 0) {
+        wake_pending = 1;
+        pthread_cond_signal(&io_cond);
+        pthread_cond_wait(&done_cond, &io_mutex);
+    }
+    pthread_mutex_unlock(&io_mutex);
+}
+
+void io_counters(uint64_t* writes, uint64_t* batches) {
+    *writes = __atomic_load_n(&n_writes, __ATOMIC_RELAXED);
+    *batches = __atomic_load_n(&n_batches, __ATOMIC_RELAXED);
+}
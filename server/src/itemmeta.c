@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "itemmeta.h"
+
+// =====================================================================
+// [상품 부가 정보 - 열 저장소]
+// 가격/로트/공급사/진열 위치는 상품 구조체에 넣지 않고 매장별 열 배열에 둡니다.
+// 상품은 슬롯 번호(4바이트, 구조체의 빈 정렬 공간)만 가지므로 판매/만료 경로가 훑는 필드는 그대로입니다.
+//  - 가격: int32 고정소수점 (1/100 원)
+//  - 로트/공급사/진열 위치: 매장별 사전의 2바이트 코드 (같은 로트의 상품 수백 개가 문자열 하나를 공유)
+//  - 분류/상태: 1바이트씩 -> 분류별 재고 금액은 가격/분류/상태 열만 연속으로 훑음
+// 빈 슬롯은 스택에 모아 다시 씁니다.
+// =====================================================================
+
+#define SLOT_USED    1
+#define SLOT_EXPIRED 2
+
+typedef struct {
+    char (*words)[META_TEXT_LEN];   // 코드 c 의 문자열 = words[c - 1]
+    int count, cap;
+    uint16_t* hash;                 // 열린 주소법, 0 = 빈 칸
+    int hash_size;
+} Dict;
+
+typedef struct MetaTable {
+    uint32_t len, cap;              // 슬롯 0 은 쓰지 않음
+    int32_t* price;
+    uint16_t *lot, *supplier, *shelf;
+    uint8_t *category, *flags;
+    void** owner;
+    uint32_t* free_slots;
+    uint32_t n_free;
+    Dict lots, suppliers, shelves;
+} MetaTable;
+
+// ---------------------------------------------------------------------
+// 입력 검증과 문자열 형식
+// ---------------------------------------------------------------------
+static int is_none(const char* s) {
+    return !s || !s[0] || strcmp(s, "-") == 0;
+}
+
+static int copy_text(char* dst, const char* s) {
+    dst[0] = '\0';
+    if (is_none(s)) return 1;
+    if (strlen(s) >= META_TEXT_LEN || strpbrk(s, " \t\r\n|")) return 0;
+    strcpy(dst, s);
+    return 1;
+}
+
+// "1500", "1500.5", "1500.50" -> 1/100 원 (부동소수점을 거치지 않음)
+static int parse_price(const char* s, int32_t* out) {
+    *out = META_NO_PRICE;
+    if (is_none(s)) return 1;
+    long long whole = 0; int frac = 0, digits = 0;
+    const char* p = s;
+    if (*p < '0' || *p > '9') return 0;
+    for (; *p >= '0' && *p <= '9'; p++) if ((whole = whole * 10 + (*p - '0')) > INT32_MAX / META_PRICE_SCALE) return 0;
+    if (*p == '.') for (p++; *p >= '0' && *p <= '9'; p++) if (digits < 2) { frac = frac * 10 + (*p - '0'); digits++; }
+    if (*p) return 0;
+    if (digits == 1) frac *= 10;
+    *out = (int32_t)(whole * META_PRICE_SCALE + frac);
+    return 1;
+}
+
+int meta_parse(const char* price, const char* lot, const char* supplier, const char* shelf, ItemMeta* out) {
+    return parse_price(price, &out->price) && copy_text(out->lot, lot) &&
+           copy_text(out->supplier, supplier) && copy_text(out->shelf, shelf);
+}
+
+int meta_is_empty(const ItemMeta* m) {
+    return m->price == META_NO_PRICE && !m->lot[0] && !m->supplier[0] && !m->shelf[0];
+}
+
+void meta_format_price(int32_t price, char* out, size_t size) {
+    if (price == META_NO_PRICE) snprintf(out, size, "-");
+    else if (price % META_PRICE_SCALE == 0) snprintf(out, size, "%d", price / META_PRICE_SCALE);
+    else snprintf(out, size, "%d.%02d", price / META_PRICE_SCALE, price % META_PRICE_SCALE);
+}
+
+void meta_format(const ItemMeta* m, char* out, size_t size) {
+    if (meta_is_empty(m)) { if (size) out[0] = '\0'; return; }
+    char p[16];
+    meta_format_price(m->price, p, sizeof(p));
+    snprintf(out, size, " %s %s %s %s", p, m->lot[0] ? m->lot : "-",
+             m->supplier[0] ? m->supplier : "-", m->shelf[0] ? m->shelf : "-");
+}
+
+// ---------------------------------------------------------------------
+// 사전 (문자열 <-> 2바이트 코드)
+// ---------------------------------------------------------------------
+static unsigned hash_text(const char* s) {
+    unsigned h = 2166136261u;
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+// 있으면 코드, 없으면 0 (slot_out 에 들어갈 빈 칸 위치)
+static uint16_t dict_find(const Dict* d, const char* s, int* slot_out) {
+    if (!d->hash_size) { if (slot_out) *slot_out = -1; return 0; }
+    int i = hash_text(s) & (d->hash_size - 1);
+    while (d->hash[i]) {
+        if (strcmp(d->words[d->hash[i] - 1], s) == 0) return d->hash[i];
+        i = (i + 1) & (d->hash_size - 1);
+    }
+    if (slot_out) *slot_out = i;
+    return 0;
+}
+
+static int dict_rehash(Dict* d, int size) {
+    uint16_t* h = calloc(size, sizeof(uint16_t));
+    if (!h) return 0;
+    for (int c = 1; c <= d->count; c++) {
+        int i = hash_text(d->words[c - 1]) & (size - 1);
+        while (h[i]) i = (i + 1) & (size - 1);
+        h[i] = (uint16_t)c;
+    }
+    free(d->hash);
+    d->hash = h; d->hash_size = size;
+    return 1;
+}
+
+// "" 은 코드 0. 사전이 가득 찼거나 메모리가 없으면 -1
+static int dict_code(Dict* d, const char* s) {
+    if (!s[0]) return 0;
+    int slot;
+    uint16_t c = dict_find(d, s, &slot);
+    if (c) return c;
+    if (d->count >= META_DICT_MAX) return -1;
+    if (d->count == d->cap) {
+        int cap = d->cap ? d->cap * 2 : 16;
+        if (cap > META_DICT_MAX) cap = META_DICT_MAX;
+        void* w = realloc(d->words, (size_t)cap * META_TEXT_LEN);
+        if (!w) return -1;
+        d->words = w; d->cap = cap;
+    }
+    if ((d->count + 1) * 2 > d->hash_size) {
+        if (!dict_rehash(d, d->hash_size ? d->hash_size * 2 : 32)) return -1;
+        dict_find(d, s, &slot);
+    }
+    strcpy(d->words[d->count], s);
+    d->hash[slot] = (uint16_t)++d->count;
+    return d->count;
+}
+
+static const char* dict_word(const Dict* d, uint16_t c) {
+    return c ? d->words[c - 1] : "";
+}
+
+static void dict_free(Dict* d) {
+    free(d->words); free(d->hash);
+    memset(d, 0, sizeof(*d));
+}
+
+// ---------------------------------------------------------------------
+// 열 저장소
+// ---------------------------------------------------------------------
+static int grow_columns(MetaTable* t) {
+    uint32_t cap = t->cap ? t->cap * 2 : 256;
+    #define GROW(col) do { void* p = realloc(t->col, sizeof(*t->col) * cap); if (!p) return 0; t->col = p; } while (0)
+    GROW(price); GROW(lot); GROW(supplier); GROW(shelf); GROW(category); GROW(flags); GROW(owner);
+    #undef GROW
+    t->cap = cap;
+    return 1;
+}
+
+uint32_t meta_store(Store* st, const ItemMeta* m, int category, void* owner) {
+    if (meta_is_empty(m)) return 0;
+    MetaTable* t = st->meta;
+    if (!t && !(t = st->meta = calloc(1, sizeof(MetaTable)))) return 0;
+
+    int lot = dict_code(&t->lots, m->lot), sup = dict_code(&t->suppliers, m->supplier), shelf = dict_code(&t->shelves, m->shelf);
+    if (lot < 0 || sup < 0 || shelf < 0) return 0;
+
+    uint32_t slot;
+    if (t->n_free) slot = t->free_slots[--t->n_free];
+    else {
+        if (t->len == 0) t->len = 1;
+        if (t->len >= t->cap && !grow_columns(t)) return 0;
+        slot = t->len++;
+    }
+    t->price[slot] = m->price;
+    t->lot[slot] = (uint16_t)lot; t->supplier[slot] = (uint16_t)sup; t->shelf[slot] = (uint16_t)shelf;
+    t->category[slot] = (uint8_t)(category < 0 ? 0xff : category);
+    t->flags[slot] = SLOT_USED;
+    t->owner[slot] = owner;
+    return slot;
+}
+
+void meta_get(Store* st, uint32_t slot, ItemMeta* out) {
+    MetaTable* t = st->meta;
+    if (!t || !slot || slot >= t->len || !(t->flags[slot] & SLOT_USED)) {
+        out->price = META_NO_PRICE; out->lot[0] = out->supplier[0] = out->shelf[0] = '\0';
+        return;
+    }
+    out->price = t->price[slot];
+    strcpy(out->lot, dict_word(&t->lots, t->lot[slot]));
+    strcpy(out->supplier, dict_word(&t->suppliers, t->supplier[slot]));
+    strcpy(out->shelf, dict_word(&t->shelves, t->shelf[slot]));
+}
+
+void meta_drop(Store* st, uint32_t slot) {
+    MetaTable* t = st->meta;
+    if (!t || !slot || slot >= t->len || !(t->flags[slot] & SLOT_USED)) return;
+    if (t->n_free % 256 == 0) {
+        uint32_t* f = realloc(t->free_slots, sizeof(uint32_t) * (t->n_free + 256));
+        if (!f) { t->flags[slot] = 0; return; }    // 재사용만 못 할 뿐 조회에서는 빠짐
+        t->free_slots = f;
+    }
+    t->flags[slot] = 0;
+    t->owner[slot] = NULL;
+    t->free_slots[t->n_free++] = slot;
+}
+
+void meta_mark_expired(Store* st, uint32_t slot) {
+    MetaTable* t = st->meta;
+    if (t && slot && slot < t->len) t->flags[slot] |= SLOT_EXPIRED;
+}
+
+void meta_set_owner(Store* st, uint32_t slot, void* owner) {
+    MetaTable* t = st->meta;
+    if (t && slot && slot < t->len && (t->flags[slot] & SLOT_USED)) t->owner[slot] = owner;
+}
+
+void meta_reset(Store* st) {
+    MetaTable* t = st->meta;
+    if (!t) return;
+    free(t->price); free(t->lot); free(t->supplier); free(t->shelf);
+    free(t->category); free(t->flags); free(t->owner); free(t->free_slots);
+    dict_free(&t->lots); dict_free(&t->suppliers); dict_free(&t->shelves);
+    free(t);
+    st->meta = NULL;
+}
+
+void meta_move(Store* dst, Store* src) {
+    meta_reset(dst);
+    dst->meta = src->meta;
+    src->meta = NULL;
+}
+
+size_t meta_bytes(Store* st) {
+    MetaTable* t = st->meta;
+    if (!t) return 0;
+    size_t per_slot = sizeof(int32_t) + 3 * sizeof(uint16_t) + 2 + sizeof(void*);
+    return sizeof(MetaTable) + t->cap * per_slot + (size_t)(t->lots.cap + t->suppliers.cap + t->shelves.cap) * META_TEXT_LEN;
+}
+
+void meta_stock_value(Store* st, int64_t* value, long* priced) {
+    memset(value, 0, sizeof(int64_t) * NUM_CATEGORIES);
+    memset(priced, 0, sizeof(long) * NUM_CATEGORIES);
+    MetaTable* t = st->meta;
+    if (!t) return;
+    for (uint32_t i = 1; i < t->len; i++) {
+        if (t->flags[i] != SLOT_USED || t->price[i] == META_NO_PRICE || t->category[i] >= NUM_CATEGORIES) continue;
+        value[t->category[i]] += t->price[i];
+        priced[t->category[i]]++;
+    }
+}
+
+long meta_find_lot(Store* st, const char* lot, long skip, void** owners, int* expired, long max) {
+    MetaTable* t = st->meta;
+    uint16_t code = (t && lot[0]) ? dict_find(&t->lots, lot, NULL) : 0;
+    if (!code) return 0;
+    long total = 0;
+    for (uint32_t i = 1; i < t->len; i++) {
+        if (t->lot[i] != code || !(t->flags[i] & SLOT_USED)) continue;
+        if (total >= skip && total - skip < max) {
+            owners[total - skip] = t->owner[i];
+            expired[total - skip] = (t->flags[i] & SLOT_EXPIRED) != 0;
+        }
+        total++;
+    }
+    return total;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "journal.h"
+#include "history.h"
+#include "push.h"
+#include "utils.h"
+
+// =====================================================================
+// [변경 저널]
+// 모든 재고 변경을 전역 단조 증가 LSN과 함께 메모리 링에 남깁니다.
+// 복제 송신기는 이 링을 따라가며 복제본에 레코드를 스트리밍합니다.
+// =====================================================================
+
+typedef struct {
+    uint64_t lsn;
+    char line[JOURNAL_LINE];
+} JournalEntry;
+
+static JournalEntry ring[JOURNAL_RING];
+static uint64_t current_lsn = 0;
+static pthread_mutex_t journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t journal_cond = PTHREAD_COND_INITIALIZER;
+
+const char* journal_store_token(const Store* st) {
+    return (st == NULL || st->id[0] == '\0') ? "-" : st->id;
+}
+
+// journal_mutex 보유 상태에서 호출
+static void put_entry(uint64_t lsn, const char* line) {
+    JournalEntry* e = &ring[lsn % JOURNAL_RING];
+    e->lsn = lsn;
+    strncpy(e->line, line, JOURNAL_LINE - 1);
+    e->line[JOURNAL_LINE - 1] = '\0';
+    current_lsn = lsn;
+    pthread_cond_broadcast(&journal_cond);
+}
+
+uint64_t journal_append(Store* st, char op, const char* args) {
+    time_t vt = get_virtual_time();
+    pthread_mutex_lock(&journal_mutex);
+    uint64_t lsn = current_lsn + 1;
+    char line[JOURNAL_LINE];
+    snprintf(line, sizeof(line), "%llu %ld %c %s%s%s", (unsigned long long)lsn, (long)vt, op,
+             journal_store_token(st), (args && args[0]) ? " " : "", args ? args : "");
+    put_entry(lsn, line);
+    pthread_mutex_unlock(&journal_mutex);
+
+    // 매장별 디스크 이력 (list_mutex 로 매장 내 순서가 보장됨)
+    history_append(st, lsn, vt, op, args ? args : "");
+    store_changed(st);
+    return lsn;
+}
+
+void journal_append_raw(uint64_t lsn, const char* line) {
+    pthread_mutex_lock(&journal_mutex);
+    if (lsn > current_lsn) put_entry(lsn, line);
+    pthread_mutex_unlock(&journal_mutex);
+}
+
+uint64_t journal_current_lsn(void) {
+    pthread_mutex_lock(&journal_mutex);
+    uint64_t lsn = current_lsn;
+    pthread_mutex_unlock(&journal_mutex);
+    return lsn;
+}
+
+int journal_read_next(uint64_t after_lsn, char* out, size_t size) {
+    int ret;
+    pthread_mutex_lock(&journal_mutex);
+    if (after_lsn >= current_lsn) {
+        ret = 0;
+    } else {
+        JournalEntry* e = &ring[(after_lsn + 1) % JOURNAL_RING];
+        if (e->lsn != after_lsn + 1) {
+            ret = -1;
+        } else {
+            strncpy(out, e->line, size - 1);
+            out[size - 1] = '\0';
+            ret = 1;
+        }
+    }
+    pthread_mutex_unlock(&journal_mutex);
+    return ret;
+}
+
+void journal_wait(uint64_t after_lsn, int timeout_ms) {
+    struct timeval now; gettimeofday(&now, NULL);
+    struct timespec ts;
+    long usec = now.tv_usec + (long)timeout_ms * 1000;
+    ts.tv_sec = now.tv_sec + usec / 1000000;
+    ts.tv_nsec = (usec % 1000000) * 1000;
+
+    pthread_mutex_lock(&journal_mutex);
+    while (current_lsn <= after_lsn) {
+        if (pthread_cond_timedwait(&journal_cond, &journal_mutex, &ts) == ETIMEDOUT) break;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <string.h>
+#include "logevent.h"
+#include "inventory.h"
+#include "utils.h"
+
+size_t logevent_encode(char* buf, int type, time_t vt, uint32_t pos, int category, int qty, int aux, const char* text) {
+    size_t tlen = text ? strlen(text) : 0;
+    if (tlen > LOG_TEXT_MAX) tlen = LOG_TEXT_MAX;
+    LogEvent ev = { .vt = vt, .pos = pos, .qty = qty, .aux = aux, .text_len = (uint16_t)tlen,
+                    .type = (uint8_t)type,
+                    .category = (category >= 0 && category < NUM_CATEGORIES) ? (uint8_t)category : EV_NO_CATEGORY };
+    memcpy(buf, &ev, sizeof(ev));
+    if (tlen) memcpy(buf + sizeof(ev), text, tlen);
+    return sizeof(ev) + tlen;
+}
+
+int logevent_render(const char* rec, size_t len, const char* tag, char* out, size_t size) {
+    LogEvent ev;
+    if (len < sizeof(ev)) return snprintf(out, size, "(손상된 로그)");
+    memcpy(&ev, rec, sizeof(ev));
+    if (ev.text_len > len - sizeof(ev)) ev.text_len = len - sizeof(ev);
+    if (ev.text_len > LOG_TEXT_MAX) ev.text_len = LOG_TEXT_MAX;
+
+    char text[LOG_TEXT_MAX + 1];
+    memcpy(text, rec + sizeof(ev), ev.text_len);
+    text[ev.text_len] = '\0';
+    // 분류표에 없는 상품은 text 에 상품명이 들어 있음
+    const char* name = ev.category < NUM_CATEGORIES ? category_name(ev.category) : text;
+
+    time_t vt = (time_t)ev.vt;
+    struct tm tm_info; localtime_r(&vt, &tm_info);
+    char t_str[32]; strftime(t_str, sizeof(t_str), "%Y-%m-%d %H:%M:%S", &tm_info);
+
+    int n = tag ? snprintf(out, size, "[%s] <%s> ", t_str, tag) : snprintf(out, size, "[%s] ", t_str);
+    if (n < 0 || (size_t)n >= size) return n;
+    char* p = out + n; size_t rest = size - n;
+
+    switch (ev.type) {
+        case EV_IMPORT:        n += snprintf(p, rest, "[POS-%04u] 단일입고: %s (%s)", ev.pos, text, name); break;
+        case EV_RANDOM_IMPORT: n += snprintf(p, rest, "[POS-%04u] 랜덤입고 %d개", ev.pos, ev.qty); break;
+        case EV_SELL:
+            if (ev.qty < ev.aux) n += snprintf(p, rest, "[POS-%04u] 부분판매: %s %d개 (요청:%d)", ev.pos, name, ev.qty, ev.aux);
+            else n += snprintf(p, rest, "[POS-%04u] 판매완료: %s %d개", ev.pos, name, ev.qty);
+            break;
+        case EV_DELETE_EXPIRED: n += snprintf(p, rest, "[POS-%04u] 삭제: 만료 일괄 폐기 %d개", ev.pos, ev.qty); break;
+        case EV_DELETE_ONE:     n += snprintf(p, rest, "[POS-%04u] 단일삭제: %s [%s] 삭제", ev.pos, category_name(ev.category), text); break;
+        case EV_DELETE_KIND:    n += snprintf(p, rest, "[POS-%04u] 종류삭제: %s %d개 삭제", ev.pos, name, ev.qty); break;
+        case EV_DELETE_KIND_EXPIRED: n += snprintf(p, rest, "[POS-%04u] 만료삭제: %s %d개 삭제", ev.pos, name, ev.qty); break;
+        case EV_EXPIRE:         n += snprintf(p, rest, "[만료 발생] %s", name); break;
+        case EV_EXPIRE_RECOVERED: {
+            char ts[26]; print_time_str(vt - ev.aux, ts);
+            n += snprintf(p, rest, "[재시작 복구] 중단 중 만료 발생: %s (원래 만료: %s)", name, ts);
+            break;
+        }
+        case EV_CLEAR:      n += snprintf(p, rest, "[POS-%04u] 창고 비움", ev.pos); break;
+        case EV_CONNECT:    n += snprintf(p, rest, "[접속] 단말기 [POS-%04u] 실행됨 (IP: %s)", ev.pos, text); break;
+        case EV_DISCONNECT: n += snprintf(p, rest, "[종료] 단말기 [POS-%04u] 종료됨", ev.pos); break;
+        case EV_DROPPED:    n += snprintf(p, rest, "[단절] 단말기 [POS-%04u] %s (재접속 대기)", ev.pos, ev.aux ? "응답 없음으로 연결 정리" : "연결 끊김"); break;
+        case EV_RESUME:     n += snprintf(p, rest, "[재접속] 단말기 [POS-%04u] 세션 이어받음 (예약 품목 %d개)", ev.pos, ev.qty); break;
+        case EV_OFFLINE_SYNC: n += snprintf(p, rest, "[오프라인] 단말기 [POS-%04u] 판매 %d건 반영 (태그 %s, 충돌 %d줄)", ev.pos, ev.qty, text, ev.aux); break;
+        default:            n += snprintf(p, rest, "%s", text); break;
+    }
+    return (size_t)n < size ? n : (int)size - 1;
+}
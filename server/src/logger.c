@@ -3,83 +3,199 @@
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include "logger.h"
 #include "utils.h"
 #include "inventory.h"
+#include "replication.h"
+#include "history.h"
+#include "logstore.h"
+#include "logevent.h"
+#include "push.h"
+#include "admission.h"
+#include "dedup.h"
+#include "trace.h"
 
 #define MAX_HISTORY 1000      
 #define DASHBOARD_LOGS 15     
+#define LOG_ARENA_SIZE (256 * 1024)
+#define LOG_LINE_MAX 1024
 
 // utils.c에 선언된 전역 파일명 가져오기
 extern char log_filename[50];
 extern char db_filename[50];
 
-// [내부 상태 캡슐화]
-static char log_history[MAX_HISTORY][1024]; 
-static int log_head = 0; 
-static int total_logs = 0;
-static char last_log[1024] = "서버 대기 중...";
+// =====================================================================
+// [무잠금 로그 이력 링]
+// 링 항목은 [매장 태그 길이 1바이트][매장 태그][이진 이벤트 레코드] 이며 문장은 읽을 때 렌더링합니다.
+// 항목은 가변 길이로 바이트 아레나(log_arena)에 이어 붙이고, 최근 MAX_HISTORY 건의
+// 위치만 슬롯 배열에 둡니다. 작성자는 원자적 fetch_add 로 순번과 아레나 구간을 확보한 뒤
+// 슬롯 seq 를 홀수(작성 중) -> 짝수(완료)로 바꾸는 seqlock 방식으로 게시합니다.
+// 읽는 쪽(대시보드, 로그 브라우저)은 락 없이 복사한 다음 seq 와 아레나 위치를 다시 확인해
+// 그 사이 덮어써졌으면 버리므로, 작성자를 절대 막지 않습니다.
+// =====================================================================
+typedef struct {
+    _Atomic uint64_t seq;      // 2*idx+1: 작성 중, 2*idx+2: idx 번 로그 게시 완료
+    _Atomic uint64_t pos;      // 아레나 내 시작 위치 (단조 증가 바이트 오프셋)
+    _Atomic uint32_t len;
+} LogSlot;
+
+static char log_arena[LOG_ARENA_SIZE];
+static _Atomic uint64_t arena_tail = 0;   // 지금까지 확보된 바이트 수
+static _Atomic uint64_t log_count = 0;    // 지금까지 확보된 로그 순번
+static _Atomic uint64_t log_base = 0;     // clearlog 이후 보여줄 첫 순번
+static LogSlot log_slots[MAX_HISTORY];
+
+static LogFile* default_log = NULL;       // 기본 매장 로그 파일 (세그먼트 + 희소 인덱스)
 static int is_browsing_log = 0; 
 
-static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER; 
 static pthread_mutex_t screen_mutex = PTHREAD_MUTEX_INITIALIZER; 
 
 extern void handle_sigint(int sig); // main.c의 종료 함수 호출용
 
-void update_log(const char* msg) {
-    time_t vt = get_virtual_time(); 
-    struct tm tm_info; 
-    localtime_r(&vt, &tm_info);
-    
-    char t_str[32]; 
-    strftime(t_str, sizeof(t_str), "%Y-%m-%d %H:%M:%S", &tm_info);
-    
-    char formatted_msg[1024];
-    snprintf(formatted_msg, sizeof(formatted_msg), "[%s] %.800s", t_str, msg); 
+static void push_history(const char* entry, size_t len) {
+    if (len > LOG_LINE_MAX - 1) len = LOG_LINE_MAX - 1;
+    uint64_t idx = atomic_fetch_add(&log_count, 1);
+    uint64_t pos = atomic_fetch_add(&arena_tail, len);
+    LogSlot* slot = &log_slots[idx % MAX_HISTORY];
 
-    pthread_mutex_lock(&log_mutex);
-    
-    FILE *fp = fopen(log_filename, "a");
-    if (fp) { 
-        fprintf(fp, "%s\n", formatted_msg); 
-        fclose(fp); 
+    // 같은 슬롯을 이전 바퀴의 느린 작성자가 쓰는 중이면 끝날 때까지 양보, 더 새 로그가 이미 있으면 포기
+    uint64_t cur = atomic_load(&slot->seq);
+    do {
+        if (cur > 2 * idx) return;
+        if (cur & 1) { sched_yield(); cur = atomic_load(&slot->seq); continue; }
+    } while (!atomic_compare_exchange_weak(&slot->seq, &cur, 2 * idx + 1));
+
+    size_t off = pos % LOG_ARENA_SIZE, first = LOG_ARENA_SIZE - off;
+    if (first >= len) memcpy(log_arena + off, entry, len);
+    else { memcpy(log_arena + off, entry, first); memcpy(log_arena, entry + first, len - first); }
+
+    atomic_store_explicit(&slot->pos, pos, memory_order_relaxed);
+    atomic_store_explicit(&slot->len, (uint32_t)len, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, 2 * idx + 2, memory_order_release);
+}
+
+// idx 번 항목의 원본 바이트를 out 에 복사 (성공 시 길이, 작성 중이거나 이미 덮어써졌으면 -1)
+static int read_history_raw(uint64_t idx, char* out, size_t size) {
+    LogSlot* slot = &log_slots[idx % MAX_HISTORY];
+    uint64_t s1 = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (s1 != 2 * idx + 2) return -1;
+
+    uint64_t pos = atomic_load_explicit(&slot->pos, memory_order_relaxed);
+    size_t len = atomic_load_explicit(&slot->len, memory_order_relaxed);
+    if (len > size) len = size;
+    size_t off = pos % LOG_ARENA_SIZE, first = LOG_ARENA_SIZE - off;
+    if (first >= len) memcpy(out, log_arena + off, len);
+    else { memcpy(out, log_arena + off, first); memcpy(out + first, log_arena, len - first); }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != s1) return -1;
+    if (atomic_load_explicit(&arena_tail, memory_order_relaxed) - pos > LOG_ARENA_SIZE) return -1;
+    return (int)len;
+}
+
+// idx 번 로그를 한 줄로 렌더링해 out 에 복사 (성공 시 길이, 실패 시 -1)
+static int read_history(uint64_t idx, char* out, size_t size) {
+    char raw[LOG_LINE_MAX];
+    int len = read_history_raw(idx, raw, sizeof(raw));
+    int tlen = (unsigned char)raw[0];
+    if (len < 1 || tlen >= len || tlen >= STORE_ID_LEN) return -1;
+    char tag[STORE_ID_LEN];
+    memcpy(tag, raw + 1, tlen); tag[tlen] = '\0';
+    return logevent_render(raw + 1 + tlen, len - 1 - tlen, tlen ? tag : NULL, out, size);
+}
+
+int read_recent_logs(char* out, size_t size, int n) {
+    uint64_t end = atomic_load(&log_count), base = atomic_load(&log_base);
+    uint64_t count = (end - base < (uint64_t)n) ? end - base : (uint64_t)n;
+    size_t len = 0; int copied = 0;
+    out[0] = '\0';
+    for (uint64_t i = end - count; i < end && len + 1 < size; i++) {
+        int l = read_history(i, out + len, size - len - 1);
+        if (l < 0) continue;
+        len += l; out[len++] = '\n'; out[len] = '\0'; copied++;
     }
+    return copied;
+}
 
-    strncpy(last_log, formatted_msg, sizeof(last_log) - 1);
-    strncpy(log_history[log_head], formatted_msg, sizeof(log_history[0]) - 1);
-    log_head = (log_head + 1) % MAX_HISTORY;
-    total_logs++;
-    
-    pthread_mutex_unlock(&log_mutex);
+// 로그 파일을 처음 쓸 때 한 번만 연다 (동시에 열었으면 진 쪽이 버림)
+static LogFile* get_log_file(LogFile** slot, const char* filename) {
+    LogFile* lf = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (lf) return lf;
+    LogFile* nlf = logstore_open(filename);
+    if (!nlf) return NULL;
+    LogFile* expected = NULL;
+    if (__atomic_compare_exchange_n(slot, &expected, nlf, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return nlf;
+    logstore_close(nlf);
+    return expected;
 }
 
-void load_persistent_logs(void) {
-    FILE *fp = fopen(log_filename, "r");
-    if (!fp) return;
-
-    char line[1024];
-    pthread_mutex_lock(&log_mutex);
-    while (fgets(line, sizeof(line), fp)) {
-        line[strcspn(line, "\n")] = 0;
-        strncpy(log_history[log_head], line, sizeof(log_history[0]) - 1);
-        log_head = (log_head + 1) % MAX_HISTORY;
-        total_logs++;
-        strncpy(last_log, line, sizeof(last_log) - 1); 
+// 이벤트 한 건을 지정한 파일과 대시보드 이력에 기록 (tag: 매장 ID, 기본 매장은 NULL)
+static void append_event(LogFile** slot, const char* filename, const char* tag, const char* rec, size_t len) {
+    LogFile* lf = get_log_file(slot, filename);
+    LogEvent ev; memcpy(&ev, rec, sizeof(ev));
+    if (lf) logstore_append(lf, (time_t)ev.vt, rec, len);
+
+    // 대시보드는 모든 매장의 로그를 함께 보여주므로 매장 ID를 앞에 붙여 둠
+    char entry[1 + STORE_ID_LEN + LOG_EVENT_MAX];
+    size_t tlen = tag ? strlen(tag) : 0;
+    entry[0] = (char)tlen;
+    memcpy(entry + 1, tag, tlen);
+    memcpy(entry + 1 + tlen, rec, len);
+    push_history(entry, 1 + tlen + len);
+}
+
+void log_event(Store* st, int type, uint32_t pos, int category, int qty, int aux, const char* text) {
+    char rec[LOG_EVENT_MAX];
+    size_t len = logevent_encode(rec, type, get_virtual_time(), pos, category, qty, aux, text);
+    if (st == NULL || st->id[0] == '\0') append_event(&default_log, log_filename, NULL, rec, len);
+    else append_event(&st->log_file, st->log_filename, st->id, rec, len);
+}
+
+static void each_log_file(void (*fn)(LogFile* lf)) {
+    LogFile* lf = __atomic_load_n(&default_log, __ATOMIC_ACQUIRE);
+    if (lf) fn(lf);
+    for (int i = 0; i < get_store_count(); i++) {
+        lf = __atomic_load_n(&get_store_at(i)->log_file, __ATOMIC_ACQUIRE);
+        if (lf) fn(lf);
     }
-    pthread_mutex_unlock(&log_mutex);
-    fclose(fp);
+}
+
+void flush_logs(void) {
+    each_log_file(logstore_flush);
+}
+
+// 파일을 읽기 전: 아직 I/O 스레드에 있는 레코드까지 파일에 쓰일 때까지 대기
+static void sync_logs(void) {
+    each_log_file(logstore_sync);
+}
+
+void update_log(const char* msg) {
+    log_event(NULL, EV_TEXT, 0, -1, 0, 0, msg);
+}
+
+void update_store_log(Store* st, const char* msg) {
+    log_event(st, EV_TEXT, 0, -1, 0, 0, msg);
+}
+
+static void push_loaded_event(const char* rec, size_t len, void* ctx) {
+    (void)ctx;
+    char entry[1 + LOG_EVENT_MAX];
+    if (len > LOG_EVENT_MAX) return;
+    entry[0] = 0;
+    memcpy(entry + 1, rec, len);
+    push_history(entry, 1 + len);
+}
+
+void load_persistent_logs(void) {
+    logstore_load_tail(log_filename, MAX_HISTORY, push_loaded_event, NULL);
 }
 
 void clear_persistent_logs(void) {
-    pthread_mutex_lock(&log_mutex);
-    FILE *fp = fopen(log_filename, "w"); 
-    if (fp) fclose(fp);
-    
-    for(int i = 0; i < MAX_HISTORY; i++) strcpy(log_history[i], "");
-    log_head = 0;
-    total_logs = 0;
-    strcpy(last_log, "로그 초기화됨.");
-    pthread_mutex_unlock(&log_mutex);
+    LogFile* lf = get_log_file(&default_log, log_filename);
+    if (lf) logstore_clear(lf);
+    atomic_store(&log_base, atomic_load(&log_count));
     
     update_log("[Clear] 로그 파일 및 내역이 초기화되었습니다.");
 }
@@ -87,7 +203,7 @@ void clear_persistent_logs(void) {
 void draw_dashboard(const char* time_str) {
     if (!is_clock_showing() || is_browsing_log) return; 
 
-    pthread_mutex_lock(&screen_mutex); 
+    trace_mutex_lock(&screen_mutex, "screen_mutex"); 
     printf("\033[s"); 
 
     printf("\033[1;1H\033[2K========================================================================");
@@ -95,34 +211,51 @@ void draw_dashboard(const char* time_str) {
         printf("\033[2;1H\033[2K [SIMULATION] 배속: x%-5d | DB: %-20s", get_speed_factor(), db_filename);
     else
         printf("\033[2;1H\033[2K [OPERATION] 실시간 동작 (1배속) | DB: %-20s", db_filename);
+    if (is_replica()) printf(" [복제본]");
     
     printf("\033[3;1H\033[2K========================================================================");
     printf("\033[4;1H\033[2K [Time] %s", time_str);
     printf("\033[5;1H\033[2K------------------------------------------------------------------------");
 
-    pthread_mutex_lock(&log_mutex);
-    int count = (total_logs < DASHBOARD_LOGS) ? total_logs : DASHBOARD_LOGS;
+    uint64_t end = atomic_load(&log_count), base = atomic_load(&log_base);
+    uint64_t count = (end - base < DASHBOARD_LOGS) ? end - base : DASHBOARD_LOGS;
 
+    char line[LOG_LINE_MAX];
     for (int i = 0; i < DASHBOARD_LOGS; i++) {
-        if (i < count) {
-            int idx = (log_head - count + i + MAX_HISTORY) % MAX_HISTORY;
-            printf("\033[%d;1H\033[2K %s", 6 + i, log_history[idx]); 
+        if ((uint64_t)i < count && read_history(end - count + i, line, sizeof(line)) >= 0) {
+            printf("\033[%d;1H\033[2K %s", 6 + i, line); 
         } else {
             printf("\033[%d;1H\033[2K", 6 + i); 
         }
     }
-    pthread_mutex_unlock(&log_mutex);
 
     printf("\033[%d;1H\033[2K------------------------------------------------------------------------", 6 + DASHBOARD_LOGS);
 
     if (get_server_mode() == 2) 
-        printf("\033[%d;1H\033[2K 👉 명령: reset / clearlog / log / speed <N> / stop / start / exit", 7 + DASHBOARD_LOGS);
+        printf("\033[%d;1H\033[2K 👉 명령: reset / clearlog / log / stores / push / adm / repl / promote / asof / restore / find / export / trace / speed <N> / stop / start / exit", 7 + DASHBOARD_LOGS);
     else 
-        printf("\033[%d;1H\033[2K 👉 명령: log / exit", 7 + DASHBOARD_LOGS);
+        printf("\033[%d;1H\033[2K 👉 명령: log / stores / push / adm / repl / promote / asof / restore / find / export / trace / exit", 7 + DASHBOARD_LOGS);
     
     printf("\033[u"); 
     fflush(stdout); 
-    pthread_mutex_unlock(&screen_mutex); 
+    trace_mutex_unlock(&screen_mutex); 
+}
+
+// 전체 화면 보기(로그/리포트)를 닫고 대시보드와 프롬프트를 다시 그림
+static void return_to_dashboard(void) {
+    is_browsing_log = 0;
+    trace_mutex_lock(&screen_mutex, "screen_mutex");
+    printf("\033[2J\033[1;1H"); 
+    trace_mutex_unlock(&screen_mutex);
+    
+    time_t vt = get_virtual_time();
+    char time_str[26]; print_time_str(vt, time_str);
+    draw_dashboard(time_str);
+
+    trace_mutex_lock(&screen_mutex, "screen_mutex");
+    printf("\033[%d;1H\033[K >> ", 9 + DASHBOARD_LOGS);
+    fflush(stdout);
+    trace_mutex_unlock(&screen_mutex);
 }
 
 void browse_logs(int start_page) {
@@ -132,10 +265,12 @@ void browse_logs(int start_page) {
     int items_per_page = 15;
     
     while(1) {
-        pthread_mutex_lock(&screen_mutex);
+        trace_mutex_lock(&screen_mutex, "screen_mutex");
         printf("\033[2J\033[1;1H"); 
 
-        pthread_mutex_lock(&log_mutex);
+        // 링에 남아 있는 최근 MAX_HISTORY 건까지만 페이지로 제공
+        uint64_t end = atomic_load(&log_count), base = atomic_load(&log_base);
+        int total_logs = (int)((end - base < MAX_HISTORY) ? end - base : MAX_HISTORY);
         int total_pages = (total_logs + items_per_page - 1) / items_per_page;
         if (total_pages == 0) total_pages = 1;
         if (page < 1) page = 1;
@@ -149,21 +284,21 @@ void browse_logs(int start_page) {
             printf("  기록된 로그가 없습니다.\n");
         } else {
             int start = (page - 1) * items_per_page;
-            int end = start + items_per_page;
-            if (end > total_logs) end = total_logs;
+            int last = start + items_per_page;
+            if (last > total_logs) last = total_logs;
             
-            for (int i = start; i < end; i++) {
-                int idx = (log_head - 1 - i + MAX_HISTORY) % MAX_HISTORY;
-                if(idx < 0) idx += MAX_HISTORY;
-                printf("  %d. %s\n", total_logs - i, log_history[idx]);
+            char line[LOG_LINE_MAX];
+            for (int i = start; i < last; i++) {
+                uint64_t idx = end - 1 - i;
+                if (read_history(idx, line, sizeof(line)) < 0) strcpy(line, "(갱신 중)");
+                printf("  %llu. %s\n", (unsigned long long)(idx - base + 1), line);
             }
         }
-        pthread_mutex_unlock(&log_mutex);
 
         printf(" ------------------------------------------------------------------------\n");
         printf(" [0: 닫기 / 숫자: 해당 페이지 이동] >> ");
         fflush(stdout);
-        pthread_mutex_unlock(&screen_mutex);
+        trace_mutex_unlock(&screen_mutex);
         
         char log_cmd[20];
         if(fgets(log_cmd, sizeof(log_cmd), stdin)) {
@@ -174,41 +309,184 @@ void browse_logs(int start_page) {
         }
     }
     
-    is_browsing_log = 0;
-    pthread_mutex_lock(&screen_mutex);
-    printf("\033[2J\033[1;1H"); 
-    pthread_mutex_unlock(&screen_mutex);
-    
-    time_t vt = get_virtual_time();
-    char time_str[26]; print_time_str(vt, time_str);
-    draw_dashboard(time_str);
+    return_to_dashboard();
+}
 
-    pthread_mutex_lock(&screen_mutex);
-    printf("\033[%d;1H\033[K >> ", 9 + DASHBOARD_LOGS);
+// 여러 줄짜리 결과(시점 조회 등)를 전체 화면으로 보여주고 Enter 를 기다림
+static void show_report(const char* text) {
+    is_browsing_log = 1;
+    usleep(50000); 
+    trace_mutex_lock(&screen_mutex, "screen_mutex");
+    printf("\033[2J\033[1;1H%s\n", text); 
+    printf(" ------------------------------------------------------------------------\n");
+    printf(" [Enter: 닫기] >> ");
     fflush(stdout);
-    pthread_mutex_unlock(&screen_mutex);
+    trace_mutex_unlock(&screen_mutex);
+
+    char buf[20];
+    if (!fgets(buf, sizeof(buf), stdin)) { /* 입력 종료 시에도 화면 복귀 */ }
+    return_to_dashboard();
+}
+
+// [로그 검색/내보내기 콜백] 레코드를 렌더링한 뒤 키워드를 모두 포함하는 줄만 모음
+#define FIND_MAX_SHOWN 200
+typedef struct {
+    char* words[8];
+    int n_words;
+    char* out;
+    size_t len, size;
+    int hits;
+} FindCtx;
+
+static int find_match(const char* rec, size_t len, void* ctx) {
+    FindCtx* fc = ctx;
+    char line[LOG_LINE_MAX];
+    int l = logevent_render(rec, len, NULL, line, sizeof(line));
+    for (int k = 0; k < fc->n_words; k++) if (!strstr(line, fc->words[k])) return 1;
+    fc->hits++;
+    if (fc->hits <= FIND_MAX_SHOWN && fc->len + l + 2 < fc->size) {
+        memcpy(fc->out + fc->len, line, l);
+        fc->len += l;
+        fc->out[fc->len++] = '\n'; fc->out[fc->len] = '\0';
+    }
+    return 1;
+}
+
+static int export_line(const char* rec, size_t len, void* ctx) {
+    char line[LOG_LINE_MAX];
+    logevent_render(rec, len, NULL, line, sizeof(line));
+    fprintf((FILE*)ctx, "%s\n", line);
+    return 1;
 }
 
 void* admin_console_thread(void* arg) {
     (void)arg;
-    char cmd[100];
+    char cmd[256];
     
-    pthread_mutex_lock(&screen_mutex);
+    trace_mutex_lock(&screen_mutex, "screen_mutex");
     printf("\033[%d;1H\033[K >> ", 9 + DASHBOARD_LOGS); 
     fflush(stdout);
-    pthread_mutex_unlock(&screen_mutex);
+    trace_mutex_unlock(&screen_mutex);
 
     while(1) {
         if (fgets(cmd, sizeof(cmd), stdin)) {
             cmd[strcspn(cmd, "\n")] = 0; 
             
-            pthread_mutex_lock(&screen_mutex);
+            trace_mutex_lock(&screen_mutex, "screen_mutex");
             printf("\033[%d;1H\033[J >> ", 9 + DASHBOARD_LOGS);
             fflush(stdout);
-            pthread_mutex_unlock(&screen_mutex);
+            trace_mutex_unlock(&screen_mutex);
 
             if (strcmp(cmd, "exit") == 0) handle_sigint(0);
 
+            if (strcmp(cmd, "stores") == 0) { print_store_stats(); continue; }
+            if (strcmp(cmd, "push") == 0) { print_push_stats(); continue; }
+            if (strcmp(cmd, "adm") == 0) { print_admission_stats(); print_dedup_stats(); continue; }
+            if (strcmp(cmd, "repl") == 0) { print_replication_status(); continue; }
+            if (strcmp(cmd, "promote") == 0) { promote_replica(); continue; }
+
+            // 추적: trace on | trace off | trace dump 파일 [초] (최근 N초 구간을 Chrome trace JSON 으로)
+            if (strncmp(cmd, "trace", 5) == 0) {
+                char file[128]; int sec = TRACE_DUMP_SEC;
+                if (strcmp(cmd, "trace on") == 0)
+                    update_log(trace_start() ? "[추적] 켜짐 (요청/락/저장/만료 구간 기록)" : "[오류] 추적 버퍼를 만들 수 없습니다");
+                else if (strcmp(cmd, "trace off") == 0) { trace_stop(); update_log("[추적] 꺼짐 (기록한 구간은 dump 가능)"); }
+                else if (sscanf(cmd, "trace dump %127s %d", file, &sec) >= 1) {
+                    if (sec < 1) sec = TRACE_DUMP_SEC;
+                    int n = trace_dump(file, sec);
+                    char buf[200];
+                    if (n < 0) snprintf(buf, sizeof(buf), "[오류] 추적 파일을 쓸 수 없습니다: %.120s", file);
+                    else snprintf(buf, sizeof(buf), "[추적] 최근 %d초 이벤트 %d건 -> %.120s", sec, n, file);
+                    update_log(buf);
+                }
+                else update_log("[오류] 사용법: trace on | trace off | trace dump 파일.json [초]");
+                continue;
+            }
+
+            // 과거 시점 조회/복원: asof|restore YYYY-MM-DD HH:MM[:SS] [매장ID]
+            if (strncmp(cmd, "asof ", 5) == 0 || strncmp(cmd, "restore ", 8) == 0) {
+                int is_restore = (cmd[0] == 'r');
+                char date[16], clock[16], sid[STORE_ID_LEN] = "", ts[40];
+                time_t t;
+                int n = sscanf(cmd + (is_restore ? 8 : 5), "%15s %15s %31s", date, clock, sid);
+                snprintf(ts, sizeof(ts), "%s %s", date, clock);
+                Store* st = (n >= 2) ? find_store(sid) : NULL;
+                if (n < 2 || !parse_time_str(ts, &t)) {
+                    update_log("[오류] 사용법: asof|restore 2026-02-25 14:00 [매장ID]");
+                } else if (!st) {
+                    char buf[96]; snprintf(buf, sizeof(buf), "[오류] 없는 매장입니다: %s", sid);
+                    update_log(buf);
+                } else if (is_restore && is_replica()) {
+                    update_log("[오류] 복제본에서는 복원할 수 없습니다. (promote 후 사용)");
+                } else {
+                    char* out = malloc(MAX_PAYLOAD);
+                    if (out) {
+                        if (is_restore) restore_store_to(st, t, out);
+                        else { make_asof_summary(st, t, out, 0); show_report(out); }
+                        free(out);
+                    }
+                }
+                continue;
+            }
+
+            // 로그 검색: find 시작일 시각 종료일 시각 [@매장ID] [키워드...] (키워드는 모두 포함해야 일치)
+            if (strncmp(cmd, "find ", 5) == 0) {
+                char d1[16], c1[16], d2[16], c2[16], ts[40];
+                FindCtx fc = { .n_words = 0 };
+                time_t from, to;
+                int off = 0;
+                int ok = sscanf(cmd + 5, "%15s %15s %15s %15s %n", d1, c1, d2, c2, &off) >= 4 && off > 0;
+                if (ok) { snprintf(ts, sizeof(ts), "%s %s", d1, c1); ok = parse_time_str(ts, &from); }
+                if (ok) { snprintf(ts, sizeof(ts), "%s %s", d2, c2); ok = parse_time_str(ts, &to); }
+                if (!ok) { update_log("[오류] 사용법: find 2026-02-24 00:00 2026-02-24 23:59 [@매장ID] [키워드...]"); continue; }
+
+                const char* path = log_filename;
+                Store* st = NULL;
+                char* save = NULL;
+                const char* missing = NULL;
+                for (char* w = strtok_r(cmd + 5 + off, " ", &save); w; w = strtok_r(NULL, " ", &save)) {
+                    if (w[0] == '@' && !st && !missing) { st = find_store(w + 1); if (st) path = st->log_filename; else missing = w + 1; }
+                    else if (fc.n_words < 8) fc.words[fc.n_words++] = w;
+                }
+                if (missing) {
+                    char buf[96]; snprintf(buf, sizeof(buf), "[오류] 없는 매장입니다: %s", missing);
+                    update_log(buf);
+                    continue;
+                }
+
+                fc.out = malloc(MAX_PAYLOAD);
+                if (!fc.out) continue;
+                fc.len = snprintf(fc.out, MAX_PAYLOAD, " [로그 검색] %s %s ~ %s %s | %s\n\n", d1, c1, d2, c2, path);
+                fc.size = MAX_PAYLOAD - 64;
+                sync_logs();
+                logstore_scan(path, from, to, find_match, &fc);
+                if (fc.hits == 0) snprintf(fc.out + fc.len, MAX_PAYLOAD - fc.len, "  일치하는 로그가 없습니다.\n");
+                else snprintf(fc.out + fc.len, MAX_PAYLOAD - fc.len, "\n 총 %d건%s", fc.hits, fc.hits > FIND_MAX_SHOWN ? " (앞 200건만 표시)" : "");
+                show_report(fc.out);
+                free(fc.out);
+                continue;
+            }
+
+            // 로그 내보내기: export 파일명 [@매장ID] -> 전체 이진 로그를 텍스트로 렌더링해 저장
+            if (strncmp(cmd, "export ", 7) == 0) {
+                char file[128], sid[STORE_ID_LEN + 1] = "";
+                if (sscanf(cmd + 7, "%127s %32s", file, sid) < 1) continue;
+                Store* st = (sid[0] == '@') ? find_store(sid + 1) : NULL;
+                if (sid[0] == '@' && !st) {
+                    char buf[96]; snprintf(buf, sizeof(buf), "[오류] 없는 매장입니다: %s", sid + 1);
+                    update_log(buf);
+                    continue;
+                }
+                FILE* fp = fopen(file, "w");
+                if (!fp) { update_log("[오류] 내보내기 파일을 열 수 없습니다."); continue; }
+                sync_logs();
+                int n = logstore_scan(st ? st->log_filename : log_filename, 0, (time_t)INT64_MAX, export_line, fp);
+                fclose(fp);
+                char buf[200]; snprintf(buf, sizeof(buf), "[내보내기] 로그 %d건 -> %.120s", n, file);
+                update_log(buf);
+                continue;
+            }
+
             if (strncmp(cmd, "log", 3) == 0) {
                 int page = 1;
                 sscanf(cmd, "log %d", &page);
@@ -216,9 +494,13 @@ void* admin_console_thread(void* arg) {
                 continue; 
             }
 
-            if (get_server_mode() == 2) { 
+            if (get_server_mode() == 2 && is_replica()) {
+                update_log("[오류] 복제본에서는 시뮬레이션 제어 명령을 사용할 수 없습니다.");
+            }
+            else if (get_server_mode() == 2) { 
                 if (strcmp(cmd, "reset") == 0) {
-                    clear_inventory_db();     // 1. 창고(DB) 비우기
+                    for (int i = 0; i < get_store_count(); i++)
+                        clear_inventory_db(get_store_at(i)); // 1. 모든 매장 창고(DB) 비우기
                     reset_virtual_time();     // 2. 가상 시간 초기화
                     set_speed_factor(1);      // 3. 배속 1배로 초기화
                     clear_persistent_logs();  // 4. [추가됨] 전체 로그 기록 삭제
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "logstore.h"
+#include "logevent.h"
+#include "iobackend.h"
+#include "trace.h"
+
+// =====================================================================
+// [세그먼트 + 희소 인덱스 로그 저장소]
+// 로그 파일이 수백 MB 가 되어도 시작 시에는 마지막 세그먼트 꼬리만 읽고,
+// 기간 검색은 인덱스로 시작 위치를 찾아 그 구간만 읽습니다.
+// 세그먼트는 LOG_MAGIC 으로 시작하고 그 뒤에 이진 이벤트 레코드(logevent.h)가 이어집니다.
+// 세그먼트와 인덱스 쓰기는 저장 I/O 백엔드(iobackend.c)에 넘기므로 기록하는 스레드는 버퍼 복사만 합니다.
+// =====================================================================
+
+#define LOG_MAGIC "EVLOG01\n"
+#define LOG_MAGIC_LEN 8
+
+struct LogFile {
+    char path[128];
+    IoFile* io;             // 활성 세그먼트 (NULL = 열지 못함)
+    IoFile* idx;            // 인덱스 "<path>.idx"
+    int seg_no;             // 활성 세그먼트 번호 (교체되면 "<path>.<seg_no>" 가 됨)
+    off_t seg_bytes;
+    int lines_since_index;
+    int regular;            // 일반 파일일 때만 세그먼트 교체/인덱스 (/dev/null 등은 그냥 기록)
+    pthread_mutex_t mutex;  // 세그먼트 교체와 인덱스 오프셋 계산을 위한 파일 단위 락
+};
+
+static void segment_path(const char* path, int seg_no, int active_no, char* out, size_t size) {
+    if (seg_no == active_no) snprintf(out, size, "%s", path);
+    else snprintf(out, size, "%s.%d", path, seg_no);
+}
+
+// 교체된 세그먼트 중 가장 큰 번호 + 1 = 활성 세그먼트 번호
+static int find_active_segment(const char* path) {
+    char p[160];
+    int n = 1;
+    for (;;) {
+        snprintf(p, sizeof(p), "%s.%d", path, n);
+        if (access(p, F_OK) != 0) return n;
+        n++;
+    }
+}
+
+static void open_index(LogFile* lf) {
+    char idx_path[160];
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", lf->path);
+    lf->idx = io_open(idx_path, IO_APPEND);
+}
+
+static void append_index(LogFile* lf, time_t vt) {
+    char rec[64];
+    int len = snprintf(rec, sizeof(rec), "%ld %d %ld\n", (long)vt, lf->seg_no, (long)lf->seg_bytes);
+    if (lf->idx) io_append(lf->idx, rec, len);     // 인덱스가 빠지면 검색이 조금 더 읽을 뿐
+    lf->lines_since_index = 0;
+}
+
+static int has_magic(const char* seg) {
+    char buf[LOG_MAGIC_LEN];
+    FILE* fp = fopen(seg, "r");
+    if (!fp) return 0;
+    int ok = fread(buf, 1, LOG_MAGIC_LEN, fp) == LOG_MAGIC_LEN && memcmp(buf, LOG_MAGIC, LOG_MAGIC_LEN) == 0;
+    fclose(fp);
+    return ok;
+}
+
+// 활성 세그먼트를 열고, 비어 있으면 머리표부터 기록
+static void open_segment(LogFile* lf) {
+    struct stat sb;
+    lf->regular = stat(lf->path, &sb) != 0 || S_ISREG(sb.st_mode);
+    lf->io = io_open(lf->path, IO_APPEND);
+    lf->seg_bytes = lf->regular && lf->io ? io_size(lf->io) : 0;
+    if (lf->regular && lf->io && lf->seg_bytes == 0) {
+        io_append(lf->io, LOG_MAGIC, LOG_MAGIC_LEN);
+        lf->seg_bytes = LOG_MAGIC_LEN;
+    }
+}
+
+LogFile* logstore_open(const char* path) {
+    LogFile* lf = calloc(1, sizeof(LogFile));
+    if (!lf) return NULL;
+    strncpy(lf->path, path, sizeof(lf->path) - 1);
+    pthread_mutex_init(&lf->mutex, NULL);
+    lf->seg_no = find_active_segment(path);
+    if (!has_magic(path)) {
+        // 이전 텍스트 형식 로그는 그대로 보관하고 새 세그먼트로 시작
+        char old[160]; snprintf(old, sizeof(old), "%s.old", path);
+        struct stat sb;
+        if (stat(path, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) rename(path, old);
+    }
+    open_segment(lf);
+    open_index(lf);
+    lf->lines_since_index = LOG_INDEX_EVERY;   // 다음 줄을 인덱스 기준점으로
+    return lf;
+}
+
+void logstore_append(LogFile* lf, time_t vt, const char* rec, size_t len) {
+    trace_mutex_lock(&lf->mutex, "logfile_mutex");
+    if (lf->regular && lf->seg_bytes + (off_t)len > LOG_SEGMENT_SIZE) {
+        // 활성 세그먼트를 번호 붙은 파일로 넘기고 새 세그먼트 시작
+        char rotated[160];
+        snprintf(rotated, sizeof(rotated), "%s.%d", lf->path, lf->seg_no);
+        io_close(lf->io);               // 남은 레코드는 I/O 스레드가 옮겨진 파일에 마저 씀
+        rename(lf->path, rotated);
+        lf->seg_no++;
+        open_segment(lf);
+        lf->lines_since_index = LOG_INDEX_EVERY;
+    }
+    if (lf->regular && lf->lines_since_index >= LOG_INDEX_EVERY) append_index(lf, vt);
+    if (lf->io) io_append(lf->io, rec, len);       // 로그 기록 실패는 서비스에 영향 주지 않음
+    lf->seg_bytes += len;
+    lf->lines_since_index++;
+    trace_mutex_unlock(&lf->mutex);
+}
+
+void logstore_clear(LogFile* lf) {
+    pthread_mutex_lock(&lf->mutex);
+    if (!lf->regular) { pthread_mutex_unlock(&lf->mutex); return; }
+    char p[160];
+    for (int n = 1; n < lf->seg_no; n++) { snprintf(p, sizeof(p), "%s.%d", lf->path, n); remove(p); }
+    io_close(lf->idx);
+    snprintf(p, sizeof(p), "%s.idx", lf->path);
+    remove(p);
+    open_index(lf);
+    if (lf->io) {
+        io_truncate(lf->io);
+        io_append(lf->io, LOG_MAGIC, LOG_MAGIC_LEN);
+        lf->seg_bytes = LOG_MAGIC_LEN;
+    }
+    lf->seg_no = 1;
+    lf->lines_since_index = LOG_INDEX_EVERY;
+    pthread_mutex_unlock(&lf->mutex);
+}
+
+void logstore_flush(LogFile* lf) {
+    pthread_mutex_lock(&lf->mutex);
+    if (lf->io) io_submit(lf->io);
+    if (lf->idx) io_submit(lf->idx);
+    pthread_mutex_unlock(&lf->mutex);
+}
+
+void logstore_sync(LogFile* lf) {
+    pthread_mutex_lock(&lf->mutex);
+    if (lf->io) io_drain(lf->io);
+    if (lf->idx) io_drain(lf->idx);
+    pthread_mutex_unlock(&lf->mutex);
+}
+
+void logstore_close(LogFile* lf) {
+    if (!lf) return;
+    io_close(lf->io);
+    io_close(lf->idx);
+    pthread_mutex_destroy(&lf->mutex);
+    free(lf);
+}
+
+// 세그먼트 하나를 통째로 읽음 (머리표가 없으면 NULL) -> 호출자가 free
+static char* read_segment(const char* seg, size_t* out_len) {
+    FILE* fp = fopen(seg, "r");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    char* buf = (size >= LOG_MAGIC_LEN) ? malloc(size) : NULL;
+    if (buf) {
+        fseek(fp, 0, SEEK_SET);
+        *out_len = fread(buf, 1, size, fp);
+        if (*out_len < LOG_MAGIC_LEN || memcmp(buf, LOG_MAGIC, LOG_MAGIC_LEN) != 0) { free(buf); buf = NULL; }
+    }
+    fclose(fp);
+    return buf;
+}
+
+// buf[off] 에서 시작하는 레코드 길이 (기록 중이라 잘린 마지막 레코드면 0)
+static size_t record_len(const char* buf, size_t size, size_t off) {
+    LogEvent ev;
+    if (off + sizeof(ev) > size) return 0;
+    memcpy(&ev, buf + off, sizeof(ev));
+    size_t len = sizeof(ev) + ev.text_len;
+    return (ev.text_len <= LOG_TEXT_MAX && off + len <= size) ? len : 0;
+}
+
+int logstore_load_tail(const char* path, int max_lines, void (*cb)(const char* rec, size_t len, void* ctx), void* ctx) {
+    char** recs = calloc(max_lines, sizeof(char*));
+    size_t* lens = calloc(max_lines, sizeof(size_t));
+    if (!recs || !lens) { free(recs); free(lens); return 0; }
+
+    // 활성 세그먼트부터 거꾸로, 필요한 건수가 찰 때까지만 이전 세그먼트를 읽어 배열 뒤쪽부터 채움
+    int active = find_active_segment(path), total = 0;
+    for (int seg = active; seg >= 1 && total < max_lines; seg--) {
+        char sp[160]; segment_path(path, seg, active, sp, sizeof(sp));
+        size_t size = 0;
+        char* buf = read_segment(sp, &size);
+        if (!buf) continue;
+
+        int count = 0;
+        for (size_t off = LOG_MAGIC_LEN, l; (l = record_len(buf, size, off)) > 0; off += l) count++;
+        int want = max_lines - total, skip = count > want ? count - want : 0, slot = max_lines - total - (count - skip), i = 0;
+        for (size_t off = LOG_MAGIC_LEN, l; (l = record_len(buf, size, off)) > 0; off += l, i++) {
+            if (i < skip) continue;
+            recs[slot] = malloc(l);
+            if (recs[slot]) memcpy(recs[slot], buf + off, l);
+            lens[slot++] = l;
+        }
+        total += count - skip;
+        free(buf);
+    }
+    for (int i = max_lines - total; i < max_lines; i++) {
+        if (recs[i]) cb(recs[i], lens[i], ctx);
+        free(recs[i]);
+    }
+    free(recs); free(lens);
+    return total;
+}
+
+int logstore_scan(const char* path, time_t from, time_t to, int (*cb)(const char* rec, size_t len, void* ctx), void* ctx) {
+    // 1. 인덱스에서 from 이전 마지막 기준점 찾기
+    int active = find_active_segment(path);
+    int start_seg = 1; long start_off = 0;
+    char idx_path[160];
+    snprintf(idx_path, sizeof(idx_path), "%s.idx", path);
+    FILE* idx = fopen(idx_path, "r");
+    if (idx) {
+        long vt, off; int seg;
+        while (fscanf(idx, "%ld %d %ld", &vt, &seg, &off) == 3) {
+            if ((time_t)vt >= from) break;     // 같은 초의 앞선 레코드를 놓치지 않도록 엄격히 이전 기준점
+            start_seg = seg; start_off = off;
+        }
+        fclose(idx);
+    }
+
+    // 2. 기준점부터 세그먼트를 순서대로 읽다가 to 를 넘으면 중단
+    int visited = 0, done = 0;
+    char rec[LOG_EVENT_MAX];
+    for (int seg = start_seg; seg <= active && !done; seg++) {
+        char sp[160]; segment_path(path, seg, active, sp, sizeof(sp));
+        if (!has_magic(sp)) continue;
+        FILE* fp = fopen(sp, "r");
+        if (!fp) continue;
+        fseek(fp, (seg == start_seg && start_off > LOG_MAGIC_LEN) ? start_off : LOG_MAGIC_LEN, SEEK_SET);
+
+        LogEvent ev;
+        while (fread(&ev, sizeof(ev), 1, fp) == 1) {
+            if (ev.text_len > LOG_TEXT_MAX) break;
+            memcpy(rec, &ev, sizeof(ev));
+            if (ev.text_len && fread(rec + sizeof(ev), 1, ev.text_len, fp) != ev.text_len) break;
+            if ((time_t)ev.vt < from) continue;
+            if ((time_t)ev.vt > to) { done = 1; break; }
+            visited++;
+            if (!cb(rec, sizeof(ev) + ev.text_len, ctx)) { done = 1; break; }
+        }
+        fclose(fp);
+    }
+    return visited;
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <signal.h>
 #include <pthread.h>
@@ -9,13 +10,26 @@
 #include "inventory.h"
 #include "logger.h"
 #include "network.h"
+#include "store.h"
+#include "scheduler.h"
+#include "replication.h"
+#include "push.h"
+#include "compact.h"
+#include "bulkjob.h"
+#include "iobackend.h"
 
 void handle_sigint(int sig) {
     (void)sig;
     printf("\033[?25h"); 
     printf("\n\n[System] 데이터 저장 및 서버 종료 중...\n");
-    save_data(); 
-    free_all_resources(); 
+    for (int i = 0; i < get_store_count(); i++) {
+        Store* st = get_store_at(i);
+        compact_flush(st); 
+        free_all_resources(st); 
+    }
+    save_config();
+    flush_logs();
+    io_flush_all();
     exit(0);
 }
 
@@ -26,14 +40,35 @@ void* monitor_thread(void* arg) {
         char time_str[26]; print_time_str(vt, time_str);
 
         draw_dashboard(time_str);
-        check_and_update_expirations(vt);
+        // 복제본은 주 서버가 보내는 만료(X) 레코드를 따르므로 직접 만료 처리하지 않음
+        if (!is_replica()) {
+            for (int i = 0; i < get_store_count(); i++)
+                check_and_update_expirations(get_store_at(i), vt);
+        }
+        flush_logs();
         
         usleep(500000); 
     }
     return NULL;
 }
 
-int main() {
+// 사용법: server [--port N] [--replica-of HOST:PORT] [--dir 데이터_디렉토리] [--io uring|pwrite]
+int main(int argc, char* argv[]) {
+    int port = PORT;
+    char primary_host[64] = ""; int primary_port = 0;
+    int io_kind = IO_BACKEND_URING;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--port") == 0) port = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--replica-of") == 0) {
+            if (sscanf(argv[i + 1], "%63[^:]:%d", primary_host, &primary_port) != 2) primary_host[0] = '\0';
+        }
+        else if (strcmp(argv[i], "--io") == 0) io_kind = strcmp(argv[i + 1], "pwrite") == 0 ? IO_BACKEND_PWRITE : IO_BACKEND_URING;
+        else if (strcmp(argv[i], "--dir") == 0 && chdir(argv[i + 1]) != 0) {
+            printf("[오류] 데이터 디렉토리로 이동할 수 없습니다: %s\n", argv[i + 1]);
+            return 1;
+        }
+    }
+
     printf("\033[2J\033[1;1H");
     printf("======================================\n");
     printf("    스마트 재고 관리 서버 (Server)    \n");
@@ -47,17 +82,20 @@ int main() {
     if (scanf("%d", &mode) != 1) mode = 1;
     getchar(); 
 
-    // 모듈 초기화
+    // 모듈 초기화 (저장 I/O 스레드는 파일을 열기 전에)
+    io_init(io_kind);
     init_config(mode);
-    init_inventory();
+    init_stores();
+    if (primary_host[0]) set_replica_source(primary_host, primary_port);
 
-    // 데이터 복구
+    // 데이터 복구 (기본 매장만 미리 로드, 나머지 매장은 첫 접속 시 로드)
     load_persistent_logs(); 
-    load_data(); 
+    load_data(get_default_store()); 
     load_config(); 
 
-    // 중단되었던 동안 발생한 만료 처리
-    recover_missed_expirations(get_virtual_time());
+    // 중단되었던 동안 발생한 만료 처리 (복제본은 주 서버 상태를 그대로 따름)
+    if (is_replica()) start_replica();
+    else recover_missed_expirations(get_default_store(), get_virtual_time());
 
     printf("\033[2J\033[1;1H"); 
     signal(SIGINT, handle_sigint);
@@ -66,6 +104,15 @@ int main() {
     pthread_t m_tid, a_tid;
     pthread_create(&m_tid, NULL, monitor_thread, NULL);
     pthread_create(&a_tid, NULL, admin_console_thread, NULL);
+    init_scheduler(SCHED_WORKERS);
+    init_compactor();
+    init_bulk_jobs();
+    init_push();
+    {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "[System] 저장 I/O: %s", io_backend_name());
+        update_log(msg);
+    }
 
     // 서버 소켓 준비
     int s_sock, c_sock; 
@@ -78,7 +125,7 @@ int main() {
     
     s_addr.sin_family = AF_INET; 
     s_addr.sin_addr.s_addr = INADDR_ANY; 
-    s_addr.sin_port = htons(PORT);
+    s_addr.sin_port = htons(port);
     
     bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
     listen(s_sock, 10);
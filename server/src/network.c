@@ -2,10 +2,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 #include <arpa/inet.h>
 #include "network.h"
 #include "inventory.h"
 #include "logger.h"
+#include "scheduler.h"
+#include "replication.h"
+#include "history.h"
+#include "push.h"
+#include "admission.h"
+#include "session.h"
+#include "itemmeta.h"
+#include "offline.h"
+#include "dedup.h"
+#include "idalloc.h"
+#include "bulkjob.h"
+#include "trace.h"
 
 ssize_t send_exact(int sock, const void *buf, size_t len) {
     size_t total = 0; const char *p = (const char *)buf;
@@ -27,6 +40,111 @@ ssize_t recv_exact(int sock, void *buf, size_t len) {
     return total;
 }
 
+// [요청 우선순위 분류] 판매/결제처럼 손님이 기다리는 요청이 긴 보고서 뒤에 밀리지 않도록 등급을 나눔
+static int sched_class(uint32_t cmd) {
+    switch (cmd) {
+        case 14: case 17: case CMD_CART_RELEASE: case CMD_MENU_SNAPSHOT:
+        case CMD_SESSION: case 100: return SCHED_CRITICAL;      // 재접속 이어받기/종료 시 예약 정리
+        case 1: case 2: case 5: case 6: case 8: case 12: case 13: case 16:
+        case CMD_OFFLINE_SYNC: case CMD_ID_LEASE: return SCHED_BULK;   // 밀린 오프라인 판매는 지금 계산대의 판매보다 뒤에
+        default: return SCHED_BACKGROUND;      // 7, 9, 10, 11, 15, 18, 19, 26, 27 요약/상세/과거 시점/부가 정보 조회
+    }
+}
+
+// 워커 스레드에서 실행되는 매장 단위 요청 처리
+static void run_request(Job* job) {
+    Store* st = job->st;
+    uint32_t cid = job->cid;
+    char* pin = job->pin;
+    char* msg = job->msg;
+
+    TRACE_BEGIN("request", "실행", (long)job->cmd);
+    // 비즈니스 로직은 이제 inventory.c 가 알아서 처리하고 msg에 결과만 적어줍니다.
+    switch(job->cmd) {
+        case 1: handle_single_import(st, cid, pin, msg); break;
+        case 2: handle_random_import(st, cid, pin, msg); break;
+        case CMD_ID_LEASE: handle_id_lease(st, cid, pin, msg); break;
+        case 7: make_category_summary(st, msg, 0, "전체 재고 요약"); break;
+        case 10: make_category_summary(st, msg, 1, "만료 재고 요약"); break;
+        case 15: make_category_summary(st, msg, 2, "판매 가능 메뉴판"); break;
+        case CMD_MENU_SNAPSHOT: make_menu_snapshot(st, msg); break;
+        case 9: case 11: {
+            char *saveptr;
+            char *n = strtok_r(pin, "|", &saveptr); 
+            char *p = strtok_r(NULL, "|", &saveptr); 
+            if(n && p) job->out_p = make_detail_page(st, msg, n, atoi(p), (job->cmd == 11 ? 1 : 0));
+            break;
+        }
+        case 14: handle_sell(st, cid, job->owner, pin, msg); break;
+        case CMD_OFFLINE_SYNC: job->out_p = handle_offline_sync(st, cid, pin, msg); break;
+        case CMD_STOCK_VALUE: make_stock_value(st, msg); break;
+        case CMD_LOT_ITEMS: {   // "로트|페이지"
+            char lot[META_TEXT_LEN] = ""; int page = 1;
+            if (sscanf(pin, "%23[^|]|%d", lot, &page) >= 1) job->out_p = make_lot_page(st, msg, lot, page);
+            else snprintf(msg, MAX_PAYLOAD, "[오류] 형식: 로트|페이지");
+            break;
+        }
+        case 16: 
+            clear_inventory_db(st);
+            snprintf(msg, MAX_PAYLOAD, "[POS-%04d] 창고 비움", cid); 
+            log_event(st, EV_CLEAR, cid, -1, 0, 0, NULL); break;
+        case 17: job->out_p = handle_cart_hold(st, job->owner, pin, msg); break;
+        case CMD_CART_RELEASE: handle_cart_release(st, job->owner, pin, msg); break;
+        case CMD_SESSION: {
+            // 토큰이 맞으면 그 세션의 예약 주인으로 바꾸고 남은 예약을 돌려줌, 아니면 새 세션.
+            // 예약은 주인 번호로만 풀리므로 토큰을 모르는 다른 연결이 남의 예약을 건드릴 수 없음
+            uint32_t prev = job->owner, resumed = pin[0] ? session_resume(st, pin) : 0;
+            char token[SESSION_TOKEN_LEN + 1];
+            if (resumed) { job->owner = resumed; snprintf(token, sizeof(token), "%.16s", pin); }
+            else job->owner = session_issue(st, token);
+            if (prev != job->owner) handle_cart_release(st, prev, "", NULL);   // 이 연결이 그전까지 쓰던 예약
+            job->out_p = resumed != 0;
+            int len = snprintf(msg, MAX_PAYLOAD, "%s\n", token);
+            int lines = list_cart_holds(st, job->owner, msg + len, MAX_PAYLOAD - len);
+            if (resumed) log_event(st, EV_RESUME, cid, -1, lines, 0, NULL);
+            break;
+        }
+        case 100:
+            snprintf(msg, MAX_PAYLOAD, "[종료] 단말기 [POS-%04d] 종료됨", cid);
+            log_event(st, EV_DISCONNECT, cid, -1, 0, 0, NULL);
+            handle_cart_release(st, job->owner, "", NULL);      // 정상 종료한 단말기의 장바구니 예약은 바로 해제
+            break;
+        case 18: {  // 과거 시점 요약: "가상시각|모드"
+            long t = 0; int mode = 0;
+            if (sscanf(pin, "%ld|%d", &t, &mode) >= 1) make_asof_summary(st, (time_t)t, msg, mode);
+            else snprintf(msg, MAX_PAYLOAD, "[오류] 형식: 가상시각|모드");
+            break;
+        }
+        case 19: {  // 과거 시점 상세: "가상시각|상품명|페이지|모드"
+            long t = 0; char name[50]; int page = 1, mode = 0;
+            if (sscanf(pin, "%ld|%49[^|]|%d|%d", &t, name, &page, &mode) >= 3)
+                job->out_p = make_asof_detail(st, (time_t)t, msg, name, page, mode);
+            else snprintf(msg, MAX_PAYLOAD, "[오류] 형식: 가상시각|상품명|페이지|모드");
+            break;
+        }
+        case 6: case 8: handle_delete_operations(st, job->cmd, cid, pin, msg); break;
+        case 5: case 12: case 13:   // 일괄 삭제: 작업 번호만 바로 돌려주고 삭제는 작업 스레드가 나눠서
+            job->out_p = (int)bulk_job_submit(st, job->cmd, cid, pin, msg, MAX_PAYLOAD); break;
+        default:
+            snprintf(msg, MAX_PAYLOAD, "[오류] 알 수 없는 명령어"); break;
+    } 
+    TRACE_END("request", "실행", 0);
+}
+
+// 수락 제어를 거쳐 워커에서 실행 (거절되면 RESP_BUSY 와 거절 문구를 채우고 0)
+static int run_admitted(Job* job, int* code) {
+    int cls = admission_class(job->cmd);
+    int verdict = admission_enter(job->owner, job->cid, cls, job->cls == SCHED_CRITICAL);
+    if (verdict != ADM_OK) {
+        *code = RESP_BUSY;
+        snprintf(job->msg, MAX_PAYLOAD, "%s", admission_reject_msg(verdict));
+        return 0;
+    }
+    submit_and_wait(job);
+    if (cls != ADM_EXEMPT) admission_leave();     // 면제 등급은 처리 슬롯을 잡지 않음
+    return 1;
+}
+
 void* client_handler(void* arg) {
     ClientInfo* info = (ClientInfo*)arg;
     int sock = info->sock;
@@ -36,8 +154,17 @@ void* client_handler(void* arg) {
     char client_ip[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &(addr.sin_addr), client_ip, INET_ADDRSTRLEN);
     
-    NetHeader req, res;
+    NetHeader req;
     char pin[MAX_PAYLOAD], pout[MAX_PAYLOAD + 512], msg[MAX_PAYLOAD + 256];
+    Store* st = get_default_store(); // 핸드셰이크(99)에서 매장 ID를 보내지 않으면 기본 매장
+    Conn* conn = conn_register(sock);
+    if (!conn) { close(sock); return NULL; }
+    tune_client_socket(sock);
+    // 예약 주인: 연결마다 새 번호, CMD_SESSION 뒤로는 그 세션의 번호 (token 이 비어 있으면 세션 없음)
+    uint32_t owner = session_new_owner(), session_cid = 0;
+    char token[SESSION_TOKEN_LEN + 1] = "";
+    int ended = 0;
+    errno = 0;
 
     while (recv_exact(sock, &req, sizeof(NetHeader)) > 0) {
         uint32_t cid = ntohl(req.client_id); 
@@ -46,48 +173,97 @@ void* client_handler(void* arg) {
         
         size_t rlen = (len < MAX_PAYLOAD - 1) ? len : MAX_PAYLOAD - 1;
         if (rlen > 0) recv_exact(sock, pin, rlen);
+        // 요청 ID 가 붙은 요청: payload 앞 4바이트를 떼어 냄 (응답 헤더로 그대로 돌려줌)
+        uint32_t rid = 0;
+        if ((cmd & REQ_ID_FLAG) && rlen >= sizeof(rid)) {
+            memcpy(&rid, pin, sizeof(rid));
+            rid = ntohl(rid);
+            rlen -= sizeof(rid);
+            memmove(pin, pin + sizeof(rid), rlen);
+        }
+        cmd &= ~REQ_ID_FLAG;
         pin[rlen] = '\0'; 
+        TRACE_BEGIN("request", "요청", (long)cmd);
         msg[0] = '\0';
-        int out_p = 0;
+        int out_p = 0, code = RESP_OK;
 
-        // 비즈니스 로직은 이제 inventory.c 가 알아서 처리하고 msg에 결과만 적어줍니다.
-        switch(cmd) {
-            case 99: 
+        if (cmd == REPL_SUBSCRIBE) {
+            // 복제본 구독: 이 연결은 이후 저널 스트리밍 전용 (복제본은 보내기만 받으므로 유휴 제한 해제)
+            setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &(struct timeval){ 0, 0 }, sizeof(struct timeval));
+            serve_replication(sock, pin);
+            ended = 1;
+            break;
+        } else if (cmd == 99) {
+            // 접속 인사: payload 가 매장 ID (비어 있으면 기본 매장)
+            Store* sel = open_store(pin);
+            if (!sel) {
+                snprintf(msg, sizeof(msg), "[오류] 잘못된 매장 ID: %.40s", pin);
+            } else {
+                st = sel;
                 snprintf(msg, sizeof(msg), "[접속] 단말기 [POS-%04d] 실행됨 (IP: %s)", cid, client_ip);
-                update_log(msg); break;
-            case 100: 
-                snprintf(msg, sizeof(msg), "[종료] 단말기 [POS-%04d] 종료됨", cid);
-                update_log(msg); break;
-            case 1: handle_single_import(cid, pin, msg); break;
-            case 2: handle_random_import(cid, pin, msg); break;
-            case 7: make_category_summary(msg, 0, "전체 재고 요약"); break;
-            case 10: make_category_summary(msg, 1, "만료 재고 요약"); break;
-            case 15: make_category_summary(msg, 2, "판매 가능 메뉴판"); break;
-            case 9: case 11: {
-                char *saveptr;
-                char *n = strtok_r(pin, "|", &saveptr); 
-                char *p = strtok_r(NULL, "|", &saveptr); 
-                if(n && p) out_p = make_detail_page(msg, n, atoi(p), (cmd == 11 ? 1 : 0));
-                break;
+                log_event(st, EV_CONNECT, cid, -1, 0, 0, client_ip);
+            }
+        } else if (cmd == CMD_SUBSCRIBE) {
+            // 이후 이 연결로 현재 매장의 재고 버전 변경을 푸시
+            conn_subscribe(conn, st);
+            snprintf(msg, sizeof(msg), "%llu", (unsigned long long)store_version(st));
+        } else if (cmd == CMD_WATCH) {
+            // 분류별 재고 이벤트(임계값 미만/만료/품절) 구독
+            conn_watch(conn, st, pin, msg, sizeof(msg));
+        } else if (cmd == CMD_PING) {
+            strcpy(msg, "pong");
+        } else if (cmd == CMD_BULK_STATUS) {
+            out_p = bulk_job_status(st, pin, msg, sizeof(msg));
+        } else if (cmd == CMD_SESSION) {
+            Job job = { .st = st, .cid = cid, .owner = owner, .cmd = cmd, .cls = sched_class(cmd), .pin = pin, .msg = msg, .run = run_request };
+            if (run_admitted(&job, &code)) {
+                if (job.owner != owner) {
+                    admission_forget(owner);
+                    if (token[0] && strncmp(token, msg, SESSION_TOKEN_LEN) != 0) session_end(token);
+                }
+                owner = job.owner;
+                snprintf(token, sizeof(token), "%.16s", msg);
+                session_cid = cid;
+                out_p = job.out_p;
             }
-            case 14: handle_sell(cid, pin, msg); break;
-            case 16: 
-                clear_inventory_db();
-                snprintf(msg, sizeof(msg), "[POS-%04d] 창고 비움", cid); 
-                update_log(msg); break;
-            case 17: handle_cart_verify(pin, msg); break;
-            case 5: case 6: case 8: case 12: case 13: 
-                handle_delete_operations(cmd, cid, pin, msg); break;
-            default:
-                snprintf(msg, sizeof(msg), "[오류] 알 수 없는 명령어"); break;
-        } 
+        } else if (cmd == 100) {
+            Job job = { .st = st, .cid = cid, .owner = owner, .cmd = cmd, .cls = sched_class(cmd), .pin = pin, .msg = msg, .run = run_request };
+            run_admitted(&job, &code);
+            if (token[0]) session_end(token);
+            ended = 1;
+        } else if (is_replica() && !is_read_only_cmd(cmd)) {
+            snprintf(msg, sizeof(msg), "[오류] 읽기 전용 복제본입니다. 변경 요청은 주 서버로 보내주세요.");
+        } else if (rid && !is_read_only_cmd(cmd) &&
+                   dedup_begin(cid, rid, cmd, &code, &out_p, msg, sizeof(msg)) == DEDUP_HIT) {
+            // 이미 처리한 변경 요청의 재전송: 다시 실행하지 않고 보관한 응답을 돌려줌
+        } else {
+            int dedup = rid && !is_read_only_cmd(cmd);
+            // 단말기별 요청 한도와 전체 동시 처리 한도를 넘으면 워커에 올리지 않고 바로 거절
+            Job job = { .st = st, .cid = cid, .owner = owner, .cmd = cmd, .cls = sched_class(cmd), .pin = pin, .msg = msg, .run = run_request };
+            if (!run_admitted(&job, &code)) {
+                if (dedup) dedup_abort(cid, rid);       // 실행하지 않았으므로 같은 ID 로 다시 보내면 새로 처리
+            } else {
+                out_p = job.out_p;
+                if (dedup) dedup_complete(cid, rid, code, out_p, msg);
+            }
+        }
 
         snprintf(pout, sizeof(pout), "%d|%.8100s", out_p, msg);
-        res.code = htonl(200); res.length = htonl(strlen(pout));
-        send_exact(sock, &res, sizeof(NetHeader));
-        send_exact(sock, pout, strlen(pout));
+        TRACE_BEGIN("net", "응답 전송", (long)strlen(pout));
+        conn_send(conn, rid, code, pout, strlen(pout));
+        TRACE_END("net", "응답 전송", 0);
+        TRACE_END("request", "요청", 0);
+        errno = 0;      // 루프를 빠져나온 이유(시간 초과 EAGAIN / 연결 종료)를 구분하기 위함
     }
 
+    // 비정상 단절(소켓 오류/유휴 시간 초과): 예약은 TTL 까지 남겨 두고 세션 이어받기 시간을 새로 셈
+    if (!ended && token[0]) {
+        int timed_out = (errno == EAGAIN || errno == EWOULDBLOCK);
+        session_touch(token);
+        log_event(st, EV_DROPPED, session_cid, -1, 0, timed_out, NULL);
+    }
+    admission_forget(owner);
+    conn_unregister(conn);
     close(sock); 
     return NULL;
-}
\ No newline at end of file
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "offline.h"
+#include "journal.h"
+
+// =====================================================================
+// [오프라인 판매 원장]
+// 태그별 최대값은 메모리에 두고, 바뀔 때마다 O 레코드를 저널/이력에 남깁니다. 판매 한 건의 D 레코드들과
+// 그 판매의 O 는 한 묶음(B ~ K)으로 남으므로 재생과 복제본에서 함께 반영되거나 함께 빠집니다.
+// 압축 파일에는 원장이 없으므로 압축 스레드가 같은 시점의 원장을 "<DB 이름>.offline" 에 통째로 다시 쓰고
+// (DB 파일보다 먼저), 적재 시 그 파일을 읽은 뒤 이력의 O 를 재생합니다. 값이 최대값이라 겹쳐 재생해도 같습니다.
+// =====================================================================
+
+typedef struct {
+    char tag[OFFLINE_TAG_LEN + 1];
+    uint64_t seq;
+} LedgerRow;
+
+typedef struct OfflineLedger {
+    LedgerRow* rows;
+    int count, cap;
+} OfflineLedger;
+
+int offline_valid_tag(const char* tag) {
+    size_t len = tag ? strlen(tag) : 0;
+    if (len == 0 || len > OFFLINE_TAG_LEN) return 0;
+    for (size_t i = 0; i < len; i++) if (!isxdigit((unsigned char)tag[i])) return 0;
+    return 1;
+}
+
+static LedgerRow* find_row(OfflineLedger* lg, const char* tag) {
+    for (int i = 0; lg && i < lg->count; i++) if (strcmp(lg->rows[i].tag, tag) == 0) return &lg->rows[i];
+    return NULL;
+}
+
+static void set_row(Store* st, const char* tag, uint64_t seq) {
+    if (!st->offline && !(st->offline = calloc(1, sizeof(OfflineLedger)))) return;
+    OfflineLedger* lg = st->offline;
+    LedgerRow* r = find_row(lg, tag);
+    if (!r) {
+        if (lg->count >= lg->cap) {
+            int cap = lg->cap ? lg->cap * 2 : 16;
+            LedgerRow* grown = realloc(lg->rows, sizeof(LedgerRow) * cap);
+            if (!grown) return;
+            lg->rows = grown; lg->cap = cap;
+        }
+        r = &lg->rows[lg->count++];
+        snprintf(r->tag, sizeof(r->tag), "%s", tag);
+        r->seq = 0;
+    }
+    if (seq > r->seq) r->seq = seq;
+}
+
+uint64_t offline_applied(Store* st, const char* tag) {
+    LedgerRow* r = find_row(st->offline, tag);
+    return r ? r->seq : 0;
+}
+
+void offline_mark(Store* st, const char* tag, uint64_t seq) {
+    char args[64];
+    set_row(st, tag, seq);
+    snprintf(args, sizeof(args), "%s %llu", tag, (unsigned long long)seq);
+    journal_append(st, 'O', args);
+}
+
+void offline_apply(Store* st, const char* args) {
+    char tag[OFFLINE_TAG_LEN + 1];
+    unsigned long long seq;
+    if (sscanf(args, "%16s %llu", tag, &seq) == 2 && offline_valid_tag(tag)) set_row(st, tag, seq);
+}
+
+void offline_load(Store* st, const char* path) {
+    char line[64];
+    FILE* fp = fopen(path, "r");
+    if (!fp) return;
+    while (fgets(line, sizeof(line), fp)) offline_apply(st, line);
+    fclose(fp);
+}
+
+char* offline_dump(Store* st, const char* prefix, size_t* len) {
+    OfflineLedger* lg = st->offline;
+    *len = 0;
+    if (!lg || lg->count == 0) return NULL;
+    size_t cap = (size_t)lg->count * (strlen(prefix) + 48);
+    char* buf = malloc(cap);
+    if (!buf) return NULL;
+    for (int i = 0; i < lg->count; i++)
+        *len += snprintf(buf + *len, cap - *len, "%s%s %llu\n", prefix, lg->rows[i].tag, (unsigned long long)lg->rows[i].seq);
+    return buf;
+}
+
+void offline_free(Store* st) {
+    if (!st->offline) return;
+    free(st->offline->rows);
+    free(st->offline);
+    st->offline = NULL;
+}
@@ -0,0 +1,36 @@
+#include <unistd.h>
+#include <pthread.h>
+#include "parallel.h"
+
+// =====================================================================
+// [병렬 분할 실행]
+// DB 적재/압축처럼 한 번에 큰 덩어리를 나눠 처리하는 작업용. 요청 처리 워커(scheduler.c)와는
+// 별개로, 호출할 때 몫마다 스레드를 띄우고 모두 합류시킵니다. (호출 빈도가 낮아 생성 비용은 무시할 만함)
+// =====================================================================
+
+static int fixed_threads = 0;
+
+void parallel_set_threads(int n) {
+    fixed_threads = n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : n;
+}
+
+int parallel_threads(void) {
+    long n = fixed_threads > 0 ? fixed_threads : sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    return n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : (int)n;
+}
+
+void parallel_run(int n, void* (*fn)(void*), void* args, size_t stride) {
+    pthread_t tids[PARALLEL_MAX_THREADS];
+    int started[PARALLEL_MAX_THREADS] = {0};
+    char* base = args;
+    if (n > PARALLEL_MAX_THREADS) n = PARALLEL_MAX_THREADS;
+
+    // 첫 몫은 호출한 스레드가 맡음
+    for (int i = 1; i < n; i++) started[i] = pthread_create(&tids[i], NULL, fn, base + i * stride) == 0;
+    if (n > 0) fn(base);
+    for (int i = 1; i < n; i++) {
+        if (started[i]) pthread_join(tids[i], NULL);
+        else fn(base + i * stride);
+    }
+}
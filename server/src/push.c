@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "push.h"
+#include "network.h"
+#include "inventory.h"
+#include "logger.h"
+
+#define PUSH_RETRY_MS 20    // 소켓 버퍼가 찬 구독자가 있을 때 다시 비워 보는 간격
+#define PUSH_COALESCE_MAX (MAX_PAYLOAD + 512)    // 이 크기까지는 헤더와 본문을 한 번의 send 로
+
+// =====================================================================
+// [재고 버전 / 분류별 이벤트 푸시]
+// 매장마다 재고 버전(변경 횟수)을 두고, 변경 경로(list_mutex 안)는 버전 증가와
+// 신호만 하고, 팬아웃 스레드가 락 밖에서 다음을 수행합니다.
+//  1) 분류 구독자가 있는 매장만, 버전이 바뀌었을 때 분류별 수량을 한 번 셈 (구독자 수와 무관)
+//  2) 직전 수량과 비교해 구독자별 이벤트(임계값 미만/만료/품절)를 각자의 대기 큐에 넣음
+//  3) 논블로킹 송신으로 큐를 비움 - 느린 단말기는 자기 큐만 밀리고 다른 구독자를 막지 않음
+// 매장 락(수량 집계)은 conns_mutex 밖에서 잡고, 응답을 보내는 중이라 send_mutex 가 잡혀 있는 연결은
+// 기다리지 않고 건너뜀 (버전 알림은 다음 회차에 다시, 그 회차의 분류 이벤트는 버린 것으로 셈)
+// =====================================================================
+
+static Conn* conns = NULL;
+static pthread_mutex_t conns_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long closed_pushed = 0, closed_dropped = 0;    // 종료된 연결 누계 (conns_mutex 보호)
+
+static int dirty = 0;
+static pthread_mutex_t dirty_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dirty_cond = PTHREAD_COND_INITIALIZER;
+
+static void wake_fanout(void) {
+    pthread_mutex_lock(&dirty_mutex);
+    dirty = 1;
+    pthread_cond_signal(&dirty_cond);
+    pthread_mutex_unlock(&dirty_mutex);
+}
+
+Conn* conn_register(int sock) {
+    Conn* c = calloc(1, sizeof(Conn));
+    if (!c) return NULL;
+    c->sock = sock;
+    pthread_mutex_init(&c->send_mutex, NULL);
+    pthread_mutex_lock(&conns_mutex);
+    c->next = conns; conns = c;
+    pthread_mutex_unlock(&conns_mutex);
+    return c;
+}
+
+void conn_unregister(Conn* c) {
+    if (!c) return;
+    pthread_mutex_lock(&conns_mutex);
+    for (Conn** pp = &conns; *pp; pp = &(*pp)->next) {
+        if (*pp == c) { *pp = c->next; break; }
+    }
+    closed_pushed += c->pushed;
+    closed_dropped += c->dropped + c->q_len + c->skipped;
+    pthread_mutex_unlock(&conns_mutex);
+    pthread_mutex_destroy(&c->send_mutex);
+    free(c);
+}
+
+// [대기 큐] send_mutex 보유 상태에서 호출
+static void enqueue_locked(Conn* c, uint16_t code, int category, uint64_t value) {
+    for (int i = 0; i < c->q_len; i++) {
+        PushEvent* e = &c->queue[(c->q_head + i) % PUSH_QUEUE_LEN];
+        if (e->code != code || e->category != category) continue;
+        // 같은 이벤트는 합침 (만료 수량은 누적, 나머지는 최신 값)
+        if (code == PUSH_EXPIRED) e->value += value; else e->value = value;
+        return;
+    }
+    if (c->q_len == PUSH_QUEUE_LEN) {
+        // 가득 참: 개별 이벤트를 버리고 "전체 다시 받기" 한 건으로 대체
+        c->dropped += c->q_len;
+        c->q_len = 0;
+        code = PUSH_INVALIDATE; category = -1;
+        value = c->st ? store_version(c->st) : 0;
+    }
+    PushEvent* e = &c->queue[(c->q_head + c->q_len) % PUSH_QUEUE_LEN];
+    e->code = code; e->category = (int8_t)category; e->value = value;
+    c->q_len++;
+}
+
+static void encode_frame(Conn* c, const PushEvent* e) {
+    char* payload = c->out + sizeof(NetHeader);
+    size_t room = sizeof(c->out) - sizeof(NetHeader);
+    const char* name = category_name(e->category);
+    int len;
+    switch (e->code) {
+        case PUSH_LOW_STOCK:
+        case PUSH_EXPIRED:  len = snprintf(payload, room, "%s|%llu", name, (unsigned long long)e->value); break;
+        case PUSH_SOLD_OUT: len = snprintf(payload, room, "%s", name); break;
+        default:            len = snprintf(payload, room, "%llu", (unsigned long long)e->value); break;
+    }
+    NetHeader h;
+    h.client_id = 0; h.code = htonl(e->code); h.length = htonl((uint32_t)len);
+    memcpy(c->out, &h, sizeof(h));
+    c->out_len = sizeof(h) + len;
+    c->out_off = 0;
+}
+
+// 논블로킹으로 보낼 수 있는 만큼 보냄. 아직 남아 있으면 1
+static int flush_locked(Conn* c) {
+    while (!c->broken) {
+        if (c->out_off == c->out_len) {
+            if (c->q_len == 0) return 0;
+            encode_frame(c, &c->queue[c->q_head]);
+            c->q_head = (c->q_head + 1) % PUSH_QUEUE_LEN;
+            c->q_len--;
+            c->pushed++;
+        }
+        ssize_t n = send(c->sock, c->out + c->out_off, c->out_len - c->out_off, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) { c->out_off += n; continue; }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+        if (n < 0 && errno == EINTR) continue;
+        c->broken = 1;      // 연결 종료는 수신 쪽(client_handler)이 처리
+    }
+    c->dropped += c->q_len;
+    c->q_len = 0;
+    return 0;
+}
+
+int conn_send(Conn* c, uint32_t cid, uint32_t code, const char* payload, size_t len) {
+    NetHeader h;
+    h.client_id = htonl(cid); h.code = htonl(code); h.length = htonl((uint32_t)len);
+    pthread_mutex_lock(&c->send_mutex);
+    // 보내다 만 푸시 프레임을 먼저 마쳐야 프레임 경계가 유지됨
+    int ok = c->out_off == c->out_len || send_exact(c->sock, c->out + c->out_off, c->out_len - c->out_off) >= 0;
+    if (ok) c->out_off = c->out_len;
+    if (ok && len <= PUSH_COALESCE_MAX) {
+        // 헤더와 본문을 한 번에 보냄 (나눠 보내면 Nagle + 상대 지연 ACK 로 응답마다 최대 40ms 지연)
+        char buf[sizeof(NetHeader) + PUSH_COALESCE_MAX];
+        memcpy(buf, &h, sizeof(h));
+        memcpy(buf + sizeof(h), payload, len);
+        ok = send_exact(c->sock, buf, sizeof(h) + len) >= 0;
+    } else {
+        ok = ok && send_exact(c->sock, &h, sizeof(h)) >= 0 && (len == 0 || send_exact(c->sock, payload, len) >= 0);
+    }
+    if (ok) flush_locked(c);
+    pthread_mutex_unlock(&c->send_mutex);
+    return ok ? 0 : -1;
+}
+
+void conn_subscribe(Conn* c, Store* st) {
+    pthread_mutex_lock(&conns_mutex);
+    c->st = st;
+    c->subscribed = 1;
+    c->pushed_version = store_version(st);
+    pthread_mutex_unlock(&conns_mutex);
+}
+
+int conn_watch(Conn* c, Store* st, const char* spec, char* msg, size_t size) {
+    char cat[50];
+    int mask, threshold = 0;
+    if (sscanf(spec, "%49[^|]|%d|%d", cat, &mask, &threshold) < 2 || mask < 0 || mask > WATCH_ALL || threshold < 0) {
+        snprintf(msg, size, "[오류] 구독 형식: 분류명|마스크(1=임계값 2=만료 4=품절)|임계값");
+        return -1;
+    }
+    int idx = strcmp(cat, "*") == 0 ? -1 : category_of(cat);
+    if (idx < 0 && strcmp(cat, "*") != 0) {
+        snprintf(msg, size, "[오류] 알 수 없는 분류: %.40s", cat);
+        return -1;
+    }
+
+    pthread_mutex_lock(&conns_mutex);
+    if (c->st != st) {
+        // 매장이 바뀌면 이전 매장 구독은 모두 해제
+        memset(c->watch_mask, 0, sizeof(c->watch_mask));
+        c->st = st;
+    }
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        if (idx >= 0 && i != idx) continue;
+        c->watch_mask[i] = (uint8_t)mask;
+        c->watch_threshold[i] = threshold;
+    }
+    c->watching = 0;
+    for (int i = 0; i < NUM_CATEGORIES; i++) if (c->watch_mask[i]) c->watching = 1;
+    pthread_mutex_unlock(&conns_mutex);
+
+    wake_fanout();      // 새 구독 매장의 기준 수량을 바로 세도록
+    snprintf(msg, size, "[구독] %s: %s%s%s%s", idx < 0 ? "전체 분류" : category_name(idx),
+             mask == 0 ? "해제" : "", (mask & WATCH_LOW_STOCK) ? "임계값 미만 " : "",
+             (mask & WATCH_EXPIRED) ? "만료 " : "", (mask & WATCH_SOLD_OUT) ? "품절" : "");
+    return 0;
+}
+
+uint64_t store_version(Store* st) {
+    return __atomic_load_n(&st->version, __ATOMIC_ACQUIRE);
+}
+
+void store_changed(Store* st) {
+    __atomic_add_fetch(&st->version, 1, __ATOMIC_RELEASE);
+    wake_fanout();
+}
+
+// [수량 집계] 이번 회차에 처음 방문한 매장만 셈. 직전 회차에 구독자가 없었다면
+// 그 사이 변경을 못 봤으므로 기준을 새로 잡고 이벤트는 내지 않음
+static void refresh_counts(Store* st, unsigned long round) {
+    if (st->watch_round == round) return;
+    int ready = st->watch_ready && st->watch_round == round - 1;
+    st->watch_round = round;
+    uint64_t v = store_version(st);
+    if (ready && v == st->watch_version) {
+        memcpy(st->watch_prev_avail, st->watch_avail, sizeof(st->watch_avail));
+        memset(st->watch_new_expired, 0, sizeof(st->watch_new_expired));
+        return;
+    }
+    int expired[NUM_CATEGORIES];
+    memcpy(st->watch_prev_avail, st->watch_avail, sizeof(st->watch_avail));
+    count_categories(st, st->watch_avail, expired);
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        int d = expired[i] - st->watch_expired[i];
+        st->watch_new_expired[i] = (ready && d > 0) ? d : 0;
+        st->watch_expired[i] = expired[i];
+    }
+    if (!ready) memcpy(st->watch_prev_avail, st->watch_avail, sizeof(st->watch_avail));
+    st->watch_version = v;
+    st->watch_ready = 1;
+}
+
+// 이번 회차 이벤트를 큐에 넣음 (deliver = 0 이면 세기만, 반환: 이벤트 수)
+static int collect_events(Conn* c, int deliver) {
+    Store* st = c->st;
+    int n = 0;
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        uint8_t m = c->watch_mask[i];
+        if (!m) continue;
+        int prev = st->watch_prev_avail[i], now = st->watch_avail[i];
+        if ((m & WATCH_LOW_STOCK) && prev >= c->watch_threshold[i] && now < c->watch_threshold[i]) {
+            n++; if (deliver) enqueue_locked(c, PUSH_LOW_STOCK, i, now);
+        }
+        if ((m & WATCH_EXPIRED) && st->watch_new_expired[i] > 0) {
+            n++; if (deliver) enqueue_locked(c, PUSH_EXPIRED, i, st->watch_new_expired[i]);
+        }
+        if ((m & WATCH_SOLD_OUT) && prev > 0 && now == 0) {
+            n++; if (deliver) enqueue_locked(c, PUSH_SOLD_OUT, i, 0);
+        }
+    }
+    return n;
+}
+
+static void* fanout_thread(void* arg) {
+    (void)arg;
+    unsigned long round = 1;
+    int backlog = 0;
+    while (1) {
+        pthread_mutex_lock(&dirty_mutex);
+        if (backlog) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += PUSH_RETRY_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) { ts.tv_sec++; ts.tv_nsec -= 1000000000L; }
+            while (!dirty && pthread_cond_timedwait(&dirty_cond, &dirty_mutex, &ts) == 0) {}
+        } else {
+            while (!dirty) pthread_cond_wait(&dirty_cond, &dirty_mutex);
+        }
+        dirty = 0;
+        pthread_mutex_unlock(&dirty_mutex);
+
+        round++;
+        backlog = 0;
+
+        // 분류 구독자가 있는 매장 목록만 뽑고, 수량은 conns_mutex 를 놓은 뒤 셈
+        Store* watched[MAX_STORES];
+        int n_watched = 0;
+        pthread_mutex_lock(&conns_mutex);
+        for (Conn* c = conns; c; c = c->next) {
+            if (!c->watching) continue;
+            int k = 0;
+            while (k < n_watched && watched[k] != c->st) k++;
+            if (k == n_watched && n_watched < MAX_STORES) watched[n_watched++] = c->st;
+        }
+        pthread_mutex_unlock(&conns_mutex);
+        for (int k = 0; k < n_watched; k++) refresh_counts(watched[k], round);
+
+        pthread_mutex_lock(&conns_mutex);
+        for (Conn* c = conns; c; c = c->next) {
+            // 그사이 구독 매장이 바뀐 연결은 다음 회차에
+            int events = c->watching && c->st->watch_round == round;
+            if (pthread_mutex_trylock(&c->send_mutex) != 0) {
+                // 응답 송신 중 (상대가 읽지 않으면 오래 걸릴 수 있음): 기다리지 않고 다음 회차에
+                if (events) c->skipped += collect_events(c, 0);
+                backlog = 1;
+                continue;
+            }
+            if (c->subscribed) {
+                uint64_t v = store_version(c->st);
+                if (v > c->pushed_version) {
+                    c->pushed_version = v;
+                    enqueue_locked(c, PUSH_INVALIDATE, -1, v);
+                }
+            }
+            if (events) collect_events(c, 1);
+            if (flush_locked(c)) backlog = 1;
+            pthread_mutex_unlock(&c->send_mutex);
+        }
+        pthread_mutex_unlock(&conns_mutex);
+    }
+    return NULL;
+}
+
+void print_push_stats(void) {
+    int total = 0, subs = 0, watchers = 0, queued = 0;
+    unsigned long pushed, dropped;
+    pthread_mutex_lock(&conns_mutex);
+    pushed = closed_pushed; dropped = closed_dropped;
+    for (Conn* c = conns; c; c = c->next) {
+        total++;
+        if (c->subscribed) subs++;
+        if (c->watching) watchers++;
+        dropped += c->skipped;
+        if (pthread_mutex_trylock(&c->send_mutex) != 0) continue;      // 송신 중인 연결은 이번 집계에서 뺌
+        queued += c->q_len;
+        pushed += c->pushed; dropped += c->dropped;
+        pthread_mutex_unlock(&c->send_mutex);
+    }
+    pthread_mutex_unlock(&conns_mutex);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "[푸시] 연결 %d개 | 버전 구독 %d | 분류 구독 %d | 대기 %d건 | 전송 %lu건 | 버림 %lu건",
+             total, subs, watchers, queued, pushed, dropped);
+    update_log(buf);
+}
+
+void init_push(void) {
+    pthread_t tid;
+    pthread_create(&tid, NULL, fanout_thread, NULL);
+    pthread_detach(tid);
+}
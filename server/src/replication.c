@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "replication.h"
+#include "journal.h"
+#include "push.h"
+#include "inventory.h"
+#include "logger.h"
+#include "network.h"
+
+// =====================================================================
+// [주/복제본 로그 전송]
+// 주 서버는 변경 저널을 TCP로 복제본에 흘려보내고, 복제본은 이를 그대로 적용해
+// 읽기 전용 명령(7, 9, 10, 11, 15, 17)을 처리합니다.
+// 복제본은 주 서버의 LSN을 자신의 저널에도 이어 기록하므로 승격 후에도
+// 다른 복제본이 같은 세대(epoch)로 계속 따라올 수 있습니다.
+// =====================================================================
+
+static volatile int replica_mode = 0;
+static volatile int promoted = 0;
+static uint64_t epoch = 0;                   // 저널 세대 (주 서버 재시작 시 바뀜)
+static uint64_t last_stream_lsn = 0;         // 복제본: 재접속 시 이어 받을 위치
+static int replica_sock = -1;
+static char primary_host[64];
+static int primary_port;
+static int connected_replicas = 0;
+static pthread_mutex_t repl_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t get_epoch(void) {
+    pthread_mutex_lock(&repl_mutex);
+    if (epoch == 0) epoch = ((uint64_t)time(NULL) << 20) ^ (uint64_t)getpid();
+    uint64_t e = epoch;
+    pthread_mutex_unlock(&repl_mutex);
+    return e;
+}
+
+int is_replica(void) { return replica_mode && !promoted; }
+
+int is_read_only_cmd(uint32_t cmd) {
+    switch (cmd) {
+        case 7: case 9: case 10: case 11: case 15: case 18: case 19:
+        case CMD_MENU_SNAPSHOT: case CMD_SUBSCRIBE: case CMD_WATCH: return 1;
+        default: return 0;
+    }
+}
+
+static int send_frame(int sock, uint32_t code, const char* payload, size_t len) {
+    NetHeader h;
+    h.client_id = 0; h.code = htonl(code); h.length = htonl((uint32_t)len);
+    if (send_exact(sock, &h, sizeof(h)) < 0) return -1;
+    if (len > 0 && send_exact(sock, payload, len) < 0) return -1;
+    return 0;
+}
+
+// 모든 매장의 현재 상태를 F/S 레코드로 보내고, 스트리밍을 이어갈 LSN을 반환 (실패 시 -1)
+static int64_t send_full_sync(int sock) {
+    uint64_t start = UINT64_MAX;
+    int n = get_store_count();
+    for (int i = 0; i < n; i++) {
+        uint64_t lsn;
+        char* dump = dump_store_snapshot(get_store_at(i), &lsn);
+        if (!dump) return -1;
+        if (lsn < start) start = lsn;
+
+        char* save = NULL;
+        for (char* line = strtok_r(dump, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+            if (send_frame(sock, REPL_FRAME_RECORD, line, strlen(line)) < 0) { free(dump); return -1; }
+        }
+        free(dump);
+    }
+    char buf[32]; int len = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)start);
+    if (send_frame(sock, REPL_FRAME_STREAM, buf, len) < 0) return -1;
+    return (int64_t)start;
+}
+
+void serve_replication(int sock, const char* pin) {
+    unsigned long long r_epoch = 0, r_lsn = 0;
+    sscanf(pin, "%llu|%llu", &r_epoch, &r_lsn);
+    uint64_t my_epoch = get_epoch();
+
+    pthread_mutex_lock(&repl_mutex); connected_replicas++; pthread_mutex_unlock(&repl_mutex);
+    update_log("[복제] 복제본 연결됨, 저널 전송 시작");
+
+    char buf[32]; int blen = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)my_epoch);
+    int ok = send_frame(sock, REPL_FRAME_EPOCH, buf, blen) == 0;
+
+    // 세대가 다르거나, 처음이거나, 요청 위치가 주 서버보다 앞서면 전체 동기화부터
+    int need_full = (r_epoch != my_epoch || r_lsn == 0 || r_lsn > journal_current_lsn());
+    uint64_t pos = r_lsn;
+    char line[JOURNAL_LINE];
+
+    while (ok) {
+        if (need_full) {
+            int64_t start = send_full_sync(sock);
+            if (start < 0) break;
+            pos = (uint64_t)start; need_full = 0;
+        }
+        int r = journal_read_next(pos, line, sizeof(line));
+        if (r < 0) { need_full = 1; continue; }           // 링에서 밀려남 -> 다시 전체 동기화
+        if (r == 0) {
+            journal_wait(pos, 1000);
+            if (journal_current_lsn() == pos) {
+                blen = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)pos);
+                ok = send_frame(sock, REPL_FRAME_HEARTBEAT, buf, blen) == 0;
+            }
+            continue;
+        }
+        ok = send_frame(sock, REPL_FRAME_RECORD, line, strlen(line)) == 0;
+        pos++;
+    }
+
+    pthread_mutex_lock(&repl_mutex); connected_replicas--; pthread_mutex_unlock(&repl_mutex);
+    update_log("[복제] 복제본 연결 종료");
+}
+
+// [복제본 측]
+
+// "lsn vt op 매장 인자..." 1줄 적용 -> 변경된 매장 반환 (없으면 NULL)
+static Store* apply_line(const char* line) {
+    unsigned long long lsn; long vt; char op; char tok[STORE_ID_LEN]; int off = 0;
+    if (sscanf(line, "%llu %ld %c %31s %n", &lsn, &vt, &op, tok, &off) < 4) return NULL;
+    Store* st = open_store(strcmp(tok, "-") == 0 ? "" : tok);
+    if (!st) return NULL;
+
+    int applied = apply_journal_record(st, lsn, (time_t)vt, op, line + off);
+    if (op != 'F' && op != 'S') {
+        journal_append_raw(lsn, line);            // 승격 대비 자신의 저널에도 같은 LSN으로 기록
+        last_stream_lsn = lsn;
+    }
+    return applied ? st : NULL;
+}
+
+static void flush_dirty(Store** dirty, int* n_dirty) {
+    for (int i = 0; i < *n_dirty; i++) {
+        store_lock(dirty[i]);
+        save_data(dirty[i]);
+        store_unlock(dirty[i]);
+    }
+    *n_dirty = 0;
+}
+
+static int connect_primary(void) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+    struct sockaddr_in a; memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET; a.sin_port = htons(primary_port);
+    if (inet_pton(AF_INET, primary_host, &a.sin_addr) <= 0 ||
+        connect(sock, (struct sockaddr*)&a, sizeof(a)) < 0) { close(sock); return -1; }
+
+    // 하트비트가 일정 시간 안 오면 주 서버 장애로 판단
+    struct timeval tv = { 5, 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return sock;
+}
+
+static void* replica_thread(void* arg) {
+    (void)arg;
+    char payload[MAX_PAYLOAD];
+    Store* dirty[MAX_STORES]; int n_dirty = 0;
+    int warned = 0;
+
+    while (!promoted) {
+        int sock = connect_primary();
+        if (sock < 0) {
+            if (!warned) { update_log("[복제] 주 서버에 연결할 수 없음, 재시도 중 (승격: promote)"); warned = 1; }
+            sleep(1);
+            continue;
+        }
+        pthread_mutex_lock(&repl_mutex); replica_sock = sock; pthread_mutex_unlock(&repl_mutex);
+
+        char req[64];
+        int rlen = snprintf(req, sizeof(req), "%llu|%llu", (unsigned long long)epoch, (unsigned long long)last_stream_lsn);
+        NetHeader h = { htonl(0), htonl(REPL_SUBSCRIBE), htonl((uint32_t)rlen) };
+        if (send_exact(sock, &h, sizeof(h)) >= 0 && send_exact(sock, req, rlen) >= 0) {
+            update_log("[복제] 주 서버 연결됨, 저널 수신 중");
+            warned = 0;
+            while (!promoted && recv_exact(sock, &h, sizeof(h)) > 0) {
+                uint32_t code = ntohl(h.code), len = ntohl(h.length);
+                if (len >= sizeof(payload) || (len > 0 && recv_exact(sock, payload, len) < 0)) break;
+                payload[len] = '\0';
+
+                if (code == REPL_FRAME_EPOCH) {
+                    unsigned long long e = strtoull(payload, NULL, 10);
+                    pthread_mutex_lock(&repl_mutex);
+                    if (e != epoch) { epoch = e; last_stream_lsn = 0; }
+                    pthread_mutex_unlock(&repl_mutex);
+                } else if (code == REPL_FRAME_STREAM) {
+                    last_stream_lsn = strtoull(payload, NULL, 10);
+                } else if (code == REPL_FRAME_RECORD) {
+                    Store* st = apply_line(payload);
+                    if (st) {
+                        int found = 0;
+                        for (int i = 0; i < n_dirty; i++) if (dirty[i] == st) found = 1;
+                        if (!found && n_dirty < MAX_STORES) dirty[n_dirty++] = st;
+                    }
+                }
+
+                // 더 받을 데이터가 없을 때 모아 둔 매장을 한 번에 저장
+                char c;
+                if (n_dirty > 0 && recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT) < 0) flush_dirty(dirty, &n_dirty);
+            }
+            flush_dirty(dirty, &n_dirty);
+        }
+        pthread_mutex_lock(&repl_mutex); replica_sock = -1; pthread_mutex_unlock(&repl_mutex);
+        close(sock);
+        if (!promoted) update_log("[복제] 주 서버 연결 끊김");
+    }
+    return NULL;
+}
+
+void set_replica_source(const char* host, int port) {
+    strncpy(primary_host, host, sizeof(primary_host) - 1);
+    primary_port = port;
+    replica_mode = 1;
+}
+
+void start_replica(void) {
+    if (!replica_mode) return;
+    pthread_t tid;
+    pthread_create(&tid, NULL, replica_thread, NULL);
+    pthread_detach(tid);
+}
+
+void promote_replica(void) {
+    if (!is_replica()) { update_log("[복제] 이미 주 서버입니다."); return; }
+    promoted = 1;
+    pthread_mutex_lock(&repl_mutex);
+    if (replica_sock >= 0) shutdown(replica_sock, SHUT_RDWR);
+    pthread_mutex_unlock(&repl_mutex);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "[복제] 주 서버로 승격됨 (LSN %llu 부터 쓰기 허용)", (unsigned long long)journal_current_lsn());
+    update_log(buf);
+}
+
+void print_replication_status(void) {
+    char buf[256];
+    pthread_mutex_lock(&repl_mutex);
+    if (is_replica())
+        snprintf(buf, sizeof(buf), "[복제] 역할: 복제본 (주 서버 %s:%d, %s) | 적용 LSN %llu",
+                 primary_host, primary_port, replica_sock >= 0 ? "연결됨" : "끊김",
+                 (unsigned long long)journal_current_lsn());
+    else
+        snprintf(buf, sizeof(buf), "[복제] 역할: 주 서버 | 현재 LSN %llu | 연결된 복제본 %d개",
+                 (unsigned long long)journal_current_lsn(), connected_replicas);
+    pthread_mutex_unlock(&repl_mutex);
+    update_log(buf);
+}
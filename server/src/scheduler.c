@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "scheduler.h"
+
+// =====================================================================
+// [매장 파티션 공유 워커 풀 + 우선순위 등급]
+// 매장마다 등급별 FIFO 작업 큐를 두고, 작업이 대기 중인 (매장, 등급)만 그 등급의 준비 큐에 올립니다.
+// 워커는 가중치 라운드 로빈(CRITICAL 8 : BULK 3 : BACKGROUND 1)으로 등급을 고른 뒤
+// 그 준비 큐 맨 앞 매장에서 작업 "하나"만 꺼내 처리하고, 남은 작업이 있으면 매장을 맨 뒤로 보냅니다.
+//  - 같은 매장/같은 등급은 동시에 하나의 워커에서만 실행되어 등급 내 처리 순서가 유지됩니다.
+//  - 보고서(BACKGROUND)는 동시에 최대 (워커 수 - 1)개만 실행해 급한 작업용 워커를 항상 남깁니다.
+//  - 긴 조회는 중간중간 sched_urgent_pending 을 보고 list_mutex 를 급한 작업에 양보합니다.
+// =====================================================================
+
+static pthread_mutex_t sched_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sched_cond = PTHREAD_COND_INITIALIZER;
+static Store* ready_head[SCHED_CLASSES];
+static Store* ready_tail[SCHED_CLASSES];
+
+static const int class_weight[SCHED_CLASSES] = { 8, 3, 1 };
+static int credit[SCHED_CLASSES];
+static int n_workers_total = SCHED_WORKERS;
+static int background_running = 0;
+
+// sched_mutex 보유 상태에서 호출
+static void push_ready(Store* st, int cls) {
+    st->in_ready[cls] = 1;
+    st->ready_next[cls] = NULL;
+    if (ready_tail[cls]) ready_tail[cls]->ready_next[cls] = st; else ready_head[cls] = st;
+    ready_tail[cls] = st;
+    pthread_cond_signal(&sched_cond);
+}
+
+static Store* pop_ready(int cls) {
+    Store* st = ready_head[cls];
+    if (st) {
+        ready_head[cls] = st->ready_next[cls];
+        if (!ready_head[cls]) ready_tail[cls] = NULL;
+        st->in_ready[cls] = 0;
+    }
+    return st;
+}
+
+// 처리할 등급 선택 (없으면 -1). 일이 있는 등급의 몫이 모두 소진되면 몫을 다시 채움
+static int pick_class(void) {
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < SCHED_CLASSES; c++) {
+            if (!ready_head[c] || credit[c] <= 0) continue;
+            if (c == SCHED_BACKGROUND && background_running >= n_workers_total - 1) continue;
+            credit[c]--;
+            return c;
+        }
+        for (int c = 0; c < SCHED_CLASSES; c++) credit[c] = class_weight[c];
+    }
+    return -1;
+}
+
+static void* worker_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&sched_mutex);
+    while (1) {
+        int cls;
+        while ((cls = pick_class()) < 0) pthread_cond_wait(&sched_cond, &sched_mutex);
+        Store* st = pop_ready(cls);
+
+        Job* job = st->q_head[cls];
+        st->q_head[cls] = job->next;
+        if (!st->q_head[cls]) st->q_tail[cls] = NULL;
+        st->q_len[cls]--;
+        st->running[cls] = 1;
+        if (cls == SCHED_BACKGROUND) background_running++;
+        pthread_mutex_unlock(&sched_mutex);
+
+        job->run(job);
+        if (cls == SCHED_CRITICAL) __atomic_sub_fetch(&st->urgent, 1, __ATOMIC_RELEASE);
+
+        pthread_mutex_lock(&sched_mutex);
+        st->running[cls] = 0;
+        st->served++;
+        job->done = 1;
+        pthread_cond_signal(&job->done_cond);
+        if (st->q_head[cls]) push_ready(st, cls);
+        if (cls == SCHED_BACKGROUND) {
+            background_running--;
+            pthread_cond_signal(&sched_cond);   // 동시 실행 한도로 기다리던 워커가 있을 수 있음
+        }
+    }
+    return NULL;
+}
+
+void init_scheduler(int n_workers) {
+    n_workers_total = n_workers;
+    for (int i = 0; i < n_workers; i++) {
+        pthread_t tid;
+        pthread_create(&tid, NULL, worker_thread, NULL);
+        pthread_detach(tid);
+    }
+}
+
+void submit_and_wait(Job* job) {
+    Store* st = job->st;
+    int cls = job->cls;
+    job->done = 0;
+    job->next = NULL;
+    pthread_cond_init(&job->done_cond, NULL);
+    if (cls == SCHED_CRITICAL) __atomic_add_fetch(&st->urgent, 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&sched_mutex);
+    if (st->q_tail[cls]) st->q_tail[cls]->next = job; else st->q_head[cls] = job;
+    st->q_tail[cls] = job;
+    st->q_len[cls]++;
+    if (!st->running[cls] && !st->in_ready[cls]) push_ready(st, cls);
+
+    while (!job->done) pthread_cond_wait(&job->done_cond, &sched_mutex);
+    pthread_mutex_unlock(&sched_mutex);
+    pthread_cond_destroy(&job->done_cond);
+}
+
+int sched_urgent_pending(Store* st) {
+    return __atomic_load_n(&st->urgent, __ATOMIC_ACQUIRE) > 0;
+}
+
+void sched_wait_urgent(Store* st) {
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (sched_urgent_pending(st)) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (ms >= SCHED_YIELD_MAX_MS) break;
+        nanosleep(&(struct timespec){ 0, 50000 }, NULL);
+    }
+}
+
+void sched_store_stats(Store* st, int q_len[SCHED_CLASSES], unsigned long* served) {
+    pthread_mutex_lock(&sched_mutex);
+    for (int c = 0; c < SCHED_CLASSES; c++) q_len[c] = st->q_len[c];
+    *served = st->served;
+    pthread_mutex_unlock(&sched_mutex);
+}
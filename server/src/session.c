@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "session.h"
+
+// =====================================================================
+// [단말기 세션]
+// 접속 인사(cmd 99) 뒤 단말기가 CMD_SESSION 으로 토큰을 받아 두었다가, 연결이 끊겨 다시 붙으면
+// 그 토큰을 보내 이전 세션을 이어받습니다. 세션마다 서버가 정한 예약 주인 번호가 있어, 이어받은 연결은
+// 끊기기 전 장바구니 예약을 그대로 쓰고 단말기는 품목마다 다시 예약(cmd 17)할 필요가 없습니다.
+// cid 는 단말기가 임의로 고른 표시용 번호라 겹칠 수 있으므로 세션/예약의 열쇠로 쓰지 않습니다.
+// 토큰이 없거나 맞지 않으면 새 번호로 새 세션을 시작하고, 이전 세션의 예약은 TTL 이 지나면 풀립니다.
+// (메모리에만 보관 - 서버 재시작 시 소멸)
+// =====================================================================
+
+#define SESSION_SLOTS 256
+
+typedef struct Session {
+    uint32_t owner;
+    Store* st;
+    char token[SESSION_TOKEN_LEN + 1];
+    time_t last_used;               // CLOCK_MONOTONIC 초
+    struct Session* next;
+} Session;
+
+static Session* sessions[SESSION_SLOTS];        // 토큰 해시
+static pthread_mutex_t session_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t next_owner = 0;
+
+static time_t mono_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+static unsigned slot_of(const char* token) {
+    unsigned h = 5381;
+    for (const char* p = token; *p; p++) h = h * 33 + (unsigned char)*p;
+    return h % SESSION_SLOTS;
+}
+
+// session_mutex 보유 상태에서 호출
+static Session** find_session(const char* token) {
+    Session** pp = &sessions[slot_of(token)];
+    while (*pp && strcmp((*pp)->token, token) != 0) pp = &(*pp)->next;
+    return pp;
+}
+
+// session_mutex 보유 상태에서 호출. 이어받을 수 없게 된 세션 정리 (같은 칸만)
+static void drop_stale(unsigned slot, time_t now) {
+    for (Session** pp = &sessions[slot]; *pp; ) {
+        Session* s = *pp;
+        if (now - s->last_used > SESSION_RESUME_SEC) { *pp = s->next; free(s); }
+        else pp = &s->next;
+    }
+}
+
+void tune_client_socket(int sock) {
+    int on = 1, idle = TCP_KEEPALIVE_IDLE_SEC, intvl = TCP_KEEPALIVE_INTVL_SEC, cnt = TCP_KEEPALIVE_COUNT;
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &intvl, sizeof(intvl));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &cnt, sizeof(cnt));
+    // 응답 확인(ACK) 없이 보낸 데이터가 이 시간 넘게 남아 있으면 커널이 연결을 끊음 (푸시 송신 쪽 감지)
+    unsigned int user_timeout = (TCP_KEEPALIVE_IDLE_SEC + TCP_KEEPALIVE_INTVL_SEC * TCP_KEEPALIVE_COUNT) * 1000;
+    setsockopt(sock, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout, sizeof(user_timeout));
+    struct timeval tv = { .tv_sec = CLIENT_IDLE_TIMEOUT_SEC, .tv_usec = 0 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+uint32_t session_new_owner(void) {
+    uint32_t owner;
+    while ((owner = __atomic_add_fetch(&next_owner, 1, __ATOMIC_RELAXED)) == 0) {}
+    return owner;
+}
+
+uint32_t session_resume(Store* st, const char* token) {
+    if (strlen(token) != SESSION_TOKEN_LEN) return 0;
+    pthread_mutex_lock(&session_mutex);
+    Session* s = *find_session(token);
+    time_t now = mono_sec();
+    uint32_t owner = (s && s->st == st && now - s->last_used <= SESSION_RESUME_SEC) ? s->owner : 0;
+    if (owner) s->last_used = now;
+    pthread_mutex_unlock(&session_mutex);
+    return owner;
+}
+
+uint32_t session_issue(Store* st, char* out) {
+    // 토큰: /dev/urandom 8바이트 (읽지 못하면 시각과 rand 로 대체)
+    unsigned long long r = 0;
+    FILE* fp = fopen("/dev/urandom", "rb");
+    if (!fp || fread(&r, sizeof(r), 1, fp) != 1) r = ((unsigned long long)rand() << 32) ^ (unsigned long long)time(NULL) ^ rand();
+    if (fp) fclose(fp);
+    snprintf(out, SESSION_TOKEN_LEN + 1, "%016llx", r);
+    uint32_t owner = session_new_owner();
+
+    pthread_mutex_lock(&session_mutex);
+    time_t now = mono_sec();
+    drop_stale(slot_of(out), now);
+    Session* s = *find_session(out);
+    if (!s && (s = calloc(1, sizeof(Session)))) {
+        strcpy(s->token, out);
+        s->next = sessions[slot_of(out)];
+        sessions[slot_of(out)] = s;
+    }
+    if (s) {
+        s->owner = owner;
+        s->st = st;
+        s->last_used = now;
+    }
+    pthread_mutex_unlock(&session_mutex);
+    return owner;
+}
+
+void session_touch(const char* token) {
+    pthread_mutex_lock(&session_mutex);
+    Session* s = *find_session(token);
+    if (s) s->last_used = mono_sec();
+    pthread_mutex_unlock(&session_mutex);
+}
+
+void session_end(const char* token) {
+    pthread_mutex_lock(&session_mutex);
+    Session** pp = find_session(token);
+    Session* s = *pp;
+    if (s) { *pp = s->next; free(s); }
+    pthread_mutex_unlock(&session_mutex);
+}
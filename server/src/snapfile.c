@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapfile.h"
+#include "idalloc.h"
+#include "itemmeta.h"
+#include "parallel.h"
+
+// =====================================================================
+// [압축 스냅샷 부호화]
+// 블록 본문 (압축 전):
+//   상품명 길이(varint) + 상품명 + ID 접두어 1바이트 + 행 수(varint), 그 뒤로 유통기한 순 행마다
+//   (유통기한 차이 zigzag << 1 | 만료) varint
+//   ID: 접두어_번호(4자리 이상, 앞자리 0 채움) 형식이면 (직전 번호와의 차이 zigzag << 1) varint,
+//       아니면 (길이 << 1 | 1) varint + ID 글자 그대로
+//   부가 정보 꼬리 길이(varint) + 글자 (없으면 0)
+// 같은 상품명이 블록 머리에 한 번만 오고, 시각/번호는 차이만 남으므로 한 행이 대개 4~6바이트가 되며
+// 그 위에 LZ 압축으로 반복되는 부가 정보와 차이 패턴을 한 번 더 줄입니다.
+// =====================================================================
+
+#define SNAP_HEAD_LEN       (SNAP_MAGIC_LEN + 8 + 4)    // 매직 + 이력 오프셋(+1, 0 = 없음) + 블록 수
+#define BLOCK_HEAD_LEN      12
+#define ROW_RAW_MAX         (10 + 10 + 20 + 10 + META_LINE_LEN)
+#define LZ_HASH_BITS        14
+#define LZ_MAX_OFFSET       65535
+
+static void put32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+static uint32_t get32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static uint32_t fnv32(const uint8_t* p, size_t n) {
+    uint32_t h = 2166136261u;
+    while (n--) h = (h ^ *p++) * 16777619u;
+    return h;
+}
+
+static uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) { *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static int get_varint(const uint8_t** p, const uint8_t* end, uint64_t* v) {
+    uint64_t x = 0;
+    for (int shift = 0; *p < end && shift < 64; shift += 7) {
+        uint8_t b = *(*p)++;
+        x |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) { *v = x; return 1; }
+    }
+    return 0;
+}
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+// "A_0012" 처럼 다시 만들었을 때 글자까지 같은 ID 만 번호로 부호화
+static int canonical_id(const char* id, char prefix, uint64_t* num) {
+    if (id[0] != prefix || !(*num = id_number(id))) return 0;
+    size_t digits = strlen(id + 2);
+    return digits == 4 || (digits > 4 && id[2] != '0');
+}
+
+static void format_id(char* out, char prefix, uint64_t num) {
+    char tmp[24]; int n = 0;
+    do { tmp[n++] = '0' + num % 10; num /= 10; } while (num);
+    while (n < 4) tmp[n++] = '0';
+    *out++ = prefix; *out++ = '_';
+    while (n) *out++ = tmp[--n];
+    *out = '\0';
+}
+
+// =====================================================================
+// [블록 압축기] LZ4 와 같은 시퀀스 구성: 토큰(리터럴 길이 4비트 | 일치 길이-4 4비트) + 길이 연장 바이트(255 단위)
+// + 리터럴 + 거리 2바이트 + 일치 길이 연장. 마지막 시퀀스는 리터럴만 있고 입력 끝으로 구분합니다.
+// =====================================================================
+static uint32_t read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+static int lz_emit(uint8_t* dst, size_t cap, size_t* opp, const uint8_t* lit, size_t lit_len, size_t offset, size_t mlen) {
+    size_t op = *opp, ml = mlen ? mlen - 4 : 0;
+    if (op + 1 + lit_len / 255 + 1 + lit_len + 2 + ml / 255 + 1 > cap) return 0;
+    uint8_t* token = dst + op++;
+    *token = (uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+    if (lit_len >= 15) {
+        size_t r = lit_len - 15;
+        for (; r >= 255; r -= 255) dst[op++] = 255;
+        dst[op++] = (uint8_t)r;
+    }
+    memcpy(dst + op, lit, lit_len); op += lit_len;
+    if (mlen) {
+        dst[op++] = offset & 0xff; dst[op++] = offset >> 8;
+        if (ml >= 15) {
+            size_t r = ml - 15;
+            for (; r >= 255; r -= 255) dst[op++] = 255;
+            dst[op++] = (uint8_t)r;
+        }
+    }
+    *opp = op;
+    return 1;
+}
+
+size_t snap_lz_compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap) {
+    int32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0xff, sizeof(table));
+    size_t ip = 0, anchor = 0, op = 0;
+    while (ip + 8 <= n) {
+        uint32_t seq = read32(src + ip);
+        uint32_t h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+        int32_t ref = table[h];
+        table[h] = (int32_t)ip;
+        if (ref < 0 || ip - ref > LZ_MAX_OFFSET || read32(src + ref) != seq) { ip++; continue; }
+        size_t len = 4;
+        while (ip + len < n && src[ref + len] == src[ip + len]) len++;
+        if (!lz_emit(dst, cap, &op, src + anchor, ip - anchor, ip - ref, len)) return 0;
+        ip += len; anchor = ip;
+    }
+    if (!lz_emit(dst, cap, &op, src + anchor, n - anchor, 0, 0)) return 0;
+    return op;
+}
+
+static int lz_len(const uint8_t* src, size_t n, size_t* ip, size_t* len) {
+    uint8_t b;
+    do {
+        if (*ip >= n) return 0;
+        b = src[(*ip)++];
+        *len += b;
+    } while (b == 255);
+    return 1;
+}
+
+int snap_lz_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_len) {
+    size_t ip = 0, op = 0;
+    while (ip < n) {
+        uint8_t t = src[ip++];
+        size_t lit = t >> 4, ml = t & 15;
+        if (lit == 15 && !lz_len(src, n, &ip, &lit)) return 0;
+        if (lit > n - ip || lit > raw_len - op) return 0;
+        memcpy(dst + op, src + ip, lit); ip += lit; op += lit;
+        if (ip == n) break;
+        if (n - ip < 2) return 0;
+        size_t off = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if (ml == 15 && !lz_len(src, n, &ip, &ml)) return 0;
+        ml += 4;
+        if (off == 0 || off > op || ml > raw_len - op) return 0;
+        if (off >= ml) memcpy(dst + op, dst + op - off, ml);
+        else for (size_t i = 0; i < ml; i++) dst[op + i] = dst[op + i - off];     // 겹치는 반복
+        op += ml;
+    }
+    return op == raw_len;
+}
+
+// =====================================================================
+// [부호화] 행을 (상품명, 유통기한) 순으로 정렬해 블록으로 나눈 뒤 블록마다 따로 부호화/압축
+// =====================================================================
+typedef struct { long from, to; } BlockPlan;
+
+typedef struct {
+    const ProductRow** sorted;
+    const char* extras;
+    const BlockPlan* plans;
+    long first, count;
+    uint8_t** bufs;                 // 블록마다 머리말 + 본문
+    size_t* lens;
+    int failed;
+} EncodeChunk;
+
+// 정렬 키에 유통기한을 함께 두어 비교할 때 행을 따라가지 않음 (행 배열이 커서 캐시를 벗어남)
+typedef struct { long et; const ProductRow* r; } SortKey;
+
+// 유통기한 기수 정렬 (11비트씩 LSD, 모든 키가 같은 자릿값이면 그 자리는 건너뜀)
+static int radix_sort_keys(SortKey* keys, long n) {
+    if (n < 256) return 0;
+    SortKey* tmp = malloc(sizeof(SortKey) * n);
+    if (!tmp) return 0;
+    SortKey *src = keys, *dst = tmp;
+    for (int shift = 0; shift < 64; shift += 11) {
+        long count[2048] = {0};
+        for (long i = 0; i < n; i++) count[(((uint64_t)src[i].et ^ (1ULL << 63)) >> shift) & 2047]++;
+        if (count[(((uint64_t)src[0].et ^ (1ULL << 63)) >> shift) & 2047] == n) continue;
+        for (long d = 0, sum = 0; d < 2048; d++) { long c = count[d]; count[d] = sum; sum += c; }
+        for (long i = 0; i < n; i++) dst[count[(((uint64_t)src[i].et ^ (1ULL << 63)) >> shift) & 2047]++] = src[i];
+        SortKey* t = src; src = dst; dst = t;
+    }
+    if (src != keys) memcpy(keys, src, sizeof(SortKey) * n);
+    free(tmp);
+    return 1;
+}
+
+static int compare_expire(const void* a, const void* b) {
+    long x = ((const SortKey*)a)->et, y = ((const SortKey*)b)->et;
+    return (x > y) - (x < y);
+}
+
+static int compare_rows(const void* a, const void* b) {
+    int c = strcmp(((const SortKey*)a)->r->name, ((const SortKey*)b)->r->name);
+    return c ? c : compare_expire(a, b);
+}
+
+static size_t encode_raw(const ProductRow** rows, long n, const char* extras, uint8_t* out) {
+    uint8_t* p = out;
+    size_t name_len = strlen(rows[0]->name);
+    char prefix = rows[0]->id[0];
+    p = put_varint(p, name_len);
+    memcpy(p, rows[0]->name, name_len); p += name_len;
+    *p++ = (uint8_t)prefix;
+    p = put_varint(p, (uint64_t)n);
+    long prev_et = 0;
+    uint64_t prev_num = 0, num;
+    for (long i = 0; i < n; i++) {
+        const ProductRow* r = rows[i];
+        p = put_varint(p, zigzag((int64_t)r->expire_time - prev_et) << 1 | (r->is_expired ? 1 : 0));
+        prev_et = r->expire_time;
+        if (canonical_id(r->id, prefix, &num)) {
+            p = put_varint(p, zigzag((int64_t)(num - prev_num)) << 1);
+            prev_num = num;
+        } else {
+            size_t len = strlen(r->id);
+            p = put_varint(p, len << 1 | 1);
+            memcpy(p, r->id, len); p += len;
+        }
+        const char* ex = r->extra >= 0 ? extras + r->extra : "";
+        size_t ex_len = strlen(ex);
+        p = put_varint(p, ex_len);
+        memcpy(p, ex, ex_len); p += ex_len;
+    }
+    return p - out;
+}
+
+static void* encode_chunk(void* arg) {
+    EncodeChunk* c = arg;
+    for (long b = c->first; b < c->first + c->count; b++) {
+        const BlockPlan* pl = &c->plans[b];
+        long n = pl->to - pl->from;
+        size_t cap = 64 + (size_t)n * ROW_RAW_MAX;
+        uint8_t* raw = malloc(cap);
+        uint8_t* out = malloc(BLOCK_HEAD_LEN + cap);
+        if (!raw || !out) { free(raw); free(out); c->failed = 1; return NULL; }
+        size_t raw_len = encode_raw(c->sorted + pl->from, n, c->extras, raw);
+        size_t comp_len = snap_lz_compress(raw, raw_len, out + BLOCK_HEAD_LEN, raw_len);
+        if (comp_len == 0) memcpy(out + BLOCK_HEAD_LEN, raw, raw_len);     // 줄지 않으면 그대로
+        put32(out, (uint32_t)raw_len);
+        put32(out + 4, (uint32_t)comp_len);
+        put32(out + 8, fnv32(raw, raw_len));
+        free(raw);
+        c->bufs[b] = out;
+        c->lens[b] = BLOCK_HEAD_LEN + (comp_len ? comp_len : raw_len);
+    }
+    return NULL;
+}
+
+char* snap_encode(const ProductRow* rows, long n, const char* extras, long history_offset, size_t* out_len) {
+    const ProductRow** sorted = malloc(sizeof(*sorted) * (n > 0 ? n : 1));
+    BlockPlan* plans = malloc(sizeof(BlockPlan) * (n > 0 ? n : 1));
+    SortKey* keys = malloc(sizeof(SortKey) * (n > 0 ? n : 1));
+    if (!sorted || !plans || !keys) { free(sorted); free(plans); free(keys); return NULL; }
+    // 분류표의 상품명은 분류 번호로 먼저 나누고(계수 정렬) 분류 안에서만 유통기한으로 정렬. 분류표 밖의 이름은 맨 뒤에서 이름순
+    long start[NUM_CATEGORIES + 2] = {0};
+    signed char* cat = malloc(n > 0 ? n : 1);
+    if (!cat) { free(sorted); free(plans); free(keys); return NULL; }
+    for (long i = 0; i < n; i++) {
+        int c = category_of(rows[i].name);
+        cat[i] = (signed char)(c >= 0 ? c : NUM_CATEGORIES);
+        start[cat[i] + 1]++;
+    }
+    for (int c = 0; c <= NUM_CATEGORIES; c++) start[c + 1] += start[c];
+    long fill[NUM_CATEGORIES + 1];
+    memcpy(fill, start, sizeof(fill));
+    for (long i = 0; i < n; i++) keys[fill[(int)cat[i]]++] = (SortKey){ rows[i].expire_time, &rows[i] };
+    free(cat);
+    for (int c = 0; c < NUM_CATEGORIES; c++)
+        if (!radix_sort_keys(keys + start[c], start[c + 1] - start[c])) qsort(keys + start[c], start[c + 1] - start[c], sizeof(SortKey), compare_expire);
+    qsort(keys + start[NUM_CATEGORIES], n - start[NUM_CATEGORIES], sizeof(SortKey), compare_rows);
+    for (long i = 0; i < n; i++) sorted[i] = keys[i].r;
+    free(keys);
+
+    long nb = 0;
+    for (long i = 0; i < n; ) {
+        long j = i + 1;
+        while (j < n && j - i < SNAP_BLOCK_ROWS && strcmp(sorted[j]->name, sorted[i]->name) == 0) j++;
+        plans[nb].from = i; plans[nb].to = j; nb++;
+        i = j;
+    }
+
+    uint8_t** bufs = calloc(nb > 0 ? nb : 1, sizeof(uint8_t*));
+    size_t* lens = calloc(nb > 0 ? nb : 1, sizeof(size_t));
+    char* file = NULL;
+    if (bufs && lens) {
+        int t = parallel_threads();
+        if (nb < t) t = nb > 0 ? (int)nb : 1;
+        EncodeChunk chunks[PARALLEL_MAX_THREADS];
+        memset(chunks, 0, sizeof(chunks));
+        for (int i = 0; i < t; i++) {
+            long from = nb * i / t, to = nb * (i + 1) / t;
+            chunks[i] = (EncodeChunk){ .sorted = sorted, .extras = extras, .plans = plans, .first = from, .count = to - from, .bufs = bufs, .lens = lens };
+        }
+        parallel_run(t, encode_chunk, chunks, sizeof(EncodeChunk));
+        int failed = 0;
+        for (int i = 0; i < t; i++) failed |= chunks[i].failed;
+
+        size_t total = SNAP_HEAD_LEN;
+        for (long b = 0; b < nb; b++) total += lens[b];
+        if (!failed && (file = malloc(total)) != NULL) {
+            uint8_t* p = (uint8_t*)file;
+            uint64_t off = history_offset >= 0 ? (uint64_t)history_offset + 1 : 0;
+            memcpy(p, SNAP_MAGIC, SNAP_MAGIC_LEN);
+            put32(p + SNAP_MAGIC_LEN, (uint32_t)off);
+            put32(p + SNAP_MAGIC_LEN + 4, (uint32_t)(off >> 32));
+            put32(p + SNAP_MAGIC_LEN + 8, (uint32_t)nb);
+            p += SNAP_HEAD_LEN;
+            for (long b = 0; b < nb; b++) { memcpy(p, bufs[b], lens[b]); p += lens[b]; }
+            *out_len = total;
+        }
+    }
+    for (long b = 0; bufs && b < nb; b++) free(bufs[b]);
+    free(bufs); free(lens); free(plans); free(sorted);
+    return file;
+}
+
+// =====================================================================
+// [복호화]
+// =====================================================================
+int snap_is_snapshot(const char* data, size_t len) {
+    return len >= SNAP_HEAD_LEN && memcmp(data, SNAP_MAGIC, SNAP_MAGIC_LEN) == 0;
+}
+
+long snap_index(const char* data, size_t len, SnapBlock** blocks, long* history_offset) {
+    *blocks = NULL;
+    if (!snap_is_snapshot(data, len)) return -1;
+    const uint8_t* d = (const uint8_t*)data;
+    uint64_t off = get32(d + SNAP_MAGIC_LEN) | (uint64_t)get32(d + SNAP_MAGIC_LEN + 4) << 32;
+    uint32_t nb = get32(d + SNAP_MAGIC_LEN + 8);
+    if (history_offset) *history_offset = off ? (long)(off - 1) : -1;
+    if (nb > (len - SNAP_HEAD_LEN) / BLOCK_HEAD_LEN) return -1;
+    SnapBlock* bl = malloc(sizeof(SnapBlock) * (nb > 0 ? nb : 1));
+    if (!bl) return -1;
+    size_t pos = SNAP_HEAD_LEN;
+    for (uint32_t i = 0; i < nb; i++) {
+        if (len - pos < BLOCK_HEAD_LEN) { free(bl); return -1; }
+        bl[i].raw_len = get32(d + pos);
+        bl[i].comp_len = get32(d + pos + 4);
+        bl[i].checksum = get32(d + pos + 8);
+        bl[i].pos = pos + BLOCK_HEAD_LEN;
+        size_t body = bl[i].comp_len ? bl[i].comp_len : bl[i].raw_len;
+        if (len - bl[i].pos < body) { free(bl); return -1; }
+        pos = bl[i].pos + body;
+    }
+    *blocks = bl;
+    return nb;
+}
+
+long snap_decode_block(const char* data, const SnapBlock* b, void (*row)(void* arg, const SnapRow* r), void* arg) {
+    const uint8_t* src = (const uint8_t*)data + b->pos;
+    uint8_t* raw = NULL;
+    if (b->comp_len) {
+        if (!(raw = malloc(b->raw_len + 1))) return -1;
+        if (!snap_lz_decompress(src, b->comp_len, raw, b->raw_len)) { free(raw); return -1; }
+        src = raw;
+    }
+    long count = -1;
+    const uint8_t *p = src, *end = src + b->raw_len;
+    uint64_t name_len, n, v;
+    char name[50];
+    if (fnv32(src, b->raw_len) != b->checksum || !get_varint(&p, end, &name_len) || name_len >= sizeof(name) ||
+        (size_t)(end - p) < name_len + 1) goto out;
+    memcpy(name, p, name_len); name[name_len] = '\0';
+    p += name_len;
+    char prefix = (char)*p++;
+    if (!get_varint(&p, end, &n)) goto out;
+
+    SnapRow r = { .name = name };
+    long prev_et = 0;
+    uint64_t prev_num = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        if (!get_varint(&p, end, &v)) goto out;
+        r.expire_time = prev_et = prev_et + (long)unzigzag(v >> 1);
+        r.is_expired = (int)(v & 1);
+        if (!get_varint(&p, end, &v)) goto out;
+        if (v & 1) {
+            size_t len = v >> 1;
+            if (len >= sizeof(r.id) || (size_t)(end - p) < len) goto out;
+            memcpy(r.id, p, len); r.id[len] = '\0';
+            p += len;
+        } else {
+            prev_num += (uint64_t)unzigzag(v >> 1);
+            format_id(r.id, prefix, prev_num);
+        }
+        if (!get_varint(&p, end, &v) || (size_t)(end - p) < v) goto out;
+        r.extra = (const char*)p; r.extra_len = v;
+        p += v;
+        row(arg, &r);
+    }
+    count = (long)n;
+out:
+    free(raw);
+    return count;
+}
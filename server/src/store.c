@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "store.h"
+#include "inventory.h"
+#include "logger.h"
+#include "utils.h"
+#include "replication.h"
+#include "itemmeta.h"
+#include "coldtier.h"
+#include "scheduler.h"
+#include "history.h"
+
+// utils.c에 선언된 기본 파일명 (기본 매장이 그대로 사용)
+extern char db_filename[50];
+extern char log_filename[50];
+
+// [매장 레지스트리]
+// 처음 여는 매장의 DB 로드는 레지스트리 락 밖에서 합니다 (큰 매장을 읽는 동안 다른 매장 조회가 멈추지 않게).
+// 로드 중인 매장은 loading 에만 두어 get_store_at 순회(만료 검사/종료 저장)에 보이지 않고,
+// 같은 매장을 동시에 연 다른 스레드는 로드가 끝날 때까지 registry_cond 에서 기다립니다.
+static Store* stores[MAX_STORES];
+static int store_count = 0;
+static Store* loading[MAX_STORES];
+static int loading_count = 0;
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t registry_cond = PTHREAD_COND_INITIALIZER;
+
+// 매장 ID는 파일명에 들어가므로 영숫자, '-', '_' 만 허용
+static int is_valid_store_id(const char* id) {
+    size_t len = strlen(id);
+    if (len >= STORE_ID_LEN) return 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)id[i]) && id[i] != '-' && id[i] != '_') return 0;
+    }
+    return 1;
+}
+
+// "oper_db.txt" + "gangnam" -> "oper_db_gangnam.txt"
+static void make_store_filename(char* out, size_t size, const char* base, const char* id) {
+    if (id[0] == '\0') { snprintf(out, size, "%s", base); return; }
+    const char* dot = strrchr(base, '.');
+    int stem = dot ? (int)(dot - base) : (int)strlen(base);
+    snprintf(out, size, "%.*s_%s%s", stem, base, id, dot ? dot : "");
+}
+
+static Store* create_store(const char* id) {
+    Store* st = calloc(1, sizeof(Store));
+    if (!st) return NULL;
+    strncpy(st->id, id, STORE_ID_LEN - 1);
+    make_store_filename(st->db_filename, sizeof(st->db_filename), db_filename, id);
+    make_store_filename(st->log_filename, sizeof(st->log_filename), log_filename, id);
+    pthread_mutex_init(&st->list_mutex, NULL);
+    init_inventory(st);
+    return st;
+}
+
+void init_stores(void) {
+    pthread_mutex_lock(&registry_mutex);
+    if (store_count == 0) {
+        Store* st = create_store("");
+        if (st) stores[store_count++] = st;
+    }
+    pthread_mutex_unlock(&registry_mutex);
+}
+
+Store* get_default_store(void) {
+    return stores[0];
+}
+
+Store* open_store(const char* store_id) {
+    if (store_id == NULL || store_id[0] == '\0') return get_default_store();
+    if (!is_valid_store_id(store_id)) return NULL;
+
+    pthread_mutex_lock(&registry_mutex);
+    for (;;) {
+        for (int i = 0; i < store_count; i++) {
+            if (strcmp(stores[i]->id, store_id) == 0) {
+                Store* st = stores[i];
+                pthread_mutex_unlock(&registry_mutex);
+                return st;
+            }
+        }
+        int busy = 0;
+        for (int i = 0; i < loading_count; i++) if (strcmp(loading[i]->id, store_id) == 0) busy = 1;
+        if (!busy) break;
+        pthread_cond_wait(&registry_cond, &registry_mutex);     // 다른 스레드가 로드 중: 끝나면 위에서 찾음
+    }
+
+    Store* st = NULL;
+    if (store_count + loading_count < MAX_STORES && (st = create_store(store_id)) != NULL) loading[loading_count++] = st;
+    pthread_mutex_unlock(&registry_mutex);
+    if (!st) return NULL;
+
+    // 처음 열리는 매장은 자신의 DB를 로드하고, 닫혀 있던 동안의 만료를 복구
+    load_data(st);
+    if (!is_replica()) recover_missed_expirations(st, get_virtual_time());
+
+    pthread_mutex_lock(&registry_mutex);
+    for (int i = 0; i < loading_count; i++) if (loading[i] == st) { loading[i] = loading[--loading_count]; break; }
+    stores[store_count++] = st;
+    pthread_cond_broadcast(&registry_cond);
+    pthread_mutex_unlock(&registry_mutex);
+    return st;
+}
+
+Store* find_store(const char* store_id) {
+    if (store_id == NULL || store_id[0] == '\0') return get_default_store();
+    if (!is_valid_store_id(store_id)) return NULL;
+    pthread_mutex_lock(&registry_mutex);
+    for (int i = 0; i < store_count; i++) {
+        if (strcmp(stores[i]->id, store_id) == 0) {
+            Store* st = stores[i];
+            pthread_mutex_unlock(&registry_mutex);
+            return st;
+        }
+    }
+    pthread_mutex_unlock(&registry_mutex);
+
+    // 아직 열리지 않은 매장: 파일이 있을 때만 열어 줌 (오타로 빈 매장이 생기지 않게)
+    Store probe;
+    memset(&probe, 0, sizeof(probe));
+    snprintf(probe.id, sizeof(probe.id), "%s", store_id);
+    make_store_filename(probe.db_filename, sizeof(probe.db_filename), db_filename, store_id);
+    char hist[160];
+    make_history_path(&probe, ".history", hist, sizeof(hist));
+    if (access(probe.db_filename, F_OK) != 0 && access(hist, F_OK) != 0) return NULL;
+    return open_store(store_id);
+}
+
+int get_store_count(void) {
+    pthread_mutex_lock(&registry_mutex);
+    int n = store_count;
+    pthread_mutex_unlock(&registry_mutex);
+    return n;
+}
+
+Store* get_store_at(int idx) {
+    pthread_mutex_lock(&registry_mutex);
+    Store* st = (idx >= 0 && idx < store_count) ? stores[idx] : NULL;
+    pthread_mutex_unlock(&registry_mutex);
+    return st;
+}
+
+void print_store_stats(void) {
+    size_t total_bytes = 0;
+    int n = get_store_count();
+    for (int i = 0; i < n; i++) {
+        Store* st = get_store_at(i);
+        store_lock(st);
+        long items = st->item_count, expired = cold_count(st, NULL);
+        unsigned long long next_id = st->id_next;
+        size_t bytes = st->mem_bytes + meta_bytes(st) + cold_bytes(st);
+        store_unlock(st);
+        int q_len[SCHED_CLASSES];
+        unsigned long served;
+        sched_store_stats(st, q_len, &served);
+        total_bytes += bytes;
+
+        char buf[256];
+        snprintf(buf, sizeof(buf), "[매장] %-12s | 재고 %ld개 (만료 %ld개) | 메모리 %.1f KB | 대기 %d/%d/%d건 | 처리 %lu건 | 다음 번호 %llu",
+                 st->id[0] ? st->id : "(기본)", items, expired, bytes / 1024.0, q_len[0], q_len[1], q_len[2], served, next_id);
+        update_log(buf);
+    }
+    char buf[128];
+    snprintf(buf, sizeof(buf), "[매장] 총 %d개 매장, 재고 메모리 합계 %.1f KB", n, total_bytes / 1024.0);
+    update_log(buf);
+}
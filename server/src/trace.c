@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "trace.h"
+
+// =====================================================================
+// [내장 추적기]
+// 모든 스레드가 하나의 링에 씁니다: 칸 번호는 원자적 증가로 받고, 칸을 다 채운 뒤 seq 를 적어 완성을 표시합니다.
+// 덤프는 seq 를 앞뒤로 읽어 쓰는 중이거나 그새 덮어쓴 칸을 버리므로 쓰는 쪽을 멈추지 않습니다.
+// 락 추적은 스레드마다 쥐고 있는 락과 잡은 시각을 작은 스택에 두었다가 놓을 때 완료 이벤트(X)로 남깁니다.
+// =====================================================================
+
+typedef struct {
+    uint64_t seq;               // 칸 번호 + 1 (0 = 쓰는 중)
+    long long ts, dur;          // ns (dur 은 완료 이벤트만)
+    const char* cat;
+    const char* name;
+    long arg;
+    int tid;
+    char ph;                    // B/E = 구간 시작/끝, X = 완료
+} TraceEvent;
+
+int trace_on = 0;
+static TraceEvent* ring;
+static uint64_t ring_head;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;   // 켜기/덤프 (쓰는 쪽은 잡지 않음)
+
+typedef struct { pthread_mutex_t* m; const char* name; long long since; } HeldLock;
+static __thread HeldLock held[TRACE_LOCK_DEPTH];
+static __thread int n_held;
+static __thread int my_tid;
+
+long long trace_now_ns(void) {
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void put_event(char ph, const char* cat, const char* name, long arg, long long ts, long long dur) {
+    TraceEvent* r = __atomic_load_n(&ring, __ATOMIC_ACQUIRE);
+    if (!r) return;
+    if (!my_tid) my_tid = (int)syscall(SYS_gettid);
+    uint64_t n = __atomic_fetch_add(&ring_head, 1, __ATOMIC_RELAXED);
+    TraceEvent* e = &r[n & (TRACE_EVENTS - 1)];
+    __atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    e->ts = ts; e->dur = dur;
+    e->cat = cat; e->name = name; e->arg = arg;
+    e->tid = my_tid; e->ph = ph;
+    __atomic_store_n(&e->seq, n + 1, __ATOMIC_RELEASE);
+}
+
+void trace_emit(char ph, const char* cat, const char* name, long arg, long long dur_ns) {
+    long long now = trace_now_ns();
+    put_event(ph, cat, name, arg, ph == 'X' ? now - dur_ns : now, dur_ns);
+}
+
+// ---------------------------------------------------------------------
+// 락 추적
+// ---------------------------------------------------------------------
+void trace_lock_slow(pthread_mutex_t* m, const char* name) {
+    long long t0 = trace_now_ns();
+    pthread_mutex_lock(m);
+    long long t1 = trace_now_ns();
+    put_event('X', "lock_wait", name, 0, t0, t1 - t0);
+
+    // 꺼진 동안 놓은 락이 남아 있을 수 있음: 같은 락이면 그 칸을 다시 씀 (같은 락을 두 번 쥘 수는 없음)
+    int i = 0;
+    while (i < n_held && held[i].m != m) i++;
+    if (i == n_held) {
+        if (n_held == TRACE_LOCK_DEPTH) { for (int k = 1; k < n_held; k++) held[k - 1] = held[k]; i = --n_held; }
+        n_held++;
+    }
+    held[i] = (HeldLock){ m, name, t1 };
+}
+
+void trace_unlock_slow(pthread_mutex_t* m) {
+    long long now = trace_now_ns();
+    pthread_mutex_unlock(m);
+    for (int i = n_held - 1; i >= 0; i--) {
+        if (held[i].m != m) continue;
+        put_event('X', "lock", held[i].name, 0, held[i].since, now - held[i].since);
+        held[i] = held[--n_held];
+        return;
+    }
+    // 켜기 전에 잡은 락: 쥔 시간을 모르므로 남기지 않음
+}
+
+// ---------------------------------------------------------------------
+// 켜기/끄기/덤프 (관리자 콘솔)
+// ---------------------------------------------------------------------
+int trace_start(void) {
+    pthread_mutex_lock(&trace_mutex);
+    if (!ring) {
+        TraceEvent* r = calloc(TRACE_EVENTS, sizeof(TraceEvent));
+        if (!r) { pthread_mutex_unlock(&trace_mutex); return 0; }
+        __atomic_store_n(&ring, r, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&trace_on, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&trace_mutex);
+    return 1;
+}
+
+// 링은 남겨 둠: 끈 뒤에도 직전 구간을 덤프할 수 있고, 쓰는 중인 스레드가 해제된 링을 만지지 않음
+void trace_stop(void) {
+    __atomic_store_n(&trace_on, 0, __ATOMIC_RELAXED);
+}
+
+int trace_dump(const char* path, int seconds) {
+    pthread_mutex_lock(&trace_mutex);
+    if (!ring) { pthread_mutex_unlock(&trace_mutex); return 0; }
+    FILE* fp = fopen(path, "w");
+    if (!fp) { pthread_mutex_unlock(&trace_mutex); return -1; }
+
+    long long from = trace_now_ns() - (long long)seconds * 1000000000LL;
+    uint64_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+    uint64_t first = head > TRACE_EVENTS ? head - TRACE_EVENTS : 0;
+    int written = 0;
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (uint64_t n = first; n < head; n++) {
+        TraceEvent* slot = &ring[n & (TRACE_EVENTS - 1)];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != n + 1) continue;
+        TraceEvent e = *slot;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != n + 1) continue;     // 읽는 사이 덮어씀
+        if (e.ts < from) continue;
+
+        fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+                written ? ",\n" : "", e.name, e.cat, e.ph, e.ts / 1e3, (int)getpid(), e.tid);
+        if (e.ph == 'X') fprintf(fp, ",\"dur\":%.3f", e.dur / 1e3);
+        if (e.arg) fprintf(fp, ",\"args\":{\"v\":%ld}", e.arg);
+        fputc('}', fp);
+        written++;
+    }
+    fprintf(fp, "\n]}\n");
+    int ok = fclose(fp) == 0;
+    pthread_mutex_unlock(&trace_mutex);
+    return ok ? written : -1;
+}
@@ -3,22 +3,20 @@
 #include <string.h>
 #include "utils.h"
 #include "logger.h"
+#include "vclock.h"
+#include "iobackend.h"
 
 #define CONFIG_FILE "server_config.txt"
 
-// 내부 상태 (캡슐화됨)
+// 내부 상태 (캡슐화됨). 가상 시각과 배속은 vclock.c 가 관리
 static int current_server_mode = 1;
-static int current_speed_factor = 1;
 static int is_clock_visible = 1;
-static time_t start_real_time;
-static time_t start_virtual_time;
 
 char db_filename[50] = "oper_db.txt";
 char log_filename[50] = "oper_server.log";
 
 void init_config(int mode) {
     current_server_mode = mode;
-    current_speed_factor = 1;
     
     if (mode == 2) {
         strncpy(db_filename, "sim_db.txt", sizeof(db_filename)-1);
@@ -28,67 +26,57 @@ void init_config(int mode) {
         strncpy(log_filename, "oper_server.log", sizeof(log_filename)-1);
     }
     
-    time(&start_real_time);
-    start_virtual_time = start_real_time;
+    vclock_set(vclock_wall_ns(), 1);
 }
 
 void load_config(void) {
     if (current_server_mode != 2) return;
 
     FILE *fp = fopen(CONFIG_FILE, "r");
-    if (!fp) { current_speed_factor = 1; return; }
+    if (!fp) { vclock_set_speed(1); return; }
 
+    // 재시작 사이의 경과는 벽시계로만 알 수 있음 (monotonic 시계는 재부팅 시 초기화)
     int saved_speed;
     long saved_vt, saved_rt;
     if (fscanf(fp, "%d %ld %ld", &saved_speed, &saved_vt, &saved_rt) == 3) {
-        current_speed_factor = saved_speed;
-        time_t now; time(&now);
-        time_t time_diff = now - (time_t)saved_rt; 
-        time_t resumed_vt = (time_t)saved_vt + (time_diff * current_speed_factor);
-        
-        start_real_time = now;
-        start_virtual_time = resumed_vt;
+        if (saved_speed < 1) saved_speed = 1;
+        int64_t time_diff = vclock_wall_ns() - (int64_t)saved_rt * VCLOCK_NS_PER_SEC;
+        if (time_diff < 0) time_diff = 0;   // 그 사이 벽시계가 뒤로 조정된 경우
+        vclock_set(vclock_advance(vclock_advance(0, saved_vt, VCLOCK_NS_PER_SEC), time_diff, saved_speed), saved_speed);
 
         char msg[256];
-        snprintf(msg, sizeof(msg), "[System] 세션 복구 완료 (%ld초 흐름, 배속: x%d)", time_diff, current_speed_factor);
+        snprintf(msg, sizeof(msg), "[System] 세션 복구 완료 (%ld초 흐름, 배속: x%d)", (long)(time_diff / VCLOCK_NS_PER_SEC), saved_speed);
         update_log(msg);
     }
     fclose(fp);
 }
 
+// 설정 파일은 한 번 열어 두고 앞부분을 덮어씀: 한 줄을 고정 폭으로 채워 이전 내용이 뒤에 남지 않게
+// (fscanf 는 뒤쪽 공백을 무시). 쓰기는 I/O 스레드가 하므로 요청 스레드는 파일을 열고 닫지 않습니다.
 void save_config(void) {
-    if (current_server_mode != 2) return; 
-    FILE *fp = fopen(CONFIG_FILE, "w");
-    if (!fp) return;
-    
+    static IoFile* cfg;
+    if (current_server_mode != 2) return;
+    if (!cfg && !(cfg = io_open(CONFIG_FILE, IO_CREATE))) return;
+
     time_t now; time(&now);
     time_t current_vt = get_virtual_time();
-    fprintf(fp, "%d %ld %ld\n", current_speed_factor, (long)current_vt, (long)now);
-    fclose(fp);
+    char val[64], line[65];
+    snprintf(val, sizeof(val), "%d %ld %ld", vclock_speed(), (long)current_vt, (long)now);
+    snprintf(line, sizeof(line), "%-63s\n", val);
+    io_replace(cfg, line, 64);
 }
 
 int get_server_mode(void) { return current_server_mode; }
-int get_speed_factor(void) { return current_speed_factor; }
+int get_speed_factor(void) { return vclock_speed(); }
 
-void set_speed_factor(int new_speed) {
-    time_t now; time(&now);
-    start_virtual_time = start_virtual_time + (time_t)(difftime(now, start_real_time) * current_speed_factor);
-    start_real_time = now;
-    current_speed_factor = new_speed;
-}
+void set_speed_factor(int new_speed) { vclock_set_speed(new_speed); }
 
 int is_clock_showing(void) { return is_clock_visible; }
 void set_clock_showing(int show) { is_clock_visible = show; }
 
-time_t get_virtual_time(void) {
-    time_t now; time(&now);
-    return start_virtual_time + (time_t)(difftime(now, start_real_time) * current_speed_factor);
-}
+time_t get_virtual_time(void) { return vclock_now(); }
 
-void reset_virtual_time(void) {
-    time(&start_real_time);
-    start_virtual_time = start_real_time;
-}
+void reset_virtual_time(void) { vclock_set(vclock_wall_ns(), vclock_speed()); }
 
 void print_time_str(time_t t, char* buf) {
     struct tm tm_info; localtime_r(&t, &tm_info);
@@ -0,0 +1,92 @@
+#include <stdint.h>
+#include <pthread.h>
+#include "vclock.h"
+
+// =====================================================================
+// [가상 시계 - seqlock]
+// 가상 시각 = virt_base + (monotonic_now - real_base) * speed
+// 곱셈은 128비트로 하고 int64 범위에서 포화시킴: 큰 배속으로 오래 돌면 (경과 ns * 배속) 이
+// int64 를 넘어 시각이 음수로 뒤집힐 수 있기 때문 (x3600 이면 약 30일이면 넘음).
+// 세 값을 바꾸는 동안 seq 를 홀수로 두고, 읽는 쪽은 seq 가 짝수이면서 읽기 전후로 같을 때만
+// 값을 씁니다. 읽기는 시스템 콜 하나(vDSO clock_gettime)와 원자적 읽기 몇 번뿐입니다.
+// 배속을 바꿀 때는 그 순간의 가상 시각을 새 기준점으로 삼으므로 시각이 뒤로 가거나 튀지 않습니다.
+// =====================================================================
+
+static unsigned seq = 0;
+static int64_t real_base = 0;       // CLOCK_MONOTONIC ns
+static int64_t virt_base = 0;       // 가상 시각 ns
+static int speed = 1;
+static pthread_mutex_t write_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * VCLOCK_NS_PER_SEC + ts.tv_nsec;
+}
+
+int64_t vclock_advance(int64_t virt_ns, int64_t real_elapsed_ns, int sp) {
+    __int128 v = (__int128)virt_ns + (__int128)real_elapsed_ns * sp;
+    if (v > INT64_MAX) return INT64_MAX;
+    if (v < INT64_MIN) return INT64_MIN;
+    return (int64_t)v;
+}
+
+int64_t vclock_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * VCLOCK_NS_PER_SEC + ts.tv_nsec;
+}
+
+// 일관된 (기준점, 배속) 한 벌과 그 사이의 monotonic 시각을 읽어 가상 시각 계산.
+// monotonic 시각도 seq 구간 안에서 재야, 배속 변경 직전에 잰 값이 옛 배속으로 앞질러 가지 않음
+static int64_t read_now(void) {
+    unsigned s1, s2;
+    int64_t rb, vb, now; int sp;
+    do {
+        s1 = __atomic_load_n(&seq, __ATOMIC_ACQUIRE);
+        rb = __atomic_load_n(&real_base, __ATOMIC_RELAXED);
+        vb = __atomic_load_n(&virt_base, __ATOMIC_RELAXED);
+        sp = __atomic_load_n(&speed, __ATOMIC_RELAXED);
+        now = mono_ns();
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&seq, __ATOMIC_RELAXED);
+    } while ((s1 & 1) || s1 != s2);
+    return vclock_advance(vb, now - rb, sp);
+}
+
+// write_mutex 보유 상태에서 호출. 새 기준점의 monotonic 시각은 seq 를 홀수로 만든 뒤에 잼
+static void write_state(int use_current, int64_t vb, int sp) {
+    unsigned s = __atomic_load_n(&seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&seq, s + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t now = mono_ns();
+    if (use_current) vb = vclock_advance(virt_base, now - real_base, speed);
+    __atomic_store_n(&real_base, now, __ATOMIC_RELAXED);
+    __atomic_store_n(&virt_base, vb, __ATOMIC_RELAXED);
+    __atomic_store_n(&speed, sp, __ATOMIC_RELAXED);
+    __atomic_store_n(&seq, s + 2, __ATOMIC_RELEASE);
+}
+
+int64_t vclock_now_ns(void) {
+    return read_now();
+}
+
+time_t vclock_now(void) {
+    return (time_t)(vclock_now_ns() / VCLOCK_NS_PER_SEC);
+}
+
+int vclock_speed(void) {
+    return __atomic_load_n(&speed, __ATOMIC_RELAXED);
+}
+
+void vclock_set(int64_t virtual_ns, int new_speed) {
+    pthread_mutex_lock(&write_mutex);
+    write_state(0, virtual_ns, new_speed > 0 ? new_speed : 1);
+    pthread_mutex_unlock(&write_mutex);
+}
+
+void vclock_set_speed(int new_speed) {
+    pthread_mutex_lock(&write_mutex);
+    write_state(1, 0, new_speed > 0 ? new_speed : 1);
+    pthread_mutex_unlock(&write_mutex);
+}
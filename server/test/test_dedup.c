@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dedup.h"
+#include "admission.h"
+
+// =====================================================================
+// [요청 중복 제거 테스트]
+// 링을 기간 안의 완료 응답으로 가득 채운 뒤
+//  - 새 요청은 오래된 응답을 밀어내지 않고 RESP_BUSY 로 거절되는지
+//  - 가장 오래된 요청 ID 의 재전송이 다시 실행되지 않고 보관한 응답을 받는지
+// 출력은 한 줄에 하나씩 key=value 형식, 실패하면 종료 코드 1
+// =====================================================================
+
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+static int failed = 0;
+
+static void check(const char* name, int ok) {
+    printf("test=%s result=%s\n", name, ok ? "ok" : "FAIL");
+    if (!ok) failed = 1;
+}
+
+int main(void) {
+    int code, out_p;
+    char msg[256], expect[64];
+    const uint32_t cid = 7, cmd = 14;
+
+    int filled = 1;
+    for (uint32_t rid = 1; rid <= DEDUP_CAPACITY; rid++) {
+        if (dedup_begin(cid, rid, cmd, &code, &out_p, msg, sizeof(msg)) != DEDUP_NEW) { filled = 0; break; }
+        snprintf(msg, sizeof(msg), "판매 #%u", rid);
+        dedup_complete(cid, rid, RESP_OK, 1, msg);
+    }
+    check("dedup_fill_ring", filled);
+
+    uint32_t fresh = DEDUP_CAPACITY + 1;
+    int r = dedup_begin(cid, fresh, cmd, &code, &out_p, msg, sizeof(msg));
+    check("dedup_full_ring_refuses_new", r == DEDUP_HIT && code == RESP_BUSY);
+
+    r = dedup_begin(cid, 1, cmd, &code, &out_p, msg, sizeof(msg));
+    check("dedup_full_ring_keeps_oldest", r == DEDUP_HIT && code == RESP_OK && out_p == 1 && strcmp(msg, "판매 #1") == 0);
+
+    snprintf(expect, sizeof(expect), "판매 #%u", (unsigned)DEDUP_CAPACITY);
+    r = dedup_begin(cid, DEDUP_CAPACITY, cmd, &code, &out_p, msg, sizeof(msg));
+    check("dedup_full_ring_keeps_newest", r == DEDUP_HIT && code == RESP_OK && strcmp(msg, expect) == 0);
+
+    return failed;
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glob.h>
+#include "inventory.h"
+#include "idalloc.h"
+#include "history.h"
+#include "logger.h"
+#include "store.h"
+#include "utils.h"
+
+// =====================================================================
+// [상품 번호 발급 테스트]
+// 발급하지 않은 최대 번호(17자리)로 직접 입고해도 다음 번호가 밀리지 않아 번호 임대가 계속 되는지,
+// 임대받은 번호로는 직접 입고가 되는지 확인합니다.
+// 파일은 현재 디렉토리에 만들었다가 지웁니다. 출력은 key=value, 실패하면 종료 코드 1
+// =====================================================================
+
+extern char log_filename[50];
+void handle_sigint(int sig) { (void)sig; exit(0); }
+
+#define DB_FILE "test_idalloc_db.txt"
+#define LOG_FILE "test_idalloc.log"
+
+static int failed = 0;
+
+static void check(const char* name, int ok, const char* detail) {
+    printf("test=%s result=%s detail=%s\n", name, ok ? "ok" : "FAIL", detail);
+    if (!ok) failed = 1;
+}
+
+static void remove_files(const char* pattern) {
+    glob_t g;
+    if (glob(pattern, 0, NULL, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; i++) remove(g.gl_pathv[i]);
+        globfree(&g);
+    }
+}
+
+int main(void) {
+    init_config(1);
+    strcpy(log_filename, LOG_FILE);
+    remove_files("test_idalloc_db*");
+
+    Store* st = calloc(1, sizeof(Store));
+    pthread_mutex_init(&st->list_mutex, NULL);
+    snprintf(st->db_filename, sizeof(st->db_filename), "%s", DB_FILE);
+    init_inventory(st);
+    load_data(st);
+
+    char pin[128], msg[MAX_PAYLOAD];
+    snprintf(pin, sizeof(pin), "A_%llu|김밥|24", (unsigned long long)ID_NUMBER_MAX);
+    handle_single_import(st, 1, pin, msg);
+    check("idalloc_explicit_max_rejected", st->item_count == 0, msg);
+
+    snprintf(pin, sizeof(pin), "10");
+    handle_id_lease(st, 1, pin, msg);
+    unsigned long long first = 0, last = 0;
+    check("idalloc_lease_after_max_import", sscanf(msg, "%llu\t%llu", &first, &last) == 2 && last == first + 9, msg);
+
+    snprintf(pin, sizeof(pin), "%llu|김밥|24", last);
+    handle_single_import(st, 1, pin, msg);
+    check("idalloc_leased_import", st->item_count == 1, msg);
+
+    history_close(st);
+    free_all_resources(st);
+    free(st);
+    remove_files("test_idalloc_db*");
+    flush_logs();
+    remove(LOG_FILE); remove(LOG_FILE ".idx");
+    return failed;
+}